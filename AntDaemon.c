@@ -0,0 +1,973 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Headless batch daemon.  Listens on a Unix socket for jobs, runs each
+ *  deck through the same code the GUI uses -- ReadCardFile, WriteCardFile
+ *  at the asked step size, nec2 (or the ANTENNAVIS_SOLVER stand-in, see
+ *  Fixture.c) and ParseFieldData -- and streams the results back.  nec2
+ *  runs in the -j workers of SolverPool.c; further jobs wait their turn,
+ *  and a run longer than -t seconds is stopped and reported.
+ *
+ *  A job is a few text lines, and a client may send any number of them
+ *  on one connection:
+ *
+ *    JOB name                   starts a job, name echoed in replies
+ *    FREQ mhz                   optional, overrides the FR card
+ *    STEP degrees               optional, pattern step, default 5
+ *    SWEEP from to count        optional, instead of a pattern solve the
+ *                               feedpoint over count frequencies in MHz
+ *    OUTPUT stats pattern image what to send back, default stats; also
+ *           analysis and feed
+ *    DECK                       the NEC cards follow, up to
+ *    END                        ..this line, which submits the job
+ *
+ *  Replies come as the job moves along, each a text line:
+ *
+ *    QUEUED name
+ *    RUNNING name
+ *    STATS name samples maxgain mingain maxtilt mintilt maxaxial minaxial
+ *    ANALYSIS name gain directivity efficiency radiated front_to_back
+ *             front_to_rear beamwidth_az beamwidth_el sidelobe_az sidelobe_el
+ *    FEED name mhz tag segment r x swr50 watts
+ *                               one per source and frequency, for feed
+ *                               and every SWEEP
+ *    PATTERN name bytes         then that many bytes of a PatFile.c file
+ *    IMAGE name bytes           then that many bytes of binary PPM
+ *    DONE name milliseconds
+ *    ERROR name message
+ *
+ *  A deck DeckCheck.c finds errors in gets the first of them as its ERROR
+ *  without going to nec2; warnings are not sent.
+ *
+ *  Usage:  AntDaemon [-s socket] [-j workers] [-t timeout] [-i image size]
+ *
+ *  The socket is $XDG_RUNTIME_DIR/antennavis.sock by default, or
+ *  /tmp/antennavis-uid.sock without one, and only its owner may connect.
+ *
+ *  For example: printf 'JOB a\nDECK\n...\nEND\n' | nc -U socket
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "pcard.h"
+#include "PatKernel.h"
+#include "WorkPool.h"
+#include "Timing.h"
+#include "Fixture.h"
+#include "SolverPool.h"
+#include "PatFile.h"
+#include "FieldAnalysis.h"
+#include "Offscreen.h"
+#include "DeckCheck.h"
+#include "Symmetry.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  MAX_CLIENTS     32     /**  Connections at once              **/
+#define  MAX_LINE        1024   /**  Longest request line             **/
+#define  DEFAULT_STEP    5      /**  Degrees                          **/
+#define  IMAGE_SIZE      500    /**  Pixels, like ModelBench          **/
+#define  POLL_MS         50     /**  How often children are reaped    **/
+
+#define  OUT_STATS       1      /**  OUTPUT words as bits             **/
+#define  OUT_PATTERN     2
+#define  OUT_IMAGE       4
+#define  OUT_ANALYSIS    8
+#define  OUT_FEED        16
+
+#define  JOB_QUEUED      0      /**  Job states                       **/
+#define  JOB_RUNNING     1
+#define  JOB_SOLVED      2
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Typedefs                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Client {
+  int            fd;              /**  Socket, -1 when free             **/
+  char           in[MAX_LINE];    /**  Partial request line             **/
+  size_t         len;             /**    ..its length                   **/
+  struct Job    *building;        /**  Job whose lines are coming in    **/
+  FILE          *deck;            /**  Its cards, while in DECK         **/
+} Client;
+
+typedef struct Job {
+  int            id;              /**  Names the job's files            **/
+  char           name[64];        /**  As the client called it          **/
+  Client        *client;          /**  NULL once the client went away   **/
+  double         freq;            /**  MHz, 0 to keep the FR card       **/
+  int            step;            /**  Pattern step, degrees            **/
+  int            outputs;         /**  OUT_ bits                        **/
+  int            sweep;           /**  SWEEP frequencies, 0 if none     **/
+  double         sweep_from;      /**    ..first, MHz                   **/
+  double         sweep_to;        /**    ..last, MHz                    **/
+  int            state;           /**  JOB_ state                       **/
+  int            slot;            /**  Solver worker, while running     **/
+  bool           failed;          /**  An ERROR was sent already        **/
+  double         start;           /**  When it was queued, ms           **/
+  char           input[256];      /**  Deck as the client sent it       **/
+  char           deck[256];       /**  Deck as nec2 is given it         **/
+  char           output[256];     /**  nec2's output                    **/
+  SY_Plan       *plan;            /**  Symmetry deck was written with   **/
+  struct Job    *next;            /**  Queue order                      **/
+} Job;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+extern AntArray  TheAnts;             /**  The antennas' geometries        **/
+extern double    SCALE_FACTOR;        /**  Antenna scale factor            **/
+extern double    DEFAULT_BOOMHEIGHT;  /**  No height above ground specd    **/
+extern double    POINT_DIST_SCALE;    /**  For point clouds, mult of dBi   **/
+extern double    POINT_SIZE_SCALE;    /**    ..also in terms of dBi        **/
+extern double    STEP_SIZE;           /**  Degrees between control points  **/
+extern double    ALPHA;               /**  Alpha transparency factor       **/
+extern double    curr_step_size;      /**  Step of the parsed pattern      **/
+extern int       MultipleAntMode;     /**  Current antenna or all          **/
+extern int       ShowRadPat;          /**  Show radiation pattern?         **/
+extern int       ShowPolSense;        /**  Show polarization sense?        **/
+extern bool      RFPowerDensityOn;    /**  Draw the field at all?          **/
+
+local Client          Clients[MAX_CLIENTS];  /**  Connections            **/
+local Job            *Jobs = NULL;           /**  Queued and running     **/
+local int             NextId = 1;            /**  For job file names     **/
+local char            WorkDir[64];           /**  Job files live here    **/
+local bool            HaveGL = false;        /**  Images can be drawn    **/
+local volatile bool   Quit = false;          /**  Set by SIGINT/SIGTERM  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Send                                   **/
+/**                                                                         **/
+/**  Writes to a client, dropping it on error.  Replies go out whole, so    **/
+/**  a slow reader holds up the daemon rather than getting torn lines.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void DropClient(Client *client);
+
+local void Send(Client *client, const void *data, size_t size) {
+
+  const char  *p;  /**  Next byte      **/
+  ssize_t      n;  /**  Bytes written  **/
+
+  for (p = data; client != NULL && client->fd >= 0 && size > 0; ) {
+    n = write(client->fd, p, size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      DropClient(client);
+      return;
+    }  /**  Gone  **/
+    p += n;
+    size -= n;
+  }  /**  Until all written  **/
+
+}  /**  End of Send  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Reply                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Reply(Job *job, const char *what, const char *rest) {
+
+  char  line[MAX_LINE];  /**  The reply  **/
+
+  snprintf(line, sizeof(line), "%s %s%s%s\n", what, job->name,
+           rest != NULL ? " " : "", rest != NULL ? rest : "");
+  Send(job->client, line, strlen(line));
+
+}  /**  End of Reply  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SendFile                                 **/
+/**                                                                         **/
+/**  Sends "WHAT name bytes" and then the bytes of a file.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SendFile(Job *job, const char *what, const char *file_name) {
+
+  FILE   *f;           /**  The file      **/
+  char    buf[8192];   /**  Block         **/
+  char    size[32];    /**  Its length    **/
+  long    bytes;       /**  File length   **/
+  size_t  n;           /**  Block length  **/
+
+  if ((f = fopen(file_name, "rb")) == NULL) {
+    Reply(job, "ERROR", "output not written");
+    return;
+  }  /**  Nothing to send  **/
+  fseek(f, 0, SEEK_END);
+  bytes = ftell(f);
+  rewind(f);
+  snprintf(size, sizeof(size), "%ld", bytes);
+  Reply(job, what, size);
+  while (bytes > 0 && (n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    Send(job->client, buf, n);
+    bytes -= n;
+  }  /**  For each block  **/
+  fclose(f);
+
+}  /**  End of SendFile  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                JobFile                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void JobFile(Job *job, const char *suffix, char *path, size_t size) {
+
+  snprintf(path, size, "%s/job-%d.%s", WorkDir, job->id, suffix);
+
+}  /**  End of JobFile  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                LoadDeck                                 **/
+/**                                                                         **/
+/**  Makes the job's deck the only antenna in the scene, at its frequency.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local Ant *LoadDeck(Job *job) {
+
+  Ant  *ant;  /**  The antenna  **/
+
+  ClearScene();
+  ReadFile(job->input);
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (ant->first_tube == NULL)
+    return NULL;
+  if (job->freq > 0.0)
+    ant->frequency = job->freq;
+  return ant;
+
+}  /**  End of LoadDeck  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                StartJob                                 **/
+/**                                                                         **/
+/**  Writes the deck nec2 is to see and hands it to a solver worker.       **/
+/**  The symmetry it was written with stays with the job, as FinishJob     **/
+/**  reads the output into a freshly loaded antenna.  Stand-in backends    **/
+/**  answer at once and leave the job JOB_SOLVED.                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void StartJob(Job *job) {
+
+  Ant        *ant;     /**  The job's antenna  **/
+  DC_Report   report;  /**  Its deck check     **/
+
+  job->state = JOB_SOLVED;
+  if ((ant = LoadDeck(job)) == NULL) {
+    Reply(job, "ERROR", "no GW cards in deck");
+    job->failed = true;
+    return;
+  }  /**  Nothing to solve  **/
+  if (DC_Check(&ant, 1, (job->sweep > 0) ? job->sweep_to : ant->frequency,
+               &report) > 0 ||
+      (job->sweep > 0 && DC_Check(&ant, 1, job->sweep_from, &report) > 0)) {
+    Reply(job, "ERROR", DC_FirstError(&report));
+    job->failed = true;
+    return;
+  }  /**  Not worth a solve  **/
+  if (job->sweep > 0)
+    job->plan = WriteSweepFile(job->deck, ant, job->sweep_from, 
+                               (job->sweep > 1) ? (job->sweep_to - 
+                               job->sweep_from) / (job->sweep - 1) : 0,
+                               job->sweep);
+  else
+    job->plan = WriteCardFile(job->deck, ant, job->step, ant->frequency);
+  Reply(job, "RUNNING", NULL);
+
+  switch (FX_Solve(job->deck, job->output)) {
+    case FX_SERVED:
+      return;
+    case FX_FAILED:
+      Reply(job, "ERROR", "no solver output");
+      job->failed = true;
+      return;
+    default:
+      break;
+  }  /**  Stand-in backends  **/
+
+  if ((job->slot = SP_Start(job->deck, job->output)) < 0) {
+    Reply(job, "ERROR", SP_Message(SP_NO_WORKER));
+    job->failed = true;
+    return;
+  }  /**  Error state  **/
+  job->state = JOB_RUNNING;
+
+}  /**  End of StartJob  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SendFeed                                 **/
+/**                                                                         **/
+/**  A FEED line for each row of the antenna's input parameters.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SendFeed(Job *job, Ant *ant) {
+
+  FeedTable  *table;      /**  Input parameters  **/
+  char        line[256];  /**  Reply             **/
+  int         i;          /**  Row index         **/
+
+  if ((table = ant->feedTable) == NULL || table->count == 0) {
+    Reply(job, "ERROR", "no input parameters in output");
+    return;
+  }  /**  Nothing parsed  **/
+  for (i = 0; i < table->count; i++) {
+    snprintf(line, sizeof(line), "%g %d %d %g %g %g %g",
+             table->frequency[i], table->tag[i], table->segment[i],
+             table->resistance[i], table->reactance[i],
+             FeedSWR(table->resistance[i], table->reactance[i], 50.0),
+             table->power[i]);
+    Reply(job, "FEED", line);
+  }  /**  Every row  **/
+
+}  /**  End of SendFeed  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FinishJob                                 **/
+/**                                                                         **/
+/**  Parses what the solver wrote and sends the asked-for outputs.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void FinishJob(Job *job) {
+
+  Ant        *ant;          /**  The job's antenna  **/
+  FieldData  *fd;           /**  Its field          **/
+  FA_Samples  samples;      /**  View of the field  **/
+  FA_Result   fa;           /**  Its figures        **/
+  FILE       *fin;          /**  Solver output      **/
+  FILE       *fout;         /**  Image              **/
+  char        path[256];    /**  Output file        **/
+  char        line[256];    /**  Reply              **/
+
+  if ((ant = LoadDeck(job)) == NULL || 
+      (fin = fopen(job->output, "rt")) == NULL) {
+    Reply(job, "ERROR", "solver wrote no output");
+    return;
+  }  /**  Nothing to parse  **/
+  FX_Solved(job->deck, job->output);
+  if (job->sweep > 0) {
+    ParseSweep(fin, ant, job->plan);
+    fclose(fin);
+    SendFeed(job, ant);
+    snprintf(line, sizeof(line), "%.1f", TM_Start() - job->start);
+    Reply(job, "DONE", line);
+    return;
+  }  /**  Feedpoint only  **/
+  ParseFieldData(fin, ant, job->plan, true, true);
+  fclose(fin);
+  fd = ant->fieldData;
+  if (fd == NULL || fd->count == 0) {
+    Reply(job, "ERROR", "no radiation pattern in output");
+    return;
+  }  /**  Nothing parsed  **/
+
+  if (job->outputs & OUT_STATS) {
+    snprintf(line, sizeof(line), "%d %g %g %g %g %g %g", fd->count,
+             fd->maxgain, fd->mingain, fd->maxtilt, fd->mintilt,
+             fd->maxaxialratio, fd->minaxialratio);
+    Reply(job, "STATS", line);
+  }  /**  Statistics  **/
+
+  if (job->outputs & OUT_ANALYSIS) {
+    FA_FieldSamples(fd, &samples);
+    if (FA_Analyze(&samples, &fa)) {
+      snprintf(line, sizeof(line), "%g %g %g %g %g %g %g %g %g %g",
+               fa.peak_gain, fa.directivity, fa.efficiency, fa.radiated,
+               fa.front_to_back, fa.front_to_rear, fa.beamwidth_az,
+               fa.beamwidth_el, fa.sidelobe_az, fa.sidelobe_el);
+      Reply(job, "ANALYSIS", line);
+    } else
+      Reply(job, "ERROR", "pattern is not a theta by phi grid");
+  }  /**  Figures of merit  **/
+
+  if (job->outputs & OUT_FEED)
+    SendFeed(job, ant);
+
+  if (job->outputs & OUT_PATTERN) {
+    JobFile(job, "pat", path, sizeof(path));
+    if (PF_Write(path, ant))
+      SendFile(job, "PATTERN", path);
+    else
+      Reply(job, "ERROR", "pattern not written");
+    remove(path);
+  }  /**  Binary pattern  **/
+
+  if (job->outputs & OUT_IMAGE) {
+    JobFile(job, "ppm", path, sizeof(path));
+    if (HaveGL && (fout = fopen(path, "wb")) != NULL) {
+      curr_step_size = job->step;
+      RFPowerDensityOn = true;
+      OS_Draw(0.0);
+      OS_WritePPM(fout);
+      fclose(fout);
+      SendFile(job, "IMAGE", path);
+    } else
+      Reply(job, "ERROR", "no offscreen GL for images");
+    remove(path);
+  }  /**  Picture  **/
+
+  snprintf(line, sizeof(line), "%.1f", TM_Start() - job->start);
+  Reply(job, "DONE", line);
+
+}  /**  End of FinishJob  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FreeJob                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void FreeJob(Job *job) {
+
+  Job  **link;  /**  Where job is linked from  **/
+
+  for (link = &Jobs; *link != NULL; link = &(*link)->next)
+    if (*link == job) {
+      *link = job->next;
+      break;
+    }  /**  Unlink  **/
+  remove(job->input);
+  remove(job->deck);
+  remove(job->output);
+  SY_Free(job->plan);
+  free(job);
+
+}  /**  End of FreeJob  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Schedule                                 **/
+/**                                                                         **/
+/**  Collects finished solvers, finishes their jobs, and starts queued     **/
+/**  jobs while a solver worker is free.                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Schedule(void) {
+
+  Job    *job;      /**  Job traversal     **/
+  Job    *next;     /**  Next in queue     **/
+  int     result;   /**  Solver result     **/
+  int     running;  /**  Solvers running   **/
+
+  for (job = Jobs; job != NULL; job = job->next)
+    if (job->state == JOB_RUNNING &&
+        (result = SP_Check(job->slot, 0)) != SP_BUSY) {
+      job->state = JOB_SOLVED;
+      if (result != SP_OK) {
+        Reply(job, "ERROR", SP_Message(result));
+        job->failed = true;
+      }  /**  Solver failed  **/
+    }  /**  For each running job  **/
+
+  do {
+    running = 0;
+    for (job = Jobs; job != NULL; job = next) {
+      next = job->next;
+      if (job->state == JOB_SOLVED) {
+        if (!job->failed && job->client != NULL)
+          FinishJob(job);
+        FreeJob(job);
+      } else if (job->state == JOB_RUNNING)
+        running++;
+    }  /**  Finish solved jobs  **/
+    for (job = Jobs; job != NULL && running < SP_Workers(); job = job->next)
+      if (job->state == JOB_QUEUED) {
+        StartJob(job);
+        running++;
+      }  /**  Start queued jobs  **/
+    for (job = Jobs; job != NULL; job = job->next)
+      if (job->state == JOB_SOLVED)
+        break;
+  } while (job != NULL);  /**  Stand-ins solve at once  **/
+
+}  /**  End of Schedule  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               DropClient                                **/
+/**                                                                         **/
+/**  Closes a connection.  Its running jobs finish, but nobody is told.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void DropClient(Client *client) {
+
+  Job  *job;  /**  Job traversal  **/
+
+  if (client->fd < 0)
+    return;
+  close(client->fd);
+  client->fd = -1;
+  if (client->deck != NULL)
+    fclose(client->deck);
+  client->deck = NULL;
+  if (client->building != NULL) {
+    remove(client->building->input);
+    free(client->building);
+  }  /**  Half-sent job  **/
+  client->building = NULL;
+  for (job = Jobs; job != NULL; job = job->next)
+    if (job->client == client)
+      job->client = NULL;
+
+}  /**  End of DropClient  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Request                                  **/
+/**                                                                         **/
+/**  Handles one line from a client.                                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Request(Client *client, char *line) {
+
+  Job   *job;        /**  Job being built   **/
+  Job  **link;       /**  Queue tail        **/
+  char  *word;       /**  OUTPUT word       **/
+
+  job = client->building;
+  if (client->deck != NULL) {
+    if (strcmp(line, "END") != 0) {
+      fprintf(client->deck, "%s\n", line);
+      return;
+    }  /**  A card  **/
+    fclose(client->deck);
+    client->deck = NULL;
+    client->building = NULL;
+    for (link = &Jobs; *link != NULL; link = &(*link)->next)
+      ;
+    *link = job;
+    Reply(job, "QUEUED", NULL);
+    return;
+  }  /**  Reading the deck  **/
+
+  if (strncmp(line, "JOB ", 4) == 0) {
+    if (job == NULL && (job = calloc(1, sizeof(Job))) == NULL)
+      return;
+    memset(job, 0, sizeof(*job));
+    job->id = NextId++;
+    snprintf(job->name, sizeof(job->name), "%s", line + 4);
+    job->client = client;
+    job->step = DEFAULT_STEP;
+    job->outputs = OUT_STATS;
+    job->start = TM_Start();
+    JobFile(job, "in", job->input, sizeof(job->input));
+    JobFile(job, "nec", job->deck, sizeof(job->deck));
+    JobFile(job, "out", job->output, sizeof(job->output));
+    client->building = job;
+  }  /**  New job  **/
+  else if (job == NULL) {
+    Send(client, "ERROR - expected JOB\n", 21);
+  }  /**  Out of order  **/
+  else if (strncmp(line, "FREQ ", 5) == 0)
+    job->freq = atof(line + 5);
+  else if (strncmp(line, "STEP ", 5) == 0) {
+    job->step = atoi(line + 5);
+    if (job->step < 1 || job->step > 90)
+      job->step = DEFAULT_STEP;
+  }  /**  Step size  **/
+  else if (strncmp(line, "SWEEP ", 6) == 0) {
+    if (sscanf(line + 6, "%lf %lf %d", &job->sweep_from, &job->sweep_to,
+               &job->sweep) != 3 || job->sweep < 1 || job->sweep > 9999 ||
+        job->sweep_from <= 0) {
+      job->sweep = 0;
+      Reply(job, "ERROR", "SWEEP wants from to count");
+    }  /**  Bad sweep  **/
+  }  /**  Frequency sweep  **/
+  else if (strncmp(line, "OUTPUT ", 7) == 0) {
+    job->outputs = 0;
+    for (word = strtok(line + 7, " \t"); word != NULL;
+         word = strtok(NULL, " \t")) {
+      if (strcmp(word, "stats") == 0)
+        job->outputs |= OUT_STATS;
+      else if (strcmp(word, "pattern") == 0)
+        job->outputs |= OUT_PATTERN;
+      else if (strcmp(word, "image") == 0)
+        job->outputs |= OUT_IMAGE;
+      else if (strcmp(word, "analysis") == 0)
+        job->outputs |= OUT_ANALYSIS;
+      else if (strcmp(word, "feed") == 0)
+        job->outputs |= OUT_FEED;
+    }  /**  For each word  **/
+  }  /**  Outputs  **/
+  else if (strcmp(line, "DECK") == 0) {
+    if ((client->deck = fopen(job->input, "wt")) == NULL)
+      Reply(job, "ERROR", "cannot store deck");
+  }  /**  Cards follow  **/
+  else
+    Reply(job, "ERROR", "unknown request");
+
+}  /**  End of Request  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ReadClient                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void ReadClient(Client *client) {
+
+  char     buf[4096];  /**  What arrived      **/
+  char    *eol;        /**  End of a line     **/
+  ssize_t  n;          /**  Bytes read        **/
+  ssize_t  i;          /**  Loop counter      **/
+
+  n = read(client->fd, buf, sizeof(buf));
+  if (n <= 0) {
+    if (n < 0 && errno == EINTR)
+      return;
+    DropClient(client);
+    return;
+  }  /**  Closed  **/
+
+  for (i = 0; i < n && client->fd >= 0; i++) {
+    if (buf[i] != '\n') {
+      if (client->len < sizeof(client->in) - 1)
+        client->in[client->len++] = buf[i];
+      continue;
+    }  /**  Same line  **/
+    client->in[client->len] = '\0';
+    if ((eol = strchr(client->in, '\r')) != NULL)
+      *eol = '\0';
+    client->len = 0;
+    Request(client, client->in);
+  }  /**  For each byte  **/
+
+}  /**  End of ReadClient  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Listen                                  **/
+/**                                                                         **/
+/**  Binds the socket readable and writable by this user only.              **/
+/**  Something already at path is removed only if it is a socket of this    **/
+/**  user's, left by a daemon that did not stop cleanly; anything else is   **/
+/**  refused.                                                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Listen(const char *path) {
+
+  struct sockaddr_un  addr;  /**  Socket address    **/
+  struct stat         st;    /**  What is at path   **/
+  mode_t              mask;  /**  Caller's umask    **/
+  int                 fd;    /**  The socket        **/
+  bool                ok;    /**  Bound, owner only **/
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }  /**  Too long  **/
+  strcpy(addr.sun_path, path);
+  if (lstat(path, &st) == 0) {
+    if (!S_ISSOCK(st.st_mode) || st.st_uid != getuid()) {
+      errno = EEXIST;
+      return -1;
+    }  /**  Not ours to remove  **/
+    unlink(path);
+  }  /**  A stale socket  **/
+  if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    return -1;
+  mask = umask(S_IRWXG | S_IRWXO);
+  ok = (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0);
+  umask(mask);
+  if (ok && chmod(path, S_IRUSR | S_IWUSR) < 0) {
+    unlink(path);
+    ok = false;
+  }  /**  Others could connect  **/
+  if (!ok || listen(fd, MAX_CLIENTS) < 0) {
+    close(fd);
+    return -1;
+  }  /**  Cannot listen  **/
+  return fd;
+
+}  /**  End of Listen  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 OnSignal                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void OnSignal(int sig) {
+
+  Quit = true;
+
+}  /**  End of OnSignal  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  main                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int main(int argc, char **argv) {
+
+  struct pollfd  fds[MAX_CLIENTS + 1];  /**  Listener, then clients  **/
+  char           path[108];             /**  Socket path             **/
+  const char    *socket_path;           /**  -s                      **/
+  const char    *runtime;               /**  XDG_RUNTIME_DIR         **/
+  int            image_size;            /**  -i                      **/
+  int            workers;               /**  -j                      **/
+  int            timeout;               /**  -t, seconds             **/
+  int            listener;              /**  Listening socket        **/
+  int            fd;                    /**  New connection          **/
+  int            opt;                   /**  Option letter           **/
+  int            i;                     /**  Loop counter            **/
+
+  if ((runtime = getenv("XDG_RUNTIME_DIR")) != NULL && runtime[0] == '/')
+    snprintf(path, sizeof(path), "%s/antennavis.sock", runtime);
+  else
+    snprintf(path, sizeof(path), "/tmp/antennavis-%d.sock", (int) getuid());
+  socket_path = path;
+  workers = sysconf(_SC_NPROCESSORS_ONLN);
+  timeout = 0;
+  image_size = IMAGE_SIZE;
+  while ((opt = getopt(argc, argv, "s:j:t:i:")) != -1) {
+    switch (opt) {
+      case 's':  socket_path = optarg;       break;
+      case 'j':  workers = atoi(optarg);     break;
+      case 't':  timeout = atoi(optarg);     break;
+      case 'i':  image_size = atoi(optarg);  break;
+      default:
+        fprintf(stderr, "Usage: %s [-s socket] [-j workers] "
+                "[-t timeout] [-i image size]\n", argv[0]);
+        return 1;
+    }  /**  Options  **/
+  }  /**  For each option  **/
+
+  snprintf(WorkDir, sizeof(WorkDir), "/tmp/AntDaemon-XXXXXX");
+  if (mkdtemp(WorkDir) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }  /**  No scratch space  **/
+  if ((listener = Listen(socket_path)) < 0) {
+    perror(socket_path);
+    rmdir(WorkDir);
+    return 1;
+  }  /**  No socket  **/
+
+  /**  Workers first, before GL and the scene make the process big  **/
+  if (freopen("/dev/null", "w", stdout) == NULL || 
+      !SP_Init(workers, timeout)) {
+    fprintf(stderr, "AntDaemon: cannot start solver workers\n");
+    close(listener);
+    unlink(socket_path);
+    rmdir(WorkDir);
+    return 1;
+  }  /**  No workers  **/
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, OnSignal);
+  signal(SIGTERM, OnSignal);
+
+  /**  Same settings as the sliders in antenna.tcl start with  **/
+  InitDisplay();
+  SCALE_FACTOR = 15.0 / 5.0;
+  DEFAULT_BOOMHEIGHT = 30.0;
+  POINT_DIST_SCALE = 5.0;
+  POINT_SIZE_SCALE = 0.1;
+  ALPHA = 0.5;
+  MultipleAntMode = 0;
+  ShowRadPat = 1;
+  ShowPolSense = 0;
+  WP_Init(0);
+  HaveGL = OS_Open(image_size);
+  fprintf(stderr, "AntDaemon: %s, %d solvers, %s\n", socket_path, SP_Workers(),
+          HaveGL ? "images on" : "no offscreen GL, images off");
+
+  for (i = 0; i < MAX_CLIENTS; i++)
+    Clients[i].fd = -1;
+  while (!Quit) {
+    fds[0].fd = listener;
+    fds[0].events = POLLIN;
+    for (i = 0; i < MAX_CLIENTS; i++) {
+      fds[i + 1].fd = Clients[i].fd;
+      fds[i + 1].events = POLLIN;
+      fds[i + 1].revents = 0;
+    }  /**  For each client  **/
+    if (poll(fds, MAX_CLIENTS + 1, POLL_MS) < 0 && errno != EINTR)
+      break;
+
+    if (fds[0].revents & POLLIN) {
+      fd = accept(listener, NULL, NULL);
+      for (i = 0; fd >= 0 && i < MAX_CLIENTS; i++)
+        if (Clients[i].fd < 0) {
+          memset(&Clients[i], 0, sizeof(Client));
+          Clients[i].fd = fd;
+          break;
+        }  /**  Free slot  **/
+      if (fd >= 0 && i == MAX_CLIENTS) {
+        if (write(fd, "ERROR - busy\n", 13) < 0)
+          ;
+        close(fd);
+      }  /**  Full  **/
+    }  /**  New connection  **/
+
+    for (i = 0; i < MAX_CLIENTS; i++)
+      if (Clients[i].fd >= 0 && (fds[i + 1].revents & (POLLIN | POLLHUP)))
+        ReadClient(&Clients[i]);
+
+    Schedule();
+  }  /**  Until told to stop  **/
+
+  SP_Shutdown();
+  while (Jobs != NULL)
+    FreeJob(Jobs);
+  for (i = 0; i < MAX_CLIENTS; i++)
+    DropClient(&Clients[i]);
+  close(listener);
+  unlink(socket_path);
+  rmdir(WorkDir);
+  return 0;
+
+}  /**  End of main  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of AntDaemon.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -40,6 +40,15 @@
 #include "TkAntenna.h"
 #include "ParseArgs.h"
 #include "ant.h"
+#include "pcard.h"
+#include "Timing.h"
+#include "Session.h"
+#include "FieldAnalysis.h"
+#include "Ports.h"
+#include "SolverPool.h"
+#include "WireIndex.h"
+#include "Symmetry.h"
+#include "Convergence.h"
 
 
 /*****************************************************************************/
@@ -66,6 +75,13 @@
 #define LIGHTMAX            8    /**  Number of lights                      **/
 #define SLICES_INIT         24   /**  Disks and cylinders have many slices  **/
 #define RINGS_INIT          1    /**  Disks and cylinders have many rings   **/
+#define FRAME_RATE         30    /**  Most frames drawn per second          **/
+#define LAYER_GROUND        1    /**  Dirty bit for the ground disk         **/
+#define LAYER_WIRES         2    /**  Dirty bit for the antennas            **/
+#define LAYER_PATTERN       4    /**  Dirty bit for the radiation field     **/
+#define LAYER_ALL           7    /**  Every layer                           **/
+#define LAYER_COUNT         3    /**  Display lists, one per layer          **/
+#define MAX_TOUCHING       64    /**  Listed by touching_tubes              **/
 
 typedef void (GLAPIENTRY *callback_t)();
 #ifndef CALLBACK
@@ -88,6 +104,7 @@ extern double  STEP_SIZE;           /**  Degrees between control points   **/
 extern double  NULL_THRESHOLD;      /**  As a percentage of max dBi       **/
 extern double  NULL_DISTANCE;       /**  So null maps float above         **/
 extern double  ALPHA;               /**  Alpha transparency factor        **/
+extern double  LOD_PIXEL_ERROR;     /**  Mesh detail error, in pixels     **/
 extern int     WireDrawMode;        /**  Mode to draw the wires in        **/
 extern int     MultipleAntMode;     /**  Current antenna or all in phase  **/
 extern int     ShowRadPat;          /**  Do we show radiation pattern     **/
@@ -96,6 +113,12 @@ extern int     ShowPolTilt;         /**  Do we show polarization tilt?    **/
 extern int     ShowAxialRatio;      /**  Show axial ratios?               **/
 extern int     ShowNulls;           /**  Do we show nulls in pattern?     **/
 extern int     FreqSteps;           /**  Number of frequencies            **/
+extern double  ClusterSpacing;      /**  Wavelengths between clusters     **/
+extern double  SolverMemory;        /**  GB for nec2 runs, 0 no limit     **/
+extern int     UseSymmetry;         /**  Write GX and GR cards to nec2?   **/
+extern int     CheckDecks;          /**  Refuse decks DC_Check faults?    **/
+extern AntArray  TheAnts;           /**  The antennas' geometries         **/
+extern bool    AntennasInScene;     /**  Are there antennas yet?          **/
 
 
 /*****************************************************************************/
@@ -157,6 +180,12 @@ struct Antenna {
   GLint            Global_Rings;                  /**  Global rings      **/
   struct Material  material[SizeOfMaterialType];  /**  Materials         **/
   struct Light     light[LIGHTMAX];               /**  Lights            **/ 
+  GLuint           Layer_Lists;                   /**  Cached layers     **/
+  GLint            Layer_Dirty;                   /**  Layers to redraw  **/
+  Tcl_TimerToken   Frame_Timer;                   /**  Frame scheduled   **/
+  double           Frame_Last;                    /**  Last frame in ms  **/
+  bool             Timing_Overlay;                /**  Show the timers   **/
+  GLuint           Timing_Font;                   /**  Overlay font      **/
 };  /**  End of Antenna  **/
 
 
@@ -174,6 +203,12 @@ local void    TKA_Reshape(struct Togl *togl);
 local void    TKA_Rotate(GLfloat ax, GLfloat ay, GLfloat az);
 local GLfloat TKA_Angle(GLfloat size, GLfloat distance);
 local void    TKA_Disk(GLfloat radius, GLint slices, GLint rings);
+local double  TKA_Now(void);
+local void    TKA_Frame(ClientData data);
+local void    TKA_PostFrame(struct Togl *togl, GLint layers);
+local bool    TKA_BeginLayer(struct Antenna *antenna, GLint layer);
+local void    TKA_EndLayer(struct Antenna *antenna, GLint layer);
+local void    TKA_DrawTiming(struct Togl *togl, struct Antenna *antenna);
       void    CALLBACK TKA_ErrorCallback(GLenum errorCode);
       void    TKA_Cylinder(GLfloat radius,
                            GLfloat height,
@@ -197,14 +232,35 @@ local GLint   TKA_ControlTube(struct Togl *togl, GLint argc, CONST84 char **argv
 local GLint   TKA_ControlAnt(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_ChangeCurrentTube(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_ChangeCurrentAnt(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_PickTube(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_NearestTube(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_TouchingTubes(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_DrawRFPowerDensity(struct Togl  *togl, GLint   argc, CONST84 char **argv);
 local GLint   TKA_SaveFile(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_SavePattern(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_LoadPattern(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Analyze(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Sweep(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_FeedTable(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_FarField(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_SolvePorts(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Converge(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Ports(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Steer(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Threads(struct Togl *togl, GLint argc, CONST84 char **argv);
+local void    TKA_SolveProgress(int done, int running, int count, 
+                                double bytes, void *data);
+local void    TKA_WriteView(FILE *f, void *data);
+local void    TKA_ReadView(int argc, CONST84 char **argv, void *data);
+local GLint   TKA_SaveSession(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_RestoreSession(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_SaveRGBImage(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_MoveCenter(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_GetVariable(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_ChangeWireDrawMode(struct Togl  *togl, GLint argc, CONST84 char **argv);
 local GLint   TKA_ChangeAntMode(struct Togl *togl, GLint argc, CONST84 char **argv);
+local GLint   TKA_Timing(struct Togl *togl, GLint argc, CONST84 char **argv);
 
 
 /*****************************************************************************/
@@ -310,14 +366,35 @@ GLint TKA_Init(Tcl_Interp *interp) {
   Togl_CreateCommand("control_ant", TKA_ControlAnt);
   Togl_CreateCommand("change_current_tube", TKA_ChangeCurrentTube);
   Togl_CreateCommand("change_current_ant", TKA_ChangeCurrentAnt);
+  Togl_CreateCommand("pick_tube", TKA_PickTube);
+  Togl_CreateCommand("nearest_tube", TKA_NearestTube);
+  Togl_CreateCommand("touching_tubes", TKA_TouchingTubes);
   Togl_CreateCommand("draw_RFPowerDensity", TKA_DrawRFPowerDensity);
   Togl_CreateCommand("save_file", TKA_SaveFile);
+  Togl_CreateCommand("save_pattern", TKA_SavePattern);
+  Togl_CreateCommand("load_pattern", TKA_LoadPattern);
+  Togl_CreateCommand("analyze", TKA_Analyze);
+  Togl_CreateCommand("sweep", TKA_Sweep);
+  Togl_CreateCommand("feed_table", TKA_FeedTable);
+  Togl_CreateCommand("sweep_table", TKA_FeedTable);
+  Togl_CreateCommand("far_field", TKA_FarField);
+  Togl_CreateCommand("solve_ports", TKA_SolvePorts);
+  Togl_CreateCommand("converge", TKA_Converge);
+  Togl_CreateCommand("ports", TKA_Ports);
+  Togl_CreateCommand("steer", TKA_Steer);
+  Togl_CreateCommand("threads", TKA_Threads);
+  Togl_CreateCommand("save_session", TKA_SaveSession);
+  Togl_CreateCommand("restore_session", TKA_RestoreSession);
   Togl_CreateCommand("save_rgb_image", TKA_SaveRGBImage);
   Togl_CreateCommand("move_center", TKA_MoveCenter);
   Togl_CreateCommand("get_var", TKA_GetVariable);
   Togl_CreateCommand("change_mode", TKA_ChangeDrawMode);
   Togl_CreateCommand("change_wire_mode", TKA_ChangeWireDrawMode);
   Togl_CreateCommand("change_ant_mode", TKA_ChangeAntMode);
+  Togl_CreateCommand("timing", TKA_Timing);
+
+  /**  Solves report to the SolveProgress variable  **/
+  SP_SetProgress(TKA_SolveProgress, interp);
 
   return TCL_OK;
 
@@ -339,7 +416,10 @@ local void TKA_Display(struct Togl *togl) {
   struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data   **/
   GLint           s = antenna->Global_Slices;          /**  Slices         **/
   GLint           r = antenna->Global_Rings;           /**  Rings          **/
+  double          start;                               /**  Timer start    **/
 
+  start = TM_Start();
+  antenna->Frame_Last = TKA_Now();
   glClearColor(antenna->Global_Background[0], 
                antenna->Global_Background[1],
                antenna->Global_Background[2], 
@@ -362,17 +442,225 @@ local void TKA_Display(struct Togl *togl) {
 
   /**  Ground plane  **/
   glTranslatef(Center.x, Center.y, Center.z);
-  TKA_SetMaterial(&(antenna->material[Gplane]));
+  SavePickView();
+  if (TKA_BeginLayer(antenna, LAYER_GROUND)) {
+    TKA_SetMaterial(&(antenna->material[Gplane]));
+    glPushMatrix();
+    TKA_Rotate(-90.0, 0.0, 0.0); 
+    TKA_Disk(GPLANE_RADIUS, s, r);
+    glPopMatrix(); 
+    TKA_EndLayer(antenna, LAYER_GROUND);
+  }  /**  Ground changed  **/
+
+  if (TKA_BeginLayer(antenna, LAYER_WIRES)) {
+    DisplayAntWires(s, r);
+    TKA_EndLayer(antenna, LAYER_WIRES);
+  }  /**  Antennas changed  **/
+
+  if (TKA_BeginLayer(antenna, LAYER_PATTERN)) {
+    DisplayAntField();
+    TKA_EndLayer(antenna, LAYER_PATTERN);
+  }  /**  Field changed  **/
+
+  TM_Stop(TM_DISPLAY, start);
+  if (antenna->Timing_Overlay)
+    TKA_DrawTiming(togl, antenna);
+  Togl_SwapBuffers(togl);
+
+}  /**  End of Display  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                   Now                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double TKA_Now(void) {
+
+  Tcl_Time  now;  /**  Wall clock  **/
+
+  Tcl_GetTime(&now);
+  return now.sec * 1000.0 + now.usec / 1000.0;
+
+}  /**  End of Now  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Frame                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_Frame(ClientData data) {
+
+  struct Togl    *togl = (struct Togl *) data;         /**  Widget        **/
+  struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data  **/
+
+  antenna->Frame_Timer = NULL;
+  Togl_PostRedisplay(togl);
+
+}  /**  End of Frame  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PostFrame                                **/
+/**                                                                         **/
+/**  Asks for a new frame after the given layers changed.  Tk sliders and   **/
+/**  drags call the widget commands far more often than a frame can be      **/
+/**  drawn, so requests are coalesced: the layers are only marked dirty,    **/
+/**  and at most one redisplay is posted per 1/FRAME_RATE of a second.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_PostFrame(struct Togl *togl, GLint layers) {
+
+  struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data  **/
+  double          wait;                                /**  Milliseconds  **/
+
+  antenna->Layer_Dirty |= layers;
+  if (antenna->Frame_Timer != NULL)
+    return;
+
+  wait = 1000.0 / FRAME_RATE - (TKA_Now() - antenna->Frame_Last);
+  if (wait < 0.0)
+    wait = 0.0;
+  antenna->Frame_Timer = Tcl_CreateTimerHandler((int) wait, TKA_Frame,
+                                                (ClientData) togl);
+
+}  /**  End of PostFrame  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                BeginLayer                               **/
+/**                                                                         **/
+/**  Every layer of the scene is kept in a display list.  A clean layer is  **/
+/**  replayed from its list and false is returned; a dirty one is recorded  **/
+/**  while being drawn (so the level of detail of the field is chosen with  **/
+/**  the matrices in effect) and true tells the caller to draw it, then     **/
+/**  call TKA_EndLayer.  Without display lists everything is simply drawn.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool TKA_BeginLayer(struct Antenna *antenna, GLint layer) {
+
+  GLuint  list;  /**  Display list of the layer  **/
+
+  if (antenna->Layer_Lists == 0) {
+    antenna->Layer_Lists = glGenLists(LAYER_COUNT);
+    antenna->Layer_Dirty = LAYER_ALL;
+  }  /**  First frame  **/
+  if (antenna->Layer_Lists == 0)
+    return true;
+
+  list = antenna->Layer_Lists + (layer == LAYER_GROUND ? 0 : 
+                                 layer == LAYER_WIRES ? 1 : 2);
+  if ((antenna->Layer_Dirty & layer) == 0) {
+    glCallList(list);
+    return false;
+  }  /**  Still valid  **/
+
+  glNewList(list, GL_COMPILE_AND_EXECUTE);
+  return true;
+
+}  /**  End of BeginLayer  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 EndLayer                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_EndLayer(struct Antenna *antenna, GLint layer) {
+
+  if (antenna->Layer_Lists != 0) {
+    glEndList();
+    antenna->Layer_Dirty &= ~layer;
+  }  /**  Layer recorded  **/
+
+}  /**  End of EndLayer  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                DrawTiming                               **/
+/**                                                                         **/
+/**  Writes the timer percentiles over the top left corner of the scene.    **/
+/**  The display timer is stopped before this, so the overlay does not      **/
+/**  count itself.                                                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_DrawTiming(struct Togl *togl, struct Antenna *antenna) {
+
+  TM_Summary  summary;    /**  One timer          **/
+  char        line[80];   /**  Text of one line   **/
+  GLint       h;          /**  Window height      **/
+  GLint       y;          /**  Baseline of line   **/
+  int         i;          /**  Loop counter       **/
+
+  if (antenna->Timing_Font == 0)
+    antenna->Timing_Font = Togl_LoadBitmapFont(togl, TOGL_BITMAP_8_BY_13);
+  if (antenna->Timing_Font == 0)
+    return;
+
+  h = Togl_Height(togl);
+  glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LIST_BIT);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_DEPTH_TEST);
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glOrtho(0.0, Togl_Width(togl), 0.0, h, -1.0, 1.0);
+  glMatrixMode(GL_MODELVIEW);
   glPushMatrix();
-  TKA_Rotate(-90.0, 0.0, 0.0); 
-  TKA_Disk(GPLANE_RADIUS, s, r);
-  glPopMatrix(); 
+  glLoadIdentity();
 
-  DisplayAnt(s, r);
+  glColor3f(0.9, 0.9, 0.5);
+  glListBase(antenna->Timing_Font);
+  y = h - 16;
+  sprintf(line, "%-14s %7s %8s %8s %8s", "ms", "count", "p50", "p95", "max");
+  glRasterPos2i(8, y);
+  glCallLists(strlen(line), GL_UNSIGNED_BYTE, line);
+  for (i = 0; i < TM_COUNT; i++) {
+    TM_Summarize(i, &summary);
+    if (summary.count == 0)
+      continue;
+    y -= 15;
+    sprintf(line, "%-14s %7ld %8.2f %8.2f %8.2f", TM_Name(i), 
+            summary.count, summary.p50, summary.p95, summary.max);
+    glRasterPos2i(8, y);
+    glCallLists(strlen(line), GL_UNSIGNED_BYTE, line);
+  }  /**  For each timer  **/
 
-  Togl_SwapBuffers(togl);
+  glPopMatrix();
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+  glMatrixMode(GL_MODELVIEW);
+  glPopAttrib();
 
-}  /**  End of Display  **/
+}  /**  End of DrawTiming  **/
 
 
 /*****************************************************************************/
@@ -390,6 +678,7 @@ local void TKA_Reshape(struct Togl *togl) {
   GLint         w = Togl_Width(togl);                  /**  Width window  **/
   GLint         h = Togl_Height(togl);                 /**  Width height  **/
 
+  antenna->Layer_Dirty |= LAYER_PATTERN;
   glViewport(0,0,(GLsizei)w,(GLsizei)h);
   glMatrixMode(GL_PROJECTION);
   glLoadIdentity();
@@ -631,6 +920,7 @@ local void TKA_Create(struct Togl *togl) {
                  antenna->Eye_Distance_Max );
   }  /**  For each light  **/
 
+  antenna->Layer_Dirty = LAYER_ALL;
   Togl_SetClientData(togl, antenna);
 
   /**  Initialize openGL environment  **/
@@ -654,6 +944,12 @@ local void TKA_Destroy(struct Togl *togl) {
   struct  Antenna *antenna;  /**  The antenna  **/
   
   antenna = Togl_GetClientData(togl);
+  if (antenna->Frame_Timer != NULL)
+    Tcl_DeleteTimerHandler(antenna->Frame_Timer);
+  if (antenna->Layer_Lists != 0)
+    glDeleteLists(antenna->Layer_Lists, LAYER_COUNT);
+  if (antenna->Timing_Font != 0)
+    Togl_UnloadBitmapFont(togl, antenna->Timing_Font);
   free(antenna);
   Togl_SetClientData(togl, NULL);  
 
@@ -672,7 +968,7 @@ local void TKA_Destroy(struct Togl *togl) {
 local GLint TKA_Reset(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
   TKA_Create(togl);
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_ALL);
 
   if(argc > 2) {
     Tcl_SetResult(Togl_Interp(togl),
@@ -698,11 +994,13 @@ local GLint TKA_Eye(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
   struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data  **/
   GLint           result;                              /**  Result        **/
+  GLfloat         distance;                            /**  Eye before    **/
 
+  distance = antenna->Eye_Distance;
   result = PA_ParseArgs(Togl_Interp(togl), argc-2, argv+2, CfgEye, antenna);
 
   if(result == PA_CHANGED) {
-    Togl_PostRedisplay(togl);
+    TKA_PostFrame(togl, distance == antenna->Eye_Distance ? 0 : LAYER_PATTERN);
     result = TCL_OK;
   }  /**  Result  **/
 
@@ -724,10 +1022,12 @@ local GLint TKA_AddElement(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
   struct Antenna *antenna = Togl_GetClientData(togl);  /**  Set up antenna  **/
   GLint           result;                              /**  Result          **/
+  GLfloat         distance;                            /**  Eye before      **/
 
+  distance = antenna->Eye_Distance;
   result = PA_ParseArgs(Togl_Interp(togl), argc-2, argv+2, CfgEye, antenna);
   if(result == PA_CHANGED) {
-    Togl_PostRedisplay(togl);
+    TKA_PostFrame(togl, distance == antenna->Eye_Distance ? 0 : LAYER_PATTERN);
     result = TCL_OK;
   }  /**  If changed  **/
 
@@ -763,7 +1063,7 @@ local GLint TKA_StdAnt(struct Togl *togl, GLint argc, CONST84 char **argv) {
     AddWall();
   }  /**  Add a wall  **/
 
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
   antennaChanged = true;
 
@@ -789,7 +1089,7 @@ local GLint TKA_LoadAnt(struct Togl *togl, GLint argc, CONST84 char **argv) {
   fprintf(stderr, "File Name = %s\n", argv[2]);
   ReadFile(argv[2]);
 
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
   antennaChanged = true;
 
@@ -813,7 +1113,7 @@ local GLint TKA_DeleteAnt(struct Togl *togl, GLint argc, char CONST84 **argv) {
 
   DeleteCurrentAnt();
 
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
   antennaChanged = true;
 
@@ -846,7 +1146,7 @@ local GLint TKA_ControlAnt(struct Togl *togl, GLint argc, CONST84 char **argv) {
     else if(func == 3)
       MoveCurrentAnt(0, atof(argv[3])/20, 0);
   }  /**  Moving tubes around  **/
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
   antennaChanged = true;
 
@@ -912,7 +1212,7 @@ local GLint TKA_ControlTube(struct Togl *togl, GLint argc, CONST84 char **argv)
 
   }  /**  Moving tubes around  **/
 
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
   antennaChanged = true;
 
@@ -936,7 +1236,7 @@ local GLint TKA_ChangeCurrentAnt(struct Togl *togl, GLint argc, CONST84 char **a
   if(argc >= 3) {
     ChangeCurrentAnt(atoi(argv[2]));
   }  /**  Change the tube  **/
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
 
   return result;
@@ -959,7 +1259,7 @@ local GLint TKA_ChangeCurrentTube(struct Togl *togl, GLint argc, CONST84 char **
   if(argc >= 3) {
     ChangeCurrentTube(atoi(argv[2]));
   }  /**  Change the tube  **/
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
 
   return result;
@@ -967,6 +1267,110 @@ local GLint TKA_ChangeCurrentTube(struct Togl *togl, GLint argc, CONST84 char **
 }  /**  End of ChangeCurrentTube  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PickTube                                 **/
+/**                                                                         **/
+/**  pick_tube x y: makes the element under the mouse current, returning   **/
+/**  its place in its antenna from 1, or 0 if there is none there.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_PickTube(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  char         text[16];                    /**  The element     **/
+  int          picked;                      /**  Its place       **/
+
+  if (argc != 4) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName pick_tube "
+                  "x y\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  Error state  **/
+
+  if ((picked = PickTube(atoi(argv[2]), atoi(argv[3]))) > 0)
+    TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
+  sprintf(text, "%d", picked);
+  Tcl_SetResult(interp, text, TCL_VOLATILE);
+  return TCL_OK;
+
+}  /**  End of PickTube  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               NearestTube                               **/
+/**                                                                         **/
+/**  nearest_tube x y z: the element nearest a point in deck units, as     **/
+/**  "antenna element distance", both counted from 1.  Empty if there are  **/
+/**  no elements.                                                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_NearestTube(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  WI_Hit       hit;                         /**  The nearest     **/
+  double       p[3];                        /**  The point       **/
+  char         text[64];                    /**  As a result     **/
+  int          i;                           /**  Loop counter    **/
+
+  if (argc != 5) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName nearest_tube "
+                  "x y z\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  Error state  **/
+
+  for (i = 0; i < 3; i++)
+    p[i] = atof(argv[i + 2]) / 100.0;
+  if (AntennasInScene && WI_Nearest(-1, p, &hit)) {
+    sprintf(text, "%d %d %.6g", hit.ant + 1, hit.index, hit.distance * 100.0);
+    Tcl_SetResult(interp, text, TCL_VOLATILE);
+  }  /**  Found one  **/
+  return TCL_OK;
+
+}  /**  End of NearestTube  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              TouchingTubes                              **/
+/**                                                                         **/
+/**  touching_tubes: the elements the current one runs into other than at   **/
+/**  segment ends, as a list of "antenna element", both counted from 1.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_TouchingTubes(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  WI_Hit       hits[MAX_TOUCHING];          /**  What it touches **/
+  char         row[32];                     /**  One of them     **/
+  int          n;                           /**  How many        **/
+  int          i;                           /**  Loop counter    **/
+
+  if (AntennasInScene == false)
+    return TCL_OK;
+  n = WI_Touching(TheAnts.ants[TheAnts.curr_ant].current_tube, hits, 
+                  MAX_TOUCHING);
+  for (i = 0; i < n && i < MAX_TOUCHING; i++) {
+    sprintf(row, "%d %d", hits[i].ant + 1, hits[i].index);
+    Tcl_AppendElement(interp, row);
+  }  /**  Each one  **/
+  return TCL_OK;
+
+}  /**  End of TouchingTubes  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
@@ -978,8 +1382,10 @@ local GLint TKA_ChangeCurrentTube(struct Togl *togl, GLint argc, CONST84 char **
 
 local GLint TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
-  GLint  result;  /**  Result  **/
+  GLint  result;  /**  Result          **/
+  GLint  layers;  /**  Layers changed  **/
 
+  layers = LAYER_PATTERN;
 
   if (strcmp(argv[2],"DrawMode") == 0) {
     if (strcmp(argv[3],"Dots") == 0) {
@@ -997,15 +1403,16 @@ local GLint TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **arg
 
   else if(strcmp(argv[2], "Scale") == 0) {
     SCALE_FACTOR = 15.0/atof(argv[3]);
+    layers |= LAYER_WIRES;
   }  /**  Antenna scale  **/
 
   else if(strcmp(argv[2], "StepSize") == 0) {
-    antennaChanged = true;
     STEP_SIZE = atof(argv[3]);
-  }  /**  Step size  **/
+  }  /**  Step size, ComputeField resamples  **/
 
   else if(strcmp(argv[2], "DBHeight") == 0) {
     DEFAULT_BOOMHEIGHT = atof(argv[3]);
+    layers |= LAYER_WIRES;
   }  /**  Default boom height  **/
 
   else if(strcmp(argv[2], "PDScale") == 0) {
@@ -1024,6 +1431,10 @@ local GLint TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **arg
     ALPHA = atof(argv[3])/10.0;
   }  /**  Alpha value  **/
 
+  else if(strcmp(argv[2], "LODError") == 0) {
+    LOD_PIXEL_ERROR = atof(argv[3]);
+  }  /**  Pattern mesh detail, 0 draws every sample  **/
+
   else if(strcmp(argv[2], "Freq") == 0) {
     ChangeFrequency(atof(argv[3]));
     antennaChanged = true;
@@ -1033,6 +1444,24 @@ local GLint TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **arg
     FreqSteps = atoi(argv[3]) ;
   }  /**  Frequency  **/
 
+  else if(strcmp(argv[2], "ClusterSpacing") == 0) {
+    ClusterSpacing = atof(argv[3]);
+    antennaChanged = true;
+  }  /**  Antennas further apart are solved apart  **/
+
+  else if(strcmp(argv[2], "SolverMemory") == 0) {
+    SolverMemory = atof(argv[3]);
+  }  /**  Memory nec2 runs may take at once, in GB  **/
+
+  else if(strcmp(argv[2], "Symmetry") == 0) {
+    UseSymmetry = atoi(argv[3]);
+    antennaChanged = true;
+  }  /**  Let nec2 solve symmetric structures by their pieces  **/
+
+  else if(strcmp(argv[2], "CheckDecks") == 0) {
+    CheckDecks = atoi(argv[3]);
+  }  /**  Refuse decks with segmentation errors before nec2  **/
+
   else if(strcmp(argv[2], "ShowRadPat") == 0) {
     ShowRadPat = atoi(argv[3]);
   }  /**  Radiation pattern checkbox  **/
@@ -1053,7 +1482,7 @@ local GLint TKA_ChangeDrawMode(struct Togl *togl, GLint argc, CONST84 char **arg
     ShowNulls = atoi(argv[3]);
   }  /**  Nulls in pattern checkbox  **/
   
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, layers);
   result = TCL_OK;
 
   return result;
@@ -1086,7 +1515,7 @@ local GLint TKA_ChangeWireDrawMode(struct Togl *togl, GLint argc, CONST84 char *
     WireDrawMode = atoi(argv[3]);
   }  /**  No wire visualization  **/
   
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES);
   result = TCL_OK;
 
   return result;
@@ -1116,7 +1545,7 @@ local GLint TKA_ChangeAntMode(struct Togl *togl, GLint argc, CONST84 char **argv
     MultipleAntMode = atoi(argv[3]);
   }  /**  All antennas  **/
   
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
   result = TCL_OK;
 
   return result;
@@ -1125,6 +1554,58 @@ local GLint TKA_ChangeAntMode(struct Togl *togl, GLint argc, CONST84 char **argv
 
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Timing                                 **/
+/**                                                                         **/
+/**  With no arguments returns one element per timer: its name, the number  **/
+/**  of samples, and the median, 95th percentile and maximum in             **/
+/**  milliseconds over the recent samples.  "timing reset" clears the       **/
+/**  timers and "timing overlay 0|1" hides or shows them on the scene.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Timing(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data  **/
+  TM_Summary      summary;                             /**  One timer     **/
+  char            item[128];                           /**  One element   **/
+  int             i;                                   /**  Loop counter  **/
+
+  if (argc == 2) {
+    for (i = 0; i < TM_COUNT; i++) {
+      TM_Summarize(i, &summary);
+      sprintf(item, "%s %ld %.3f %.3f %.3f", TM_Name(i), summary.count, 
+              summary.p50, summary.p95, summary.max);
+      Tcl_AppendElement(Togl_Interp(togl), item);
+    }  /**  For each timer  **/
+    return TCL_OK;
+  }  /**  Report  **/
+
+  if (strcmp(argv[2], "reset") == 0) {
+    TM_Reset();
+  }  /**  Start over  **/
+
+  else if (strcmp(argv[2], "overlay") == 0 && argc >= 4) {
+    antenna->Timing_Overlay = atoi(argv[3]) != 0;
+  }  /**  Overlay on or off  **/
+
+  else {
+    Tcl_SetResult(Togl_Interp(togl),
+      "TKA_Timing ERROR: Use timing, timing reset or timing overlay 0|1!",
+      TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  Bad option  **/
+
+  TKA_PostFrame(togl, 0);
+  return TCL_OK;
+
+}  /**  End of Timing  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
@@ -1138,13 +1619,17 @@ local GLint TKA_DrawRFPowerDensity(struct Togl *togl, GLint argc, CONST84 char *
 
   GLint   result;  /**  Result   **/
 
+  result = TCL_OK;
   if(argc >= 2) {
-    ComputeField(antennaChanged);
-    if (antennaChanged == true)
+    if (ComputeField(antennaChanged) == false) {
+      Tcl_SetResult(Togl_Interp(togl),
+        "No field computed, see the terminal for why", TCL_STATIC);
+      result = TCL_ERROR;
+    }  /**  End of error  **/
+    else if (antennaChanged == true)
       antennaChanged=false;
   }  /**  Draw the field  **/
-  Togl_PostRedisplay(togl);
-  result = TCL_OK;
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
 
   return result;
 
@@ -1167,16 +1652,16 @@ local GLint TKA_SaveFile(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
   if(argc >= 2) {
     if (argc >= 3)
-      GenerateNECFile(argv[2]);
+      SY_Free(GenerateNECFile(argv[2]));
     else
     {
       printf("Enter name of file:");
       scanf("%s", file_name);
-      GenerateNECFile(file_name);
+      SY_Free(GenerateNECFile(file_name));
     }
     
   }  /**  Generate file  **/
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, 0);
   result = TCL_OK;
 
   return result;
@@ -1187,92 +1672,734 @@ local GLint TKA_SaveFile(struct Togl *togl, GLint argc, CONST84 char **argv) {
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
-/**                                SaveRGBImage                             **/
+/**                                SavePattern                              **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-local GLint TKA_SaveRGBImage(struct Togl *togl, GLint argc, CONST84 char **argv) {
-
-  char    file_name[255];  /**  File name  **/
-  GLint   result;          /**  Result     **/
-
-  if(argc >= 2) {
-    if (argc >= 3)
-      Togl_DumpToEpsFile(togl,argv[2],2,(void *)TKA_Display);
-    else {
-      printf("Enter name of file:");
-      scanf("%s", file_name);
-      Togl_DumpToEpsFile(togl,file_name,2,(void *)TKA_Display);
-    }  /**  Generate image  **/
-  }  /**  Args  **/
-
-  Togl_PostRedisplay(togl);
-  result = TCL_OK;
+local GLint TKA_SavePattern(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
-  return result;
+  if (argc != 3) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Usage: save_pattern file", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  if (!SavePattern(argv[2])) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "No pattern saved", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
 
-}  /**  End of SaveRGBImage  **/
+  return TCL_OK;
 
+}  /**  End of SavePattern  **/
 
 
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
-/**                                MoveCenter                             **/
+/**                                LoadPattern                              **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-local GLint TKA_MoveCenter(struct Togl *togl, GLint argc, CONST84 char **argv) {
-  struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data   **/
-  GLint   result;          /**  Result     **/
-  double dist, elevation, azimuth;
+local GLint TKA_LoadPattern(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
-  if(argc >= 2) {
-    if(argc >= 4) {
-      dist =  -(antenna->Eye_Distance *
-               (antenna->Eye_Distance_Max - antenna->Eye_Distance_Min)
-               + antenna->Eye_Distance_Min);
-      elevation = antenna->Eye_Latitude;
-      azimuth = antenna->Eye_Longitude;
-      DoMoveCenter(atof(argv[2]), atof(argv[3]), azimuth, elevation, dist);
-    }
-  }  /**  Args  **/
+  if (argc != 3) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Usage: load_pattern file", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  if (!LoadPattern(argv[2])) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "No pattern loaded", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
 
-  Togl_PostRedisplay(togl);
-  result = TCL_OK;
+  /**  The loaded field stands until the antenna is edited again  **/
+  antennaChanged = false;
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
 
-  return result;
+  return TCL_OK;
 
-}  /**  End of SaveRGBImage  **/
+}  /**  End of LoadPattern  **/
 
 
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
-/**                                 GetVariable                             **/
+/**                              AppendFigure                               **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-local GLint TKA_GetVariable(struct Togl *togl, GLint argc, CONST84 char **argv) {
+local void TKA_AppendFigure(Tcl_Interp *interp, const char *name, 
+                            double value) {
 
-  GLint   result;          /**  Result     **/
+  char  item[64];  /**  The value  **/
 
-  if(argc >= 2) {
-    #if 0
-    if(strcmp(argv[2], "SCALE_FACTOR") == 0)
+  sprintf(item, "%.6g", value);
+  Tcl_AppendElement(interp, name);
+  Tcl_AppendElement(interp, item);
+
+}  /**  End of AppendFigure  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Analyze                                 **/
+/**                                                                         **/
+/**  Figures of merit of the current field as a name value list, so a      **/
+/**  script can "array set" it; -999.99 marks a figure the pattern does     **/
+/**  not define, such as the beamwidth of an omni.                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Analyze(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  FA_Result    r;                           /**  The figures     **/
+
+  if (!AnalyzePattern(&r)) {
+    Tcl_SetResult(interp, "No field computed", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  TKA_AppendFigure(interp, "gain", r.peak_gain);
+  TKA_AppendFigure(interp, "theta", r.peak_theta);
+  TKA_AppendFigure(interp, "phi", r.peak_phi);
+  TKA_AppendFigure(interp, "directivity", r.directivity);
+  TKA_AppendFigure(interp, "efficiency", r.efficiency);
+  TKA_AppendFigure(interp, "radiated", r.radiated);
+  TKA_AppendFigure(interp, "front_to_back", r.front_to_back);
+  TKA_AppendFigure(interp, "front_to_rear", r.front_to_rear);
+  TKA_AppendFigure(interp, "beamwidth_az", r.beamwidth_az);
+  TKA_AppendFigure(interp, "beamwidth_el", r.beamwidth_el);
+  TKA_AppendFigure(interp, "sidelobe_az", r.sidelobe_az);
+  TKA_AppendFigure(interp, "sidelobe_el", r.sidelobe_el);
+
+  return TCL_OK;
+
+}  /**  End of Analyze  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Sweep                                  **/
+/**                                                                         **/
+/**  Solves the current antenna for its input impedance at FreqSteps        **/
+/**  frequencies between start and stop MHz, 5% either side of its          **/
+/**  frequency when they are left out.                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Sweep(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For errors  **/
+  double       start;                       /**  MHz         **/
+  double       stop;                        /**  MHz         **/
+
+  start = stop = 0;
+  if (argc == 4) {
+    start = atof(argv[2]);
+    stop = atof(argv[3]);
+  } else if (argc != 2) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName sweep "
+                  "?start stop?\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of usage  **/
+
+  if (!ComputeSweep(start, stop)) {
+    Tcl_SetResult(interp, "Sweep failed", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  return TCL_OK;
+
+}  /**  End of Sweep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FeedTable                                **/
+/**                                                                         **/
+/**  The current antenna's input parameters as a list of rows, each         **/
+/**  {MHz tag segment R X SWR watts}, with SWR against z0 ohms, 50 when     **/
+/**  left out.  Those of its last solve as feed_table, of its last sweep    **/
+/**  as sweep_table.                                                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_FeedTable(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  FeedTable   *table;                       /**  Rows            **/
+  double       z0;                          /**  Line impedance  **/
+  char         row[160];                    /**  One row         **/
+  int          i;                           /**  Row index       **/
+
+  z0 = (argc > 2) ? atof(argv[2]) : 50.0;
+  if (z0 <= 0) {
+    Tcl_SetResult(interp, "Line impedance must be positive", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  if (strcmp(argv[1], "sweep_table") == 0)
+    table = CurrentSweepTable();
+  else
+    table = CurrentFeedTable();
+  if (table == NULL)
+    return TCL_OK;
+
+  for (i = 0; i < table->count; i++) {
+    sprintf(row, "%.6g %d %d %.6g %.6g %.4g %.6g", table->frequency[i],
+            table->tag[i], table->segment[i], table->resistance[i],
+            table->reactance[i],
+            FeedSWR(table->resistance[i], table->reactance[i], z0),
+            table->power[i]);
+    Tcl_AppendElement(interp, row);
+  }  /**  Every row  **/
+
+  return TCL_OK;
+
+}  /**  End of FeedTable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FarField                                 **/
+/**                                                                         **/
+/**  far_field theta0 theta1 phi0 phi1 step: the current antenna's gain     **/
+/**  over that window from its segment currents, with no nec2 run, as a     **/
+/**  list of {theta phi vert hor total} in dBi.  For a close look at a      **/
+/**  lobe at finer steps than the displayed pattern.                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_FarField(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result   **/
+  FieldData    fd;                          /**  The window       **/
+  double       theta0;                      /**  Degrees          **/
+  double       theta1;
+  double       phi0;
+  double       phi1;
+  double       step;
+  int          thetas;                      /**  Samples          **/
+  int          phis;
+  char         row[160];                    /**  One sample       **/
+  int          i;                           /**  Loop counter     **/
+
+  if (argc != 7) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName far_field "
+                  "theta0 theta1 phi0 phi1 step\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of usage  **/
+  theta0 = atof(argv[2]);
+  theta1 = atof(argv[3]);
+  phi0 = atof(argv[4]);
+  phi1 = atof(argv[5]);
+  step = atof(argv[6]);
+  if (step <= 0 || theta1 < theta0 || phi1 < phi0) {
+    Tcl_SetResult(interp, "Empty window", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  thetas = (int) ((theta1 - theta0) / step + 1e-6) + 1;
+  phis = (int) ((phi1 - phi0) / step + 1e-6) + 1;
+
+  memset(&fd, 0, sizeof(fd));
+  if (!SampleFarField(theta0, phi0, step, thetas, phis, &fd)) {
+    free(fd.vals);
+    Tcl_SetResult(interp, "No segment currents, or too many samples",
+                  TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  for (i = 0; i < fd.count; i++) {
+    sprintf(row, "%.4f %.4f %.2f %.2f %.2f", fd.vals[i].theta, 
+            fd.vals[i].phi, fd.vals[i].vert_gain, fd.vals[i].hor_gain,
+            fd.vals[i].total_gain);
+    Tcl_AppendElement(interp, row);
+  }  /**  Every sample  **/
+  free(fd.vals);
+
+  return TCL_OK;
+
+}  /**  End of FarField  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SolvePorts                                **/
+/**                                                                         **/
+/**  Solves the current antenna once per voltage source so steer can        **/
+/**  drive them without nec2.  Returns the number of sources.               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_SolvePorts(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  char         count[16];                   /**  Ports solved    **/
+  int          ports;                       /**    ..as a number **/
+
+  if ((ports = SolvePorts()) == 0) {
+    Tcl_SetResult(interp, "No ports solved, see the terminal for why",
+                  TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  antennaChanged = false;
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
+
+  sprintf(count, "%d", ports);
+  Tcl_SetResult(interp, count, TCL_VOLATILE);
+  return TCL_OK;
+
+}  /**  End of SolvePorts  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Converge                                 **/
+/**                                                                         **/
+/**  converge: solves the current antenna at several segment densities      **/
+/**  together and returns one row per density solved, coarsest first,      **/
+/**  {factor segments gain_dB_off impedance_off pattern_dB_off within best  **/
+/**  deck}, the errors against the finest.  converge apply: gives the       **/
+/**  antenna the best density of that study and returns its segments.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Converge(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp       *interp = Togl_Interp(togl);  /**  For the result  **/
+  const CV_Study   *study;                       /**  Densities       **/
+  const CV_Level   *l;                           /**  Current one     **/
+  char              row[128];                    /**  One density     **/
+  int               segments;                    /**  Applied         **/
+  int               k;                           /**  Loop counter    **/
+
+  if (argc > 2 && strcmp(argv[2], "apply") == 0) {
+    if (antennaChanged || (segments = ApplySegmentation()) == 0) {
+      Tcl_SetResult(interp, "No segmentation to apply, use converge",
+                    TCL_STATIC);
+      return TCL_ERROR;
+    }  /**  End of error  **/
+    antennaChanged = true;
+    TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
+    sprintf(row, "%d", segments);
+    Tcl_SetResult(interp, row, TCL_VOLATILE);
+    return TCL_OK;
+  }  /**  Apply the last study  **/
+
+  if ((study = StudySegmentation()) == NULL) {
+    Tcl_SetResult(interp, "No segmentation study, see the terminal for why",
+                  TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  antennaChanged = false;
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
+
+  for (k = 0; k < study->levels; k++) {
+    l = &study->level[k];
+    if (!l->solved)
+      continue;
+    sprintf(row, "%.3g %d %.4f %.5f %.4f %d %d %d", l->factor, l->segments,
+            l->gain_error, l->impedance_error, l->pattern_error, 
+            l->within ? 1 : 0, (k == study->best) ? 1 : 0,
+            (k == study->original) ? 1 : 0);
+    Tcl_AppendElement(interp, row);
+  }  /**  Every density solved  **/
+
+  return TCL_OK;
+
+}  /**  End of Converge  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Ports                                  **/
+/**                                                                         **/
+/**  The solved ports of the current antenna as a list of rows, each        **/
+/**  {tag segment volts degrees} with the drive steer last gave it.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Ports(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  PT_Set      *set;                         /**  The ports       **/
+  char         row[96];                     /**  One port        **/
+  int          p;                           /**  Port index      **/
+
+  if ((set = CurrentPorts()) == NULL)
+    return TCL_OK;
+
+  for (p = 0; p < set->ports; p++) {
+    sprintf(row, "%d %d %.6g %.6g", set->tag[p], set->segment[p],
+            set->amplitude[p], set->phase[p]);
+    Tcl_AppendElement(interp, row);
+  }  /**  Every port  **/
+
+  return TCL_OK;
+
+}  /**  End of Ports  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Steer                                  **/
+/**                                                                         **/
+/**  steer volts0 degrees0 ?volts1 degrees1 ...?: drives the solved ports   **/
+/**  in order and redraws the field they superpose to.  Needs solve_ports   **/
+/**  since the antenna last changed.                                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Steer(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For errors      **/
+  double       amplitude[PT_MAX_PORTS];     /**  Volts           **/
+  double       phase[PT_MAX_PORTS];         /**  Degrees         **/
+  int          n;                           /**  Ports given     **/
+  int          p;                           /**  Loop counter    **/
+
+  if (argc < 4 || (argc % 2) != 0) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName steer "
+                  "volts degrees ?volts degrees ...?\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of usage  **/
+  if (antennaChanged || CurrentPorts() == NULL) {
+    Tcl_SetResult(interp, "Ports not solved, use solve_ports", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  n = (argc - 2) / 2;
+  if (n > PT_MAX_PORTS)
+    n = PT_MAX_PORTS;
+  for (p = 0; p < n; p++) {
+    amplitude[p] = atof(argv[2 + 2 * p]);
+    phase[p] = atof(argv[3 + 2 * p]);
+    if (amplitude[p] < 0) {
+      Tcl_SetResult(interp, "Amplitudes must not be negative", TCL_STATIC);
+      return TCL_ERROR;
+    }  /**  End of error  **/
+  }  /**  Every port given  **/
+
+  if (!SteerPorts(n, amplitude, phase)) {
+    Tcl_SetResult(interp, "No power into the ports", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  TKA_PostFrame(togl, LAYER_WIRES | LAYER_PATTERN);
+
+  return TCL_OK;
+
+}  /**  End of Steer  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Threads                                 **/
+/**                                                                         **/
+/**  threads ?n?: the number of cores solves and pattern work are split     **/
+/**  over, after setting it to n first (0 for one per CPU).                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_Threads(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  Tcl_Interp  *interp = Togl_Interp(togl);  /**  For the result  **/
+  char         count[16];                   /**  Threads         **/
+
+  if (argc > 3) {
+    Tcl_SetResult(interp, "wrong # args: should be \"pathName threads "
+                  "?n?\"", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of usage  **/
+  if (argc == 3 && !SetThreads(atoi(argv[2]))) {
+    Tcl_SetResult(interp, "A solve is running", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  sprintf(count, "%d", SP_Workers());
+  Tcl_SetResult(interp, count, TCL_VOLATILE);
+  return TCL_OK;
+
+}  /**  End of Threads  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SolveProgress                              **/
+/**                                                                         **/
+/**  Called by the solver pool while decks run.  Sets SolveProgress and     **/
+/**  lets Tk redraw whatever shows it; only idle events are run, so no      **/
+/**  button can start another solve meanwhile.                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_SolveProgress(int done, int running, int count, double bytes, 
+                             void *data) {
+
+  Tcl_Interp  *interp = data;  /**  Where the variable lives  **/
+  char         text[96];       /**  What it says              **/
+
+  if (done == count)
+    text[0] = '\0';
+  else if (bytes > 0.0)
+    sprintf(text, "nec2: %d of %d decks done, %d running in %.0f MB", done,
+            count, running, bytes / 1048576.0);
+  else
+    sprintf(text, "nec2: %d of %d decks done, %d running", done, count,
+            running);
+  Tcl_SetVar(interp, "SolveProgress", text, TCL_GLOBAL_ONLY);
+  while (Tcl_DoOneEvent(TCL_IDLE_EVENTS | TCL_DONT_WAIT))
+    ;
+
+}  /**  End of SolveProgress  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 WriteView                               **/
+/**                                                                         **/
+/**  Writes the camera, global settings, materials and lights as VIEW       **/
+/**  lines of a session, each one the words of a widget command.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_WriteView(FILE *f, void *data) {
+
+  struct Antenna *antenna = Togl_GetClientData(data);  /**  Antenna data  **/
+  char            prefix[32];                          /**  Command       **/
+  int             i;                                   /**  Loop counter  **/
+
+  PA_WriteArgs(f, "VIEW eye", CfgEye, antenna);
+  PA_WriteArgs(f, "VIEW global", CfgGlobal, antenna);
+  for(i = 0; i < SizeOfMaterialType; i++) {
+    sprintf(prefix, "VIEW material %d", i);
+    PA_WriteArgs(f, prefix, CfgMaterial, &(antenna->material[i]));
+  }  /**  For each material  **/
+  for(i = 0; i < LIGHTMAX; i++) {
+    sprintf(prefix, "VIEW light %d", i);
+    PA_WriteArgs(f, prefix, CfgLight, &(antenna->light[i]));
+  }  /**  For each light  **/
+
+}  /**  End of WriteView  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 ReadView                                **/
+/**                                                                         **/
+/**  Runs a VIEW line of a session through the widget command it names.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void TKA_ReadView(int argc, CONST84 char **argv, void *data) {
+
+  struct Togl *togl = data;  /**  The widget  **/
+
+  if(argc < 3)
+    return;
+  if(strcmp(argv[1], "eye") == 0)
+    TKA_Eye(togl, argc, argv);
+  else if(strcmp(argv[1], "global") == 0)
+    TKA_Global(togl, argc, argv);
+  else if(strcmp(argv[1], "material") == 0)
+    TKA_Material(togl, argc, argv);
+  else if(strcmp(argv[1], "light") == 0)
+    TKA_Light(togl, argc, argv);
+
+}  /**  End of ReadView  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SaveSession                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_SaveSession(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  if (argc != 3) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Usage: save_session file", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  if (!SS_Save(argv[2], TKA_WriteView, togl)) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Session not saved", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  return TCL_OK;
+
+}  /**  End of SaveSession  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              RestoreSession                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_RestoreSession(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  if (argc != 3) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Usage: restore_session file", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+  if (!SS_Restore(argv[2], TKA_ReadView, togl)) {
+    Tcl_SetResult(Togl_Interp(togl),
+      "Not a session file", TCL_STATIC);
+    return TCL_ERROR;
+  }  /**  End of error  **/
+
+  /**  The saved fields stand until the antennas are edited again  **/
+  Tcl_ResetResult(Togl_Interp(togl));
+  antennaChanged = false;
+  TKA_PostFrame(togl, LAYER_ALL);
+
+  return TCL_OK;
+
+}  /**  End of RestoreSession  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SaveRGBImage                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_SaveRGBImage(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  char    file_name[255];  /**  File name  **/
+  GLint   result;          /**  Result     **/
+
+  if(argc >= 2) {
+    if (argc >= 3)
+      Togl_DumpToEpsFile(togl,argv[2],2,(void *)TKA_Display);
+    else {
+      printf("Enter name of file:");
+      scanf("%s", file_name);
+      Togl_DumpToEpsFile(togl,file_name,2,(void *)TKA_Display);
+    }  /**  Generate image  **/
+  }  /**  Args  **/
+
+  TKA_PostFrame(togl, 0);
+  result = TCL_OK;
+
+  return result;
+
+}  /**  End of SaveRGBImage  **/
+
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                MoveCenter                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_MoveCenter(struct Togl *togl, GLint argc, CONST84 char **argv) {
+  struct Antenna *antenna = Togl_GetClientData(togl);  /**  Antenna data   **/
+  GLint   result;          /**  Result     **/
+  double dist, elevation, azimuth;
+
+  if(argc >= 2) {
+    if(argc >= 4) {
+      dist =  -(antenna->Eye_Distance *
+               (antenna->Eye_Distance_Max - antenna->Eye_Distance_Min)
+               + antenna->Eye_Distance_Min);
+      elevation = antenna->Eye_Latitude;
+      azimuth = antenna->Eye_Longitude;
+      DoMoveCenter(atof(argv[2]), atof(argv[3]), azimuth, elevation, dist);
+    }
+  }  /**  Args  **/
+
+  TKA_PostFrame(togl, 0);
+  result = TCL_OK;
+
+  return result;
+
+}  /**  End of SaveRGBImage  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 GetVariable                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLint TKA_GetVariable(struct Togl *togl, GLint argc, CONST84 char **argv) {
+
+  GLint   result;          /**  Result     **/
+
+  if(argc >= 2) {
+    #if 0
+    if(strcmp(argv[2], "SCALE_FACTOR") == 0)
       sprintf(togl->Interp->result, "%lf", SCALE_FACTOR);
     else
       sprintf(togl->Interp->result, "NO_VARIABLE");
     #endif
     
   }  /**  Generate file  **/
-  Togl_PostRedisplay(togl);
+  TKA_PostFrame(togl, 0);
   result = TCL_OK;
 
   return result;
@@ -1368,7 +2495,7 @@ local GLint TKA_Global(struct Togl *togl, GLint argc, CONST84 char **argv) {
 
   result = PA_ParseArgs(Togl_Interp(togl), argc-2, argv+2, CfgGlobal, antenna);
   if(result == PA_CHANGED) {
-    Togl_PostRedisplay(togl);
+    TKA_PostFrame(togl, LAYER_ALL);
     result = TCL_OK;
   }  /**  Redisplay  **/
   return result;
@@ -1407,7 +2534,7 @@ local GLint TKA_Material(struct Togl *togl, GLint argc, CONST84 char **argv) {
     CfgMaterial, &(antenna->material[type]));
 
   if(result == PA_CHANGED) {
-    Togl_PostRedisplay(togl);
+    TKA_PostFrame(togl, LAYER_ALL);
     result = TCL_OK;
   }  /**  Redraw  **/
 
@@ -1450,7 +2577,7 @@ local GLint TKA_Light(struct Togl *togl, GLint argc, CONST84 char **argv) {
   if(result == PA_CHANGED) {
     TKA_SetLight(&(antenna->light[n]), 
       antenna->Eye_Distance_Min, antenna->Eye_Distance_Max);
-    Togl_PostRedisplay(togl);
+    TKA_PostFrame(togl, 0);
     result = TCL_OK;
   }  /**  Redraw  **/
 
@@ -0,0 +1,282 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Clusters of far apart antennas.  Showing all antennas in phase puts
+ *  every wire of the scene into one NEC deck, so the interaction matrix
+ *  grows with the square of the total segment count and a scene of a
+ *  few big arrays cannot be solved at all.  The coupling between two
+ *  antennas many wavelengths apart is weak, so the blocks of the matrix
+ *  between them can be dropped: antennas closer than the spacing are
+ *  grouped by CL_Group, each group is solved as a deck of its own, and
+ *  CL_Sum adds the groups' far fields.  NEC prints each with the wires
+ *  at their place in the scene, so the fields add without any further
+ *  phase shift, and the gains are over the input power of all groups.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "FarField.h"
+#include "Clusters.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  DEG  (M_PI / 180.0)  /**  Radians per degree  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Bounds                                  **/
+/**                                                                         **/
+/**  A sphere around an antenna's wires at its offset, in metres.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Bounds(const Ant *ant, double centre[3], double *radius) {
+
+  const Tube  *tube;   /**  Tube traversal  **/
+  double       lo[3];  /**  Box corner      **/
+  double       hi[3];  /**    ..and other   **/
+  double       d;      /**  Distance        **/
+  int          n;      /**  Tubes seen      **/
+  int          i;      /**  Loop counter    **/
+
+  n = 0;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next, n++) {
+    if (n == 0) {
+      lo[0] = hi[0] = tube->e1.x;
+      lo[1] = hi[1] = tube->e1.y;
+      lo[2] = hi[2] = tube->e1.z;
+    }  /**  First  **/
+    lo[0] = fmin(lo[0], fmin(tube->e1.x, tube->e2.x));
+    lo[1] = fmin(lo[1], fmin(tube->e1.y, tube->e2.y));
+    lo[2] = fmin(lo[2], fmin(tube->e1.z, tube->e2.z));
+    hi[0] = fmax(hi[0], fmax(tube->e1.x, tube->e2.x));
+    hi[1] = fmax(hi[1], fmax(tube->e1.y, tube->e2.y));
+    hi[2] = fmax(hi[2], fmax(tube->e1.z, tube->e2.z));
+  }  /**  For each tube  **/
+  if (n == 0)
+    lo[0] = lo[1] = lo[2] = hi[0] = hi[1] = hi[2] = 0.0;
+
+  *radius = 0.0;
+  for (i = 0; i < 3; i++) {
+    centre[i] = (lo[i] + hi[i]) / 2.0;
+    d = (hi[i] - lo[i]) / 2.0;
+    *radius += d * d;
+  }  /**  Each axis  **/
+  *radius = sqrt(*radius) * 100.0;
+  centre[0] = (centre[0] + ant->dx) * 100.0;
+  centre[1] = (centre[1] + ant->dy) * 100.0;
+  centre[2] = (centre[2] + ant->dz) * 100.0;
+
+}  /**  End of Bounds  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Root                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Root(int *parent, int i) {
+
+  while (parent[i] != i)
+    i = parent[i] = parent[parent[i]];
+  return i;
+
+}  /**  End of Root  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CL_Group                                 **/
+/**                                                                         **/
+/**  Groups the antennas so that any two whose wires come within spacing    **/
+/**  wavelengths at freq MHz are in the same group, as are their            **/
+/**  neighbours' neighbours.  cluster[k] gets antenna k's group, numbered   **/
+/**  from 0 in order of first antenna.  Returns the number of groups.       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int CL_Group(const AntArray *ants, double spacing, double freq, 
+             int *cluster) {
+
+  double  centre[MAX_ANTENNAS][3];  /**  Bounding spheres  **/
+  double  radius[MAX_ANTENNAS];
+  int     parent[MAX_ANTENNAS];     /**  Union find        **/
+  int     number[MAX_ANTENNAS];     /**  Group of a root   **/
+  double  gap;                      /**  Metres, clear     **/
+  double  d[3];                     /**  Centre to centre  **/
+  int     groups;                   /**  Result            **/
+  int     i;                        /**  Loop counter      **/
+  int     j;                        /**  Loop counter      **/
+
+  if (freq <= 0.0)
+    freq = FF_NEC_FREQ;
+  for (i = 0; i < ants->ant_count; i++) {
+    Bounds(&ants->ants[i], centre[i], &radius[i]);
+    parent[i] = i;
+    number[i] = -1;
+  }  /**  For each antenna  **/
+
+  for (i = 0; i < ants->ant_count; i++)
+    for (j = i + 1; j < ants->ant_count; j++) {
+      d[0] = centre[i][0] - centre[j][0];
+      d[1] = centre[i][1] - centre[j][1];
+      d[2] = centre[i][2] - centre[j][2];
+      gap = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) - 
+            radius[i] - radius[j];
+      if (gap < spacing * FF_C / freq)
+        parent[Root(parent, j)] = Root(parent, i);
+    }  /**  For each pair  **/
+
+  groups = 0;
+  for (i = 0; i < ants->ant_count; i++) {
+    j = Root(parent, i);
+    if (number[j] < 0)
+      number[j] = groups++;
+    cluster[i] = number[j];
+  }  /**  Number the groups  **/
+  return groups;
+
+}  /**  End of CL_Group  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              CL_Segments                                **/
+/**                                                                         **/
+/**  Segments in group id, or in the whole scene if cluster is NULL.        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+long CL_Segments(const AntArray *ants, const int *cluster, int id) {
+
+  const Tube  *tube;   /**  Tube traversal  **/
+  long         count;  /**  Result          **/
+  int          k;      /**  Loop counter    **/
+
+  count = 0;
+  for (k = 0; k < ants->ant_count; k++)
+    if (cluster == NULL || cluster[k] == id)
+      for (tube = ants->ants[k].first_tube; tube != NULL; tube = tube->next)
+        count += tube->segments;
+  return count;
+
+}  /**  End of CL_Segments  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 CL_Sum                                  **/
+/**                                                                         **/
+/**  Fills out with the sum of n groups' fields, as NEC printed them on     **/
+/**  one grid, with gains over the groups' total input power watts.         **/
+/**  False if the grids differ or no power went in.  The serial is left to  **/
+/**  the caller.                                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool CL_Sum(FieldData *const *parts, const double *power, int n, 
+            FieldData *out) {
+
+  const FieldVal  *v;      /**  A group's sample     **/
+  FieldVal        *vals;   /**  Grown sample array   **/
+  double           total;  /**  Input power, watts   **/
+  double           e[4];   /**  E theta, E phi       **/
+  int              count;  /**  Samples              **/
+  int              c;      /**  Group                **/
+  int              i;      /**  Loop counter         **/
+
+  if (n < 1 || (count = parts[0]->count) < 1)
+    return false;
+  total = 0.0;
+  for (c = 0; c < n; c++) {
+    if (parts[c]->count != count)
+      return false;
+    total += power[c];
+  }  /**  For each group  **/
+  if (total <= 0.0)
+    return false;
+  if ((vals = (FieldVal *) realloc(out->vals, count * sizeof(FieldVal)))
+      == NULL)
+    return false;
+  out->vals = vals;
+
+  for (i = 0; i < count; i++) {
+    e[0] = e[1] = e[2] = e[3] = 0.0;
+    for (c = 0; c < n; c++) {
+      v = &parts[c]->vals[i];
+      e[0] += v->theta_mag * cos(v->theta_phase * DEG);
+      e[1] += v->theta_mag * sin(v->theta_phase * DEG);
+      e[2] += v->phi_mag * cos(v->phi_phase * DEG);
+      e[3] += v->phi_mag * sin(v->phi_phase * DEG);
+    }  /**  For each group  **/
+    vals[i].theta = parts[0]->vals[i].theta;
+    vals[i].phi = parts[0]->vals[i].phi;
+    FF_FillValue(e[0], e[1], e[2], e[3], 2.0 * M_PI / (FF_ETA0 * total),
+                 &vals[i]);
+  }  /**  For each sample  **/
+  out->count = count;
+  FF_Ranges(out);
+  return true;
+
+}  /**  End of CL_Sum  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of Clusters.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
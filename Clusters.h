@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CLUSTERS_H
+#define CLUSTERS_H
+
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int    CL_Group(const AntArray *, double, double, int *);
+long   CL_Segments(const AntArray *, const int *, int);
+bool   CL_Sum(FieldData *const *, const double *, int, FieldData *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of Clusters.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
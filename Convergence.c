@@ -0,0 +1,716 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Segmentation convergence.  How many segments a GW card is given is
+ *  guesswork, and every segment beyond what the answer needs costs the
+ *  solver, the matrix filling as the square and factoring as the cube
+ *  of the total.  A study writes the antenna's deck at up to CV_LEVELS
+ *  densities, each tube's segments scaled by the same factor with their
+ *  parity kept so that a centre feed stays on the centre segment, and
+ *  has them solved side by side.  The peak gain, feed impedances and
+ *  pattern of each are compared with those of the finest, and the
+ *  cheapest density from which every finer one agrees with it within
+ *  CV_GAIN_TOL, CV_IMPEDANCE_TOL and CV_PATTERN_TOL is recommended.
+ *
+ *  EX, LD, NT and TL cards follow the segments, each segment they name
+ *  moved to the one over the same point of its wire, and a loaded range
+ *  to the segments covering the same stretch.  Decks whose cards cannot
+ *  follow are not studied: lumped loads over several segments, whose
+ *  total would change with their number, and cards that build wires
+ *  other than by GW or name segments some other way.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "Convergence.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local const double Factors[CV_LEVELS] = {  /**  Of the deck's own segments  **/
+  0.33, 0.5, 0.75, 1.0, 1.5, 2.0
+};
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CV_Free                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void CV_Free(CV_Study *study) {
+
+  int  k;  /**  Loop counter  **/
+
+  if (study == NULL)
+    return;
+  for (k = 0; k < study->levels; k++) {
+    free(study->level[k].counts);
+    free(study->level[k].pattern);
+  }  /**  For each level  **/
+  free(study->cards);
+  free(study);
+
+}  /**  End of CV_Free  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Movable                                  **/
+/**                                                                         **/
+/**  Whether every card of the antenna can follow its wires to another      **/
+/**  segmentation.  If not, note says which does not.                       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Movable(const Ant *ant, char *note, int size) {
+
+  const char  *card;  /**  Current card   **/
+  int          v[4];  /**  Card integers  **/
+  int          i;     /**  Loop counter   **/
+
+  for (i = 0; i < ant->card_count; i++) {
+    card = ant->cards[i];
+    if (card[0] == 'G' && card[1] == 'M' &&
+        sscanf(card + 2, "%d%d", &v[0], &v[1]) == 2 && v[1] != 0) {
+      snprintf(note, size, "a GM card copies wires");
+      return false;
+    }  /**  Copies  **/
+    if ((card[0] == 'G' && card[1] != 'W' && card[1] != 'E' &&
+         card[1] != 'N' && card[1] != 'S' && card[1] != 'M') ||
+        (card[0] == 'S' && (card[1] == 'P' || card[1] == 'M' ||
+                            card[1] == 'C'))) {
+      snprintf(note, size, "a %.2s card builds wires other than by GW", 
+               card);
+      return false;
+    }  /**  Other geometry  **/
+    if ((card[0] == 'C' && card[1] == 'P') ||
+        (card[0] == 'P' && (card[1] == 'T' || card[1] == 'Q') &&
+         sscanf(card + 2, "%d%d", &v[0], &v[1]) == 2 && v[1] != 0)) {
+      snprintf(note, size, "a %.2s card names segments", card);
+      return false;
+    }  /**  Coupling or printing  **/
+    if (card[0] == 'L' && card[1] == 'D' &&
+        sscanf(card + 2, "%d%d%d%d", &v[0], &v[1], &v[2], &v[3]) == 4 &&
+        (v[0] == 0 || v[0] == 1 || v[0] == 4) &&
+        ((v[2] == 0 && v[3] == 0) || (v[3] != 0 && v[3] != v[2]))) {
+      snprintf(note, size, "an LD card lumps a load over several segments");
+      return false;
+    }  /**  Load whose total depends on the segments  **/
+  }  /**  For each card  **/
+  return true;
+
+}  /**  End of Movable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Scaled                                   **/
+/**                                                                         **/
+/**  Segments for a wire of n at factor times the density, at least one     **/
+/**  and odd where n is, so a centre segment stays one.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Scaled(int n, double factor) {
+
+  int  m;  /**  Segments  **/
+
+  if (n < 1)
+    return n;
+  m = (int) floor(n * factor + 0.5);
+  if (m < 1)
+    m = 1;
+  if ((m - n) % 2 != 0)
+    m++;
+  return m;
+
+}  /**  End of Scaled  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CV_Plan                                  **/
+/**                                                                         **/
+/**  The densities to study the antenna at, coarsest first, those that      **/
+/**  come out the same as a coarser one dropped.  NULL if the antenna       **/
+/**  cannot be studied, with the reason in note.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+CV_Study *CV_Plan(const Ant *ant, char *note, int size) {
+
+  CV_Study    *study;  /**  The plan          **/
+  CV_Level    *level;  /**  Current level     **/
+  const Tube  *tube;   /**  Current tube      **/
+  int         *counts; /**  Level's segments  **/
+  int          wires;  /**  Tubes that are    **/
+  int          n;      /**  Tubes             **/
+  int          i;      /**  Loop counter      **/
+  int          k;      /**  Loop counter      **/
+
+  note[0] = '\0';
+  for (tube = ant->first_tube, n = 0, wires = 0; tube != NULL; 
+       tube = tube->next, n++)
+    if (tube->type == IS_TUBE && tube->segments > 0)
+      wires++;
+  if (wires == 0) {
+    snprintf(note, size, "the antenna has no wires");
+    return NULL;
+  }  /**  Nothing to segment  **/
+  if (!Movable(ant, note, size))
+    return NULL;
+  if ((study = (CV_Study *) calloc(1, sizeof(CV_Study))) == NULL) {
+    snprintf(note, size, "out of memory");
+    return NULL;
+  }  /**  No room  **/
+  study->tubes = n;
+  study->reference = study->best = study->in_use = -1;
+
+  for (k = 0; k < CV_LEVELS; k++) {
+    if ((counts = (int *) malloc(n * sizeof(int))) == NULL) {
+      CV_Free(study);
+      snprintf(note, size, "out of memory");
+      return NULL;
+    }  /**  No room  **/
+    for (tube = ant->first_tube, i = 0; tube != NULL; tube = tube->next)
+      counts[i++] = (tube->type == IS_TUBE) ? 
+                    Scaled(tube->segments, Factors[k]) : tube->segments;
+
+    level = (study->levels > 0) ? &study->level[study->levels - 1] : NULL;
+    if (level != NULL && 
+        memcmp(counts, level->counts, n * sizeof(int)) == 0) {
+      if (Factors[k] == 1.0) {
+        level->factor = 1.0;
+        study->original = study->levels - 1;
+      }  /**  The deck's own after all  **/
+      free(counts);
+      continue;
+    }  /**  Same as the last  **/
+
+    level = &study->level[study->levels];
+    level->factor = Factors[k];
+    level->counts = counts;
+    for (i = 0; i < n; i++)
+      level->segments += counts[i];
+    if (Factors[k] == 1.0)
+      study->original = study->levels;
+    study->levels++;
+  }  /**  For each density  **/
+  return study;
+
+}  /**  End of CV_Plan  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Moved                                   **/
+/**                                                                         **/
+/**  Segment seg of a wire of from segments at to segments: the one over    **/
+/**  its middle for end 0, or over its start for -1 and its end for 1, so   **/
+/**  that a range keeps the stretch of wire it covers.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Moved(int seg, int from, int to, int end) {
+
+  double  u;  /**  Along the wire, in new segments  **/
+  int     s;  /**  New segment                      **/
+
+  if (seg < 1 || seg > from || to < 1 || from == to)
+    return seg;
+  u = (seg - 0.5 + 0.5 * end) / from * to;
+  s = (end > 0) ? (int) ceil(u - 1.0e-9) : (int) floor(u + 1.0e-9) + 1;
+  if (s < 1)
+    s = 1;
+  if (s > to)
+    s = to;
+  return s;
+
+}  /**  End of Moved  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                MovedOn                                  **/
+/**                                                                         **/
+/**  Moved for segment seg of tag from the antenna's own segments to the    **/
+/**  level's, tag 0 counting over the whole structure as NEC does.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int MovedOn(const CV_Study *study, int level, int tag, int seg, 
+                  int end) {
+
+  const int  *from;  /**  Own segments     **/
+  const int  *to;    /**  Level's          **/
+  int         a;     /**  Own before tube  **/
+  int         b;     /**  Level's before   **/
+  int         k;     /**  Tube             **/
+
+  from = study->level[study->original].counts;
+  to = study->level[level].counts;
+  if (tag > 0 && tag <= study->tubes)
+    return Moved(seg, from[tag - 1], to[tag - 1], end);
+  if (tag != 0 || seg < 1)
+    return seg;
+
+  for (k = 0, a = b = 0; k < study->tubes && seg > a + from[k]; k++) {
+    a += from[k];
+    b += to[k];
+  }  /**  Tubes before  **/
+  return (k < study->tubes) ? b + Moved(seg - a, from[k], to[k], end) : seg;
+
+}  /**  End of MovedOn  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Rewritten                                 **/
+/**                                                                         **/
+/**  A new copy of card with its first n integers, which took used          **/
+/**  characters after the mnemonic, replaced by v.                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local char *Rewritten(const char *card, const int *v, int n, int used) {
+
+  char    *text;  /**  The copy      **/
+  size_t   size;  /**  Its room      **/
+  int      at;    /**  Written so far **/
+  int      i;     /**  Loop counter  **/
+
+  size = strlen(card) + 16 * n + 8;
+  if ((text = (char *) malloc(size)) == NULL)
+    return NULL;
+  at = snprintf(text, size, "%.2s", card);
+  for (i = 0; i < n; i++)
+    at += snprintf(text + at, size - at, " %d", v[i]);
+  snprintf(text + at, size - at, "%s", card + 2 + used);
+  return text;
+
+}  /**  End of Rewritten  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               LevelCard                                 **/
+/**                                                                         **/
+/**  A new copy of card for the level's segments, NULL if out of memory.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local char *LevelCard(const CV_Study *study, int level, const char *card) {
+
+  int  v[4];  /**  Card integers   **/
+  int  used;  /**  Characters read **/
+
+  if (card[0] == 'E' && card[1] == 'X' &&
+      sscanf(card + 2, "%d%d%d%d%n", &v[0], &v[1], &v[2], &v[3], 
+             &used) == 4 && (v[0] == 0 || v[0] == 5)) {
+    v[2] = MovedOn(study, level, v[1], v[2], 0);
+    return Rewritten(card, v, 4, used);
+  }  /**  Voltage source  **/
+
+  if (card[0] == 'L' && card[1] == 'D' &&
+      sscanf(card + 2, "%d%d%d%d%n", &v[0], &v[1], &v[2], &v[3], 
+             &used) == 4 && v[0] >= 0 && (v[2] != 0 || v[3] != 0)) {
+    if (v[3] == 0 || v[3] == v[2]) {
+      v[2] = MovedOn(study, level, v[1], v[2], 0);
+      v[3] = (v[3] == 0) ? 0 : v[2];
+    } else {
+      v[2] = MovedOn(study, level, v[1], v[2], -1);
+      v[3] = MovedOn(study, level, v[1], v[3], 1);
+    }  /**  One segment or a range  **/
+    return Rewritten(card, v, 4, used);
+  }  /**  Load on some of a wire  **/
+
+  if (((card[0] == 'N' && card[1] == 'T') ||
+       (card[0] == 'T' && card[1] == 'L')) &&
+      sscanf(card + 2, "%d%d%d%d%n", &v[0], &v[1], &v[2], &v[3], 
+             &used) == 4) {
+    v[1] = MovedOn(study, level, v[0], v[1], 0);
+    v[3] = MovedOn(study, level, v[2], v[3], 0);
+    return Rewritten(card, v, 4, used);
+  }  /**  Network or line  **/
+
+  return strdup(card);
+
+}  /**  End of LevelCard  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SetCounts                                 **/
+/**                                                                         **/
+/**  Gives the antenna's tubes the level's segments.                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SetCounts(const CV_Study *study, Ant *ant, int level) {
+
+  const CV_Level  *from;  /**  Segments it has   **/
+  const CV_Level  *to;    /**    ..and is given  **/
+  Tube            *tube;  /**  Current tube      **/
+  int              i;     /**  Loop counter      **/
+
+  from = &study->level[(study->in_use >= 0) ? study->in_use : 
+                                              study->original];
+  to = &study->level[level];
+  for (tube = ant->first_tube, i = 0; tube != NULL && i < study->tubes;
+       tube = tube->next)
+    tube->segments = to->counts[i++];
+  ant->total_segments += to->segments - from->segments;
+
+}  /**  End of SetCounts  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 CV_Use                                  **/
+/**                                                                         **/
+/**  Puts the level's segments and cards on the antenna, its own kept in    **/
+/**  the study until CV_Restore.                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool CV_Use(CV_Study *study, Ant *ant, int level) {
+
+  char  **own;  /**  The antenna's cards  **/
+  int     i;    /**  Loop counter         **/
+
+  CV_Restore(study, ant);
+  if (level < 0 || level >= study->levels)
+    return false;
+  if ((own = (char **) malloc((ant->card_count + 1) * sizeof(char *))) ==
+      NULL)
+    return false;
+  for (i = 0; i < ant->card_count; i++) {
+    own[i] = ant->cards[i];
+    if ((ant->cards[i] = LevelCard(study, level, own[i])) == NULL) {
+      while (i >= 0) {
+        free(ant->cards[i]);
+        ant->cards[i] = own[i];
+        i--;
+      }  /**  Back as they were  **/
+      free(own);
+      return false;
+    }  /**  Out of memory  **/
+  }  /**  For each card  **/
+
+  study->cards = own;
+  study->card_count = ant->card_count;
+  SetCounts(study, ant, level);
+  study->in_use = level;
+  return true;
+
+}  /**  End of CV_Use  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CV_Restore                                **/
+/**                                                                         **/
+/**  Gives the antenna back its own segments and cards.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void CV_Restore(CV_Study *study, Ant *ant) {
+
+  int  i;  /**  Loop counter  **/
+
+  if (study->in_use < 0)
+    return;
+  for (i = 0; i < study->card_count; i++) {
+    free(ant->cards[i]);
+    ant->cards[i] = study->cards[i];
+  }  /**  For each card  **/
+  free(study->cards);
+  study->cards = NULL;
+  SetCounts(study, ant, study->original);
+  study->in_use = -1;
+
+}  /**  End of CV_Restore  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 CV_Keep                                 **/
+/**                                                                         **/
+/**  Makes the level's segments and cards the antenna's own.                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool CV_Keep(CV_Study *study, Ant *ant, int level) {
+
+  int  i;  /**  Loop counter  **/
+
+  if (!CV_Use(study, ant, level))
+    return false;
+  for (i = 0; i < study->card_count; i++)
+    free(study->cards[i]);
+  free(study->cards);
+  study->cards = NULL;
+  study->original = level;
+  study->in_use = -1;
+  return true;
+
+}  /**  End of CV_Keep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CV_Capture                                **/
+/**                                                                         **/
+/**  Keeps the peak gain, feed impedances and pattern ParseFieldData just   **/
+/**  read into the antenna as the solution at the level.                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool CV_Capture(CV_Study *study, int level, const Ant *ant) {
+
+  const FieldData  *fd;     /**  Level's field    **/
+  const FeedTable  *table;  /**    ..and feeds    **/
+  CV_Level         *l;      /**  Where they go    **/
+  int               i;      /**  Loop counter     **/
+
+  fd = ant->fieldData;
+  if (level < 0 || level >= study->levels || fd == NULL || fd->count < 1)
+    return false;
+  l = &study->level[level];
+  free(l->pattern);
+  if ((l->pattern = (float *) malloc(fd->count * sizeof(float))) == NULL)
+    return false;
+  l->samples = fd->count;
+  for (i = 0; i < fd->count; i++)
+    l->pattern[i] = fd->vals[i].total_gain;
+  l->gain = fd->maxgain;
+
+  table = ant->feedTable;
+  l->feeds = 0;
+  for (i = 0; table != NULL && i < table->count && i < CV_MAX_FEEDS; i++) {
+    l->resistance[i] = table->resistance[i];
+    l->reactance[i] = table->reactance[i];
+    l->feeds++;
+  }  /**  For each source  **/
+  l->solved = true;
+  return true;
+
+}  /**  End of CV_Capture  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Compare                                   **/
+/**                                                                         **/
+/**  Errors of level l against the reference r, and whether they are all    **/
+/**  within tolerance.                                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Compare(CV_Level *l, const CV_Level *r) {
+
+  double  cut;    /**  dBi under which the pattern is ignored  **/
+  double  sum;    /**  Of squared differences                 **/
+  double  a;      /**  Level's gain, dBi                      **/
+  double  b;      /**    ..and the reference's                **/
+  double  z;      /**  Reference |Z|                          **/
+  int     n;      /**  Samples compared                       **/
+  int     i;      /**  Loop counter                           **/
+
+  l->gain_error = fabs(l->gain - r->gain);
+
+  l->impedance_error = (l->feeds == r->feeds) ? 0.0 : HUGE_VAL;
+  for (i = 0; i < l->feeds && i < r->feeds; i++) {
+    z = fmax(hypot(r->resistance[i], r->reactance[i]), 1.0);
+    l->impedance_error = fmax(l->impedance_error, 
+                              hypot(l->resistance[i] - r->resistance[i],
+                                    l->reactance[i] - r->reactance[i]) / z);
+  }  /**  For each source  **/
+
+  l->pattern_error = (l->samples == r->samples) ? 0.0 : HUGE_VAL;
+  if (l->samples == r->samples) {
+    cut = r->gain - CV_FLOOR;
+    for (i = 0, n = 0, sum = 0.0; i < l->samples; i++) {
+      if (r->pattern[i] <= cut)
+        continue;
+      a = fmax(l->pattern[i], cut);
+      b = r->pattern[i];
+      sum += (a - b) * (a - b);
+      n++;
+    }  /**  For each sample  **/
+    l->pattern_error = (n > 0) ? sqrt(sum / n) : 0.0;
+  }  /**  Same grid  **/
+
+  l->within = l->gain_error <= CV_GAIN_TOL && 
+              l->impedance_error <= CV_IMPEDANCE_TOL &&
+              l->pattern_error <= CV_PATTERN_TOL;
+
+}  /**  End of Compare  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CV_Choose                                 **/
+/**                                                                         **/
+/**  Compares every solved level with the finest and picks the cheapest     **/
+/**  from which all finer solved levels agree with it.  Returns the level,  **/
+/**  or -1 if not even the next finest agrees, so that nothing shows the    **/
+/**  answer has settled.                                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int CV_Choose(CV_Study *study) {
+
+  int  k;  /**  Loop counter  **/
+
+  study->reference = study->best = -1;
+  for (k = study->levels - 1; k >= 0 && study->reference < 0; k--)
+    if (study->level[k].solved)
+      study->reference = k;
+  if (study->reference < 0)
+    return -1;
+
+  for (k = 0; k < study->levels; k++)
+    if (study->level[k].solved)
+      Compare(&study->level[k], &study->level[study->reference]);
+  for (k = study->reference - 1; k >= 0; k--) {
+    if (!study->level[k].solved)
+      continue;
+    if (!study->level[k].within)
+      break;
+    study->best = k;
+  }  /**  Down from the finest  **/
+  return study->best;
+
+}  /**  End of CV_Choose  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CV_Print                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void CV_Print(FILE *f, const CV_Study *study) {
+
+  const CV_Level  *l;  /**  Current level  **/
+  int              k;  /**  Loop counter   **/
+
+  fprintf(f, "Segmentation study, against the finest solved:\n");
+  fprintf(f, "  factor  segments  gain dBi  off dB  |Z| off  pattern dB\n");
+  for (k = 0; k < study->levels; k++) {
+    l = &study->level[k];
+    if (!l->solved)
+      fprintf(f, "  %6.2f  %8d  skipped: %s\n", l->factor, l->segments,
+              l->note[0] != '\0' ? l->note : "not solved");
+    else
+      fprintf(f, "  %6.2f  %8d  %8.2f  %6.3f  %6.2f%%  %10.3f%s%s\n", 
+              l->factor, l->segments, l->gain, l->gain_error, 
+              100.0 * l->impedance_error, l->pattern_error,
+              (k == study->original) ? "  deck" : "",
+              (k == study->best) ? "  best" : "");
+  }  /**  For each level  **/
+  if (study->best < 0)
+    fprintf(f, "No coarser density agrees with the finest within "
+            "%.2f dB, %.0f%% and %.2f dB\n", CV_GAIN_TOL,
+            100.0 * CV_IMPEDANCE_TOL, CV_PATTERN_TOL);
+  else
+    fprintf(f, "Cheapest within tolerance: %d segments, the deck has %d\n",
+            study->level[study->best].segments,
+            study->level[study->original].segments);
+
+}  /**  End of CV_Print  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of Convergence.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
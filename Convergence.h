@@ -0,0 +1,120 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+#include <stdio.h>
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  CV_LEVELS         6      /**  Densities one study solves          **/
+#define  CV_MAX_FEEDS      16     /**  Feed rows compared, at most         **/
+#define  CV_GAIN_TOL       0.1    /**  dB, peak gain off the finest        **/
+#define  CV_IMPEDANCE_TOL  0.02   /**  Of |Z|, feed impedance off finest   **/
+#define  CV_PATTERN_TOL    0.25   /**  dB RMS, pattern off the finest      **/
+#define  CV_FLOOR          30.0   /**  dB under the peak, pattern ignored  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct CV_Level {
+  double   factor;                     /**  Of the deck's own segments      **/
+  int      segments;                   /**  In all, at this density         **/
+  int     *counts;                     /**  Per tube, in list order         **/
+  bool     solved;                     /**  Else skipped, see note          **/
+  char     note[96];                   /**  Why it was skipped              **/
+  double   gain;                       /**  Peak, dBi                       **/
+  int      feeds;                      /**  Feed rows kept                  **/
+  double   resistance[CV_MAX_FEEDS];   /**  Ohms, one per source            **/
+  double   reactance[CV_MAX_FEEDS];
+  int      samples;                    /**  Pattern samples                 **/
+  float   *pattern;                    /**  Total gain of each, dBi         **/
+  double   gain_error;                 /**  dB, against the reference       **/
+  double   impedance_error;            /**  Of |Z|, worst feed              **/
+  double   pattern_error;              /**  dB RMS                          **/
+  bool     within;                     /**  All three within tolerance      **/
+} CV_Level;
+
+typedef struct CV_Study {
+  int       tubes;                /**  In the antenna                     **/
+  int       levels;               /**  Densities, coarsest first          **/
+  CV_Level  level[CV_LEVELS];
+  int       original;             /**  Level of the deck's own segments   **/
+  int       reference;            /**  Finest solved, -1 if none          **/
+  int       best;                 /**  Cheapest converged, -1 if none     **/
+  int       in_use;               /**  Level on the antenna, -1 if none   **/
+  int       card_count;           /**  The antenna's own cards while a    **/
+  char    **cards;                /**    level is in use                  **/
+} CV_Study;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+CV_Study  *CV_Plan(const Ant *, char *, int);
+bool       CV_Use(CV_Study *, Ant *, int);
+void       CV_Restore(CV_Study *, Ant *);
+bool       CV_Keep(CV_Study *, Ant *, int);
+bool       CV_Capture(CV_Study *, int, const Ant *);
+int        CV_Choose(CV_Study *);
+void       CV_Print(FILE *, const CV_Study *);
+void       CV_Free(CV_Study *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of Convergence.h                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
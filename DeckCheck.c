@@ -0,0 +1,564 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Checks what nec2 would be given before it is run, so that a deck it
+ *  cannot solve well costs milliseconds here rather than a solve and a
+ *  failed parse.  The wires are taken as the deck writes them, in
+ *  metres after the GS card, and checked against NEC's own guidance:
+ *
+ *    segments between DC_MIN_SEG and DC_MAX_SEG wavelengths long, with
+ *    a warning outside DC_SHORT_SEG to DC_LONG_SEG;
+ *
+ *    segments at least DC_THICK times their radius, with a warning under
+ *    DC_THIN, both divided by DC_EK_FACTOR when an EK card asks for the
+ *    extended thin wire kernel;
+ *
+ *    no two wires crossing, overlapping or closer than their radii
+ *    except where segment ends meet, which is where NEC joins wires;
+ *
+ *    GW tags in card order, as the deck is written renumbered, and every
+ *    tag and segment an EX, LD, NT or TL card names present.
+ *
+ *  Wire pairs are found through their bounding boxes sorted along x, so
+ *  only wires whose boxes overlap are compared.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "Timing.h"
+#include "WireIndex.h"
+#include "DeckCheck.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  C_MHZ  299.792458   /**  Wavelength in metres times MHz  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Wire {
+  int     tag;        /**  In the written deck         **/
+  int     segments;   /**  NEC segments                **/
+  double  a[3];       /**  End points, metres          **/
+  double  b[3];
+  double  radius;     /**  Metres                      **/
+  double  lo[3];      /**  Box, the radius around it   **/
+  double  hi[3];
+} Wire;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                   Add                                   **/
+/**                                                                         **/
+/**  Counts an issue, and keeps it while there is room.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Add(DC_Report *report, bool error, int tag, const char *format,
+               ...) {
+
+  va_list    args;   /**  Format arguments  **/
+  DC_Issue  *issue;  /**  Where it is kept  **/
+
+  if (error)
+    report->errors++;
+  else
+    report->warnings++;
+  if (report->kept == DC_MAX_ISSUES)
+    return;
+  issue = &report->issues[report->kept++];
+  issue->error = error;
+  issue->tag = tag;
+  va_start(args, format);
+  vsnprintf(issue->text, sizeof(issue->text), format, args);
+  va_end(args);
+
+}  /**  End of Add  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Length                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Length(const Wire *w) {
+
+  return sqrt((w->b[0] - w->a[0]) * (w->b[0] - w->a[0]) +
+              (w->b[1] - w->a[1]) * (w->b[1] - w->a[1]) +
+              (w->b[2] - w->a[2]) * (w->b[2] - w->a[2]));
+
+}  /**  End of Length  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Scale                                   **/
+/**                                                                         **/
+/**  Metres per deck unit, from the antenna's GS card.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Scale(const Ant *ant) {
+
+  double  scale;  /**  GS factor     **/
+  int     i1;     /**  GS integers   **/
+  int     i2;
+  int     i;      /**  Loop counter  **/
+
+  for (i = 0; i < ant->card_count; i++)
+    if (ant->cards[i][0] == 'G' && ant->cards[i][1] == 'S' &&
+        sscanf(ant->cards[i] + 2, "%d%d%lf", &i1, &i2, &scale) == 3 &&
+        scale > 0.0)
+      return scale;
+  return 1.0;
+
+}  /**  End of Scale  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CompareLo                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int CompareLo(const void *p, const void *q) {
+
+  const Wire  *a = (const Wire *) p;  /**  First   **/
+  const Wire  *b = (const Wire *) q;  /**  Second  **/
+
+  return (a->lo[0] < b->lo[0]) ? -1 : (a->lo[0] > b->lo[0]) ? 1 : 0;
+
+}  /**  End of CompareLo  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Contact                                 **/
+/**                                                                         **/
+/**  Reports two wires that overlap, cross, or come closer than their       **/
+/**  radii anywhere but where segment ends meet, by the rule WI_Touching    **/
+/**  uses.                                                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Contact(const Wire *p, const Wire *q, DC_Report *report) {
+
+  double  s;         /**  Along p          **/
+  double  t;         /**  Along q          **/
+  double  t1;        /**  q's ends along p **/
+  double  t2;
+  double  gap;       /**  Between axes     **/
+  double  tol;       /**  Ends meet within **/
+  double  len;       /**  p's length       **/
+  double  dot;       /**  Projection       **/
+  bool    parallel;  /**  Axes parallel    **/
+  int     i;         /**  Loop counter     **/
+
+  gap = WI_Segments(p->a, p->b, q->a, q->b, &s, &t, &parallel);
+  if (gap >= p->radius + q->radius)
+    return;
+  tol = WI_JoinTolerance(p->a, p->b, p->segments, q->a, q->b, q->segments);
+  len = Length(p);
+
+  if (parallel && gap <= tol) {
+    for (i = 0, t1 = t2 = 0.0; i < 3; i++) {
+      dot = (p->b[i] - p->a[i]) / len;
+      t1 += (q->a[i] - p->a[i]) * dot;
+      t2 += (q->b[i] - p->a[i]) * dot;
+    }  /**  Project q onto p  **/
+    if (fmin(len, fmax(t1, t2)) - fmax(0.0, fmin(t1, t2)) > tol) {
+      Add(report, true, p->tag, "tags %d and %d overlap", p->tag, q->tag);
+      return;
+    }  /**  Along each other  **/
+  }  /**  In line  **/
+
+  if (WI_Joined(p->a, p->b, p->segments, s, q->a, q->b, q->segments, t, gap))
+    return;
+  if (gap <= tol)
+    Add(report, true, p->tag, "tags %d and %d meet away from a segment end",
+        p->tag, q->tag);
+  else
+    Add(report, true, p->tag, "tags %d and %d are closer than their radii",
+        p->tag, q->tag);
+
+}  /**  End of Contact  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CheckWire                                **/
+/**                                                                         **/
+/**  Segment length against the wavelength and against the wire's radius.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void CheckWire(const Wire *w, double wavelength, bool ek,
+                     DC_Report *report) {
+
+  double  seg;    /**  Segment length, metres  **/
+  double  thin;   /**  Warning ratio           **/
+  double  thick;  /**  Error ratio             **/
+  double  r;      /**  A ratio                 **/
+
+  if (w->segments < 1) {
+    Add(report, true, w->tag, "tag %d has no segments", w->tag);
+    return;
+  }  /**  Nothing to solve  **/
+  if ((seg = Length(w) / w->segments) <= 0.0) {
+    Add(report, true, w->tag, "tag %d has no length", w->tag);
+    return;
+  }  /**  A point  **/
+  if (w->radius <= 0.0) {
+    Add(report, true, w->tag, "tag %d has no radius", w->tag);
+    return;
+  }  /**  No wire  **/
+
+  if (wavelength > 0.0) {
+    r = seg / wavelength;
+    if (r > DC_MAX_SEG)
+      Add(report, true, w->tag, "tag %d has segments of %.3g wavelengths, "
+          "over %g", w->tag, r, DC_MAX_SEG);
+    else if (r > DC_LONG_SEG)
+      Add(report, false, w->tag, "tag %d has segments of %.3g wavelengths, "
+          "over %g", w->tag, r, DC_LONG_SEG);
+    else if (r < DC_MIN_SEG)
+      Add(report, true, w->tag, "tag %d has segments of %.3g wavelengths, "
+          "under %g", w->tag, r, DC_MIN_SEG);
+    else if (r < DC_SHORT_SEG)
+      Add(report, false, w->tag, "tag %d has segments of %.3g wavelengths, "
+          "under %g", w->tag, r, DC_SHORT_SEG);
+  }  /**  Against the wavelength  **/
+
+  thin = ek ? DC_THIN / DC_EK_FACTOR : DC_THIN;
+  thick = ek ? DC_THICK / DC_EK_FACTOR : DC_THICK;
+  r = seg / w->radius;
+  if (r < thick)
+    Add(report, true, w->tag, "tag %d has segments %.3g times its radius, "
+        "under %g", w->tag, r, thick);
+  else if (r < thin)
+    Add(report, false, w->tag, "tag %d has segments %.3g times its radius, "
+        "under %g", w->tag, r, thin);
+
+}  /**  End of CheckWire  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CheckTags                                 **/
+/**                                                                         **/
+/**  GW tags of each antenna in card order, and the tags and segments the   **/
+/**  written control cards name present; segs[tag] holds each deck tag's    **/
+/**  segments, -1 for a wall's.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void CheckTags(Ant *const *ants, int count, const int *segs, int tags,
+                     DC_Report *report) {
+
+  const Ant  *ant;     /**  Current antenna   **/
+  const char *card;    /**  Current card      **/
+  int         v[4];    /**  Card integers     **/
+  int         pair[4]; /**  Tags and segments **/
+  int         pairs;   /**  How many named    **/
+  int         total;   /**  Segments in all   **/
+  int         wire;    /**  GW cards so far   **/
+  int         k;       /**  Loop counter      **/
+  int         i;       /**  Loop counter      **/
+  int         j;       /**  Loop counter      **/
+
+  for (k = 0; k < count; k++) {
+    ant = ants[k];
+    for (i = 0, wire = 0; i < ant->card_count; i++)
+      if (ant->cards[i][0] == 'G' && ant->cards[i][1] == 'W' &&
+          sscanf(ant->cards[i] + 2, "%d", &v[0]) == 1 && ++wire != v[0] &&
+          v[0] != 0)
+        Add(report, false, v[0], "GW card %d has tag %d, but is written as "
+            "tag %d", wire, v[0], wire);
+  }  /**  Tags as written  **/
+
+  for (i = 1, total = 0; i <= tags; i++)
+    total += (segs[i] > 0) ? segs[i] : 0;
+  ant = ants[count - 1];
+  for (i = 0; i < ant->card_count; i++) {
+    card = ant->cards[i];
+    pairs = 0;
+    if (card[0] == 'E' && card[1] == 'X' &&
+        sscanf(card + 2, "%d%d%d", &v[0], &v[1], &v[2]) == 3 &&
+        (v[0] == 0 || v[0] == 5)) {
+      pair[0] = v[1];
+      pair[1] = v[2];
+      pairs = 1;
+    }  /**  Voltage source  **/
+    else if (card[0] == 'L' && card[1] == 'D' &&
+             sscanf(card + 2, "%d%d%d%d", &v[0], &v[1], &v[2], &v[3]) == 4 &&
+             v[0] >= 0) {
+      pair[0] = pair[2] = v[1];
+      pair[1] = v[2];
+      pair[3] = v[3];
+      pairs = 2;
+    }  /**  Load  **/
+    else if (((card[0] == 'N' && card[1] == 'T') ||
+              (card[0] == 'T' && card[1] == 'L')) &&
+             sscanf(card + 2, "%d%d%d%d", &v[0], &v[1], &v[2], &v[3]) == 4) {
+      for (j = 0; j < 4; j++)
+        pair[j] = v[j];
+      pairs = 2;
+    }  /**  Network or line  **/
+
+    for (j = 0; j < 2 * pairs; j += 2) {
+      if (pair[j] < 0 || pair[j] > tags)
+        Add(report, true, 0, "%.2s card names tag %d, which the deck does "
+            "not have", card, pair[j]);
+      else if (pair[j] == 0 && card[0] != 'L' &&
+               (pair[j + 1] < 1 || pair[j + 1] > total))
+        Add(report, true, 0, "%.2s card names segment %d, of %d in all",
+            card, pair[j + 1], total);
+      else if (pair[j] > 0 && segs[pair[j]] > 0 &&
+               (pair[j + 1] < 0 || pair[j + 1] > segs[pair[j]] ||
+                (pair[j + 1] == 0 && card[0] != 'L')))
+        Add(report, true, pair[j], "%.2s card names segment %d of tag %d, "
+            "which has %d", card, pair[j + 1], pair[j], segs[pair[j]]);
+    }  /**  For each tag named  **/
+  }  /**  For each card  **/
+
+}  /**  End of CheckTags  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                DC_Check                                 **/
+/**                                                                         **/
+/**  Checks the deck written for count antennas (one for WriteCardFile,     **/
+/**  all for WriteMultAntsFile, whose control cards are the last's) at      **/
+/**  freq MHz into report.  Returns the number of errors; a deck with any   **/
+/**  should not be solved.                                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int DC_Check(Ant *const *ants, int count, double freq, DC_Report *report) {
+
+  const Ant   *ant;         /**  Current antenna   **/
+  const Tube  *tube;        /**  Current tube      **/
+  Wire        *wires;       /**  The deck's wires  **/
+  Wire        *w;           /**  Current wire      **/
+  int         *segs;        /**  Per deck tag      **/
+  double       start;       /**  Timer start       **/
+  double       scale;       /**  Metres per unit   **/
+  double       off[3];      /**  Antenna's offset  **/
+  double       wavelength;  /**  Metres, 0 if none **/
+  bool         ek;          /**  Extended kernel   **/
+  int          n;           /**  Wires             **/
+  int          tags;        /**  Deck tags         **/
+  int          i;           /**  Loop counter      **/
+  int          j;           /**  Loop counter      **/
+  int          k;           /**  Loop counter      **/
+
+  start = TM_Start();
+  report->errors = report->warnings = report->kept = 0;
+  for (k = 0, tags = 0; k < count; k++)
+    for (tube = ants[k]->first_tube; tube != NULL; tube = tube->next)
+      tags++;
+  if (tags == 0) {
+    Add(report, true, 0, "the deck has no wires");
+    TM_Stop(TM_CHECK, start);
+    return report->errors;
+  }  /**  Nothing to write  **/
+  wires = (Wire *) malloc(tags * sizeof(Wire));
+  segs = (int *) malloc((tags + 1) * sizeof(int));
+  if (wires == NULL || segs == NULL) {
+    free(wires);
+    free(segs);
+    Add(report, true, 0, "no memory to check the deck");
+    TM_Stop(TM_CHECK, start);
+    return report->errors;
+  }  /**  No room  **/
+
+  ant = ants[count - 1];
+  scale = 100.0 * Scale(ant);
+  wavelength = (freq > 0.0) ? C_MHZ / freq : 0.0;
+  for (i = 0, ek = false; i < ant->card_count; i++)
+    if (ant->cards[i][0] == 'E' && ant->cards[i][1] == 'K' &&
+        atoi(ant->cards[i] + 2) >= 0)
+      ek = true;
+
+  /**  The wires as written, one tag per tube  **/
+  n = 0;
+  tags = 0;
+  for (k = 0; k < count; k++) {
+    off[0] = (count > 1) ? ants[k]->dx : 0.0;
+    off[1] = (count > 1) ? ants[k]->dy : 0.0;
+    off[2] = (count > 1) ? ants[k]->dz : 0.0;
+    for (tube = ants[k]->first_tube; tube != NULL; tube = tube->next) {
+      tags++;
+      if (tube->type != IS_TUBE) {
+        segs[tags] = -1;
+        continue;
+      }  /**  Walls are written their own way  **/
+      segs[tags] = tube->segments;
+      w = &wires[n++];
+      w->tag = tags;
+      w->segments = tube->segments;
+      w->a[0] = (tube->e1.x + off[0]) * scale;
+      w->a[1] = (tube->e1.y + off[1]) * scale;
+      w->a[2] = (tube->e1.z + off[2]) * scale;
+      w->b[0] = (tube->e2.x + off[0]) * scale;
+      w->b[1] = (tube->e2.y + off[1]) * scale;
+      w->b[2] = (tube->e2.z + off[2]) * scale;
+      w->radius = tube->width * scale;
+      for (i = 0; i < 3; i++) {
+        w->lo[i] = fmin(w->a[i], w->b[i]) - w->radius;
+        w->hi[i] = fmax(w->a[i], w->b[i]) + w->radius;
+      }  /**  Box  **/
+      CheckWire(w, wavelength, ek, report);
+    }  /**  For each tube  **/
+  }  /**  For each antenna  **/
+
+  /**  Pairs whose boxes overlap, swept along x  **/
+  qsort(wires, n, sizeof(Wire), CompareLo);
+  for (i = 0; i < n; i++)
+    for (j = i + 1; j < n && wires[j].lo[0] <= wires[i].hi[0]; j++)
+      if (wires[j].lo[1] <= wires[i].hi[1] &&
+          wires[i].lo[1] <= wires[j].hi[1] &&
+          wires[j].lo[2] <= wires[i].hi[2] &&
+          wires[i].lo[2] <= wires[j].hi[2] &&
+          wires[i].segments > 0 && wires[j].segments > 0 &&
+          Length(&wires[i]) > 0.0 && Length(&wires[j]) > 0.0)
+        Contact(&wires[i], &wires[j], report);
+
+  CheckTags(ants, count, segs, tags, report);
+  free(wires);
+  free(segs);
+  TM_Stop(TM_CHECK, start);
+  return report->errors;
+
+}  /**  End of DC_Check  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                DC_Print                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void DC_Print(FILE *f, const DC_Report *report) {
+
+  int  i;  /**  Loop counter  **/
+
+  if (report->errors + report->warnings == 0)
+    return;
+  fprintf(f, "Deck check: %d error%s, %d warning%s\n", report->errors,
+          (report->errors == 1) ? "" : "s", report->warnings,
+          (report->warnings == 1) ? "" : "s");
+  for (i = 0; i < report->kept; i++)
+    fprintf(f, "  %s: %s\n", report->issues[i].error ? "error" : "warning",
+            report->issues[i].text);
+  if (report->errors + report->warnings > report->kept)
+    fprintf(f, "  ..and %d more\n",
+            report->errors + report->warnings - report->kept);
+
+}  /**  End of DC_Print  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              DC_FirstError                              **/
+/**                                                                         **/
+/**  The first error kept, NULL if none was.                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+const char *DC_FirstError(const DC_Report *report) {
+
+  int  i;  /**  Loop counter  **/
+
+  for (i = 0; i < report->kept; i++)
+    if (report->issues[i].error)
+      return report->issues[i].text;
+  return NULL;
+
+}  /**  End of DC_FirstError  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of DeckCheck.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
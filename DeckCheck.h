@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DECKCHECK_H
+#define DECKCHECK_H
+
+#include <stdio.h>
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  DC_MAX_ISSUES   16       /**  Kept in a report, the rest counted   **/
+#define  DC_LONG_SEG     0.1      /**  Wavelengths, longer segments warn    **/
+#define  DC_MAX_SEG      0.25     /**    ..and longer still are refused    **/
+#define  DC_SHORT_SEG    1.0e-3   /**  Shorter segments warn                **/
+#define  DC_MIN_SEG      1.0e-4   /**    ..and shorter still are refused   **/
+#define  DC_THIN         8.0      /**  Segment over radius, less warns      **/
+#define  DC_THICK        2.0      /**    ..and less still is refused       **/
+#define  DC_EK_FACTOR    4.0      /**  Extended kernel divides both by      **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct DC_Issue {
+  bool  error;      /**  Refused, else a warning         **/
+  int   tag;        /**  Deck tag it is about, 0 if none **/
+  char  text[96];   /**  What is wrong                   **/
+} DC_Issue;
+
+typedef struct DC_Report {
+  int       errors;                 /**  Issues that refuse the deck  **/
+  int       warnings;               /**  Issues that only warn        **/
+  int       kept;                   /**  In issues                    **/
+  DC_Issue  issues[DC_MAX_ISSUES];  /**  The first found              **/
+} DC_Report;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int   DC_Check(Ant *const *, int, double, DC_Report *);
+void  DC_Print(FILE *, const DC_Report *);
+const char *DC_FirstError(const DC_Report *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of DeckCheck.h                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,940 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Far field of the segment currents of the last solve, computed here
+ *  rather than by running nec2 again with another RP card.  Each segment
+ *  is taken as a short current element at its centre p, along the vector
+ *  l from one end to the other, so in direction r the field is
+ *
+ *    E = -j eta k / (4 pi) * sum of I (l - (l.r) r) exp(j k r.p)
+ *
+ *  as NEC prints it: times the range, with exp(-jkr) dropped.  With
+ *  segments short against the wavelength this agrees closely with NEC's
+ *  own pattern.  Only free space is done, which is what WriteCardFile
+ *  asks nec2 for too (it drops GN cards).
+ *
+ *  The sum over segments is the whole cost.  It runs FF_BLOCK directions
+ *  at a time, with the sine and cosine of the phase from a polynomial, 4
+ *  (SSE2) or 8 (AVX2) lanes wide on whichever kernel PatKernel.c picked,
+ *  and the blocks of a grid are spread over the WorkPool.c threads.  The
+ *  projection onto theta and phi, the gains and the polarisation are per
+ *  direction and are done in double precision afterwards.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "PatKernel.h"
+#include "WorkPool.h"
+#include "FarField.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FF_HAVE_X86
+#include <immintrin.h>
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  DEG           (M_PI / 180.0)  /**  Radians per degree            **/
+#define  POWER_STEP    2.0             /**  Degrees, FF_RadiatedPower     **/
+#define  NULL_POWER    1.0e-100        /**  Ratio printed as FF_NULL_DB   **/
+#define  LINEAR_RATIO  1.0e-5          /**  Axial ratio NEC calls linear  **/
+
+/**  x - n pi/2 in three parts, then sin and cos on [-pi/4, pi/4] (Cephes)  **/
+#define  TWO_OVER_PI   0.63661977236758134f
+#define  PIO2_A        1.5703125f
+#define  PIO2_B        4.837512969970703125e-4f
+#define  PIO2_C        7.54978995489188216e-8f
+#define  SIN_C1        -1.6666654611e-1f
+#define  SIN_C2        8.3321608736e-3f
+#define  SIN_C3        -1.9515295891e-4f
+#define  COS_C1        4.166664568298827e-2f
+#define  COS_C2        -1.388731625493765e-3f
+#define  COS_C3        2.443315711809948e-5f
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Typedefs                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Grid {
+  const FF_Sources  *src;     /**  The segments                       **/
+  float             *kx;      /**  Segment centres times k            **/
+  float             *ky;
+  float             *kz;
+  double            *st;      /**  sin, cos of each column's theta    **/
+  double            *ct;
+  double            *sp;      /**  sin, cos of each row's phi         **/
+  double            *cp;
+  double             k;       /**  Wavenumber, per metre              **/
+  double             norm;    /**  Gain ratio per |E|^2, 0 for none   **/
+  double             theta0;  /**  First sample, degrees              **/
+  double             phi0;
+  double             step;    /**  Degrees between samples            **/
+  int                rows;    /**  Phi samples                        **/
+  int                cols;    /**  Theta samples in each row          **/
+  FieldVal          *vals;    /**  Output, rows * cols                 **/
+} Grid;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             SumScalar                                   **/
+/**                                                                         **/
+/**  Reference kernel: the sum of I l exp(j k r.p) over every segment for   **/
+/**  FF_BLOCK directions, in double precision through libm.  acc gets the   **/
+/**  x, y and z components, real then imaginary, one row per lane.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SumScalar(const Grid *g, const float *dx, const float *dy, 
+                     const float *dz, float acc[6][FF_BLOCK]) {
+
+  const FF_Sources  *src = g->src;  /**  Shorthand        **/
+  double  sum[6];                   /**  One lane's sums  **/
+  double  psi;                      /**  Phase, radians   **/
+  double  c;                        /**  Its cosine       **/
+  double  s;                        /**    ..and sine     **/
+  double  wr;                       /**  I exp(j psi)     **/
+  double  wi;
+  int     lane;                     /**  Loop counter     **/
+  int     i;                        /**  Loop counter     **/
+
+  for (lane = 0; lane < FF_BLOCK; lane++) {
+    memset(sum, 0, sizeof(sum));
+    for (i = 0; i < src->count; i++) {
+      psi = (double) g->kx[i] * dx[lane] + (double) g->ky[i] * dy[lane] + 
+            (double) g->kz[i] * dz[lane];
+      c = cos(psi);
+      s = sin(psi);
+      wr = src->re[i] * c - src->im[i] * s;
+      wi = src->re[i] * s + src->im[i] * c;
+      sum[0] += wr * src->lx[i];
+      sum[1] += wi * src->lx[i];
+      sum[2] += wr * src->ly[i];
+      sum[3] += wi * src->ly[i];
+      sum[4] += wr * src->lz[i];
+      sum[5] += wi * src->lz[i];
+    }  /**  For each segment  **/
+    for (i = 0; i < 6; i++)
+      acc[i][lane] = sum[i];
+  }  /**  For each lane  **/
+
+}  /**  End of SumScalar  **/
+
+
+#ifdef FF_HAVE_X86
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SinCosSSE2                                 **/
+/**                                                                         **/
+/**  Sine and cosine of four angles.  The nearest multiple n of pi/2 is     **/
+/**  taken off, the polynomials give sin and cos of what is left, and the   **/
+/**  low two bits of n swap them and set the signs.  Good to a few parts   **/
+/**  in 10^7 for the phases a pattern needs.                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("sse2")))
+local void SinCosSSE2(__m128 x, __m128 *sine, __m128 *cosine) {
+
+  __m128i  n;     /**  Quadrant            **/
+  __m128   fn;    /**    ..as a float      **/
+  __m128   y;     /**  Reduced angle       **/
+  __m128   y2;    /**    ..squared         **/
+  __m128   ps;    /**  sin(y)              **/
+  __m128   pc;    /**  cos(y)              **/
+  __m128   swap;  /**  Odd quadrants       **/
+  __m128   s;     /**  Unsigned results    **/
+  __m128   c;
+
+  n  = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+  fn = _mm_cvtepi32_ps(n);
+  y  = _mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(PIO2_A)));
+  y  = _mm_sub_ps(y, _mm_mul_ps(fn, _mm_set1_ps(PIO2_B)));
+  y  = _mm_sub_ps(y, _mm_mul_ps(fn, _mm_set1_ps(PIO2_C)));
+  y2 = _mm_mul_ps(y, y);
+
+  ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_C3), y2), _mm_set1_ps(SIN_C2));
+  ps = _mm_add_ps(_mm_mul_ps(ps, y2), _mm_set1_ps(SIN_C1));
+  ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, y2), y), y);
+
+  pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_C3), y2), _mm_set1_ps(COS_C2));
+  pc = _mm_add_ps(_mm_mul_ps(pc, y2), _mm_set1_ps(COS_C1));
+  pc = _mm_mul_ps(_mm_mul_ps(pc, y2), y2);
+  pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(y2, _mm_set1_ps(0.5f))),
+                  _mm_set1_ps(1.0f));
+
+  swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+           _mm_and_si128(n, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  s = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+  c = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+  *sine = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(
+            _mm_and_si128(n, _mm_set1_epi32(2)), 30)));
+  *cosine = _mm_xor_ps(c, _mm_castsi128_ps(_mm_slli_epi32(
+              _mm_and_si128(_mm_add_epi32(n, _mm_set1_epi32(1)),
+                            _mm_set1_epi32(2)), 30)));
+
+}  /**  End of SinCosSSE2  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SumSSE2                                  **/
+/**                                                                         **/
+/**  SumScalar four directions at a time, in single precision.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("sse2")))
+local void SumSSE2(const Grid *g, const float *dx, const float *dy, 
+                   const float *dz, float acc[6][FF_BLOCK]) {
+
+  const FF_Sources  *src = g->src;  /**  Shorthand          **/
+  __m128  vdx;                      /**  Directions         **/
+  __m128  vdy;
+  __m128  vdz;
+  __m128  a[6];                     /**  Sums               **/
+  __m128  psi;                      /**  Phases             **/
+  __m128  s;                        /**  Their sines        **/
+  __m128  c;                        /**    ..and cosines    **/
+  __m128  re;                       /**  Segment current    **/
+  __m128  im;
+  __m128  wr;                       /**  I exp(j psi)       **/
+  __m128  wi;
+  __m128  l;                        /**  Segment component  **/
+  int     h;                        /**  First lane         **/
+  int     i;                        /**  Loop counter       **/
+
+  for (h = 0; h < FF_BLOCK; h += 4) {
+    vdx = _mm_loadu_ps(dx + h);
+    vdy = _mm_loadu_ps(dy + h);
+    vdz = _mm_loadu_ps(dz + h);
+    for (i = 0; i < 6; i++)
+      a[i] = _mm_setzero_ps();
+
+    for (i = 0; i < src->count; i++) {
+      psi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(g->kx[i]), vdx),
+                                  _mm_mul_ps(_mm_set1_ps(g->ky[i]), vdy)),
+                       _mm_mul_ps(_mm_set1_ps(g->kz[i]), vdz));
+      SinCosSSE2(psi, &s, &c);
+      re = _mm_set1_ps(src->re[i]);
+      im = _mm_set1_ps(src->im[i]);
+      wr = _mm_sub_ps(_mm_mul_ps(re, c), _mm_mul_ps(im, s));
+      wi = _mm_add_ps(_mm_mul_ps(re, s), _mm_mul_ps(im, c));
+      l = _mm_set1_ps(src->lx[i]);
+      a[0] = _mm_add_ps(a[0], _mm_mul_ps(wr, l));
+      a[1] = _mm_add_ps(a[1], _mm_mul_ps(wi, l));
+      l = _mm_set1_ps(src->ly[i]);
+      a[2] = _mm_add_ps(a[2], _mm_mul_ps(wr, l));
+      a[3] = _mm_add_ps(a[3], _mm_mul_ps(wi, l));
+      l = _mm_set1_ps(src->lz[i]);
+      a[4] = _mm_add_ps(a[4], _mm_mul_ps(wr, l));
+      a[5] = _mm_add_ps(a[5], _mm_mul_ps(wi, l));
+    }  /**  For each segment  **/
+
+    for (i = 0; i < 6; i++)
+      _mm_storeu_ps(acc[i] + h, a[i]);
+  }  /**  For each group of 4  **/
+
+}  /**  End of SumSSE2  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SinCosAVX2                                 **/
+/**                                                                         **/
+/**  SinCosSSE2 on eight angles, with fused multiply-adds.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("avx2,fma")))
+local void SinCosAVX2(__m256 x, __m256 *sine, __m256 *cosine) {
+
+  __m256i  n;     /**  Quadrant            **/
+  __m256   fn;    /**    ..as a float      **/
+  __m256   y;     /**  Reduced angle       **/
+  __m256   y2;    /**    ..squared         **/
+  __m256   ps;    /**  sin(y)              **/
+  __m256   pc;    /**  cos(y)              **/
+  __m256   swap;  /**  Odd quadrants       **/
+
+  n  = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)));
+  fn = _mm256_cvtepi32_ps(n);
+  y  = _mm256_fnmadd_ps(fn, _mm256_set1_ps(PIO2_A), x);
+  y  = _mm256_fnmadd_ps(fn, _mm256_set1_ps(PIO2_B), y);
+  y  = _mm256_fnmadd_ps(fn, _mm256_set1_ps(PIO2_C), y);
+  y2 = _mm256_mul_ps(y, y);
+
+  ps = _mm256_fmadd_ps(_mm256_set1_ps(SIN_C3), y2, _mm256_set1_ps(SIN_C2));
+  ps = _mm256_fmadd_ps(ps, y2, _mm256_set1_ps(SIN_C1));
+  ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, y2), y, y);
+
+  pc = _mm256_fmadd_ps(_mm256_set1_ps(COS_C3), y2, _mm256_set1_ps(COS_C2));
+  pc = _mm256_fmadd_ps(pc, y2, _mm256_set1_ps(COS_C1));
+  pc = _mm256_mul_ps(_mm256_mul_ps(pc, y2), y2);
+  pc = _mm256_add_ps(_mm256_fnmadd_ps(y2, _mm256_set1_ps(0.5f), pc),
+                     _mm256_set1_ps(1.0f));
+
+  swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+           _mm256_and_si256(n, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+  *sine = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap),
+                        _mm256_castsi256_ps(_mm256_slli_epi32(
+                          _mm256_and_si256(n, _mm256_set1_epi32(2)), 30)));
+  *cosine = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap),
+                          _mm256_castsi256_ps(_mm256_slli_epi32(
+                            _mm256_and_si256(
+                              _mm256_add_epi32(n, _mm256_set1_epi32(1)),
+                              _mm256_set1_epi32(2)), 30)));
+
+}  /**  End of SinCosAVX2  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SumAVX2                                  **/
+/**                                                                         **/
+/**  SumScalar all eight directions at once.                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("avx2,fma")))
+local void SumAVX2(const Grid *g, const float *dx, const float *dy, 
+                   const float *dz, float acc[6][FF_BLOCK]) {
+
+  const FF_Sources  *src = g->src;  /**  Shorthand          **/
+  __m256  vdx;                      /**  Directions         **/
+  __m256  vdy;
+  __m256  vdz;
+  __m256  a[6];                     /**  Sums               **/
+  __m256  psi;                      /**  Phases             **/
+  __m256  s;                        /**  Their sines        **/
+  __m256  c;                        /**    ..and cosines    **/
+  __m256  re;                       /**  Segment current    **/
+  __m256  im;
+  __m256  wr;                       /**  I exp(j psi)       **/
+  __m256  wi;
+  __m256  l;                        /**  Segment component  **/
+  int     i;                        /**  Loop counter       **/
+
+  vdx = _mm256_loadu_ps(dx);
+  vdy = _mm256_loadu_ps(dy);
+  vdz = _mm256_loadu_ps(dz);
+  for (i = 0; i < 6; i++)
+    a[i] = _mm256_setzero_ps();
+
+  for (i = 0; i < src->count; i++) {
+    psi = _mm256_mul_ps(_mm256_set1_ps(g->kx[i]), vdx);
+    psi = _mm256_fmadd_ps(_mm256_set1_ps(g->ky[i]), vdy, psi);
+    psi = _mm256_fmadd_ps(_mm256_set1_ps(g->kz[i]), vdz, psi);
+    SinCosAVX2(psi, &s, &c);
+    re = _mm256_set1_ps(src->re[i]);
+    im = _mm256_set1_ps(src->im[i]);
+    wr = _mm256_fmsub_ps(re, c, _mm256_mul_ps(im, s));
+    wi = _mm256_fmadd_ps(re, s, _mm256_mul_ps(im, c));
+    l = _mm256_set1_ps(src->lx[i]);
+    a[0] = _mm256_fmadd_ps(wr, l, a[0]);
+    a[1] = _mm256_fmadd_ps(wi, l, a[1]);
+    l = _mm256_set1_ps(src->ly[i]);
+    a[2] = _mm256_fmadd_ps(wr, l, a[2]);
+    a[3] = _mm256_fmadd_ps(wi, l, a[3]);
+    l = _mm256_set1_ps(src->lz[i]);
+    a[4] = _mm256_fmadd_ps(wr, l, a[4]);
+    a[5] = _mm256_fmadd_ps(wi, l, a[5]);
+  }  /**  For each segment  **/
+
+  for (i = 0; i < 6; i++)
+    _mm256_storeu_ps(acc[i], a[i]);
+
+}  /**  End of SumAVX2  **/
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 ToDb                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double ToDb(double ratio) {
+
+  return (ratio > NULL_POWER) ? 10.0 * log10(ratio) : FF_NULL_DB;
+
+}  /**  End of ToDb  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FF_FillValue                               **/
+/**                                                                         **/
+/**  Fills the field part of a sample from its complex theta and phi        **/
+/**  fields, in volts as NEC prints them: magnitudes and phases, gains      **/
+/**  (norm turns |E|^2 into a gain ratio), and the polarisation ellipse     **/
+/**  the way NEC works it out -- tilt from the theta axis, minor over       **/
+/**  major axis, and the sense from which component leads.  The angles      **/
+/**  are left to the caller.                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FF_FillValue(double eth_re, double eth_im, double eph_re, 
+                  double eph_im, double norm, FieldVal *v) {
+
+  double  eth2;        /**  |E theta|^2           **/
+  double  eph2;        /**  |E phi|^2             **/
+  double  dfaz;        /**  Phase of phi - theta  **/
+  double  t1, t2;      /**  Ellipse terms         **/
+  double  tilt;        /**  Radians               **/
+  double  emaj, emin;  /**  Axes squared          **/
+
+  eth2 = eth_re * eth_re + eth_im * eth_im;
+  eph2 = eph_re * eph_re + eph_im * eph_im;
+  v->theta_mag = sqrt(eth2);
+  v->theta_phase = atan2(eth_im, eth_re) / DEG;
+  v->phi_mag = sqrt(eph2);
+  v->phi_phase = atan2(eph_im, eph_re) / DEG;
+
+  v->vert_gain = ToDb(norm * eth2);
+  v->hor_gain = ToDb(norm * eph2);
+  v->total_gain = ToDb(norm * (eth2 + eph2));
+
+  dfaz = (v->phi_phase - v->theta_phase) * DEG;
+  t1 = eth2 - eph2;
+  t2 = 2.0 * v->theta_mag * v->phi_mag * cos(dfaz);
+  tilt = 0.5 * atan2(t2, t1);
+  emaj = -t1 * sin(tilt) * sin(tilt) + t2 * sin(tilt) * cos(tilt) + eth2;
+  emin = t1 * sin(tilt) * sin(tilt) - t2 * sin(tilt) * cos(tilt) + eph2;
+  if (emin < 0.0)
+    emin = 0.0;
+  v->axial_ratio = (emaj > 0.0) ? sqrt(emin / emaj) : 0.0;
+  v->tilt = tilt / DEG;
+  if (v->axial_ratio <= LINEAR_RATIO)
+    v->sense = LINEAR;
+  else
+    v->sense = (sin(dfaz) > 0.0) ? LEFT : RIGHT;
+
+}  /**  End of FF_FillValue  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FillValue                                 **/
+/**                                                                         **/
+/**  One sample of the pattern from the sums for its direction.             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void FillValue(const Grid *g, int row, int col, const double a[6],
+                     FieldVal *v) {
+
+  double  st, ct;      /**  sin, cos of theta     **/
+  double  sp, cp;      /**  sin, cos of phi       **/
+  double  scale;       /**  eta k / 4 pi          **/
+  double  tr, ti;      /**  Sum along theta hat   **/
+  double  pr, pi;      /**  Sum along phi hat     **/
+
+  st = g->st[col];
+  ct = g->ct[col];
+  sp = g->sp[row];
+  cp = g->cp[row];
+  scale = FF_ETA0 * g->k / (4.0 * M_PI);
+
+  tr = a[0] * ct * cp + a[2] * ct * sp - a[4] * st;
+  ti = a[1] * ct * cp + a[3] * ct * sp - a[5] * st;
+  pr = -a[0] * sp + a[2] * cp;
+  pi = -a[1] * sp + a[3] * cp;
+
+  /**  E = -j scale A  **/
+  v->theta = g->theta0 + col * g->step;
+  v->phi = g->phi0 + row * g->step;
+  FF_FillValue(scale * ti, -scale * tr, scale * pi, -scale * pr, g->norm, v);
+
+}  /**  End of FillValue  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Band                                    **/
+/**                                                                         **/
+/**  WP_Run callback: blocks first to last-1 of FF_BLOCK samples each, in   **/
+/**  the order of the vals array.  A short last block repeats its final     **/
+/**  direction in the spare lanes and throws those away.                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Band(void *arg, int first, int last) {
+
+  const Grid  *g = arg;                 /**  The job             **/
+  float        dx[FF_BLOCK];            /**  Directions          **/
+  float        dy[FF_BLOCK];
+  float        dz[FF_BLOCK];
+  int          row[FF_BLOCK];           /**  Their grid place    **/
+  int          col[FF_BLOCK];
+  float        acc[6][FF_BLOCK];        /**  Sums per direction  **/
+  double       a[6];                    /**  One lane's sums     **/
+  long         n;                       /**  Samples in all      **/
+  long         i;                       /**  Sample index        **/
+  int          block;                   /**  Loop counter        **/
+  int          lane;                    /**  Loop counter        **/
+  int          j;                       /**  Loop counter        **/
+
+  n = (long) g->rows * g->cols;
+  for (block = first; block < last; block++) {
+    for (lane = 0; lane < FF_BLOCK; lane++) {
+      i = (long) block * FF_BLOCK + lane;
+      if (i >= n)
+        i = n - 1;
+      row[lane] = i / g->cols;
+      col[lane] = i % g->cols;
+      dx[lane] = g->st[col[lane]] * g->cp[row[lane]];
+      dy[lane] = g->st[col[lane]] * g->sp[row[lane]];
+      dz[lane] = g->ct[col[lane]];
+    }  /**  Directions of the block  **/
+
+    switch (PK_ActiveKernel()) {
+#ifdef FF_HAVE_X86
+      case PK_AVX2:
+        SumAVX2(g, dx, dy, dz, acc);
+        break;
+      case PK_SSE2:
+        SumSSE2(g, dx, dy, dz, acc);
+        break;
+#endif
+      default:
+        SumScalar(g, dx, dy, dz, acc);
+        break;
+    }  /**  Switch on kernel  **/
+
+    for (lane = 0; lane < FF_BLOCK; lane++) {
+      i = (long) block * FF_BLOCK + lane;
+      if (i >= n)
+        break;
+      for (j = 0; j < 6; j++)
+        a[j] = acc[j][lane];
+      FillValue(g, row[lane], col[lane], a, &g->vals[i]);
+    }  /**  Samples of the block  **/
+  }  /**  For each block  **/
+
+}  /**  End of Band  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Compute                                  **/
+/**                                                                         **/
+/**  Fills vals with a rows x cols grid, theta along a row and phi between  **/
+/**  rows as NEC prints it.  norm turns |E|^2 into a gain ratio.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Compute(const FF_Sources *src, double freq, double norm,
+                   double theta0, double phi0, double step, int cols,
+                   int rows, FieldVal *vals) {
+
+  Grid  g;     /**  The job       **/
+  bool  done;  /**  Memory found  **/
+  int   i;     /**  Loop counter  **/
+
+  g.src = src;
+  g.k = 2.0 * M_PI * freq / FF_C;
+  g.norm = norm;
+  g.theta0 = theta0;
+  g.phi0 = phi0;
+  g.step = step;
+  g.rows = rows;
+  g.cols = cols;
+  g.vals = vals;
+  g.kx = malloc(src->count * sizeof(float));
+  g.ky = malloc(src->count * sizeof(float));
+  g.kz = malloc(src->count * sizeof(float));
+  g.st = malloc(cols * sizeof(double));
+  g.ct = malloc(cols * sizeof(double));
+  g.sp = malloc(rows * sizeof(double));
+  g.cp = malloc(rows * sizeof(double));
+  done = g.kx != NULL && g.ky != NULL && g.kz != NULL && g.st != NULL &&
+         g.ct != NULL && g.sp != NULL && g.cp != NULL;
+
+  if (done) {
+    for (i = 0; i < src->count; i++) {
+      g.kx[i] = g.k * src->x[i];
+      g.ky[i] = g.k * src->y[i];
+      g.kz[i] = g.k * src->z[i];
+    }  /**  Phase per unit direction  **/
+    for (i = 0; i < cols; i++) {
+      g.st[i] = sin((theta0 + i * step) * DEG);
+      g.ct[i] = cos((theta0 + i * step) * DEG);
+    }  /**  Each theta  **/
+    for (i = 0; i < rows; i++) {
+      g.sp[i] = sin((phi0 + i * step) * DEG);
+      g.cp[i] = cos((phi0 + i * step) * DEG);
+    }  /**  Each phi  **/
+    PK_ActiveKernel();
+    WP_Run(Band, &g, (int) (((long) rows * cols + FF_BLOCK - 1) / FF_BLOCK));
+  }  /**  Have the memory  **/
+
+  free(g.kx);
+  free(g.ky);
+  free(g.kz);
+  free(g.st);
+  free(g.ct);
+  free(g.sp);
+  free(g.cp);
+  return done;
+
+}  /**  End of Compute  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FF_Gather                                 **/
+/**                                                                         **/
+/**  Collects the segments of every wire that has currents from the last   **/
+/**  solve, in metres as the deck gives them to nec2 (a GS card scales      **/
+/**  them).  Returns false, with src empty, if there are none.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool FF_Gather(const Ant *ant, FF_Sources *src) {
+
+  const Tube         *tube;    /**  Tube traversal          **/
+  const SegmentData  *seg;     /**  Its currents            **/
+  double              scale;   /**  Tube units to metres    **/
+  double              gs;      /**  GS card factor          **/
+  double              d[3];    /**  Segment vector          **/
+  int                 dummy;   /**  Fields we ignore        **/
+  int                 count;   /**  Segments with currents  **/
+  int                 n;       /**  Segments filled         **/
+  int                 i;       /**  Loop counter            **/
+
+  memset(src, 0, sizeof(FF_Sources));
+  gs = 1.0;
+  for (i = 0; i < ant->card_count; i++)
+    if (ant->cards[i][0] == 'G' && ant->cards[i][1] == 'S' &&
+        (sscanf(ant->cards[i] + 2, "%d%d%lf", &dummy, &dummy, &gs) != 3 ||
+         gs <= 0.0))
+      gs = 1.0;
+  scale = 100.0 * gs;
+
+  count = 0;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+    if (tube->type == IS_TUBE && tube->currents != NULL && tube->segments > 0)
+      count += tube->segments;
+  if (count == 0)
+    return false;
+
+  src->x = malloc(count * sizeof(float));
+  src->y = malloc(count * sizeof(float));
+  src->z = malloc(count * sizeof(float));
+  src->lx = malloc(count * sizeof(float));
+  src->ly = malloc(count * sizeof(float));
+  src->lz = malloc(count * sizeof(float));
+  src->re = malloc(count * sizeof(float));
+  src->im = malloc(count * sizeof(float));
+  if (src->x == NULL || src->y == NULL || src->z == NULL ||
+      src->lx == NULL || src->ly == NULL || src->lz == NULL ||
+      src->re == NULL || src->im == NULL) {
+    FF_Free(src);
+    return false;
+  }  /**  Out of memory  **/
+
+  n = 0;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next) {
+    if (tube->type != IS_TUBE || tube->currents == NULL || 
+        tube->segments <= 0)
+      continue;
+    d[0] = (tube->e2.x - tube->e1.x) * scale / tube->segments;
+    d[1] = (tube->e2.y - tube->e1.y) * scale / tube->segments;
+    d[2] = (tube->e2.z - tube->e1.z) * scale / tube->segments;
+    for (i = 0, seg = tube->currents; i < tube->segments && seg != NULL;
+         i++, seg = seg->next) {
+      src->x[n] = tube->e1.x * scale + (i + 0.5) * d[0];
+      src->y[n] = tube->e1.y * scale + (i + 0.5) * d[1];
+      src->z[n] = tube->e1.z * scale + (i + 0.5) * d[2];
+      src->lx[n] = d[0];
+      src->ly[n] = d[1];
+      src->lz[n] = d[2];
+      src->re[n] = seg->currentMagnitude * cos(seg->currentPhase * DEG);
+      src->im[n] = seg->currentMagnitude * sin(seg->currentPhase * DEG);
+      n++;
+    }  /**  For each segment  **/
+  }  /**  For each tube  **/
+  src->count = n;
+
+  return n > 0;
+
+}  /**  End of FF_Gather  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FF_Free                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FF_Free(FF_Sources *src) {
+
+  free(src->x);
+  free(src->y);
+  free(src->z);
+  free(src->lx);
+  free(src->ly);
+  free(src->lz);
+  free(src->re);
+  free(src->im);
+  memset(src, 0, sizeof(FF_Sources));
+
+}  /**  End of FF_Free  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           FF_RadiatedPower                              **/
+/**                                                                         **/
+/**  Watts radiated by the sources at freq MHz: |E|^2 / 2 eta over the      **/
+/**  sphere, by the midpoint rule on a POWER_STEP degree grid.  Negative    **/
+/**  if it cannot be computed.                                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double FF_RadiatedPower(const FF_Sources *src, double freq) {
+
+  FieldVal  *vals;    /**  Scratch grid          **/
+  double     power;   /**  Running sum           **/
+  int        thetas;  /**  Samples in theta      **/
+  int        phis;    /**    ..and phi           **/
+  int        i;       /**  Loop counter          **/
+
+  thetas = (int) (180.0 / POWER_STEP + 0.5);
+  phis = 2 * thetas;
+  if (src->count == 0 || freq <= 0.0 ||
+      (vals = malloc((size_t) thetas * phis * sizeof(FieldVal))) == NULL)
+    return -1.0;
+  if (!Compute(src, freq, 0.0, POWER_STEP / 2, 0.0, POWER_STEP, thetas, 
+               phis, vals)) {
+    free(vals);
+    return -1.0;
+  }  /**  Out of memory  **/
+
+  power = 0.0;
+  for (i = 0; i < thetas * phis; i++)
+    power += (vals[i].theta_mag * vals[i].theta_mag + 
+              vals[i].phi_mag * vals[i].phi_mag) * sin(vals[i].theta * DEG);
+  free(vals);
+  return power * POWER_STEP * POWER_STEP * DEG * DEG / (2.0 * FF_ETA0);
+
+}  /**  End of FF_RadiatedPower  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FF_Ranges                                 **/
+/**                                                                         **/
+/**  Sets the gain, tilt and axial ratio ranges of a filled FieldData.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FF_Ranges(FieldData *fd) {
+
+  const FieldVal  *v;  /**  Sample traversal  **/
+  int              i;  /**  Loop counter      **/
+
+  if (fd->count < 1)
+    return;
+  v = fd->vals;
+  fd->maxgain = fd->mingain = v[0].total_gain;
+  fd->maxtilt = fd->mintilt = v[0].tilt;
+  fd->maxaxialratio = fd->minaxialratio = v[0].axial_ratio;
+  for (i = 1; i < fd->count; i++) {
+    if (v[i].total_gain > fd->maxgain)
+      fd->maxgain = v[i].total_gain;
+    if (v[i].total_gain < fd->mingain)
+      fd->mingain = v[i].total_gain;
+    if (v[i].tilt > fd->maxtilt)
+      fd->maxtilt = v[i].tilt;
+    if (v[i].tilt < fd->mintilt)
+      fd->mintilt = v[i].tilt;
+    if (v[i].axial_ratio > fd->maxaxialratio)
+      fd->maxaxialratio = v[i].axial_ratio;
+    if (v[i].axial_ratio < fd->minaxialratio)
+      fd->minaxialratio = v[i].axial_ratio;
+  }  /**  Ranges  **/
+
+}  /**  End of FF_Ranges  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FF_Residual                                **/
+/**                                                                         **/
+/**  How far, in dB, a pattern from the single precision kernels is from    **/
+/**  the reference NEC printed for the same grid: the largest difference    **/
+/**  in total gain over the samples within range dB of the reference's      **/
+/**  peak.  Nulls are left out; their depth depends on rounding in both.    **/
+/**  -1 if the grids are not the same.                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double FF_Residual(const FieldData *ref, const FieldData *test, double range) {
+
+  const FieldVal  *r;      /**  Reference sample  **/
+  const FieldVal  *t;      /**  Tested sample     **/
+  double           floor;  /**  Lowest compared   **/
+  double           worst;  /**  Result            **/
+  int              i;      /**  Loop counter      **/
+
+  if (ref->count < 1 || ref->count != test->count)
+    return -1.0;
+  floor = ref->maxgain - range;
+  worst = 0.0;
+  for (i = 0; i < ref->count; i++) {
+    r = &ref->vals[i];
+    t = &test->vals[i];
+    if (fabs(r->theta - t->theta) > 1e-3 || fabs(r->phi - t->phi) > 1e-3)
+      return -1.0;
+    if (r->total_gain < floor)
+      continue;
+    if (fabs(r->total_gain - t->total_gain) > worst)
+      worst = fabs(r->total_gain - t->total_gain);
+  }  /**  For each sample  **/
+  return worst;
+
+}  /**  End of FF_Residual  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FF_Pattern                                **/
+/**                                                                         **/
+/**  Fills fd with the pattern of the sources at freq MHz on a grid of      **/
+/**  thetas x phis samples step degrees apart from (theta0, phi0), in the   **/
+/**  order ParseFieldData reads NEC's, along with its gain, tilt and axial  **/
+/**  ratio ranges.  Gains are over power watts, the input power of the      **/
+/**  solve, as NEC's are; with power 0 they are over the radiated power,    **/
+/**  that is directivities.  The serial is left to the caller.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool FF_Pattern(const FF_Sources *src, double freq, double power, 
+                double theta0, double phi0, double step, int thetas, 
+                int phis, FieldData *fd) {
+
+  FieldVal  *vals;  /**  Grown sample array  **/
+  long       n;     /**  Samples             **/
+
+  n = (long) thetas * phis;
+  if (src->count == 0 || freq <= 0.0 || step <= 0.0 || thetas < 1 || 
+      phis < 1 || n > FF_MAX_SAMPLES)
+    return false;
+  if (power <= 0.0 && (power = FF_RadiatedPower(src, freq)) <= 0.0)
+    return false;
+  if ((vals = realloc(fd->vals, n * sizeof(FieldVal))) == NULL)
+    return false;
+  fd->vals = vals;
+  if (!Compute(src, freq, 2.0 * M_PI / (FF_ETA0 * power), theta0, phi0, 
+               step, thetas, phis, vals))
+    return false;
+
+  fd->count = n;
+  FF_Ranges(fd);
+
+  return true;
+
+}  /**  End of FF_Pattern  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of FarField.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
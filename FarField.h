@@ -0,0 +1,103 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FAR_FIELD_H
+#define FAR_FIELD_H
+
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  FF_NULL_DB      -999.99      /**  NEC's gain for a null             **/
+#define  FF_ETA0         376.730      /**  Impedance of free space, ohms     **/
+#define  FF_C            299.792458   /**  Speed of light, metres per us     **/
+#define  FF_NEC_FREQ     299.8        /**  MHz nec2 uses with no FR card     **/
+#define  FF_BLOCK        8            /**  Directions per kernel pass        **/
+#define  FF_MAX_SAMPLES  4000000      /**  Largest grid FF_Pattern fills     **/
+#define  FF_CHECK_RANGE  20.0         /**  dB below peak FF_Residual checks  **/
+#define  FF_CHECK_DB     0.5          /**  Residual a resample may have      **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct FF_Sources {
+  int     count;   /**  Segments                            **/
+  float  *x;       /**  Segment centre, metres              **/
+  float  *y;
+  float  *z;
+  float  *lx;      /**  Segment vector, end to end, metres  **/
+  float  *ly;
+  float  *lz;
+  float  *re;      /**  Segment current, amps, real part    **/
+  float  *im;      /**    ..and imaginary part              **/
+} FF_Sources;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool    FF_Gather(const Ant *, FF_Sources *);
+void    FF_Free(FF_Sources *);
+double  FF_RadiatedPower(const FF_Sources *, double);
+bool    FF_Pattern(const FF_Sources *, double, double, double, double,
+                   double, int, int, FieldData *);
+void    FF_FillValue(double, double, double, double, double, FieldVal *);
+void    FF_Ranges(FieldData *);
+double  FF_Residual(const FieldData *, const FieldData *, double);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of FarField.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,427 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Figures of merit from a computed far field: radiated power,
+ *  efficiency and directivity by integrating over solid angle, front to
+ *  back and front to rear ratios, -3 dB beamwidths and first sidelobe
+ *  levels in the two cuts through the peak.
+ *
+ *  The samples are read through strided column pointers, as PK_Convert
+ *  reads them, so the FieldVal array of an antenna and the columns of a
+ *  mapped pattern file (PatFile.c) go through the same code.  The grid
+ *  is taken from the samples themselves: NEC prints phi major, so the
+ *  first row ends where phi first changes.
+ *
+ *  Integration is one pass over the samples with trapezoid weights
+ *  |sin theta| dtheta dphi.  Grids that wrap theta past 180 degrees, as
+ *  the RP cards from WriteCardFile do, cover the sphere twice, and the
+ *  sum is scaled back to one covering.  A grid over less than the sphere
+ *  (a hemisphere over ground) is summed as it stands, since nothing is
+ *  radiated where it has no samples.
+ *
+ *  Angles follow NEC: theta from the zenith, phi around it.  The back
+ *  direction is at the same theta, phi + 180, the usual reading over
+ *  ground; front to rear takes the strongest sample at that theta more
+ *  than 90 degrees of phi away from the peak.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "FieldAnalysis.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  NO_GAIN      -999.0                /**  NEC's value in nulls       **/
+#define  DB_TO_LN     0.23025850929940458   /**  10^(x/10) = e^(x*k)        **/
+#define  ANGLE_EPS    1.0e-3                /**  Degrees, same direction    **/
+#define  SPHERE       (4.0 * PI)            /**  Steradians                 **/
+#define  HALF_POWER   3.0                   /**  dB below the peak          **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Cut {
+  const double  *gain;     /**  First sample of the cut              **/
+  size_t         pitch;    /**  Doubles between its samples          **/
+  int            n;        /**  Samples in the cut                   **/
+  int            peak;     /**  Index of the pattern peak            **/
+  bool           wraps;    /**  Sample n - 1 is next to sample 0     **/
+  double         step;     /**  Degrees between samples              **/
+} Cut;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             FA_FieldSamples                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FA_FieldSamples(const FieldData *field, FA_Samples *samples) {
+
+  samples->theta = &field->vals[0].theta;
+  samples->phi = &field->vals[0].phi;
+  samples->gain = &field->vals[0].total_gain;
+  samples->theta_mag = &field->vals[0].theta_mag;
+  samples->phi_mag = &field->vals[0].phi_mag;
+  samples->stride = sizeof(FieldVal) / sizeof(double);
+  samples->count = field->count;
+
+}  /**  End of FA_FieldSamples  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 InCut                                   **/
+/**                                                                         **/
+/**  Whether k samples from the peak, k negative going back, is in the      **/
+/**  cut; a cut that wraps has no ends.                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool InCut(const Cut *cut, int k) {
+
+  return cut->wraps || (cut->peak + k >= 0 && cut->peak + k < cut->n);
+
+}  /**  End of InCut  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CutGain                                  **/
+/**                                                                         **/
+/**  Gain k samples from the peak, which InCut must allow.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double CutGain(const Cut *cut, int k) {
+
+  int  i;  /**  Sample index  **/
+
+  i = ((cut->peak + k) % cut->n + cut->n) % cut->n;
+  return cut->gain[(size_t) i * cut->pitch];
+
+}  /**  End of CutGain  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                HalfPower                                **/
+/**                                                                         **/
+/**  Degrees from the peak to the -3 dB point going one way (dir +1 or      **/
+/**  -1), interpolated between samples, or FA_NONE if the gain never       **/
+/**  drops that far.                                                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double HalfPower(const Cut *cut, int dir) {
+
+  double  level;  /**  -3 dB gain       **/
+  double  prev;   /**  Sample before k   **/
+  double  g;      /**  Sample k          **/
+  int     k;      /**  Loop counter      **/
+
+  level = CutGain(cut, 0) - HALF_POWER;
+  prev = CutGain(cut, 0);
+  for (k = 1; k < cut->n && InCut(cut, dir * k); k++) {
+    g = CutGain(cut, dir * k);
+    if (g < level)
+      return (k - 1 + (prev - level) / (prev - g)) * cut->step;
+    prev = g;
+  }  /**  Until below -3 dB  **/
+  return FA_NONE;
+
+}  /**  End of HalfPower  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FirstSidelobe                              **/
+/**                                                                         **/
+/**  Gain of the first local maximum past the first null going one way,     **/
+/**  or FA_NONE if there is none before the cut ends or comes round.        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double FirstSidelobe(const Cut *cut, int dir) {
+
+  double  prev;     /**  Sample before k    **/
+  double  g;        /**  Sample k           **/
+  bool    rising;   /**  Past the null      **/
+  int     k;        /**  Loop counter       **/
+
+  prev = CutGain(cut, 0);
+  rising = false;
+  for (k = 1; k < cut->n && InCut(cut, dir * k); k++) {
+    g = CutGain(cut, dir * k);
+    if (!rising && g > prev)
+      rising = true;
+    else if (rising && g < prev)
+      return prev;
+    prev = g;
+  }  /**  Along the cut  **/
+  return FA_NONE;
+
+}  /**  End of FirstSidelobe  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CutFigures                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void CutFigures(const Cut *cut, double *beamwidth, double *sidelobe) {
+
+  double  up;     /**  Toward higher index  **/
+  double  down;   /**  Toward lower index   **/
+  double  peak;   /**  Gain at the peak     **/
+
+  up = HalfPower(cut, 1);
+  down = HalfPower(cut, -1);
+  *beamwidth = (up == FA_NONE || down == FA_NONE) ? FA_NONE : up + down;
+  if (*beamwidth != FA_NONE && *beamwidth > 360.0)
+    *beamwidth = FA_NONE;
+
+  peak = CutGain(cut, 0);
+  up = FirstSidelobe(cut, 1);
+  down = FirstSidelobe(cut, -1);
+  if (up == FA_NONE || (down != FA_NONE && down > up))
+    up = down;
+  *sidelobe = (up == FA_NONE) ? FA_NONE : up - peak;
+
+}  /**  End of CutFigures  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                AngleOff                                 **/
+/**                                                                         **/
+/**  Absolute difference of two azimuths, 0 to 180 degrees.                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double AngleOff(double a, double b) {
+
+  double  d;  /**  Difference  **/
+
+  d = fmod(fabs(a - b), 360.0);
+  return (d > 180.0) ? 360.0 - d : d;
+
+}  /**  End of AngleOff  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FA_Analyze                                **/
+/**                                                                         **/
+/**  Fills in result for the pattern in samples.  Returns false if the      **/
+/**  samples are not a theta by phi grid.                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool FA_Analyze(const FA_Samples *samples, FA_Result *result) {
+
+  const double  *gain;         /**  Shorthand               **/
+  double        *col_weight;   /**  |sin theta| dtheta      **/
+  double         row_weight;   /**  dphi                    **/
+  double         dtheta;       /**  Grid step, theta        **/
+  double         dphi;         /**    ..phi                 **/
+  double         weights;      /**  Sum of all weights      **/
+  double         power;        /**  Sum of w |E|^2          **/
+  double         linear;       /**  Sum of w 10^(G/10)      **/
+  double         row_power;    /**  Per row                 **/
+  double         row_linear;   /**  Per row                 **/
+  double         row_sum;      /**  Per row, weights        **/
+  double         g;            /**  One sample's gain       **/
+  double         e2;           /**  ..its |E|^2             **/
+  double         scale;        /**  One covering of sphere  **/
+  double         back_phi;     /**  Behind the peak         **/
+  double         rear;         /**  Worst rear sample       **/
+  double         off;          /**  Phi from the peak       **/
+  bool           theta_wraps;  /**  Theta covers 360        **/
+  bool           phi_wraps;    /**  Phi covers 360          **/
+  size_t         s;            /**  Stride                  **/
+  size_t         i;            /**  Sample offset           **/
+  int            rows;         /**  Phi values              **/
+  int            cols;         /**  Theta values            **/
+  int            peak;         /**  Index of the peak       **/
+  int            r;            /**  Loop counter            **/
+  int            c;            /**  Loop counter            **/
+  Cut            cut;          /**  Cut through the peak    **/
+
+  s = samples->stride;
+  gain = samples->gain;
+  for (cols = 1; cols < samples->count; cols++)
+    if (fabs(samples->phi[cols * s] - samples->phi[0]) > ANGLE_EPS)
+      break;
+  if (samples->count < 2 || cols < 2 || samples->count % cols != 0)
+    return false;
+  rows = samples->count / cols;
+  dtheta = samples->theta[s] - samples->theta[0];
+  dphi = (rows > 1) ? samples->phi[cols * s] - samples->phi[0] : 0.0;
+  theta_wraps = cols * dtheta > 360.0 - ANGLE_EPS;
+  phi_wraps = rows * dphi > 360.0 - ANGLE_EPS;
+  result->rows = rows;
+  result->cols = cols;
+
+  col_weight = (double *) malloc(cols * sizeof(double));
+  if (col_weight == NULL)
+    return false;
+  for (c = 0; c < cols; c++) {
+    col_weight[c] = fabs(sin(radian(samples->theta[c * s]))) * 
+                    radian(dtheta);
+    if (!theta_wraps && (c == 0 || c == cols - 1))
+      col_weight[c] *= 0.5;
+  }  /**  For each theta  **/
+
+  /**  The one pass: weights, |E|^2, linear gain and the peak  **/
+  weights = power = linear = 0.0;
+  peak = 0;
+  for (r = 0; r < rows; r++) {
+    row_weight = radian(dphi);
+    if (!phi_wraps && (r == 0 || r == rows - 1))
+      row_weight *= 0.5;
+    row_power = row_linear = row_sum = 0.0;
+    for (c = 0; c < cols; c++) {
+      i = ((size_t) r * cols + c) * s;
+      g = gain[i];
+      e2 = samples->theta_mag[i] * samples->theta_mag[i] + 
+           samples->phi_mag[i] * samples->phi_mag[i];
+      row_sum += col_weight[c];
+      row_power += col_weight[c] * e2;
+      if (g > NO_GAIN)
+        row_linear += col_weight[c] * exp(g * DB_TO_LN);
+      if (g > gain[(size_t) peak * s])
+        peak = r * cols + c;
+    }  /**  For each theta  **/
+    weights += row_weight * row_sum;
+    power += row_weight * row_power;
+    linear += row_weight * row_linear;
+  }  /**  For each phi  **/
+  free(col_weight);
+
+  result->peak_gain = gain[(size_t) peak * s];
+  result->peak_theta = samples->theta[(size_t) peak * s];
+  result->peak_phi = samples->phi[(size_t) peak * s];
+
+  result->radiated = result->efficiency = result->directivity = FA_NONE;
+  if (rows > 1 && weights > 0.0) {
+    scale = (weights > 1.05 * SPHERE) ? SPHERE / weights : 1.0;
+    result->radiated = scale * power / (2.0 * FA_ETA0);
+    result->efficiency = scale * linear / SPHERE;
+    if (result->efficiency > 0.0)
+      result->directivity = result->peak_gain - 
+                            10.0 * log10(result->efficiency);
+  }  /**  A surface to integrate  **/
+
+  /**  Front to back and front to rear, at the peak's theta  **/
+  back_phi = result->peak_phi + 180.0;
+  result->front_to_back = result->front_to_rear = FA_NONE;
+  rear = FA_NONE;
+  for (r = 0; r < rows; r++) {
+    i = ((size_t) r * cols + peak % cols) * s;
+    off = AngleOff(samples->phi[i], result->peak_phi);
+    if (AngleOff(samples->phi[i], back_phi) < ANGLE_EPS)
+      result->front_to_back = result->peak_gain - gain[i];
+    if (off > 90.0 + ANGLE_EPS && gain[i] > rear)
+      rear = gain[i];
+  }  /**  For each phi  **/
+  if (rear != FA_NONE)
+    result->front_to_rear = result->peak_gain - rear;
+
+  /**  Across phi at the peak's theta  **/
+  cut.gain = gain + (size_t) (peak % cols) * s;
+  cut.pitch = cols * s;
+  cut.n = rows;
+  cut.peak = peak / cols;
+  cut.wraps = phi_wraps;
+  cut.step = dphi;
+  CutFigures(&cut, &result->beamwidth_az, &result->sidelobe_az);
+
+  /**  Across theta at the peak's phi  **/
+  cut.gain = gain + (size_t) (peak / cols) * cols * s;
+  cut.pitch = s;
+  cut.n = cols;
+  cut.peak = peak % cols;
+  cut.wraps = theta_wraps;
+  cut.step = dtheta;
+  CutFigures(&cut, &result->beamwidth_el, &result->sidelobe_el);
+
+  return true;
+
+}  /**  End of FA_Analyze  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of FieldAnalysis.c                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
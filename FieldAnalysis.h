@@ -0,0 +1,107 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FIELD_ANALYSIS_H
+#define FIELD_ANALYSIS_H
+
+#include <stddef.h>
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  FA_NONE    -999.99   /**  Figure the pattern does not define  **/
+#define  FA_ETA0    376.730   /**  Impedance of free space, ohms       **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct FA_Samples {
+  const double  *theta;      /**  Degrees, NEC THETA column          **/
+  const double  *phi;        /**  Degrees, NEC PHI column            **/
+  const double  *gain;       /**  Total power gain, dBi              **/
+  const double  *theta_mag;  /**  |E theta|, volts                   **/
+  const double  *phi_mag;    /**  |E phi|, volts                     **/
+  size_t         stride;     /**  Doubles from one sample to next    **/
+  int            count;      /**  Samples, phi major as NEC prints   **/
+} FA_Samples;
+
+typedef struct FA_Result {
+  int     rows;              /**  Phi values in the grid             **/
+  int     cols;              /**  Theta values in each row           **/
+  double  peak_gain;         /**  dBi                                **/
+  double  peak_theta;        /**  Direction of the peak, degrees     **/
+  double  peak_phi;
+  double  radiated;          /**  Watts, |E|^2 over the sphere       **/
+  double  efficiency;        /**  Radiated over input power, 0..1    **/
+  double  directivity;       /**  dBi                                **/
+  double  front_to_back;     /**  dB, peak over phi + 180            **/
+  double  front_to_rear;     /**  dB, peak over worst rear lobe      **/
+  double  beamwidth_az;      /**  -3 dB width across phi, degrees    **/
+  double  beamwidth_el;      /**    ..across theta                   **/
+  double  sidelobe_az;       /**  First sidelobe, dB below the peak  **/
+  double  sidelobe_el;
+} FA_Result;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void  FA_FieldSamples(const FieldData *, FA_Samples *);
+bool  FA_Analyze(const FA_Samples *, FA_Result *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of FieldAnalysis.h                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
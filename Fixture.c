@@ -0,0 +1,697 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Stand-in solver backends, so the field can be computed without nec2.
+ *  The backend is picked with the ANTENNAVIS_SOLVER environment variable:
+ *
+ *    nec2             run nec2 (the default)
+ *    record:DIR       run nec2 and keep a copy of its output in DIR
+ *    recorded:DIR     serve the output recorded in DIR, never run nec2
+ *    dipole           synthesise a vertical half wave dipole
+ *    isotropic        synthesise an isotropic radiator
+ *
+ *  Recorded outputs are keyed by a hash of the generated deck, so the
+ *  same geometry, frequency and step size always find the same file,
+ *  named DIR/<hash>.out.  Synthetic outputs follow the RP card and the
+ *  wires of the deck, GX and GR copies included, so they come at
+ *  whatever resolution STEP_SIZE asks for and carry one current per
+ *  segment, in the layout ParseFieldData reads from real NEC output.  Each frequency of the FR
+ *  card gets its input parameters, from a series resonance at the middle
+ *  of the sweep, so SWR sweeps have something plausible to show.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "MyTypes.h"
+#include "Fixture.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  FNV_OFFSET   14695981039346656037UL  /**  FNV-1a, 64 bits         **/
+#define  FNV_PRIME    1099511628211UL
+#define  NO_GAIN      -999.99                 /**  NEC's gain for a null   **/
+#define  MAX_DIR      1024                    /**  Longest recorded dir    **/
+#define  FEED_R       73.1                    /**  Synthetic input, ohms   **/
+#define  FEED_Q       8.0                     /**    ..and its Q           **/
+#define  ETA0         376.73                  /**  Free space, ohms        **/
+#define  NEC_FREQ     299.8                   /**  MHz without an FR card  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Wire {
+  int     tag;       /**  GW tag, or the one GX or GR gave the copy  **/
+  int     segments;  /**  GW segments                               **/
+  double  e[6];      /**  End points                                **/
+} Wire;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int   Backend = -1;       /**  -1 until the environment is read  **/
+local char  Directory[MAX_DIR]; /**  For FX_RECORD and FX_RECORDED     **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FX_Backend                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int FX_Backend(void) {
+
+  const char  *env;  /**  ANTENNAVIS_SOLVER  **/
+
+  if (Backend >= 0)
+    return Backend;
+
+  env = getenv(FX_ENV);
+  if (env == NULL || strcmp(env, "nec2") == 0 || env[0] == '\0')
+    FX_SetBackend(FX_NEC2, NULL);
+  else if (strncmp(env, "record:", 7) == 0)
+    FX_SetBackend(FX_RECORD, env + 7);
+  else if (strncmp(env, "recorded:", 9) == 0)
+    FX_SetBackend(FX_RECORDED, env + 9);
+  else if (strcmp(env, "dipole") == 0)
+    FX_SetBackend(FX_DIPOLE, NULL);
+  else if (strcmp(env, "isotropic") == 0)
+    FX_SetBackend(FX_ISOTROPIC, NULL);
+  else {
+    fprintf(stderr, "Unknown %s \"%s\", running nec2\n", FX_ENV, env);
+    FX_SetBackend(FX_NEC2, NULL);
+  }  /**  Parse the setting  **/
+
+  return Backend;
+
+}  /**  End of FX_Backend  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FX_SetBackend                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FX_SetBackend(int backend, const char *directory) {
+
+  Backend = backend;
+  snprintf(Directory, sizeof(Directory), "%s", 
+           directory != NULL ? directory : ".");
+
+}  /**  End of FX_SetBackend  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               FX_DeckHash                               **/
+/**                                                                         **/
+/**  FNV-1a over the bytes of a deck file, 0 if it cannot be read.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+unsigned long FX_DeckHash(const char *deck) {
+
+  FILE           *fin;   /**  The deck       **/
+  unsigned long   hash;  /**  Running hash   **/
+  int             c;     /**  Current byte   **/
+
+  if ((fin = fopen(deck, "rb")) == NULL)
+    return 0;
+  hash = FNV_OFFSET;
+  while ((c = getc(fin)) != EOF) {
+    hash ^= (unsigned char) c;
+    hash *= FNV_PRIME;
+  }  /**  For each byte  **/
+  fclose(fin);
+
+  return hash;
+
+}  /**  End of FX_DeckHash  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             FX_RecordedPath                             **/
+/**                                                                         **/
+/**  Names the recorded output for a deck in a directory.  Returns false    **/
+/**  if the deck cannot be read.                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool FX_RecordedPath(const char *directory, const char *deck, char *path,
+                     size_t size) {
+
+  unsigned long  hash;  /**  Deck hash  **/
+
+  if ((hash = FX_DeckHash(deck)) == 0)
+    return false;
+  snprintf(path, size, "%s/%016lx.out", directory, hash);
+  return true;
+
+}  /**  End of FX_RecordedPath  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                CopyFile                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool CopyFile(const char *from, const char *to) {
+
+  FILE    *fin;         /**  Source       **/
+  FILE    *fout;        /**  Destination  **/
+  char     buf[8192];   /**  Block        **/
+  size_t   n;           /**  Bytes read   **/
+  bool     ok;          /**  All written  **/
+
+  if ((fin = fopen(from, "rb")) == NULL)
+    return false;
+  if ((fout = fopen(to, "wb")) == NULL) {
+    fclose(fin);
+    return false;
+  }  /**  Cannot write  **/
+  ok = true;
+  while ((n = fread(buf, 1, sizeof(buf), fin)) > 0)
+    if (fwrite(buf, 1, n, fout) != n)
+      ok = false;
+  fclose(fin);
+  if (fclose(fout) != 0)
+    ok = false;
+
+  return ok;
+
+}  /**  End of CopyFile  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Gain                                   **/
+/**                                                                         **/
+/**  Power gain, as a ratio, of the analytic patterns at polar angle theta  **/
+/**  (degrees from the z axis).                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Gain(int pattern, double theta) {
+
+  double  s;  /**  Sin of theta  **/
+  double  f;  /**  Field factor  **/
+
+  if (pattern == FX_ISOTROPIC)
+    return 1.0;
+
+  s = sin(radian(theta));
+  if (fabs(s) < 1.0e-9)
+    return 0.0;
+  f = cos(M_PI / 2.0 * cos(radian(theta))) / s;
+  return 1.64 * f * f;
+
+}  /**  End of Gain  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ReadWires                                 **/
+/**                                                                         **/
+/**  The GW wires of the deck, in NEC's order, with the images a GX card    **/
+/**  reflects (in z, then y, then x, the tag increment doubling after       **/
+/**  each plane) and the copies a GR card turns about the z axis.           **/
+/**  Returns how many, the wires in *wires for the caller to free.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int ReadWires(FILE *fin, Wire **wires) {
+
+  char     line[256];    /**  One card                       **/
+  Wire    *w;            /**  The wires                      **/
+  Wire    *grown;        /**  Reallocated                    **/
+  int      count;        /**  Wires so far                   **/
+  int      room;         /**  Allocated                      **/
+  int      inc;          /**  Tag increment                  **/
+  int      flags;        /**  GX planes, or GR copies        **/
+  int      n;            /**  Wires before the card          **/
+  int      axis;         /**  Current plane                  **/
+  int      c;            /**  Copy                           **/
+  int      i;            /**  Loop counter                   **/
+  int      k;            /**  Loop counter                   **/
+  double   a;            /**  GR angle                       **/
+  double   x;            /**  Turned coordinate              **/
+
+  w = NULL;
+  count = room = 0;
+  rewind(fin);
+  while (fgets(line, sizeof(line), fin) != NULL) {
+    if (line[0] == 'G' && line[1] == 'E')
+      break;
+    if (line[0] != 'G')
+      continue;
+    if (count == room) {
+      room = (room > 0) ? 2 * room : 64;
+      if ((grown = (Wire *) realloc(w, room * sizeof(Wire))) == NULL)
+        break;
+      w = grown;
+    }  /**  Room for one more  **/
+    if (line[1] == 'W' &&
+        sscanf(line + 2, "%d%d%lf%lf%lf%lf%lf%lf", &w[count].tag,
+               &w[count].segments, &w[count].e[0], &w[count].e[1],
+               &w[count].e[2], &w[count].e[3], &w[count].e[4],
+               &w[count].e[5]) == 8) {
+      count++;
+    }  /**  Wire  **/
+    else if (line[1] == 'X' &&
+             sscanf(line + 2, "%d%d", &inc, &flags) == 2) {
+      for (axis = 2; axis >= 0; axis--) {
+        if ((axis == 0 && flags / 100 % 10 == 0) ||
+            (axis == 1 && flags / 10 % 10 == 0) ||
+            (axis == 2 && flags % 10 == 0))
+          continue;
+        n = count;
+        if (2 * n > room) {
+          room = 2 * n;
+          if ((grown = (Wire *) realloc(w, room * sizeof(Wire))) == NULL)
+            break;
+          w = grown;
+        }  /**  Room for the images  **/
+        for (i = 0; i < n; i++) {
+          w[count] = w[i];
+          w[count].e[axis] = -w[i].e[axis];
+          w[count].e[axis + 3] = -w[i].e[axis + 3];
+          if (w[i].tag != 0)
+            w[count].tag = w[i].tag + inc;
+          count++;
+        }  /**  For each wire  **/
+        inc *= 2;
+      }  /**  For each plane  **/
+    }  /**  Reflections  **/
+    else if (line[1] == 'R' &&
+             sscanf(line + 2, "%d%d", &inc, &flags) == 2 && flags > 1) {
+      n = count;
+      if (n * flags > room) {
+        room = n * flags;
+        if ((grown = (Wire *) realloc(w, room * sizeof(Wire))) == NULL)
+          break;
+        w = grown;
+      }  /**  Room for the copies  **/
+      for (c = 1; c < flags; c++) {
+        a = 2.0 * M_PI * c / flags;
+        for (i = 0; i < n; i++) {
+          w[count] = w[i];
+          for (k = 0; k < 6; k += 3) {
+            x = w[i].e[k];
+            w[count].e[k] = x * cos(a) - w[i].e[k + 1] * sin(a);
+            w[count].e[k + 1] = x * sin(a) + w[i].e[k + 1] * cos(a);
+          }  /**  Both ends  **/
+          if (w[i].tag != 0)
+            w[count].tag = w[i].tag + c * inc;
+          count++;
+        }  /**  For each wire  **/
+      }  /**  For each copy  **/
+    }  /**  Rotations  **/
+  }  /**  Geometry cards  **/
+
+  *wires = w;
+  return count;
+
+}  /**  End of ReadWires  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             WriteCurrents                               **/
+/**                                                                         **/
+/**  A cosine current along every wire of the deck, peak amps at the        **/
+/**  middle of each.                                                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void WriteCurrents(const Wire *w, int count, FILE *fout, double peak) {
+
+  int      seg_num;      /**  Running segment number         **/
+  double   t;            /**  Position along the wire, 0..1  **/
+  double   mag;          /**  Current magnitude              **/
+  int      i;            /**  Loop counter                   **/
+  int      k;            /**  Loop counter                   **/
+
+  fprintf(fout, "                           "
+          "- - - CURRENTS AND LOCATION - - -\n\n"
+          "                              DISTANCES IN WAVELENGTHS\n\n\n"
+          "   SEG.  TAG    COORDINATES OF SEG. CENTER     SEG."
+          "          - - - CURRENT (AMPS) - - -\n"
+          "   No:   No:       X         Y         Z      LENGTH"
+          "     REAL      IMAGINARY    MAGN        PHASE\n");
+
+  seg_num = 0;
+  for (k = 0; k < count; k++) {
+    for (i = 0; i < w[k].segments; i++) {
+      t = (i + 0.5) / w[k].segments;
+      mag = peak * cos(M_PI * (t - 0.5));
+      fprintf(fout, "%6d %4d %9.4f %9.4f %9.4f %9.5f %11.4E %11.4E "
+              "%11.4E %8.3f\n", ++seg_num, w[k].tag,
+              w[k].e[0] + t * (w[k].e[3] - w[k].e[0]),
+              w[k].e[1] + t * (w[k].e[4] - w[k].e[1]),
+              w[k].e[2] + t * (w[k].e[5] - w[k].e[2]),
+              1.0 / w[k].segments, mag, 0.0, mag, 0.0);
+    }  /**  For each segment  **/
+  }  /**  For each wire  **/
+  fprintf(fout, "\n\n");
+
+}  /**  End of WriteCurrents  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          WriteInputParameters                           **/
+/**                                                                         **/
+/**  NEC's frequency heading and the input parameters of a 1 volt source    **/
+/**  on a series resonance at centre MHz.  Returns the source current.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double WriteInputParameters(FILE *fout, double freq, double centre,
+                                  int tag, int seg) {
+
+  double  x;      /**  Reactance, ohms    **/
+  double  den;    /**  |Z|^2              **/
+  double  g;      /**  Conductance        **/
+  double  b;      /**  Susceptance        **/
+
+  x = FEED_R * FEED_Q * (freq / centre - centre / freq);
+  den = FEED_R * FEED_R + x * x;
+  g = FEED_R / den;
+  b = -x / den;
+
+  fprintf(fout, "\n                               "
+          "- - - - - - FREQUENCY - - - - - -\n\n"
+          "                                    FREQUENCY= %11.4E MHZ\n"
+          "                                    WAVELENGTH= %11.4E METERS\n\n",
+          freq, NEC_FREQ / freq);
+  fprintf(fout, "                        "
+          "- - - ANTENNA INPUT PARAMETERS - - -\n\n"
+          "  TAG   SEG.      VOLTAGE (VOLTS)         CURRENT (AMPS)"
+          "         IMPEDANCE (OHMS)        ADMITTANCE (MHOS)     POWER\n"
+          "  NO.   NO.     REAL      IMAG.         REAL      IMAG."
+          "         REAL      IMAG.         REAL      IMAG.      (WATTS)\n"
+          " %4d %5d %11.4E %11.4E %11.4E %11.4E %11.4E %11.4E %11.4E "
+          "%11.4E %11.4E\n\n\n", tag, seg, 1.0, 0.0, g, b, FEED_R, x, g, b,
+          0.5 * g);
+  return 1.0 / sqrt(den);
+
+}  /**  End of WriteInputParameters  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FX_Synthesize                              **/
+/**                                                                         **/
+/**  Writes an NEC style output for the deck with an analytic pattern       **/
+/**  (FX_DIPOLE or FX_ISOTROPIC): for each frequency of the FR card the     **/
+/**  input parameters of the EX source and a cosine current along every     **/
+/**  wire, then the gain on the grid of the first RP card, all vertically   **/
+/**  polarised.  A deck with XQ and no RP gets no pattern.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool FX_Synthesize(const char *deck, const char *output, int pattern) {
+
+  FILE    *fin;          /**  The deck                       **/
+  FILE    *fout;         /**  The output                     **/
+  char     line[256];    /**  One card                       **/
+  double   mag;          /**  Power gain, as a ratio         **/
+  double   gain;         /**  Gain in dBi                    **/
+  int      dummy;        /**  Fields we ignore               **/
+  int      thetas;       /**  RP samples in theta            **/
+  int      phis;         /**    ..and phi                    **/
+  double   theta0;       /**  RP start, theta                **/
+  double   phi0;         /**    ..phi                        **/
+  double   dtheta;       /**  RP step, theta                 **/
+  double   dphi;         /**    ..phi                        **/
+  int      step_type;    /**  FR: 0 linear, 1 multiplicative **/
+  int      freqs;        /**  FR: number of frequencies      **/
+  double   freq0;        /**  FR: first frequency, MHz       **/
+  double   freq_step;    /**  FR: step                       **/
+  double   freq;         /**  Current frequency              **/
+  double   centre;       /**  Of the sweep                   **/
+  double   peak;         /**  Wire current, amps             **/
+  double   field;        /**  Volts/metre at gain 1          **/
+  int      ex_tag;       /**  EX source wire                 **/
+  int      ex_seg;       /**    ..and segment                **/
+  Wire    *wires;        /**  The deck's wires               **/
+  int      count;        /**  How many                       **/
+  int      abs_seg;      /**  Source's number in the deck    **/
+  bool     seen_rp;      /**  Grid known                     **/
+  bool     seen_ex;      /**  Source known                   **/
+  bool     seen_xq;      /**  Execute without a pattern      **/
+  int      i;            /**  Loop counter                   **/
+  int      j;            /**  Loop counter                   **/
+
+  if ((fin = fopen(deck, "rt")) == NULL)
+    return false;
+  if ((fout = fopen(output, "wt")) == NULL) {
+    fclose(fin);
+    return false;
+  }  /**  Cannot write  **/
+
+  seen_rp = seen_ex = seen_xq = false;
+  thetas = phis = 0;
+  theta0 = phi0 = dtheta = dphi = 0.0;
+  step_type = 0;
+  freqs = 1;
+  freq0 = NEC_FREQ;
+  freq_step = 0.0;
+  ex_tag = ex_seg = 1;
+  peak = 1.0e-2;
+  while (fgets(line, sizeof(line), fin) != NULL) {
+    if (line[0] == 'R' && line[1] == 'P' && !seen_rp &&
+        sscanf(line + 2, "%d%d%d%d%lf%lf%lf%lf", &dummy, &thetas, 
+               &phis, &dummy, &theta0, &phi0, &dtheta, &dphi) == 8) {
+      seen_rp = true;
+    }  /**  First pattern card  **/
+    else if (line[0] == 'F' && line[1] == 'R' &&
+             sscanf(line + 2, "%d%d%d%d%lf%lf", &step_type, &freqs, 
+                    &dummy, &dummy, &freq0, &freq_step) == 6) {
+      if (freqs < 1)
+        freqs = 1;
+    }  /**  Frequencies  **/
+    else if (line[0] == 'E' && line[1] == 'X' && !seen_ex &&
+             sscanf(line + 2, "%d%d%d", &dummy, &ex_tag, &ex_seg) == 3) {
+      seen_ex = true;
+    }  /**  Source  **/
+    else if (line[0] == 'X' && line[1] == 'Q') {
+      seen_xq = true;
+    }  /**  Execute  **/
+  }  /**  For each card  **/
+
+  /**  NEC numbers the source's segment over the whole structure  **/
+  count = ReadWires(fin, &wires);
+  fclose(fin);
+  abs_seg = ex_seg;
+  for (i = 0; i < count && wires[i].tag != ex_tag; i++)
+    abs_seg += wires[i].segments;
+
+  fprintf(fout, "\n          SYNTHETIC %s PATTERN, NOT AN NEC SOLUTION\n\n",
+          pattern == FX_DIPOLE ? "HALF WAVE DIPOLE" : "ISOTROPIC");
+  centre = (step_type == 1) ? freq0 * pow(freq_step, (freqs - 1) / 2.0)
+                            : freq0 + freq_step * (freqs - 1) / 2.0;
+  for (i = 0; i < freqs; i++) {
+    freq = (step_type == 1) ? freq0 * pow(freq_step, i)
+                            : freq0 + freq_step * i;
+    peak = 1.0e-2;
+    if (seen_ex && freq > 0.0 && centre > 0.0)
+      peak = WriteInputParameters(fout, freq, centre, ex_tag, abs_seg);
+    WriteCurrents(wires, count, fout, peak);
+  }  /**  For each frequency  **/
+  free(wires);
+
+  /**  E at 1 m for the source's input power, so gain = 2 pi E^2 / eta P  **/
+  field = 1.0;
+  if (seen_ex && freq0 > 0.0)
+    field = sqrt(ETA0 * 0.5 * FEED_R * peak * peak / (2.0 * M_PI));
+
+  if (seen_rp) {
+    fprintf(fout, "                           "
+            "- - - RADIATION PATTERNS - - -\n\n"
+            " - - ANGLES - -           - POWER GAINS -       "
+            "- - - POLARIZATION - - -    - - - E(THETA) - - -"
+            "    - - - E(PHI) - - -\n"
+            "  THETA     PHI       VERT.   HOR.    TOTAL       "
+            "AXIAL     TILT  SENSE   MAGNITUDE    PHASE "
+            "   MAGNITUDE    PHASE\n"
+            " DEGREES   DEGREES      DB       DB       DB       "
+            "RATIO   DEGREES          VOLTS    DEGREES     VOLTS"
+            "     DEGREES\n");
+    for (i = 0; i < phis; i++) {
+      for (j = 0; j < thetas; j++) {
+        mag = Gain(pattern, theta0 + j * dtheta);
+        gain = mag > 1.0e-99 ? 10.0 * log10(mag) : NO_GAIN;
+        if (gain < NO_GAIN)
+          gain = NO_GAIN;
+        fprintf(fout, "%9.2f %9.2f %8.2f %8.2f %8.2f %10.5f %8.2f %-7s "
+                "%11.4E %9.2f %11.4E %9.2f\n", 
+                theta0 + j * dtheta, phi0 + i * dphi, gain, NO_GAIN, gain,
+                0.0, 0.0, "LINEAR", field * sqrt(mag), 0.0, 0.0, 0.0);
+      }  /**  For each theta  **/
+    }  /**  For each phi  **/
+    fprintf(fout, "\n");
+  }  /**  Pattern  **/
+
+  return fclose(fout) == 0 && (seen_rp || seen_xq);
+
+}  /**  End of FX_Synthesize  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FX_Solve                                 **/
+/**                                                                         **/
+/**  Produces the output for a deck with the selected backend.  Returns     **/
+/**  FX_RUN_NEC2 when the caller should run nec2 itself, FX_SERVED when     **/
+/**  output now holds the result, and FX_FAILED when there is none (a       **/
+/**  deck nobody recorded, say).                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int FX_Solve(const char *deck, const char *output) {
+
+  char  path[MAX_DIR + 32];  /**  Recorded output  **/
+
+  switch (FX_Backend()) {
+    case FX_RECORDED:
+      if (!FX_RecordedPath(Directory, deck, path, sizeof(path)) ||
+          !CopyFile(path, output)) {
+        fprintf(stderr, "No recorded output %s\n", path);
+        return FX_FAILED;
+      }  /**  Not recorded  **/
+      printf("Serving recorded output %s\n", path);
+      return FX_SERVED;
+
+    case FX_DIPOLE:
+    case FX_ISOTROPIC:
+      if (!FX_Synthesize(deck, output, Backend))
+        return FX_FAILED;
+      printf("Synthesised %s pattern\n", 
+             Backend == FX_DIPOLE ? "dipole" : "isotropic");
+      return FX_SERVED;
+
+    default:
+      return FX_RUN_NEC2;
+  }  /**  By backend  **/
+
+}  /**  End of FX_Solve  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FX_Solved                                **/
+/**                                                                         **/
+/**  Called after nec2 wrote output for deck; keeps a copy when recording.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FX_Solved(const char *deck, const char *output) {
+
+  char  path[MAX_DIR + 32];  /**  Recorded output  **/
+
+  if (FX_Backend() != FX_RECORD)
+    return;
+  if (!FX_RecordedPath(Directory, deck, path, sizeof(path)) ||
+      !CopyFile(output, path))
+    fprintf(stderr, "Could not record output as %s\n", path);
+  else
+    printf("Recorded output as %s\n", path);
+
+}  /**  End of FX_Solved  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Fixture.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
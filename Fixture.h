@@ -0,0 +1,83 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FIXTURE_H
+#define FIXTURE_H
+
+#include <stddef.h>
+#include "MyTypes.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  FX_ENV            "ANTENNAVIS_SOLVER"
+
+#define  FX_NEC2           0   /**  Run nec2, as always               **/
+#define  FX_RECORD         1   /**  Run nec2 and keep its output      **/
+#define  FX_RECORDED       2   /**  Serve recorded outputs only       **/
+#define  FX_DIPOLE         3   /**  Synthesise a half wave dipole     **/
+#define  FX_ISOTROPIC      4   /**  Synthesise an isotropic radiator  **/
+
+#define  FX_RUN_NEC2       0   /**  FX_Solve: caller runs nec2        **/
+#define  FX_SERVED         1   /**    ..output was written            **/
+#define  FX_FAILED         2   /**    ..no output could be had        **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int            FX_Backend(void);
+void           FX_SetBackend(int, const char *);
+unsigned long  FX_DeckHash(const char *);
+bool           FX_RecordedPath(const char *, const char *, char *, size_t);
+bool           FX_Synthesize(const char *, const char *, int);
+int            FX_Solve(const char *, const char *);
+void           FX_Solved(const char *, const char *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Fixture.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,460 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Benchmark suite over the bundled NEC decks.  For every deck it times
+ *  ReadCardFile (through ReadFile, as the GUI loads it), and then for
+ *  each step size: writing the NEC deck, parsing the recorded NEC output
+ *  for that deck and step with ParseFieldData, reloading the same result
+ *  from a binary pattern file, integrating the same grid from the parsed
+ *  segment currents (FarField.c), building the pattern mesh, and drawing
+ *  frames of the wires and the pattern in each DrawMode into an offscreen
+ *  EGL pbuffer.  Results go out as JSON so successive builds can be
+ *  compared by a script.
+ *
+ *  Recorded outputs live in the recorded directory under the hash of the
+ *  generated deck, as ANTENNAVIS_SOLVER=recorded:DIR serves them to the
+ *  GUI (see Fixture.c).  With -R a missing one is made by running nec2 on
+ *  the deck; with -a dipole or -a isotropic a synthetic output stands in
+ *  for it, so the parser and renderer can be timed on a machine without
+ *  nec2.  Otherwise the step is reported as "missing" and only the deck
+ *  generation is timed.  When no EGL display can be had, frame times are
+ *  reported as null and everything else still runs.
+ *
+ *  Usage:  ModelBench [-f frames] [-s steps] [-r dir] [-R]
+ *                     [-a dipole|isotropic] [-o file] [deck.nec ...]
+ *
+ *  By default every .nec deck in Models is run at steps 10, 5 and 2.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <glob.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <GL/gl.h>
+#include <GL/glu.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "pcard.h"
+#include "VisField.h"
+#include "PatKernel.h"
+#include "WorkPool.h"
+#include "Timing.h"
+#include "Fixture.h"
+#include "SolverPool.h"
+#include "PatFile.h"
+#include "Symmetry.h"
+#include "Offscreen.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  DEFAULT_FRAMES   20          /**  Frames drawn per DrawMode       **/
+#define  DEFAULT_STEPS    "10,5,2"    /**  STEP_SIZE values, in degrees    **/
+#define  DEFAULT_DECKS    "Models/*.nec"
+#define  RECORDED_DIR     "Models/recorded"
+#define  MAX_STEPS        8           /**  Step sizes on the command line  **/
+#define  FRAME_SIZE       500         /**  Pbuffer width and height        **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+extern AntArray  TheAnts;             /**  The antennas' geometries        **/
+extern double    SCALE_FACTOR;        /**  Antenna scale factor            **/
+extern double    DEFAULT_BOOMHEIGHT;  /**  No height above ground specd    **/
+extern double    POINT_DIST_SCALE;    /**  For point clouds, mult of dBi   **/
+extern double    POINT_SIZE_SCALE;    /**    ..also in terms of dBi        **/
+extern double    STEP_SIZE;           /**  Degrees between control points  **/
+extern double    ALPHA;               /**  Alpha transparency factor       **/
+extern int       DrawMode;            /**  Points, surface or sphere       **/
+extern int       MultipleAntMode;     /**  Current antenna or all          **/
+extern int       ShowRadPat;          /**  Show radiation pattern?         **/
+extern int       ShowPolSense;        /**  Show polarization sense?        **/
+extern bool      RFPowerDensityOn;    /**  Draw the field at all?          **/
+extern bool      AntennasInScene;     /**  Are there antennas yet?         **/
+
+local bool            HaveGL = false; /**  Offscreen context is current    **/
+
+local const char *ModeNames[3] = {"points", "surface", "sphere"};
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               RenderFrames                              **/
+/**                                                                         **/
+/**  Draws the wires and the pattern of the current antenna in one          **/
+/**  DrawMode, turning the eye a little every frame like a drag would, and  **/
+/**  returns the average milliseconds per frame including glFinish.  An     **/
+/**  untimed frame first keeps driver warm-up out of the numbers.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double RenderFrames(int mode, int frames) {
+
+  double  start;  /**  Timer start   **/
+  int     f;      /**  Loop counter  **/
+
+  DrawMode = mode;
+  start = 0.0;
+  for (f = -1; f < frames; f++) {
+    if (f == 0) {
+      glFinish();
+      start = TM_Start();
+    }  /**  Frame -1 only warms up the driver  **/
+    OS_Draw(360.0 * f / frames);
+  }  /**  For each frame  **/
+  glFinish();
+
+  return (TM_Start() - start) / frames;
+
+}  /**  End of RenderFrames  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               RecordOutput                              **/
+/**                                                                         **/
+/**  Runs nec2 on a generated deck to make a recorded output.               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool RecordOutput(const char *deck, const char *output) {
+
+  return SP_Solve(deck, output) == SP_OK && access(output, R_OK) == 0;
+
+}  /**  End of RecordOutput  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                JsonString                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void JsonString(FILE *json, const char *text) {
+
+  fputc('"', json);
+  for (; *text != '\0'; text++) {
+    if (*text == '"' || *text == '\\')
+      fputc('\\', json);
+    if ((unsigned char) *text >= ' ')
+      fputc(*text, json);
+  }  /**  For each character  **/
+  fputc('"', json);
+
+}  /**  End of JsonString  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                BenchStep                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void BenchStep(FILE *json, int step, int frames, const char *dir,
+                     bool record, int synthetic) {
+
+  Ant         *ant;           /**  The deck's antenna        **/
+  FILE        *fin;           /**  NEC output                **/
+  char         deck[64];      /**  Generated NEC deck        **/
+  char         scratch[64];   /**  Synthetic NEC output      **/
+  char         output[1024];  /**  Recorded output file      **/
+  const char  *kind;          /**  Where the output is from  **/
+  FieldData    resampled;     /**  Same grid from currents   **/
+  SY_Plan     *plan;          /**  Symmetry of the deck      **/
+  double       start;         /**  Timer start               **/
+  int          mode;          /**  Loop counter              **/
+
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  snprintf(deck, sizeof(deck), "/tmp/ModelBench-%d.nec", (int) getpid());
+  snprintf(scratch, sizeof(scratch), "/tmp/ModelBench-%d.out",
+           (int) getpid());
+
+  STEP_SIZE = step;
+  start = TM_Start();
+  plan = GenerateNECFile(deck);
+  fprintf(json, "        {\"step\": %d, \"generate_ms\": %.3f", step,
+          TM_Start() - start);
+
+  kind = "recorded";
+  if (!FX_RecordedPath(dir, deck, output, sizeof(output)))
+    output[0] = '\0';
+  else if (access(output, R_OK) != 0 && record)
+    RecordOutput(deck, output);
+  if (access(output, R_OK) != 0 && synthetic != FX_NEC2 &&
+      FX_Synthesize(deck, scratch, synthetic)) {
+    snprintf(output, sizeof(output), "%s", scratch);
+    kind = "synthetic";
+  }  /**  Stand in for nec2  **/
+  remove(deck);
+  fin = fopen(output, "rt");
+  remove(scratch);
+  if (fin == NULL) {
+    SY_Free(plan);
+    fprintf(json, ", \"output\": \"missing\"}");
+    return;
+  }  /**  Nothing recorded  **/
+
+  start = TM_Start();
+  ParseFieldData(fin, ant, plan, true, true);
+  SY_Free(plan);
+  fprintf(json, ", \"output\": \"%s\", \"parse_ms\": %.3f, "
+          "\"samples\": %d", kind, TM_Start() - start,
+          ant->fieldData->count);
+  fclose(fin);
+
+  if (PF_Write(scratch, ant)) {
+    start = TM_Start();
+    PF_Load(scratch, ant);
+    fprintf(json, ", \"load_ms\": %.3f", TM_Start() - start);
+    remove(scratch);
+  }  /**  Same result through a pattern file  **/
+
+  memset(&resampled, 0, sizeof(resampled));
+  start = TM_Start();
+  if (SampleFarField(0.0, 0.0, step, 361 / step, 361 / step, &resampled))
+    fprintf(json, ", \"far_field_ms\": %.3f", TM_Start() - start);
+  else
+    fprintf(json, ", \"far_field_ms\": null");
+  free(resampled.vals);
+
+  ant->meshKey.serial = 0;
+  start = TM_Start();
+  BuildPatternMesh(ant, true);
+  fprintf(json, ", \"mesh_ms\": %.3f", TM_Start() - start);
+
+  fprintf(json, ", \"frame_ms\": ");
+  if (!HaveGL) {
+    fprintf(json, "null}");
+    return;
+  }  /**  No offscreen context  **/
+  RFPowerDensityOn = true;
+  for (mode = 0; mode < 3; mode++)
+    fprintf(json, "%s\"%s\": %.3f", mode == 0 ? "{" : ", ", ModeNames[mode],
+            RenderFrames(mode, frames));
+  fprintf(json, "}}");
+
+}  /**  End of BenchStep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                BenchDeck                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void BenchDeck(FILE *json, const char *path, const int *steps,
+                     int nsteps, int frames, const char *dir, bool record,
+                     int synthetic) {
+
+  const char  *name;   /**  File name of the deck  **/
+  double       start;  /**  Timer start            **/
+  int          i;      /**  Loop counter           **/
+
+  name = strrchr(path, '/') != NULL ? strrchr(path, '/') + 1 : path;
+  fprintf(stderr, "ModelBench: %s\n", name);
+
+  AntennasInScene = false;
+  start = TM_Start();
+  ReadFile(path);
+  fprintf(json, "    {\"deck\": ");
+  JsonString(json, name);
+  fprintf(json, ", \"tubes\": %d, \"read_ms\": %.3f, \"steps\": [\n",
+          TheAnts.ants[TheAnts.curr_ant].tube_count, TM_Start() - start);
+
+  for (i = 0; i < nsteps; i++) {
+    BenchStep(json, steps[i], frames, dir, record, synthetic);
+    fprintf(json, i + 1 < nsteps ? ",\n" : "\n");
+  }  /**  For each step size  **/
+  fprintf(json, "      ]}");
+
+}  /**  End of BenchDeck  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                   main                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int main(int argc, char **argv) {
+
+  FILE        *json;                /**  Results                **/
+  glob_t       decks;               /**  Default deck list      **/
+  char       **paths;               /**  Decks to run           **/
+  const char  *dir = RECORDED_DIR;  /**  Recorded outputs       **/
+  const char  *steplist = DEFAULT_STEPS;
+  const char  *renderer;            /**  GL_RENDERER            **/
+  char        *next;                /**  Step list parsing      **/
+  int          steps[MAX_STEPS];    /**  Step sizes             **/
+  int          nsteps;              /**  How many               **/
+  int          npaths;              /**  Decks to run           **/
+  int          frames = DEFAULT_FRAMES;
+  bool         record = false;      /**  Run nec2 when missing  **/
+  int          synthetic = FX_NEC2; /**  Stand-in when missing  **/
+  int          opt;                 /**  Option letter          **/
+  int          i;                   /**  Loop counter           **/
+
+  json = NULL;
+  while ((opt = getopt(argc, argv, "f:s:r:Ra:o:")) != -1) {
+    switch (opt) {
+      case 'f':  frames = atoi(optarg);  break;
+      case 's':  steplist = optarg;      break;
+      case 'r':  dir = optarg;           break;
+      case 'R':  record = true;          break;
+      case 'a':
+        if (strcmp(optarg, "dipole") == 0)
+          synthetic = FX_DIPOLE;
+        else if (strcmp(optarg, "isotropic") == 0)
+          synthetic = FX_ISOTROPIC;
+        else {
+          fprintf(stderr, "Unknown pattern %s\n", optarg);
+          return 1;
+        }  /**  Which pattern  **/
+        break;
+      case 'o':
+        if ((json = fopen(optarg, "w")) == NULL) {
+          perror(optarg);
+          return 1;
+        }  /**  Cannot write  **/
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-f frames] [-s steps] [-r dir] [-R] "
+                "[-a dipole|isotropic] [-o file] [deck.nec ...]\n",
+                argv[0]);
+        return 1;
+    }  /**  Options  **/
+  }  /**  For each option  **/
+  if (frames < 1)
+    frames = 1;
+
+  for (nsteps = 0; nsteps < MAX_STEPS && *steplist != '\0'; ) {
+    steps[nsteps] = strtol(steplist, &next, 10);
+    if (next == steplist)
+      break;
+    if (steps[nsteps] >= 1 && steps[nsteps] <= 90)
+      nsteps++;
+    steplist = (*next == ',') ? next + 1 : next;
+  }  /**  Parse step list  **/
+
+  /**  The parser and loader chat on stdout; keep it for the JSON  **/
+  if (json == NULL)
+    json = fdopen(dup(1), "w");
+  dup2(2, 1);
+
+  if (optind < argc) {
+    paths = argv + optind;
+    npaths = argc - optind;
+  } else {
+    glob(DEFAULT_DECKS, 0, NULL, &decks);
+    paths = decks.gl_pathv;
+    npaths = decks.gl_pathc;
+  }  /**  Decks  **/
+
+  /**  Same settings as the sliders in antenna.tcl start with  **/
+  InitDisplay();
+  SCALE_FACTOR = 15.0 / 5.0;
+  DEFAULT_BOOMHEIGHT = 30.0;
+  POINT_DIST_SCALE = 5.0;
+  POINT_SIZE_SCALE = 0.1;
+  ALPHA = 0.5;
+  MultipleAntMode = 0;
+  ShowRadPat = 1;
+  ShowPolSense = 0;
+
+  WP_Init(0);
+  HaveGL = OS_Open(FRAME_SIZE);
+  renderer = HaveGL ? (const char *) glGetString(GL_RENDERER) : NULL;
+  if (!HaveGL)
+    fprintf(stderr, "ModelBench: no offscreen GL, frames not timed\n");
+
+  fprintf(json, "{\n  \"benchmark\": \"ModelBench\",\n  \"version\": 1,\n");
+  fprintf(json, "  \"frames\": %d,\n  \"frame_size\": %d,\n", frames,
+          FRAME_SIZE);
+  fprintf(json, "  \"kernel\": \"%s\",\n  \"threads\": %d,\n",
+          PK_KernelName(PK_ActiveKernel()), WP_Threads());
+  fprintf(json, "  \"renderer\": ");
+  if (renderer != NULL)
+    JsonString(json, renderer);
+  else
+    fprintf(json, "null");
+  fprintf(json, ",\n  \"decks\": [\n");
+  for (i = 0; i < npaths; i++) {
+    BenchDeck(json, paths[i], steps, nsteps, frames, dir, record,
+              synthetic);
+    fprintf(json, i + 1 < npaths ? ",\n" : "\n");
+  }  /**  For each deck  **/
+  fprintf(json, "  ]\n}\n");
+  fclose(json);
+
+  return 0;
+
+}  /**  End of main  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of ModelBench.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,257 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Headless drawing for the programs that run without Tk (ModelBench and
+ *  AntDaemon): an OpenGL context on an EGL pbuffer, the scene drawn as
+ *  the widget first shows it, and the pixels read back.  Also supplies
+ *  the primitives AntennaWidget.c gives VisWires.c and ant.c, since the
+ *  widget cannot be linked in without Tk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <EGL/egl.h>
+#include <GL/gl.h>
+#include <GL/glu.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "Offscreen.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  EYE_DISTANCE     128.0       /**  As the widget starts up         **/
+#define  EYE_LATITUDE     30.0        /**    ..                            **/
+#define  FIELD_OF_VIEW    7.4         /**    ..degrees, vertical           **/
+#define  SLICES           24          /**  Like SLICES_INIT                **/
+#define  RINGS            1           /**  Like RINGS_INIT                 **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local GLUquadricObj  *Qobj;           /**  For the stand-in primitives     **/
+local int             Size = 0;       /**  Pbuffer width and height        **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               TKA_Cylinder                              **/
+/**                                                                         **/
+/**  Stand-ins for the widget's primitives.  They draw the same shapes      **/
+/**  with GLU directly.                                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TKA_Cylinder(GLfloat radius, GLfloat height, GLint slices, GLint rings) {
+
+  glPushMatrix();
+  glPushMatrix();
+  glTranslatef(0.0, 0.0, height);
+  gluDisk(Qobj, 0.0, radius, slices, rings);
+  glPopMatrix();
+  gluCylinder(Qobj, radius, radius, height, slices, rings);
+  glRotatef(180.0, 1.0, 0.0, 0.0);
+  gluDisk(Qobj, 0.0, radius, slices, rings);
+  glPopMatrix();
+
+}  /**  End of TKA_Cylinder  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 TKA_Cube                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TKA_Cube(GLfloat size) {
+
+  glPushMatrix();
+  glTranslatef(0.0, 0.0, -size / 2.0);
+  glRotatef(45.0, 0.0, 0.0, 1.0);
+  glPushMatrix();
+  glTranslatef(0.0, 0.0, size);
+  gluDisk(Qobj, 0.0, (GLdouble) size / 1.414, 4, 1);
+  glPopMatrix();
+  gluCylinder(Qobj, size / 1.414, size / 1.414, size, 4, 1);
+  glRotatef(180.0, 1.0, 0.0, 0.0);
+  gluDisk(Qobj, 0.0, (GLdouble) size / 1.414, 4, 1);
+  glPopMatrix();
+
+}  /**  End of TKA_Cube  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 OS_Open                                 **/
+/**                                                                         **/
+/**  Makes an OpenGL context on a size by size pbuffer current.  Without    **/
+/**  an X or Wayland display Mesa is asked for its surfaceless platform,    **/
+/**  so this also works on build machines and servers.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool OS_Open(int size) {
+
+  EGLDisplay  display;   /**  EGL display          **/
+  EGLConfig   config;    /**  Chosen config        **/
+  EGLSurface  surface;   /**  The pbuffer          **/
+  EGLContext  context;   /**  GL context           **/
+  EGLint      count;     /**  Configs found        **/
+  EGLint      major;     /**  EGL version          **/
+  EGLint      minor;     /**    ..                 **/
+  EGLint      config_attr[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 16, EGL_NONE
+  };
+  EGLint      surface_attr[] = {
+    EGL_WIDTH, size, EGL_HEIGHT, size, EGL_NONE
+  };
+
+  if (getenv("DISPLAY") == NULL && getenv("WAYLAND_DISPLAY") == NULL)
+    setenv("EGL_PLATFORM", "surfaceless", 0);
+
+  display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    return false;
+  if (!eglChooseConfig(display, config_attr, &config, 1, &count) ||
+      count < 1)
+    return false;
+  surface = eglCreatePbufferSurface(display, config, surface_attr);
+  if (surface == EGL_NO_SURFACE || !eglBindAPI(EGL_OPENGL_API))
+    return false;
+  context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+  if (context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, surface, surface, context))
+    return false;
+
+  Qobj = gluNewQuadric();
+  gluQuadricDrawStyle(Qobj, GLU_FILL);
+  gluQuadricNormals(Qobj, GLU_FLAT);
+
+  glViewport(0, 0, size, size);
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  gluPerspective(FIELD_OF_VIEW, 1.0, 1.0, 10.0 * EYE_DISTANCE);
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_LIGHTING);
+  glEnable(GL_LIGHT0);
+  glClearColor(0.0, 0.0, 0.05, 1.0);
+  Size = size;
+  return true;
+
+}  /**  End of OS_Open  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 OS_Draw                                 **/
+/**                                                                         **/
+/**  Draws the wires and the pattern from the start-up eye position, the    **/
+/**  scene turned by turn degrees about the vertical.                       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void OS_Draw(double turn) {
+
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+  glTranslatef(0.0, 0.0, -EYE_DISTANCE);
+  glRotatef(EYE_LATITUDE, 1.0, 0.0, 0.0);
+  glRotatef(turn, 0.0, 1.0, 0.0);
+  DisplayAntWires(SLICES, RINGS);
+  DisplayAntField();
+
+}  /**  End of OS_Draw  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               OS_WritePPM                               **/
+/**                                                                         **/
+/**  Writes the pbuffer as a binary PPM, top row first.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool OS_WritePPM(FILE *f) {
+
+  unsigned char  *pixels;  /**  RGB, bottom row first  **/
+  int             row;     /**  Loop counter           **/
+
+  if (Size <= 0 || (pixels = malloc(3 * Size * Size)) == NULL)
+    return false;
+  glFinish();
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, Size, Size, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+  fprintf(f, "P6\n%d %d\n255\n", Size, Size);
+  for (row = Size - 1; row >= 0; row--)
+    fwrite(pixels + 3 * Size * row, 3, Size, f);
+  free(pixels);
+
+  return !ferror(f);
+
+}  /**  End of OS_WritePPM  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of Offscreen.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
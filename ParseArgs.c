@@ -162,6 +162,51 @@ GLint PA_ParseArgs(Tcl_Interp  *interp,
 }  /**  End of ParseArgs  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WriteArgs                                **/
+/**                                                                         **/
+/**  Writes every option of cfg as a line "prefix name value", in the form  **/
+/**  PA_ParseArgs reads back.                                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PA_WriteArgs(FILE              *f,
+                  const char        *prefix,
+                  struct PA_Config  *cfg,
+                  void              *data) {
+
+  GLfloat  *v;  /**  Float values  **/
+
+  for ( ; cfg->type != PA_END; cfg++) {
+    v = (GLfloat *)((char *) data + cfg->offset);
+    switch(cfg->type) {
+      case PA_FLOAT:
+        fprintf(f, "%s %s %.9g\n", prefix, cfg->name, (double) v[0]);
+        break;
+      case PA_BOOL:
+        fprintf(f, "%s %s %s\n", prefix, cfg->name,
+          (*((bool *)((char *) data + cfg->offset))) ? "true" : "false");
+        break;
+      case PA_INT:
+        fprintf(f, "%s %s %d\n", prefix, cfg->name,
+          (int) (*((GLint *)((char *) data + cfg->offset))));
+        break;
+      case PA_RGB:
+        fprintf(f, "%s %s %.9g %.9g %.9g\n", prefix, cfg->name,
+          (double) v[0], (double) v[1], (double) v[2]);
+        break;
+      default:
+        break;
+    }  /**  Switch  **/
+  }  /**  For each option  **/
+
+}  /**  End of WriteArgs  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
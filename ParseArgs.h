@@ -28,6 +28,7 @@
 #ifndef PARSEARGS_H
 #define PARSEARGS_H
 
+#include <stdio.h>
 #include <tk.h>
 #include <GL/gl.h>
 #include "MyTypes.h"
@@ -77,6 +78,10 @@ extern GLint PA_ParseArgs(Tcl_Interp  *interp,
                                CONST84 char **argv,
                     struct PA_Config  *cfg, 
                                 void  *data);
+extern void  PA_WriteArgs(FILE              *f,
+                          const char        *prefix,
+                          struct PA_Config  *cfg,
+                          void              *data);
 
 
 #endif
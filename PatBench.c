@@ -0,0 +1,304 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Micro-benchmark for the pattern conversion kernels in PatKernel.c.
+ *  Builds a synthetic 1 degree RP grid (361 x 361 samples, the densest
+ *  grid WriteCardFile asks NEC for) and times converting it to mesh
+ *  positions: first the straightforward per-sample libm loop, then each
+ *  kernel the CPU supports using the cached direction table, and last the
+ *  best kernel split over the WorkPool threads by bands of rows.  Accuracy
+ *  is reported against the libm loop.
+ *
+ *  Usage:  PatBench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "ant.h"
+#include "PatKernel.h"
+#include "WorkPool.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  GRID_SIZE     361    /**  Samples per row and rows  **/
+#define  DEFAULT_ITER  50     /**  Conversions per kernel    **/
+#define  SCALE         1.0    /**  Like POINT_DIST_SCALE     **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Job {
+  const PK_Grid   *grid;  /**  Direction table          **/
+  const FieldVal  *vals;  /**  Pattern being converted  **/
+  float          **out;   /**  Radius, x, y, z          **/
+} Job;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Now                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Now(void) {
+
+  struct timespec  ts;  /**  Monotonic clock  **/
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+
+}  /**  End of Now  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FillPattern                                **/
+/**                                                                         **/
+/**  A half wave dipole along the z axis, in the same layout NEC prints     **/
+/**  it: theta inner, phi outer, gain in dBi with -999.99 in the nulls.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void FillPattern(FieldVal *vals, int n) {
+
+  double  ct;   /**  cos(theta)     **/
+  double  lin;  /**  Linear gain    **/
+  int     el;   /**  Loop counter   **/
+  int     az;   /**  Loop counter   **/
+  int     i;    /**  Sample index   **/
+
+  for (el = 0; el < n; el++) {
+    for (az = 0; az < n; az++) {
+      i = el * n + az;
+      vals[i].theta = az * 360.0 / (n - 1);
+      vals[i].phi = el * 360.0 / (n - 1);
+      ct = cos(radian(vals[i].theta));
+      if (fabs(ct) > 0.9999) {
+        vals[i].total_gain = -999.99;
+      } else {
+        lin = 1.64 * pow(cos(PI / 2.0 * ct) / sqrt(1.0 - ct * ct), 2.0);
+        vals[i].total_gain = 10.0 * log10(lin > 1e-30 ? lin : 1e-30);
+      }  /**  Null or lobe  **/
+    }  /**  For each theta  **/
+  }  /**  For each phi  **/
+
+}  /**  End of FillPattern  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              Reference                                  **/
+/**                                                                         **/
+/**  What the mesh builders in VisField.c did per sample before the         **/
+/**  kernel: two angle conversions, four trig calls and a pow.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Reference(const FieldVal *vals, int count, 
+                     float *radius, float *x, float *y, float *z) {
+
+  double  ttheta;  /**  Temporary angle  **/
+  double  tphi;    /**  Temporary angle  **/
+  double  tdist;   /**  Temp distance    **/
+  int     i;       /**  Loop counter     **/
+
+  for (i = 0; i < count; i++) {
+    ttheta = vals[i].theta * 2.0 * PI / 360.0;
+    tphi = vals[i].phi * 2.0 * PI / 360.0;
+    tdist = PK_DbToLinear(vals[i].total_gain) * SCALE;
+    radius[i] = tdist;
+    y[i] = cos(ttheta) * cos(tphi) * tdist;
+    x[i] = sin(ttheta) * cos(tphi) * tdist;
+    z[i] = sin(tphi)               * tdist;
+  }  /**  For each sample  **/
+
+}  /**  End of Reference  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              ConvertBand                                **/
+/**                                                                         **/
+/**  WorkPool callback converting a band of rows into the Job outputs.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void ConvertBand(void *arg, int first, int last) {
+
+  Job     *job;  /**  What to convert       **/
+  size_t   at;   /**  First output of band  **/
+
+  job = (Job *) arg;
+  at = (size_t) first * job->grid->cols;
+  PK_ConvertRows(job->grid, first, last, &job->vals[0].total_gain, 
+                 sizeof(FieldVal), SCALE, 0.0, true, job->out[0] + at, 
+                 job->out[1] + at, job->out[2] + at, job->out[3] + at);
+
+}  /**  End of ConvertBand  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 main                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int main(int argc, char **argv) {
+
+  FieldVal       *vals;      /**  Synthetic pattern            **/
+  const PK_Grid  *grid;      /**  Shared direction table       **/
+  Job             job;       /**  Threaded conversion          **/
+  float          *ref[4];    /**  Reference radius, x, y, z    **/
+  float          *out[4];    /**  Kernel radius, x, y, z       **/
+  int             count;     /**  Samples in the grid          **/
+  int             iter;      /**  Conversions per kernel       **/
+  int             kernel;    /**  Kernel under test            **/
+  int             i;         /**  Loop counter                 **/
+  int             j;         /**  Loop counter                 **/
+  double          start;     /**  Timer                        **/
+  double          ref_ns;    /**  Reference ns per sample      **/
+  double          ns;        /**  Kernel ns per sample         **/
+  double          rerr;      /**  Max relative radius error    **/
+  double          perr;      /**  Max position error / radius  **/
+  double          e;         /**  Current error                **/
+
+  iter = (argc > 1) ? atoi(argv[1]) : DEFAULT_ITER;
+  if (iter < 1)
+    iter = 1;
+  count = GRID_SIZE * GRID_SIZE;
+  vals = (FieldVal *) malloc(count * sizeof(FieldVal));
+  for (j = 0; j < 4; j++) {
+    ref[j] = (float *) malloc(count * sizeof(float));
+    out[j] = (float *) malloc(count * sizeof(float));
+  }  /**  Allocate outputs  **/
+  FillPattern(vals, GRID_SIZE);
+
+  start = Now();
+  for (i = 0; i < iter; i++)
+    Reference(vals, count, ref[0], ref[1], ref[2], ref[3]);
+  ref_ns = (Now() - start) * 1e9 / ((double) iter * count);
+
+  start = Now();
+  grid = PK_DirectionTable(1.0, GRID_SIZE, GRID_SIZE);
+  printf("%d x %d grid, %d iterations, direction table built in %.2f ms\n", 
+         GRID_SIZE, GRID_SIZE, iter, (Now() - start) * 1e3);
+  printf("%-8s %10s %8s %12s %12s\n", 
+         "kernel", "ns/sample", "speedup", "max rel err", "max pos err");
+  printf("%-8s %10.2f %8.2f %12s %12s\n", "libm", ref_ns, 1.0, "-", "-");
+
+  for (kernel = PK_SCALAR; kernel <= PK_AVX2; kernel++) {
+    if (PK_SelectKernel(kernel) != kernel) {
+      printf("%-8s %10s\n", PK_KernelName(kernel), "unsupported");
+      continue;
+    }  /**  Not on this CPU  **/
+
+    start = Now();
+    for (i = 0; i < iter; i++)
+      PK_Convert(grid, &vals[0].total_gain, sizeof(FieldVal), SCALE, 0.0, 
+                 true, out[0], out[1], out[2], out[3]);
+    ns = (Now() - start) * 1e9 / ((double) iter * count);
+
+    rerr = 0.0;
+    perr = 0.0;
+    for (i = 0; i < count; i++) {
+      if (ref[0][i] > 1e-30) {
+        e = fabs(out[0][i] - ref[0][i]) / ref[0][i];
+        if (e > rerr)
+          rerr = e;
+        for (j = 1; j < 4; j++) {
+          e = fabs(out[j][i] - ref[j][i]) / ref[0][i];
+          if (e > perr)
+            perr = e;
+        }  /**  For x, y, z  **/
+      }  /**  Skip exact nulls  **/
+    }  /**  For each sample  **/
+    printf("%-8s %10.2f %8.2f %12.2e %12.2e\n", PK_KernelName(kernel), 
+           ns, ref_ns / ns, rerr, perr);
+  }  /**  For each kernel  **/
+
+  job.grid = grid;
+  job.vals = vals;
+  job.out = out;
+  PK_SelectKernel(PK_AUTO);
+  start = Now();
+  for (i = 0; i < iter; i++)
+    WP_Run(ConvertBand, &job, GRID_SIZE);
+  ns = (Now() - start) * 1e9 / ((double) iter * count);
+  printf("%-8s %10.2f %8.2f   (%s, %d threads)\n", "pool", ns, ref_ns / ns,
+         PK_KernelName(PK_ActiveKernel()), WP_Threads());
+  WP_Shutdown();
+
+  for (j = 0; j < 4; j++) {
+    free(ref[j]);
+    free(out[j]);
+  }  /**  Free outputs  **/
+  free(vals);
+  return 0;
+
+}  /**  End of main  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           End of PatBench.c                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,523 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Binary pattern files.  A solve result -- the pattern grid, every
+ *  FieldVal quantity stored a column at a time, the segment currents and
+ *  the statistics the renderer scales by -- is written in the layout of
+ *  PF_Header, so that reading it back is an mmap and a few bounds checks
+ *  rather than parsing megabytes of NEC text.  Files are in the byte
+ *  order of the machine that wrote them; one written elsewhere is
+ *  refused rather than swapped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "pcard.h"
+#include "PatFile.h"
+#include "Ports.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Align                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local uint64_t Align(uint64_t offset) {
+
+  return (offset + 7) & ~(uint64_t) 7;
+
+}  /**  End of Align  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Column                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Column(const FieldVal *val, int column) {
+
+  switch (column) {
+    case PF_THETA:        return val->theta;
+    case PF_PHI:          return val->phi;
+    case PF_VERT_GAIN:    return val->vert_gain;
+    case PF_HOR_GAIN:     return val->hor_gain;
+    case PF_TOTAL_GAIN:   return val->total_gain;
+    case PF_AXIAL_RATIO:  return val->axial_ratio;
+    case PF_TILT:         return val->tilt;
+    case PF_THETA_MAG:    return val->theta_mag;
+    case PF_THETA_PHASE:  return val->theta_phase;
+    case PF_PHI_MAG:      return val->phi_mag;
+    default:              return val->phi_phase;
+  }  /**  By column  **/
+
+}  /**  End of Column  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Pad                                     **/
+/**                                                                         **/
+/**  Writes zeros up to offset.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Pad(FILE *f, uint64_t offset) {
+
+  while ((uint64_t) ftell(f) < offset)
+    fputc(0, f);
+
+}  /**  End of Pad  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PF_Write                                 **/
+/**                                                                         **/
+/**  Writes the field and currents of an antenna.  The grid is read off     **/
+/**  the samples, which ParseFieldData keeps in NEC's phi-major order.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool PF_Write(const char *file_name, Ant *ant) {
+
+  FILE         *f;          /**  Output                 **/
+  PF_Header     h;          /**  Header                 **/
+  FieldData    *fd;         /**  The field              **/
+  Tube         *tube;       /**  Tube traversal         **/
+  SegmentData  *seg;        /**  Current traversal      **/
+  uint64_t      offset;     /**  Next free byte         **/
+  int32_t       n;          /**  Segments of one tube   **/
+  double        value;      /**  Column value           **/
+  float         current;    /**  Current value          **/
+  int           i;          /**  Loop counter           **/
+  int           c;          /**  Column counter         **/
+
+  fd = ant->fieldData;
+  if (fd == NULL || fd->count <= 0)
+    return false;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, PF_MAGIC, sizeof(h.magic));
+  h.byte_order = PF_BYTE_ORDER;
+  h.version = PF_VERSION;
+  h.header_size = sizeof(h);
+  h.count = fd->count;
+  for (h.thetas = 1; h.thetas < h.count &&
+       fd->vals[h.thetas].phi == fd->vals[0].phi; h.thetas++)
+    ;
+  h.phis = h.count / h.thetas;
+  h.theta0 = fd->vals[0].theta;
+  h.phi0 = fd->vals[0].phi;
+  if (h.thetas > 1)
+    h.dtheta = fd->vals[1].theta - fd->vals[0].theta;
+  if (h.phis > 1)
+    h.dphi = fd->vals[h.thetas].phi - fd->vals[0].phi;
+  h.frequency = ant->frequency;
+  h.maxgain = fd->maxgain;
+  h.mingain = fd->mingain;
+  h.maxtilt = fd->maxtilt;
+  h.mintilt = fd->mintilt;
+  h.maxaxialratio = fd->maxaxialratio;
+  h.minaxialratio = fd->minaxialratio;
+  h.max_current_mag = ant->max_current_mag;
+  h.min_current_mag = ant->min_current_mag;
+  h.max_current_phase = ant->max_current_phase;
+  h.min_current_phase = ant->min_current_phase;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next) {
+    h.tubes++;
+    for (seg = tube->currents; seg != NULL; seg = seg->next)
+      h.segments++;
+  }  /**  Count currents  **/
+
+  offset = Align(sizeof(h));
+  for (c = 0; c < PF_COLUMNS; c++) {
+    h.column[c] = offset;
+    offset = Align(offset + (uint64_t) h.count * sizeof(double));
+  }  /**  For each column  **/
+  h.sense = offset;
+  offset = Align(offset + (uint64_t) h.count * sizeof(int32_t));
+  h.tube_segments = offset;
+  offset = Align(offset + (uint64_t) h.tubes * sizeof(int32_t));
+  h.current_mag = offset;
+  offset = Align(offset + (uint64_t) h.segments * sizeof(float));
+  h.current_phase = offset;
+  offset = Align(offset + (uint64_t) h.segments * sizeof(float));
+  h.file_size = offset;
+
+  if ((f = fopen(file_name, "wb")) == NULL)
+    return false;
+  fwrite(&h, sizeof(h), 1, f);
+  for (c = 0; c < PF_COLUMNS; c++) {
+    Pad(f, h.column[c]);
+    for (i = 0; i < fd->count; i++) {
+      value = Column(&fd->vals[i], c);
+      fwrite(&value, sizeof(value), 1, f);
+    }  /**  For each sample  **/
+  }  /**  For each column  **/
+  Pad(f, h.sense);
+  for (i = 0; i < fd->count; i++) {
+    n = fd->vals[i].sense;
+    fwrite(&n, sizeof(n), 1, f);
+  }  /**  For each sample  **/
+  Pad(f, h.tube_segments);
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next) {
+    for (n = 0, seg = tube->currents; seg != NULL; seg = seg->next)
+      n++;
+    fwrite(&n, sizeof(n), 1, f);
+  }  /**  For each tube  **/
+  Pad(f, h.current_mag);
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+    for (seg = tube->currents; seg != NULL; seg = seg->next) {
+      current = seg->currentMagnitude;
+      fwrite(&current, sizeof(current), 1, f);
+    }  /**  For each segment  **/
+  Pad(f, h.current_phase);
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+    for (seg = tube->currents; seg != NULL; seg = seg->next) {
+      current = seg->currentPhase;
+      fwrite(&current, sizeof(current), 1, f);
+    }  /**  For each segment  **/
+  Pad(f, h.file_size);
+
+  if (ferror(f)) {
+    fclose(f);
+    return false;
+  }  /**  Write failed  **/
+  return fclose(f) == 0;
+
+}  /**  End of PF_Write  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Fits                                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Fits(const PF_Header *h, uint64_t offset, uint64_t count,
+                size_t size) {
+
+  return (offset & 7) == 0 && offset >= h->header_size &&
+         offset <= h->file_size && count <= (h->file_size - offset) / size;
+
+}  /**  End of Fits  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 PF_Map                                  **/
+/**                                                                         **/
+/**  Maps a pattern file read-only and points the arrays of pattern into    **/
+/**  it.  Fails, leaving nothing mapped, if the file is not a pattern file  **/
+/**  of this version and byte order or any array runs off its end.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool PF_Map(const char *file_name, PF_Pattern *pattern) {
+
+  const PF_Header  *h;     /**  The header        **/
+  struct stat       st;    /**  File size         **/
+  const char       *base;  /**  Start of mapping  **/
+  bool              ok;    /**  Passed checks     **/
+  int               fd;    /**  File descriptor   **/
+  int               c;     /**  Column counter    **/
+
+  memset(pattern, 0, sizeof(*pattern));
+  if ((fd = open(file_name, O_RDONLY)) < 0)
+    return false;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(PF_Header)) {
+    close(fd);
+    return false;
+  }  /**  Too short  **/
+  pattern->size = st.st_size;
+  pattern->base = mmap(NULL, pattern->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (pattern->base == MAP_FAILED) {
+    pattern->base = NULL;
+    return false;
+  }  /**  Cannot map  **/
+
+  base = pattern->base;
+  h = (const PF_Header *) base;
+  ok = memcmp(h->magic, PF_MAGIC, sizeof(h->magic)) == 0 &&
+       h->byte_order == PF_BYTE_ORDER && h->version == PF_VERSION &&
+       h->header_size == sizeof(PF_Header) &&
+       h->file_size <= pattern->size &&
+       Fits(h, h->sense, h->count, sizeof(int32_t)) &&
+       Fits(h, h->tube_segments, h->tubes, sizeof(int32_t)) &&
+       Fits(h, h->current_mag, h->segments, sizeof(float)) &&
+       Fits(h, h->current_phase, h->segments, sizeof(float));
+  for (c = 0; ok && c < PF_COLUMNS; c++)
+    ok = Fits(h, h->column[c], h->count, sizeof(double));
+  if (!ok) {
+    PF_Unmap(pattern);
+    return false;
+  }  /**  Not ours  **/
+
+  pattern->header = h;
+  for (c = 0; c < PF_COLUMNS; c++)
+    pattern->column[c] = (const double *) (base + h->column[c]);
+  pattern->sense = (const int32_t *) (base + h->sense);
+  pattern->tube_segments = (const int32_t *) (base + h->tube_segments);
+  pattern->current_mag = (const float *) (base + h->current_mag);
+  pattern->current_phase = (const float *) (base + h->current_phase);
+
+  return true;
+
+}  /**  End of PF_Map  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PF_Unmap                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PF_Unmap(PF_Pattern *pattern) {
+
+  if (pattern->base != NULL)
+    munmap(pattern->base, pattern->size);
+  memset(pattern, 0, sizeof(*pattern));
+
+}  /**  End of PF_Unmap  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 NecGrid                                 **/
+/**                                                                         **/
+/**  The step of a mapped pattern if it is the square RP grid               **/
+/**  WriteCardFile asks NEC for -- 361 / step samples of theta and of phi,  **/
+/**  both from 0 in whole degrees -- the only grid the mesh can draw; 0     **/
+/**  otherwise.  The samples' own angles are checked as well as the         **/
+/**  header's, since the mesh reads them.                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int NecGrid(const PF_Pattern *p) {
+
+  const PF_Header  *h;     /**  The header          **/
+  int               step;  /**  Degrees, as RP has  **/
+
+  h = p->header;
+  step = (int) (h->dtheta + 0.5);
+  if (h->count == 0 || step < 1 || 361 / step < 2 ||
+      h->thetas != (uint32_t) (361 / step) || h->phis != h->thetas ||
+      (uint64_t) h->thetas * h->phis != h->count ||
+      fabs(h->dtheta - step) > 1e-6 || fabs(h->dphi - step) > 1e-6 ||
+      fabs(h->theta0) > 1e-6 || fabs(h->phi0) > 1e-6)
+    return 0;
+  if (fabs(p->column[PF_THETA][1] - p->column[PF_THETA][0] - step) > 1e-6 ||
+      fabs(p->column[PF_PHI][h->thetas] - p->column[PF_PHI][0] - step) > 
+      1e-6)
+    return 0;
+  return step;
+
+}  /**  End of NecGrid  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 PF_Load                                 **/
+/**                                                                         **/
+/**  Makes a pattern file the field of an antenna, as ParseFieldData would  **/
+/**  have, at the file's frequency.  Files not on NEC's grid (NecGrid) are  **/
+/**  refused, leaving the antenna alone.  The currents are only taken if    **/
+/**  the file has one entry for each tube of the antenna; otherwise the     **/
+/**  antenna is left with none, so nothing is resampled from another        **/
+/**  solve.  The file has no input parameters or ports, so those of the     **/
+/**  last solve are dropped too, and the far field falls back to the        **/
+/**  radiated power until the next solve.                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool PF_Load(const char *file_name, Ant *ant) {
+
+  PF_Pattern        p;       /**  The mapped file        **/
+  const PF_Header  *h;       /**  Its header             **/
+  FieldVal         *vals;    /**  New samples            **/
+  FieldVal         *val;     /**  Sample being filled    **/
+  Tube             *tube;    /**  Tube traversal         **/
+  SegmentData     **link;    /**  Where the next goes    **/
+  SegmentData      *seg;     /**  Current being freed    **/
+  int               first;   /**  First current of tube  **/
+  uint32_t          total;   /**  Currents listed        **/
+  bool              fits;    /**  Currents match wires   **/
+  uint32_t          i;       /**  Loop counter           **/
+  int               j;       /**  Loop counter           **/
+
+  if (!PF_Map(file_name, &p))
+    return false;
+  h = p.header;
+  if (NecGrid(&p) == 0) {
+    fprintf(stderr, "%s: not a square RP grid from 0 degrees\n", 
+            file_name);
+    PF_Unmap(&p);
+    return false;
+  }  /**  Cannot be drawn  **/
+  if (ant->fieldData == NULL)
+    ant->fieldData = calloc(1, sizeof(FieldData));
+  if (ant->fieldData == NULL || 
+      (vals = malloc(h->count * sizeof(FieldVal))) == NULL) {
+    PF_Unmap(&p);
+    return false;
+  }  /**  Out of memory  **/
+
+  for (i = 0; i < h->count; i++) {
+    val = &vals[i];
+    val->theta       = p.column[PF_THETA][i];
+    val->phi         = p.column[PF_PHI][i];
+    val->vert_gain   = p.column[PF_VERT_GAIN][i];
+    val->hor_gain    = p.column[PF_HOR_GAIN][i];
+    val->total_gain  = p.column[PF_TOTAL_GAIN][i];
+    val->axial_ratio = p.column[PF_AXIAL_RATIO][i];
+    val->tilt        = p.column[PF_TILT][i];
+    val->theta_mag   = p.column[PF_THETA_MAG][i];
+    val->theta_phase = p.column[PF_THETA_PHASE][i];
+    val->phi_mag     = p.column[PF_PHI_MAG][i];
+    val->phi_phase   = p.column[PF_PHI_PHASE][i];
+    val->sense       = p.sense[i];
+  }  /**  For each sample  **/
+
+  free(ant->fieldData->vals);
+  ant->fieldData->vals = vals;
+  ant->fieldData->count = h->count;
+  ant->fieldData->maxgain = h->maxgain;
+  ant->fieldData->mingain = h->mingain;
+  ant->fieldData->maxtilt = h->maxtilt;
+  ant->fieldData->mintilt = h->mintilt;
+  ant->fieldData->maxaxialratio = h->maxaxialratio;
+  ant->fieldData->minaxialratio = h->minaxialratio;
+  ant->fieldData->serial = NewPatternSerial();
+  ant->fieldComputed = true;
+  if (h->frequency > 0.0)
+    ant->frequency = h->frequency;
+  FreeFeedTable(ant);
+  PT_Free(ant->ports);
+  ant->ports = NULL;
+
+  /**  Each wire's count within what is left, so the sum cannot wrap  **/
+  fits = h->tubes == (uint32_t) ant->tube_count;
+  total = 0;
+  for (i = 0; fits && i < h->tubes; i++) {
+    if (p.tube_segments[i] < 0 || 
+        (uint32_t) p.tube_segments[i] > h->segments - total)
+      fits = false;
+    else
+      total += p.tube_segments[i];
+  }  /**  For each tube  **/
+  fits = fits && total == h->segments;
+
+  first = 0;
+  for (tube = ant->first_tube, i = 0; tube != NULL; tube = tube->next, i++) {
+    while ((seg = tube->currents) != NULL) {
+      tube->currents = seg->next;
+      free(seg);
+    }  /**  Drop the old currents  **/
+    link = &tube->currents;
+    for (j = 0; fits && j < p.tube_segments[i]; j++) {
+      if ((*link = calloc(1, sizeof(SegmentData))) == NULL) {
+        fits = false;
+        break;
+      }  /**  Out of memory  **/
+      (*link)->currentMagnitude = p.current_mag[first + j];
+      (*link)->currentPhase = p.current_phase[first + j];
+      link = &(*link)->next;
+    }  /**  For each segment  **/
+    if (fits)
+      first += p.tube_segments[i];
+  }  /**  For each tube  **/
+
+  if (!fits) {
+    for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+      while ((seg = tube->currents) != NULL) {
+        tube->currents = seg->next;
+        free(seg);
+      }  /**  Drop what was taken  **/
+    fprintf(stderr, "%s: currents do not fit the %d wires; "
+            "pattern only\n", file_name, ant->tube_count);
+    ant->solvedSerial = 0;
+  } else {
+    ant->max_current_mag = h->max_current_mag;
+    ant->min_current_mag = h->min_current_mag;
+    ant->max_current_phase = h->max_current_phase;
+    ant->min_current_phase = h->min_current_phase;
+    ant->solvedSerial = ant->fieldData->serial;
+  }  /**  Currents match the wires  **/
+  ant->resampleError = -1.0;
+
+  PF_Unmap(&p);
+  return true;
+
+}  /**  End of PF_Load  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of PatFile.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,147 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PATFILE_H
+#define PATFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  PF_MAGIC        "AVPATTN"    /**  First 8 bytes, with the NUL    **/
+#define  PF_VERSION      1
+#define  PF_BYTE_ORDER   0x01020304   /**  As written by this machine     **/
+
+#define  PF_THETA        0            /**  Double columns, one value per  **/
+#define  PF_PHI          1            /**  sample, in the FieldVal order  **/
+#define  PF_VERT_GAIN    2
+#define  PF_HOR_GAIN     3
+#define  PF_TOTAL_GAIN   4
+#define  PF_AXIAL_RATIO  5
+#define  PF_TILT         6
+#define  PF_THETA_MAG    7
+#define  PF_THETA_PHASE  8
+#define  PF_PHI_MAG      9
+#define  PF_PHI_PHASE    10
+#define  PF_COLUMNS      11
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Typedefs                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+/*
+ *  The file starts with this header; every offset is in bytes from the
+ *  start of the file and is a multiple of 8, so the arrays can be used
+ *  in place once the file is mapped.
+ */
+
+typedef struct PF_Header {
+  char      magic[8];             /**  PF_MAGIC                         **/
+  uint32_t  byte_order;           /**  PF_BYTE_ORDER                    **/
+  uint32_t  version;              /**  PF_VERSION                       **/
+  uint32_t  header_size;          /**  sizeof(PF_Header)                **/
+  uint32_t  count;                /**  Pattern samples                  **/
+  uint32_t  thetas;               /**  Grid: samples per phi row        **/
+  uint32_t  phis;                 /**    ..and rows                     **/
+  uint32_t  tubes;                /**  Wires with currents              **/
+  uint32_t  segments;             /**  Currents, over all wires         **/
+  double    theta0;               /**  Grid: first theta, degrees       **/
+  double    phi0;                 /**    ..first phi                    **/
+  double    dtheta;               /**    ..theta step                   **/
+  double    dphi;                 /**    ..phi step                     **/
+  double    frequency;            /**  MHz                              **/
+  double    maxgain;              /**  FieldData statistics             **/
+  double    mingain;
+  double    maxtilt;
+  double    mintilt;
+  double    maxaxialratio;
+  double    minaxialratio;
+  double    max_current_mag;      /**  Ant current statistics           **/
+  double    min_current_mag;
+  double    max_current_phase;
+  double    min_current_phase;
+  uint64_t  column[PF_COLUMNS];   /**  double[count] each               **/
+  uint64_t  sense;                /**  int32_t[count], LINEAR..LEFT     **/
+  uint64_t  tube_segments;        /**  int32_t[tubes]                   **/
+  uint64_t  current_mag;          /**  float[segments]                  **/
+  uint64_t  current_phase;        /**  float[segments]                  **/
+  uint64_t  file_size;            /**  Total bytes                      **/
+} PF_Header;
+
+typedef struct PF_Pattern {
+  const PF_Header  *header;               /**  Start of the mapping       **/
+  const double     *column[PF_COLUMNS];   /**  Into the mapping           **/
+  const int32_t    *sense;
+  const int32_t    *tube_segments;
+  const float      *current_mag;
+  const float      *current_phase;
+  void             *base;                 /**  For munmap                 **/
+  size_t            size;
+} PF_Pattern;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           Function Prototypes                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool  PF_Write(const char *, Ant *);
+bool  PF_Map(const char *, PF_Pattern *);
+void  PF_Unmap(PF_Pattern *);
+bool  PF_Load(const char *, Ant *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of PatFile.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
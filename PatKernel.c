@@ -0,0 +1,890 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Converts a NEC radiation pattern grid into mesh positions.  Each sample
+ *  of the RP grid is a (theta, phi, gain in dB) triple; the drawing code
+ *  needs the linear radius and the cartesian position of every sample.
+ *  The directions only depend on the grid step and size, never on the
+ *  antenna or the frequency, so the unit vectors are tabulated once per
+ *  grid (PK_DirectionTable) and shared by every caller.  What remains per
+ *  sample is the dB to linear conversion and three multiplies, done 4
+ *  (SSE2) or 8 (AVX2) samples at a time when the CPU allows, with a plain
+ *  libm loop as the fallback.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyTypes.h"
+#include "PatKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PK_HAVE_X86
+#include <immintrin.h>
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  LOG2_10_OVER_10  0.33219280948873623  /**  10^(x/10) = 2^(x*k)  **/
+#define  EXP2_MIN         -126.0               /**  Smallest normal      **/
+#define  EXP2_MAX         127.0                /**  Largest before inf   **/
+#define  NORMAL_EPS       1e-12                /**  Degenerate normal    **/
+
+/**  Minimax coefficients of 2^f on [0,1), relative error below 2e-7  **/
+#define  EXP2_C6  1.535336188319500e-4
+#define  EXP2_C5  1.339887440266574e-3
+#define  EXP2_C4  9.618437357674640e-3
+#define  EXP2_C3  5.550332471162809e-2
+#define  EXP2_C2  2.402264791363012e-1
+#define  EXP2_C1  6.931472028550421e-1
+#define  EXP2_C0  1.0
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int      ActiveKernel = PK_AUTO;  /**  Resolved on first conversion  **/
+local PK_Grid  Tables[PK_TABLES];       /**  Direction table cache         **/
+local int      NextTable = 0;           /**  Cache slot to replace next    **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             PK_DbToLinear                               **/
+/**                                                                         **/
+/**  Converts a gain in dB to a linear power ratio.                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double PK_DbToLinear(double db) {
+
+  return pow(10.0, db / 10.0);
+
+}  /**  End of PK_DbToLinear  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             PK_KernelName                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+const char *PK_KernelName(int kernel) {
+
+  switch (kernel) {
+    case PK_SCALAR: return "scalar";
+    case PK_SSE2:   return "sse2";
+    case PK_AVX2:   return "avx2";
+  }  /**  Switch on kernel  **/
+  return "auto";
+
+}  /**  End of PK_KernelName  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            PK_SelectKernel                              **/
+/**                                                                         **/
+/**  Chooses the kernel used by PK_Convert.  PK_AUTO picks the widest one   **/
+/**  the CPU supports; asking for one the CPU lacks falls back the same     **/
+/**  way.  Returns the kernel actually selected.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int PK_SelectKernel(int kernel) {
+
+  int  best;  /**  Widest supported kernel  **/
+
+  best = PK_SCALAR;
+#ifdef PK_HAVE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2"))
+    best = PK_SSE2;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    best = PK_AVX2;
+#endif
+
+  if (kernel < PK_SCALAR || kernel > best)
+    kernel = best;
+  ActiveKernel = kernel;
+  return kernel;
+
+}  /**  End of PK_SelectKernel  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              PK_BuildGrid                               **/
+/**                                                                         **/
+/**  Fills the direction table of a rows x cols RP grid as WriteCardFile    **/
+/**  asks NEC for it: theta and phi both start at 0 and advance by step     **/
+/**  degrees, theta along a row and phi between rows.  Sample (row, col)    **/
+/**  is at index row * cols + col, the order NEC prints the pattern in.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PK_BuildGrid(PK_Grid *grid, double step, int rows, int cols) {
+
+  double  *cos_theta;  /**  One per column  **/
+  double  *sin_theta;  /**  One per column  **/
+  double   cos_phi;    /**  Current row     **/
+  double   sin_phi;    /**  Current row     **/
+  int      row;        /**  Loop counter    **/
+  int      col;        /**  Loop counter    **/
+  size_t   i;          /**  Sample index    **/
+
+  PK_FreeGrid(grid);
+  grid->step = step;
+  grid->rows = rows;
+  grid->cols = cols;
+  grid->dir_x = (float *) malloc((size_t) rows * cols * sizeof(float));
+  grid->dir_y = (float *) malloc((size_t) rows * cols * sizeof(float));
+  grid->dir_z = (float *) malloc((size_t) rows * cols * sizeof(float));
+
+  cos_theta = (double *) malloc(cols * sizeof(double));
+  sin_theta = (double *) malloc(cols * sizeof(double));
+  for (col = 0; col < cols; col++) {
+    cos_theta[col] = cos(radian(col * step));
+    sin_theta[col] = sin(radian(col * step));
+  }  /**  For each column  **/
+
+  for (row = 0; row < rows; row++) {
+    cos_phi = cos(radian(row * step));
+    sin_phi = sin(radian(row * step));
+    for (col = 0; col < cols; col++) {
+      i = (size_t) row * cols + col;
+      grid->dir_x[i] = sin_theta[col] * cos_phi;
+      grid->dir_y[i] = cos_theta[col] * cos_phi;
+      grid->dir_z[i] = sin_phi;
+    }  /**  For each column  **/
+  }  /**  For each row  **/
+
+  free(cos_theta);
+  free(sin_theta);
+
+}  /**  End of PK_BuildGrid  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              PK_FreeGrid                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PK_FreeGrid(PK_Grid *grid) {
+
+  free(grid->dir_x);
+  free(grid->dir_y);
+  free(grid->dir_z);
+  memset(grid, 0, sizeof(PK_Grid));
+
+}  /**  End of PK_FreeGrid  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           PK_DirectionTable                             **/
+/**                                                                         **/
+/**  Returns the shared direction table for a grid of the given step and    **/
+/**  size, building it on first use.  The last PK_TABLES grids are kept,    **/
+/**  which covers every antenna and overlay in a scene (they all use        **/
+/**  curr_step_size) plus a few step changes.  The table belongs to the     **/
+/**  cache; callers must not free or modify it.                             **/
+/**                                                                         **/
+/**  Main thread only: the cache has no lock, and a miss rebuilds the       **/
+/**  oldest slot in place, so a table is only good until the next call.     **/
+/**  Use it within the call that asked for it -- hand it to WP_Run          **/
+/**  workers, which only read it -- and never keep the pointer.  A caller   **/
+/**  that needs a grid of its own builds one with PK_BuildGrid.             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+const PK_Grid *PK_DirectionTable(double step, int rows, int cols) {
+
+  PK_Grid  *grid;  /**  Cache slot    **/
+  int       i;     /**  Loop counter  **/
+
+  for (i = 0; i < PK_TABLES; i++) {
+    grid = &Tables[i];
+    if (grid->dir_x != NULL && grid->step == step && 
+        grid->rows == rows && grid->cols == cols)
+      return grid;
+  }  /**  Look for a match  **/
+
+  grid = &Tables[NextTable];
+  NextTable = (NextTable + 1) % PK_TABLES;
+  PK_BuildGrid(grid, step, rows, cols);
+  return grid;
+
+}  /**  End of PK_DirectionTable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              ConvertScalar                              **/
+/**                                                                         **/
+/**  Reference kernel: one sample at a time through libm.  Like the vector  **/
+/**  kernels it converts one row of the grid; the outputs hold just that    **/
+/**  row, indexed by column.                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void ConvertScalar(const PK_Grid *grid, const char *gbase, 
+                         size_t stride, float scale, float offset, 
+                         int use_gain, int row, 
+                         float *radius, float *x, float *y, float *z) {
+
+  float   r;    /**  Linear radius  **/
+  int     col;  /**  Loop counter   **/
+  size_t  i;    /**  Sample index   **/
+
+  for (col = 0; col < grid->cols; col++) {
+    i = (size_t) row * grid->cols + col;
+    if (use_gain)
+      r = PK_DbToLinear(*(const double *) (gbase + i * stride));
+    else
+      r = 1.0;
+    r = r * scale + offset;
+    radius[col] = r;
+    x[col] = grid->dir_x[i] * r;
+    y[col] = grid->dir_y[i] * r;
+    z[col] = grid->dir_z[i] * r;
+  }  /**  For each column  **/
+
+}  /**  End of ConvertScalar  **/
+
+
+#ifdef PK_HAVE_X86
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ConvertSSE2                               **/
+/**                                                                         **/
+/**  Four samples per iteration.  10^(g/10) is computed as 2^(g*k) with     **/
+/**  the integer part going straight into the float exponent and the       **/
+/**  fraction through the EXP2 polynomial.  The exponent is clamped, so     **/
+/**  the -999.99 dB NEC prints for a deep null comes out as a tiny radius   **/
+/**  rather than a denormal.                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("sse2")))
+local void ConvertSSE2(const PK_Grid *grid, const char *gbase, 
+                       size_t stride, float scale, float offset, 
+                       int use_gain, int row, 
+                       float *radius, float *x, float *y, float *z) {
+
+  __m128   g;       /**  Gains, then radii        **/
+  __m128   f;       /**  Fractional exponent      **/
+  __m128   p;       /**  Polynomial accumulator   **/
+  __m128i  n;       /**  Integer exponent         **/
+  __m128   vscale;  /**  Broadcast scale          **/
+  __m128   voffs;   /**  Broadcast offset         **/
+  const char *s;    /**  First gain of the group  **/
+  const float *dx;  /**  Directions of this row   **/
+  const float *dy;  /**  Directions of this row   **/
+  const float *dz;  /**  Directions of this row   **/
+  size_t   base;    /**  First index of the row   **/
+  int      col;     /**  Loop counter             **/
+
+  base   = (size_t) row * grid->cols;
+  dx     = grid->dir_x + base;
+  dy     = grid->dir_y + base;
+  dz     = grid->dir_z + base;
+  vscale = _mm_set1_ps(scale);
+  voffs  = _mm_set1_ps(offset);
+
+  for (col = 0; col + 4 <= grid->cols; col += 4) {
+    if (use_gain) {
+      s = gbase + (base + col) * stride;
+      g = _mm_set_ps(*(const double *) (s + 3 * stride),
+                     *(const double *) (s + 2 * stride),
+                     *(const double *) (s + stride),
+                     *(const double *) s);
+      g = _mm_mul_ps(g, _mm_set1_ps(LOG2_10_OVER_10));
+      g = _mm_max_ps(g, _mm_set1_ps(EXP2_MIN));
+      g = _mm_min_ps(g, _mm_set1_ps(EXP2_MAX));
+
+      /**  floor() without SSE4.1: truncate, then fix up negatives  **/
+      n = _mm_cvttps_epi32(g);
+      f = _mm_cvtepi32_ps(n);
+      p = _mm_and_ps(_mm_cmpgt_ps(f, g), _mm_set1_ps(1.0f));
+      f = _mm_sub_ps(f, p);
+      n = _mm_cvttps_epi32(f);
+      f = _mm_sub_ps(g, f);
+
+      p = _mm_set1_ps(EXP2_C6);
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C5));
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C4));
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C3));
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C2));
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C1));
+      p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C0));
+
+      n = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+      g = _mm_mul_ps(p, _mm_castsi128_ps(n));
+    } else {
+      g = _mm_set1_ps(1.0f);
+    }  /**  Radius from gain or unit sphere  **/
+
+    g = _mm_add_ps(_mm_mul_ps(g, vscale), voffs);
+    _mm_storeu_ps(radius + col, g);
+    _mm_storeu_ps(x + col, 
+                  _mm_mul_ps(_mm_loadu_ps(dx + col), g));
+    _mm_storeu_ps(y + col, 
+                  _mm_mul_ps(_mm_loadu_ps(dy + col), g));
+    _mm_storeu_ps(z + col, 
+                  _mm_mul_ps(_mm_loadu_ps(dz + col), g));
+  }  /**  For each group of 4  **/
+
+  /**  Leftover columns  **/
+  for ( ; col < grid->cols; col++) {
+    size_t  i;  /**  Sample index  **/
+    float   r;  /**  Radius        **/
+
+    i = base + col;
+    r = use_gain ? PK_DbToLinear(*(const double *) (gbase + i * stride)) : 1.0;
+    r = r * scale + offset;
+    radius[col] = r;
+    x[col] = grid->dir_x[i] * r;
+    y[col] = grid->dir_y[i] * r;
+    z[col] = grid->dir_z[i] * r;
+  }  /**  For each leftover  **/
+
+}  /**  End of ConvertSSE2  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ConvertAVX2                               **/
+/**                                                                         **/
+/**  Same as ConvertSSE2 eight samples at a time, with a real floor and     **/
+/**  fused multiply-adds for the polynomial.                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("avx2,fma")))
+local void ConvertAVX2(const PK_Grid *grid, const char *gbase, 
+                       size_t stride, float scale, float offset, 
+                       int use_gain, int row, 
+                       float *radius, float *x, float *y, float *z) {
+
+  __m256   g;       /**  Gains, then radii        **/
+  __m256   f;       /**  Fractional exponent      **/
+  __m256   p;       /**  Polynomial accumulator   **/
+  __m256i  n;       /**  Integer exponent         **/
+  __m256   vscale;  /**  Broadcast scale          **/
+  __m256   voffs;   /**  Broadcast offset         **/
+  const char *s;    /**  First gain of the group  **/
+  const float *dx;  /**  Directions of this row   **/
+  const float *dy;  /**  Directions of this row   **/
+  const float *dz;  /**  Directions of this row   **/
+  size_t   base;    /**  First index of the row   **/
+  int      col;     /**  Loop counter             **/
+
+  base   = (size_t) row * grid->cols;
+  dx     = grid->dir_x + base;
+  dy     = grid->dir_y + base;
+  dz     = grid->dir_z + base;
+  vscale = _mm256_set1_ps(scale);
+  voffs  = _mm256_set1_ps(offset);
+
+  for (col = 0; col + 8 <= grid->cols; col += 8) {
+    if (use_gain) {
+      s = gbase + (base + col) * stride;
+      g = _mm256_set_ps(*(const double *) (s + 7 * stride),
+                        *(const double *) (s + 6 * stride),
+                        *(const double *) (s + 5 * stride),
+                        *(const double *) (s + 4 * stride),
+                        *(const double *) (s + 3 * stride),
+                        *(const double *) (s + 2 * stride),
+                        *(const double *) (s + stride),
+                        *(const double *) s);
+      g = _mm256_mul_ps(g, _mm256_set1_ps(LOG2_10_OVER_10));
+      g = _mm256_max_ps(g, _mm256_set1_ps(EXP2_MIN));
+      g = _mm256_min_ps(g, _mm256_set1_ps(EXP2_MAX));
+
+      f = _mm256_floor_ps(g);
+      n = _mm256_cvtps_epi32(f);
+      f = _mm256_sub_ps(g, f);
+
+      p = _mm256_set1_ps(EXP2_C6);
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C5));
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C4));
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C3));
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C2));
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C1));
+      p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(EXP2_C0));
+
+      n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+      g = _mm256_mul_ps(p, _mm256_castsi256_ps(n));
+    } else {
+      g = _mm256_set1_ps(1.0f);
+    }  /**  Radius from gain or unit sphere  **/
+
+    g = _mm256_fmadd_ps(g, vscale, voffs);
+    _mm256_storeu_ps(radius + col, g);
+    _mm256_storeu_ps(x + col, 
+                     _mm256_mul_ps(_mm256_loadu_ps(dx + col), g));
+    _mm256_storeu_ps(y + col, 
+                     _mm256_mul_ps(_mm256_loadu_ps(dy + col), g));
+    _mm256_storeu_ps(z + col, 
+                     _mm256_mul_ps(_mm256_loadu_ps(dz + col), g));
+  }  /**  For each group of 8  **/
+
+  /**  Leftover columns  **/
+  for ( ; col < grid->cols; col++) {
+    size_t  i;  /**  Sample index  **/
+    float   r;  /**  Radius        **/
+
+    i = base + col;
+    r = use_gain ? PK_DbToLinear(*(const double *) (gbase + i * stride)) : 1.0;
+    r = r * scale + offset;
+    radius[col] = r;
+    x[col] = grid->dir_x[i] * r;
+    y[col] = grid->dir_y[i] * r;
+    z[col] = grid->dir_z[i] * r;
+  }  /**  For each leftover  **/
+
+}  /**  End of ConvertAVX2  **/
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            PK_ActiveKernel                              **/
+/**                                                                         **/
+/**  Returns the kernel PK_Convert will use, choosing one on first call.    **/
+/**  Code that converts rows from several threads calls this beforehand     **/
+/**  so that the choice is made once, on the calling thread.                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int PK_ActiveKernel(void) {
+
+  if (ActiveKernel == PK_AUTO)
+    PK_SelectKernel(PK_AUTO);
+  return ActiveKernel;
+
+}  /**  End of PK_ActiveKernel  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             PK_ConvertRows                              **/
+/**                                                                         **/
+/**  Computes radius and x/y/z for rows first up to (not including) last.   **/
+/**  gain points at the first sample's gain in dB of the whole grid and     **/
+/**  stride is the distance in bytes between samples, so an array of        **/
+/**  FieldVal can be passed without copying.  The radius is linear gain *   **/
+/**  scale + offset, or just scale + offset when use_gain is false (the     **/
+/**  colour spheres). The outputs start at row first: sample (row, col)     **/
+/**  goes to (row - first) * cols + col.  Different row ranges touch        **/
+/**  disjoint memory, so ranges can be converted from several threads at    **/
+/**  once.                                                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PK_ConvertRows(const PK_Grid *grid, int first, int last, 
+                    const double *gain, size_t stride, 
+                    double scale, double offset, int use_gain,
+                    float *radius, float *x, float *y, float *z) {
+
+  size_t  out;  /**  First output of the row  **/
+  int     row;  /**  Loop counter              **/
+
+  for (row = first; row < last; row++) {
+    out = (size_t) (row - first) * grid->cols;
+    switch (PK_ActiveKernel()) {
+#ifdef PK_HAVE_X86
+      case PK_AVX2:
+        ConvertAVX2(grid, (const char *) gain, stride, scale, offset, 
+                    use_gain, row, 
+                    radius + out, x + out, y + out, z + out);
+        break;
+      case PK_SSE2:
+        ConvertSSE2(grid, (const char *) gain, stride, scale, offset, 
+                    use_gain, row, 
+                    radius + out, x + out, y + out, z + out);
+        break;
+#endif
+      default:
+        ConvertScalar(grid, (const char *) gain, stride, scale, offset, 
+                      use_gain, row, 
+                      radius + out, x + out, y + out, z + out);
+        break;
+    }  /**  Switch on kernel  **/
+  }  /**  For each row  **/
+
+}  /**  End of PK_ConvertRows  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PK_Convert                                **/
+/**                                                                         **/
+/**  Converts the whole grid.  Same as PK_ConvertRows over every row, so    **/
+/**  the outputs are rows*cols floats each, indexed row * cols + col.       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PK_Convert(const PK_Grid *grid, const double *gain, size_t stride, 
+                double scale, double offset, int use_gain,
+                float *radius, float *x, float *y, float *z) {
+
+  PK_ConvertRows(grid, 0, grid->rows, gain, stride, scale, offset, use_gain,
+                 radius, x, y, z);
+
+}  /**  End of PK_Convert  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             NormalsScalar                               **/
+/**                                                                         **/
+/**  Normals for columns first to last-1 of one row.  The tangents are      **/
+/**  central differences to the neighbouring samples, wrapping around in    **/
+/**  both directions, and the normal is their cross product.  It is turned  **/
+/**  to point away from the origin: every pattern surface is a radius per   **/
+/**  direction, so the outward normal always has a positive dot product     **/
+/**  with the position.  Where the tangents vanish (at the poles, where a   **/
+/**  whole row collapses to one point) the radial direction is used         **/
+/**  instead.                                                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void NormalsScalar(const float *px, const float *py, const float *pz,
+                         int rows, int cols, int row, int first, int last,
+                         float *nx, float *ny, float *nz) {
+
+  const float  *p[3];  /**  Positions, as x/y/z           **/
+  float  tu[3];        /**  Tangent along the row         **/
+  float  tv[3];        /**  Tangent across rows           **/
+  float  n[3];         /**  Normal                        **/
+  float  len;          /**  Length of the normal          **/
+  int    up;           /**  Next row, wrapped              **/
+  int    dn;           /**  Previous row, wrapped          **/
+  int    col;          /**  Loop counter                  **/
+  int    k;            /**  Loop counter                  **/
+  size_t i;            /**  Sample index                  **/
+  size_t l;            /**  Left neighbour                **/
+  size_t r;            /**  Right neighbour               **/
+
+  p[0] = px;
+  p[1] = py;
+  p[2] = pz;
+  up = (row + 1) % rows;
+  dn = (row + rows - 1) % rows;
+  for (col = first; col < last; col++) {
+    i = (size_t) row * cols + col;
+    l = (size_t) row * cols + (col + cols - 1) % cols;
+    r = (size_t) row * cols + (col + 1) % cols;
+    for (k = 0; k < 3; k++) {
+      tu[k] = p[k][r] - p[k][l];
+      tv[k] = p[k][(size_t) up * cols + col] - p[k][(size_t) dn * cols + col];
+    }  /**  For x, y, z  **/
+    n[0] = tu[1] * tv[2] - tu[2] * tv[1];
+    n[1] = tu[2] * tv[0] - tu[0] * tv[2];
+    n[2] = tu[0] * tv[1] - tu[1] * tv[0];
+
+    len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len < NORMAL_EPS) {
+      n[0] = px[i];
+      n[1] = py[i];
+      n[2] = pz[i];
+      len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      if (len < NORMAL_EPS) {
+        n[0] = 0.0;
+        n[1] = 0.0;
+        n[2] = 1.0;
+        len = 1.0;
+      }  /**  Point at the origin  **/
+    } else if (n[0] * px[i] + n[1] * py[i] + n[2] * pz[i] < 0.0) {
+      len = -len;
+    }  /**  Degenerate or pointing inwards  **/
+
+    nx[i] = n[0] / len;
+    ny[i] = n[1] / len;
+    nz[i] = n[2] / len;
+  }  /**  For each column  **/
+
+}  /**  End of NormalsScalar  **/
+
+
+#ifdef PK_HAVE_X86
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              NormalsSSE2                                **/
+/**                                                                         **/
+/**  Four normals per iteration for the inner columns of one row; the two   **/
+/**  wrap-around columns go through NormalsScalar.  A group with a          **/
+/**  degenerate normal is handed to NormalsScalar too.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("sse2")))
+local void NormalsSSE2(const float *px, const float *py, const float *pz,
+                       int rows, int cols, int row,
+                       float *nx, float *ny, float *nz) {
+
+  __m128  tu[3];   /**  Tangent along the row          **/
+  __m128  tv[3];   /**  Tangent across rows            **/
+  __m128  n[3];    /**  Normal                         **/
+  __m128  len2;    /**  Squared length of the normal   **/
+  __m128  dot;     /**  Normal . position              **/
+  __m128  flip;    /**  Sign bit where inwards         **/
+  __m128  inv;     /**  1 / length                     **/
+  size_t  c;       /**  This row                       **/
+  size_t  u;       /**  Next row                       **/
+  size_t  d;       /**  Previous row                   **/
+  int     col;     /**  Loop counter                   **/
+
+  c = (size_t) row * cols;
+  u = (size_t) ((row + 1) % rows) * cols;
+  d = (size_t) ((row + rows - 1) % rows) * cols;
+
+  NormalsScalar(px, py, pz, rows, cols, row, 0, 1, nx, ny, nz);
+  for (col = 1; col + 4 < cols; col += 4) {
+    tu[0] = _mm_sub_ps(_mm_loadu_ps(px + c + col + 1), 
+                       _mm_loadu_ps(px + c + col - 1));
+    tu[1] = _mm_sub_ps(_mm_loadu_ps(py + c + col + 1), 
+                       _mm_loadu_ps(py + c + col - 1));
+    tu[2] = _mm_sub_ps(_mm_loadu_ps(pz + c + col + 1), 
+                       _mm_loadu_ps(pz + c + col - 1));
+    tv[0] = _mm_sub_ps(_mm_loadu_ps(px + u + col), _mm_loadu_ps(px + d + col));
+    tv[1] = _mm_sub_ps(_mm_loadu_ps(py + u + col), _mm_loadu_ps(py + d + col));
+    tv[2] = _mm_sub_ps(_mm_loadu_ps(pz + u + col), _mm_loadu_ps(pz + d + col));
+
+    n[0] = _mm_sub_ps(_mm_mul_ps(tu[1], tv[2]), _mm_mul_ps(tu[2], tv[1]));
+    n[1] = _mm_sub_ps(_mm_mul_ps(tu[2], tv[0]), _mm_mul_ps(tu[0], tv[2]));
+    n[2] = _mm_sub_ps(_mm_mul_ps(tu[0], tv[1]), _mm_mul_ps(tu[1], tv[0]));
+    len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), 
+                                 _mm_mul_ps(n[1], n[1])),
+                      _mm_mul_ps(n[2], n[2]));
+    if (_mm_movemask_ps(_mm_cmplt_ps(len2, 
+                        _mm_set1_ps(NORMAL_EPS * NORMAL_EPS)))) {
+      NormalsScalar(px, py, pz, rows, cols, row, col, col + 4, nx, ny, nz);
+      continue;
+    }  /**  Degenerate somewhere, let the scalar code sort it out  **/
+
+    dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], _mm_loadu_ps(px + c + col)),
+                                _mm_mul_ps(n[1], _mm_loadu_ps(py + c + col))),
+                     _mm_mul_ps(n[2], _mm_loadu_ps(pz + c + col)));
+    flip = _mm_and_ps(dot, _mm_set1_ps(-0.0f));
+    inv = _mm_xor_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len2)), flip);
+    _mm_storeu_ps(nx + c + col, _mm_mul_ps(n[0], inv));
+    _mm_storeu_ps(ny + c + col, _mm_mul_ps(n[1], inv));
+    _mm_storeu_ps(nz + c + col, _mm_mul_ps(n[2], inv));
+  }  /**  For each group of 4  **/
+  NormalsScalar(px, py, pz, rows, cols, row, col, cols, nx, ny, nz);
+
+}  /**  End of NormalsSSE2  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              NormalsAVX2                                **/
+/**                                                                         **/
+/**  Same as NormalsSSE2 eight samples at a time.                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+__attribute__((target("avx2,fma")))
+local void NormalsAVX2(const float *px, const float *py, const float *pz,
+                       int rows, int cols, int row,
+                       float *nx, float *ny, float *nz) {
+
+  __m256  tu[3];   /**  Tangent along the row          **/
+  __m256  tv[3];   /**  Tangent across rows            **/
+  __m256  n[3];    /**  Normal                         **/
+  __m256  len2;    /**  Squared length of the normal   **/
+  __m256  dot;     /**  Normal . position              **/
+  __m256  flip;    /**  Sign bit where inwards         **/
+  __m256  inv;     /**  1 / length                     **/
+  size_t  c;       /**  This row                       **/
+  size_t  u;       /**  Next row                       **/
+  size_t  d;       /**  Previous row                   **/
+  int     col;     /**  Loop counter                   **/
+
+  c = (size_t) row * cols;
+  u = (size_t) ((row + 1) % rows) * cols;
+  d = (size_t) ((row + rows - 1) % rows) * cols;
+
+  NormalsScalar(px, py, pz, rows, cols, row, 0, 1, nx, ny, nz);
+  for (col = 1; col + 8 < cols; col += 8) {
+    tu[0] = _mm256_sub_ps(_mm256_loadu_ps(px + c + col + 1), 
+                          _mm256_loadu_ps(px + c + col - 1));
+    tu[1] = _mm256_sub_ps(_mm256_loadu_ps(py + c + col + 1), 
+                          _mm256_loadu_ps(py + c + col - 1));
+    tu[2] = _mm256_sub_ps(_mm256_loadu_ps(pz + c + col + 1), 
+                          _mm256_loadu_ps(pz + c + col - 1));
+    tv[0] = _mm256_sub_ps(_mm256_loadu_ps(px + u + col), 
+                          _mm256_loadu_ps(px + d + col));
+    tv[1] = _mm256_sub_ps(_mm256_loadu_ps(py + u + col), 
+                          _mm256_loadu_ps(py + d + col));
+    tv[2] = _mm256_sub_ps(_mm256_loadu_ps(pz + u + col), 
+                          _mm256_loadu_ps(pz + d + col));
+
+    n[0] = _mm256_fmsub_ps(tu[1], tv[2], _mm256_mul_ps(tu[2], tv[1]));
+    n[1] = _mm256_fmsub_ps(tu[2], tv[0], _mm256_mul_ps(tu[0], tv[2]));
+    n[2] = _mm256_fmsub_ps(tu[0], tv[1], _mm256_mul_ps(tu[1], tv[0]));
+    len2 = _mm256_fmadd_ps(n[0], n[0], 
+           _mm256_fmadd_ps(n[1], n[1], _mm256_mul_ps(n[2], n[2])));
+    if (_mm256_movemask_ps(_mm256_cmp_ps(len2, 
+                           _mm256_set1_ps(NORMAL_EPS * NORMAL_EPS),
+                           _CMP_LT_OQ))) {
+      NormalsScalar(px, py, pz, rows, cols, row, col, col + 8, nx, ny, nz);
+      continue;
+    }  /**  Degenerate somewhere, let the scalar code sort it out  **/
+
+    dot = _mm256_fmadd_ps(n[0], _mm256_loadu_ps(px + c + col),
+          _mm256_fmadd_ps(n[1], _mm256_loadu_ps(py + c + col),
+                          _mm256_mul_ps(n[2], _mm256_loadu_ps(pz + c + col))));
+    flip = _mm256_and_ps(dot, _mm256_set1_ps(-0.0f));
+    inv = _mm256_xor_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), 
+                                      _mm256_sqrt_ps(len2)), flip);
+    _mm256_storeu_ps(nx + c + col, _mm256_mul_ps(n[0], inv));
+    _mm256_storeu_ps(ny + c + col, _mm256_mul_ps(n[1], inv));
+    _mm256_storeu_ps(nz + c + col, _mm256_mul_ps(n[2], inv));
+  }  /**  For each group of 8  **/
+  NormalsScalar(px, py, pz, rows, cols, row, col, cols, nx, ny, nz);
+
+}  /**  End of NormalsAVX2  **/
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PK_Normals                                **/
+/**                                                                         **/
+/**  Computes unit normals of a closed rows x cols mesh whose positions     **/
+/**  are given as separate x, y and z arrays indexed row * cols + col.      **/
+/**  Rows and columns both wrap around, as in the surfaceMesh of a          **/
+/**  pattern.  Only rows first to last-1 are written, so bands of rows can  **/
+/**  be done from several threads at once, but the positions of the         **/
+/**  neighbouring rows must be complete beforehand.                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PK_Normals(const float *px, const float *py, const float *pz,
+                int rows, int cols, int first, int last,
+                float *nx, float *ny, float *nz) {
+
+  int  row;  /**  Loop counter  **/
+
+  for (row = first; row < last; row++) {
+    switch (PK_ActiveKernel()) {
+#ifdef PK_HAVE_X86
+      case PK_AVX2:
+        NormalsAVX2(px, py, pz, rows, cols, row, nx, ny, nz);
+        break;
+      case PK_SSE2:
+        NormalsSSE2(px, py, pz, rows, cols, row, nx, ny, nz);
+        break;
+#endif
+      default:
+        NormalsScalar(px, py, pz, rows, cols, row, 0, cols, nx, ny, nz);
+        break;
+    }  /**  Switch on kernel  **/
+  }  /**  For each row  **/
+
+}  /**  End of PK_Normals  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of PatKernel.c                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,104 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PAT_KERNEL_H
+#define PAT_KERNEL_H
+
+#include <stddef.h>
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  PK_AUTO    -1   /**  Pick the best kernel the CPU supports  **/
+#define  PK_SCALAR  0
+#define  PK_SSE2    1
+#define  PK_AVX2    2
+
+#define  PK_TABLES  4    /**  Direction tables kept, main thread    **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct PK_Grid {
+  double  step;       /**  Degrees between samples, theta and phi  **/
+  int     rows;       /**  Number of phi rows in the RP grid       **/
+  int     cols;       /**  Number of theta samples in each row     **/
+  float  *dir_x;      /**  Unit direction of each sample, x        **/
+  float  *dir_y;      /**  Unit direction of each sample, y        **/
+  float  *dir_z;      /**  Unit direction of each sample, z        **/
+} PK_Grid;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int             PK_SelectKernel(int);
+int             PK_ActiveKernel(void);
+const char     *PK_KernelName(int);
+double          PK_DbToLinear(double);
+void            PK_BuildGrid(PK_Grid *, double, int, int);
+void            PK_FreeGrid(PK_Grid *);
+const PK_Grid  *PK_DirectionTable(double, int, int);
+void            PK_ConvertRows(const PK_Grid *, int, int, 
+                               const double *, size_t, double, double, int,
+                               float *, float *, float *, float *);
+void            PK_Convert(const PK_Grid *, const double *, size_t, 
+                           double, double, int,
+                           float *, float *, float *, float *);
+void            PK_Normals(const float *, const float *, const float *,
+                           int, int, int, int, float *, float *, float *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          End of PatKernel.h                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
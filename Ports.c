@@ -0,0 +1,457 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Per-port superposition.  The structure is linear in its excitation,
+ *  so once the deck has been solved with 1 volt on each voltage source
+ *  (EX type 0 or 5) in turn, any set of source voltages is the weighted
+ *  sum of those solutions: the segment currents, the complex far field
+ *  NEC printed, and from the currents at the sources their impedances
+ *  and the input power the gains are over.  Steering an array is then a
+ *  few multiply-adds per sample instead of a nec2 run.
+ *
+ *  PT_Find lists the ports of a deck, PT_Capture keeps the currents and
+ *  field of one port's solve after ParseFieldData has read it, and
+ *  PT_Combine writes the antenna's field, currents and feed table for
+ *  the amplitudes and phases in the set, as if nec2 had been run with
+ *  them.  SolvePorts in ant.c drives the solves.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "pcard.h"
+#include "FarField.h"
+#include "Ports.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  DEG  (M_PI / 180.0)  /**  Radians per degree  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PT_Free                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void PT_Free(PT_Set *set) {
+
+  int  p;  /**  Loop counter  **/
+
+  if (set == NULL)
+    return;
+  for (p = 0; p < set->ports; p++) {
+    free(set->eth_re[p]);
+    free(set->eth_im[p]);
+    free(set->eph_re[p]);
+    free(set->eph_im[p]);
+    free(set->cur_re[p]);
+    free(set->cur_im[p]);
+  }  /**  For each port  **/
+  free(set->theta);
+  free(set->phi);
+  free(set);
+
+}  /**  End of PT_Free  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PT_Find                                  **/
+/**                                                                         **/
+/**  The voltage sources of the antenna's deck, in deck order, each with    **/
+/**  the voltage the deck drives it with.  NULL if there are none, more     **/
+/**  than PT_MAX_PORTS, or an excitation that is not a voltage source (a    **/
+/**  plane wave does not split into ports).                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+PT_Set *PT_Find(const Ant *ant) {
+
+  PT_Set  *set;     /**  The ports      **/
+  int      ex[4];   /**  EX integers    **/
+  double   v[2];    /**  EX voltage     **/
+  int      fields;  /**  Parsed fields  **/
+  int      i;       /**  Loop counter   **/
+
+  if ((set = (PT_Set *) calloc(1, sizeof(PT_Set))) == NULL)
+    return NULL;
+  for (i = 0; i < ant->card_count; i++) {
+    if (ant->cards[i][0] != 'E' || ant->cards[i][1] != 'X')
+      continue;
+    v[0] = v[1] = 0.0;
+    fields = sscanf(ant->cards[i] + 2, "%d%d%d%d%lf%lf", &ex[0], &ex[1], 
+                    &ex[2], &ex[3], &v[0], &v[1]);
+    if (fields < 4 || (ex[0] != 0 && ex[0] != 5) || 
+        set->ports == PT_MAX_PORTS) {
+      free(set);
+      return NULL;
+    }  /**  Not ports  **/
+    set->tag[set->ports] = ex[1];
+    set->segment[set->ports] = ex[2];
+    set->amplitude[set->ports] = sqrt(v[0] * v[0] + v[1] * v[1]);
+    set->phase[set->ports] = atan2(v[1], v[0]) / DEG;
+    set->ports++;
+  }  /**  For each card  **/
+
+  if (set->ports == 0) {
+    free(set);
+    return NULL;
+  }  /**  Nothing driven  **/
+  return set;
+
+}  /**  End of PT_Find  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PortIndex                                 **/
+/**                                                                         **/
+/**  Where NEC's (tag, segment) falls in the segment currents as FF_Gather  **/
+/**  lists them: tag 0 counts segments over the whole structure, as NEC     **/
+/**  does, otherwise tags number the wires in order.  -1 if out of range.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int PortIndex(const Ant *ant, int tag, int segment, int segments) {
+
+  const Tube  *tube;    /**  Tube traversal   **/
+  int          wire;    /**  Its tag          **/
+  int          offset;  /**  Segments before  **/
+
+  if (tag == 0)
+    return (segment >= 1 && segment <= segments) ? segment - 1 : -1;
+
+  offset = 0;
+  wire = 1;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next, wire++) {
+    if (tube->type != IS_TUBE || tube->currents == NULL || 
+        tube->segments <= 0)
+      continue;
+    if (wire == tag)
+      return (segment >= 1 && segment <= tube->segments) ? 
+             offset + segment - 1 : -1;
+    offset += tube->segments;
+  }  /**  For each tube  **/
+  return -1;
+
+}  /**  End of PortIndex  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PT_Capture                                **/
+/**                                                                         **/
+/**  Keeps the field and segment currents ParseFieldData just read into     **/
+/**  the antenna as the solution for 1 volt at port.  Every port must come  **/
+/**  with the same grid and segments as the first.                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool PT_Capture(PT_Set *set, int port, const Ant *ant) {
+
+  const FieldData  *fd;     /**  The port's field     **/
+  FF_Sources        src;    /**  Its currents         **/
+  double            m;      /**  Magnitude            **/
+  int               n;      /**  Samples              **/
+  int               i;      /**  Loop counter         **/
+
+  fd = ant->fieldData;
+  if (port < 0 || port >= set->ports || fd == NULL || fd->count < 1 ||
+      !FF_Gather(ant, &src))
+    return false;
+  n = fd->count;
+  if ((set->samples != 0 && set->samples != n) ||
+      (set->segments != 0 && set->segments != src.count)) {
+    FF_Free(&src);
+    return false;
+  }  /**  Not the same structure  **/
+
+  if (set->samples == 0) {
+    set->samples = n;
+    set->segments = src.count;
+    set->frequency = (ant->frequency > 0.0) ? ant->frequency : FF_NEC_FREQ;
+    set->theta = (double *) malloc(n * sizeof(double));
+    set->phi = (double *) malloc(n * sizeof(double));
+    if (set->theta == NULL || set->phi == NULL) {
+      FF_Free(&src);
+      return false;
+    }  /**  Out of memory  **/
+    for (i = 0; i < n; i++) {
+      set->theta[i] = fd->vals[i].theta;
+      set->phi[i] = fd->vals[i].phi;
+    }  /**  Angles  **/
+    for (i = 0; i < set->ports; i++)
+      set->index[i] = PortIndex(ant, set->tag[i], set->segment[i], 
+                                src.count);
+  }  /**  First port  **/
+
+  set->eth_re[port] = (float *) malloc(n * sizeof(float));
+  set->eth_im[port] = (float *) malloc(n * sizeof(float));
+  set->eph_re[port] = (float *) malloc(n * sizeof(float));
+  set->eph_im[port] = (float *) malloc(n * sizeof(float));
+  set->cur_re[port] = src.re;
+  set->cur_im[port] = src.im;
+  src.re = src.im = NULL;
+  FF_Free(&src);
+  if (set->eth_re[port] == NULL || set->eth_im[port] == NULL ||
+      set->eph_re[port] == NULL || set->eph_im[port] == NULL)
+    return false;
+
+  for (i = 0; i < n; i++) {
+    m = fd->vals[i].theta_mag;
+    set->eth_re[port][i] = m * cos(fd->vals[i].theta_phase * DEG);
+    set->eth_im[port][i] = m * sin(fd->vals[i].theta_phase * DEG);
+    m = fd->vals[i].phi_mag;
+    set->eph_re[port][i] = m * cos(fd->vals[i].phi_phase * DEG);
+    set->eph_im[port][i] = m * sin(fd->vals[i].phi_phase * DEG);
+  }  /**  For each sample  **/
+
+  return true;
+
+}  /**  End of PT_Capture  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SetCurrents                                **/
+/**                                                                         **/
+/**  Writes combined segment currents back to the tubes, in FF_Gather's     **/
+/**  order, and the antenna's current ranges with them.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SetCurrents(Ant *ant, const double *re, const double *im) {
+
+  Tube         *tube;   /**  Tube traversal    **/
+  SegmentData  *seg;    /**  Its currents      **/
+  double        mag;    /**  Amps              **/
+  double        phase;  /**  Degrees           **/
+  int           n;      /**  Segment index     **/
+  int           i;      /**  Loop counter      **/
+
+  n = 0;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next) {
+    if (tube->type != IS_TUBE || tube->currents == NULL || 
+        tube->segments <= 0)
+      continue;
+    for (i = 0, seg = tube->currents; i < tube->segments && seg != NULL;
+         i++, seg = seg->next, n++) {
+      mag = sqrt(re[n] * re[n] + im[n] * im[n]);
+      phase = atan2(im[n], re[n]) / DEG;
+      seg->currentMagnitude = mag;
+      seg->currentPhase = phase;
+      if (n == 0) {
+        ant->max_current_mag = ant->min_current_mag = mag;
+        ant->max_current_phase = ant->min_current_phase = phase;
+      } else {
+        if (mag > ant->max_current_mag)
+          ant->max_current_mag = mag;
+        if (mag < ant->min_current_mag)
+          ant->min_current_mag = mag;
+        if (phase > ant->max_current_phase)
+          ant->max_current_phase = phase;
+        if (phase < ant->min_current_phase)
+          ant->min_current_phase = phase;
+      }  /**  Ranges  **/
+    }  /**  For each segment  **/
+  }  /**  For each tube  **/
+
+}  /**  End of SetCurrents  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PT_Combine                                **/
+/**                                                                         **/
+/**  Fills the antenna's field, segment currents and feed table for the     **/
+/**  set's amplitudes and phases.  Each port's 1 volt solution is weighted  **/
+/**  by its complex voltage and summed; the input power, from the summed    **/
+/**  current at each driven port, sets the gains as NEC's are set.          **/
+/**  Returns false, leaving the antenna alone, if every port is off or the  **/
+/**  set is not fully captured.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool PT_Combine(PT_Set *set, Ant *ant) {
+
+  FieldData  *fd;              /**  Antenna's field         **/
+  FieldVal   *vals;            /**  Grown sample array      **/
+  FeedTable  *table;           /**  Antenna's feed table    **/
+  double      w_re[PT_MAX_PORTS];  /**  Port voltages       **/
+  double      w_im[PT_MAX_PORTS];
+  double     *cur_re;          /**  Summed currents         **/
+  double     *cur_im;
+  float      *sum;             /**  Summed fields, 4 rows   **/
+  float      *tr, *ti;         /**  E theta                 **/
+  float      *pr, *pi;         /**  E phi                   **/
+  float       wr, wi;          /**  One port's weight       **/
+  double      ir, ii;          /**  Current at a port       **/
+  double      i2;              /**    ..squared magnitude   **/
+  double      power;           /**  Input power, watts      **/
+  double      p_port;          /**  One port's share        **/
+  int         n;               /**  Samples                 **/
+  int         p;               /**  Port                    **/
+  int         i;               /**  Loop counter            **/
+
+  n = set->samples;
+  if (n < 1 || set->segments < 1)
+    return false;
+  for (p = 0; p < set->ports; p++) {
+    if (set->eth_re[p] == NULL || set->cur_re[p] == NULL)
+      return false;
+    w_re[p] = set->amplitude[p] * cos(set->phase[p] * DEG);
+    w_im[p] = set->amplitude[p] * sin(set->phase[p] * DEG);
+  }  /**  Weights  **/
+
+  cur_re = (double *) calloc(set->segments, sizeof(double));
+  cur_im = (double *) calloc(set->segments, sizeof(double));
+  sum = (float *) calloc(4 * (size_t) n, sizeof(float));
+  if (cur_re == NULL || cur_im == NULL || sum == NULL) {
+    free(cur_re);
+    free(cur_im);
+    free(sum);
+    return false;
+  }  /**  Out of memory  **/
+
+  for (p = 0; p < set->ports; p++)
+    for (i = 0; i < set->segments; i++) {
+      cur_re[i] += w_re[p] * set->cur_re[p][i] - w_im[p] * set->cur_im[p][i];
+      cur_im[i] += w_re[p] * set->cur_im[p][i] + w_im[p] * set->cur_re[p][i];
+    }  /**  Currents  **/
+
+  power = 0.0;
+  for (p = 0; p < set->ports; p++)
+    if (set->amplitude[p] > 0.0 && set->index[p] >= 0) {
+      ir = cur_re[set->index[p]];
+      ii = cur_im[set->index[p]];
+      power += 0.5 * (w_re[p] * ir + w_im[p] * ii);
+    }  /**  Input power  **/
+  if (power <= 0.0) {
+    free(cur_re);
+    free(cur_im);
+    free(sum);
+    return false;
+  }  /**  Nothing driven  **/
+
+  tr = sum;
+  ti = sum + n;
+  pr = sum + 2 * n;
+  pi = sum + 3 * n;
+  for (p = 0; p < set->ports; p++) {
+    if (set->amplitude[p] <= 0.0)
+      continue;
+    wr = w_re[p];
+    wi = w_im[p];
+    for (i = 0; i < n; i++) {
+      tr[i] += wr * set->eth_re[p][i] - wi * set->eth_im[p][i];
+      ti[i] += wr * set->eth_im[p][i] + wi * set->eth_re[p][i];
+      pr[i] += wr * set->eph_re[p][i] - wi * set->eph_im[p][i];
+      pi[i] += wr * set->eph_im[p][i] + wi * set->eph_re[p][i];
+    }  /**  For each sample  **/
+  }  /**  For each port  **/
+
+  if (ant->fieldData == NULL)
+    ant->fieldData = (FieldData *) calloc(1, sizeof(FieldData));
+  fd = ant->fieldData;
+  if (fd == NULL || 
+      (vals = (FieldVal *) realloc(fd->vals, n * sizeof(FieldVal))) == NULL) {
+    free(cur_re);
+    free(cur_im);
+    free(sum);
+    return false;
+  }  /**  Out of memory  **/
+  fd->vals = vals;
+  for (i = 0; i < n; i++) {
+    vals[i].theta = set->theta[i];
+    vals[i].phi = set->phi[i];
+    FF_FillValue(tr[i], ti[i], pr[i], pi[i], 
+                 2.0 * M_PI / (FF_ETA0 * power), &vals[i]);
+  }  /**  For each sample  **/
+  fd->count = n;
+  FF_Ranges(fd);
+  fd->serial = NewPatternSerial();
+  ant->fieldComputed = true;
+
+  SetCurrents(ant, cur_re, cur_im);
+  table = ClearFeedTable(ant);
+  for (p = 0; p < set->ports; p++)
+    if (set->amplitude[p] > 0.0 && set->index[p] >= 0) {
+      ir = cur_re[set->index[p]];
+      ii = cur_im[set->index[p]];
+      i2 = ir * ir + ii * ii;
+      p_port = 0.5 * (w_re[p] * ir + w_im[p] * ii);
+      if (i2 > 0.0)
+        AddFeedRow(table, set->frequency, set->tag[p], set->segment[p],
+                   (w_re[p] * ir + w_im[p] * ii) / i2,
+                   (w_im[p] * ir - w_re[p] * ii) / i2, p_port);
+    }  /**  Feed rows  **/
+
+  free(cur_re);
+  free(cur_im);
+  free(sum);
+  return true;
+
+}  /**  End of PT_Combine  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              End of Ports.c                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
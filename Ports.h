@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PORTS_H
+#define PORTS_H
+
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  PT_MAX_PORTS  64   /**  Voltage sources in one deck, at most  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct PT_Set {
+  int      ports;                     /**  Voltage sources in the deck     **/
+  int      tag[PT_MAX_PORTS];         /**  EX tag of each                  **/
+  int      segment[PT_MAX_PORTS];     /**    ..and segment                 **/
+  int      index[PT_MAX_PORTS];       /**  Its segment among the currents  **/
+  double   amplitude[PT_MAX_PORTS];   /**  Volts it is driven with         **/
+  double   phase[PT_MAX_PORTS];       /**    ..and their phase, degrees    **/
+  double   frequency;                 /**  Of the solves, MHz              **/
+  int      samples;                   /**  Field samples of each port      **/
+  double  *theta;                     /**  Their angles, degrees           **/
+  double  *phi;
+  float   *eth_re[PT_MAX_PORTS];      /**  E theta for 1 volt at the port  **/
+  float   *eth_im[PT_MAX_PORTS];
+  float   *eph_re[PT_MAX_PORTS];      /**  E phi for 1 volt at the port    **/
+  float   *eph_im[PT_MAX_PORTS];
+  int      segments;                  /**  Segment currents of each port   **/
+  float   *cur_re[PT_MAX_PORTS];      /**  Amps for 1 volt at the port     **/
+  float   *cur_im[PT_MAX_PORTS];
+} PT_Set;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+PT_Set  *PT_Find(const Ant *);
+bool     PT_Capture(PT_Set *, int, const Ant *);
+bool     PT_Combine(PT_Set *, Ant *);
+void     PT_Free(PT_Set *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              End of Ports.h                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
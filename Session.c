@@ -0,0 +1,383 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Session files.  A session is a text file of one-line records that
+ *  holds everything needed to put the scene back as it was: the display
+ *  settings, the camera, lights and materials of the widget, and every
+ *  antenna in the scene with its cards, its wires as edited (walls
+ *  included), its offsets and frequency.  The field of each antenna that
+ *  has one is written next to the session as a binary pattern file
+ *  (PatFile.c), <session>.<n>.pat, so restoring maps it back in and
+ *  never runs nec2.
+ *
+ *    ANTENNAVIS-SESSION 1
+ *    SET name value              a display setting
+ *    CENTER x y z                centre of the scene
+ *    VIEW command words ...      a widget command, see SS_ReadView
+ *    ANT type freq dx dy dz scale ground segments
+ *    CARD text                   the antenna's cards, in order
+ *    TUBE type segments width x1 y1 z1 x2 y2 z2
+ *    PATTERN file                its field, beside the session
+ *    CURRENT n                   the selected antenna
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "PatFile.h"
+#include "Session.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  MAX_LINE    1024   /**  Longest record      **/
+#define  MAX_WORDS   16     /**  Words in a VIEW     **/
+#define  MAX_CARDS   1000   /**  Size of Ant.cards   **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+extern double    SCALE_FACTOR;        /**  Scale factor for antenna         **/
+extern double    DEFAULT_BOOMHEIGHT;  /**  In case no ground specd          **/
+extern double    POINT_DIST_SCALE;    /**  For point clouds, in dBi         **/
+extern double    POINT_SIZE_SCALE;    /**    ..also in terms of dBi         **/
+extern double    STEP_SIZE;           /**  Degrees between control points   **/
+extern double    NULL_THRESHOLD;      /**  As a percentage of max dBi       **/
+extern double    NULL_DISTANCE;       /**  So null maps float above         **/
+extern double    ALPHA;               /**  Alpha transparency factor        **/
+extern double    LOD_PIXEL_ERROR;     /**  Mesh detail error, in pixels     **/
+extern double    TUBE_WIDTH_SCALE;    /**  Tube width scale                 **/
+extern double    curr_step_size;      /**  Updated when the NEC called      **/
+extern int       WireDrawMode;        /**  Mode to draw the wires in        **/
+extern int       MultipleAntMode;     /**  Current antenna or all in phase  **/
+extern int       ShowRadPat;          /**  Show radiation pattern?          **/
+extern int       ShowPolSense;        /**  Show polarization sense?         **/
+extern int       ShowPolTilt;         /**  Show polarization tilt?          **/
+extern int       ShowAxialRatio;      /**  Show axial ratios?               **/
+extern int       ShowNulls;           /**  Show nulls in pattern?           **/
+extern int       DrawMode;            /**  Mode to draw output in           **/
+extern int       FreqSteps;           /**  Frequency steps                  **/
+extern double    ClusterSpacing;      /**  Wavelengths between clusters     **/
+extern double    SolverMemory;        /**  GB for nec2 runs, 0 no limit     **/
+extern int       UseSymmetry;         /**  Write GX and GR cards to nec2?   **/
+extern int       CheckDecks;          /**  Refuse decks DC_Check faults?    **/
+extern AntArray  TheAnts;             /**  The antennas' geometries         **/
+extern bool      FieldDataComputed;   /**  Do we need to compute field?     **/
+extern bool      RFPowerDensityOn;    /**  Draw RF Power Density?           **/
+extern bool      AntennasInScene;     /**  Are there antennas yet?          **/
+extern Point     Center;              /**  Center of scene                  **/
+
+local struct {
+  const char  *name;    /**  As written          **/
+  double      *real;    /**  One of these three  **/
+  int         *whole;
+  bool        *flag;
+} Settings[] = {
+  {"SCALE_FACTOR",       &SCALE_FACTOR,       NULL,             NULL},
+  {"DEFAULT_BOOMHEIGHT", &DEFAULT_BOOMHEIGHT, NULL,             NULL},
+  {"POINT_DIST_SCALE",   &POINT_DIST_SCALE,   NULL,             NULL},
+  {"POINT_SIZE_SCALE",   &POINT_SIZE_SCALE,   NULL,             NULL},
+  {"STEP_SIZE",          &STEP_SIZE,          NULL,             NULL},
+  {"NULL_THRESHOLD",     &NULL_THRESHOLD,     NULL,             NULL},
+  {"NULL_DISTANCE",      &NULL_DISTANCE,      NULL,             NULL},
+  {"ALPHA",              &ALPHA,              NULL,             NULL},
+  {"LOD_PIXEL_ERROR",    &LOD_PIXEL_ERROR,    NULL,             NULL},
+  {"TUBE_WIDTH_SCALE",   &TUBE_WIDTH_SCALE,   NULL,             NULL},
+  {"curr_step_size",     &curr_step_size,     NULL,             NULL},
+  {"WireDrawMode",       NULL,                &WireDrawMode,    NULL},
+  {"MultipleAntMode",    NULL,                &MultipleAntMode, NULL},
+  {"ShowRadPat",         NULL,                &ShowRadPat,      NULL},
+  {"ShowPolSense",       NULL,                &ShowPolSense,    NULL},
+  {"ShowPolTilt",        NULL,                &ShowPolTilt,     NULL},
+  {"ShowAxialRatio",     NULL,                &ShowAxialRatio,  NULL},
+  {"ShowNulls",          NULL,                &ShowNulls,       NULL},
+  {"DrawMode",           NULL,                &DrawMode,        NULL},
+  {"FreqSteps",          NULL,                &FreqSteps,       NULL},
+  {"ClusterSpacing",     &ClusterSpacing,     NULL,             NULL},
+  {"SolverMemory",       &SolverMemory,       NULL,             NULL},
+  {"UseSymmetry",        NULL,                &UseSymmetry,     NULL},
+  {"CheckDecks",         NULL,                &CheckDecks,      NULL},
+  {"FieldDataComputed",  NULL,                NULL,  &FieldDataComputed},
+  {"RFPowerDensityOn",   NULL,                NULL,  &RFPowerDensityOn},
+  {NULL,                 NULL,                NULL,             NULL}
+};  /**  Display settings kept in a session  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               PatternName                               **/
+/**                                                                         **/
+/**  The pattern file of antenna n of a session, as written in the session  **/
+/**  (name) and as opened (path, beside the session file).                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void PatternName(const char *session, const char *name, char *path,
+                       size_t size) {
+
+  const char  *slash;  /**  End of the session's directory  **/
+
+  slash = strrchr(session, '/');
+  if (slash == NULL || strchr(name, '/') != NULL)
+    snprintf(path, size, "%s", name);
+  else
+    snprintf(path, size, "%.*s/%s", (int) (slash - session), session, name);
+
+}  /**  End of PatternName  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 SS_Save                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SS_Save(const char *session, SS_WriteView view, void *data) {
+
+  FILE        *f;             /**  The session           **/
+  Ant         *ant;           /**  Antenna being saved   **/
+  Tube        *tube;          /**  Tube traversal        **/
+  const char  *base;          /**  Session file name     **/
+  char         name[256];     /**  Pattern file name     **/
+  char         path[1024];    /**  ..and where it goes   **/
+  bool         ok;            /**  Everything written    **/
+  int          i;             /**  Loop counter          **/
+  int          j;             /**  Loop counter          **/
+
+  if ((f = fopen(session, "wt")) == NULL) {
+    fprintf(stderr, "Could not open file %s for writing\n", session);
+    return false;
+  }  /**  Cannot write  **/
+
+  ok = true;
+  fprintf(f, "%s %d\n", SS_MAGIC, SS_VERSION);
+  for (i = 0; Settings[i].name != NULL; i++) {
+    if (Settings[i].real != NULL)
+      fprintf(f, "SET %s %.17g\n", Settings[i].name, *Settings[i].real);
+    else if (Settings[i].whole != NULL)
+      fprintf(f, "SET %s %d\n", Settings[i].name, *Settings[i].whole);
+    else
+      fprintf(f, "SET %s %d\n", Settings[i].name, *Settings[i].flag);
+  }  /**  For each setting  **/
+  fprintf(f, "CENTER %.17g %.17g %.17g\n", Center.x, Center.y, Center.z);
+  if (view != NULL)
+    view(f, data);
+
+  base = strrchr(session, '/') != NULL ? strrchr(session, '/') + 1 : session;
+  for (i = 0; AntennasInScene && i < TheAnts.ant_count; i++) {
+    ant = &TheAnts.ants[i];
+    fprintf(f, "ANT %d %.17g %.17g %.17g %.17g %.17g %d %d\n", ant->type,
+            ant->frequency, ant->dx, ant->dy, ant->dz, ant->visual_scale,
+            ant->ground_specified, ant->total_segments);
+    for (j = 0; j < ant->card_count; j++)
+      fprintf(f, "CARD %s%s", ant->cards[j],
+              strchr(ant->cards[j], '\n') == NULL ? "\n" : "");
+    for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+      fprintf(f, "TUBE %d %d %.17g %.17g %.17g %.17g %.17g %.17g %.17g\n",
+              tube->type, tube->segments, tube->width, tube->e1.x,
+              tube->e1.y, tube->e1.z, tube->e2.x, tube->e2.y, tube->e2.z);
+    if (ant->fieldComputed && ant->fieldData != NULL) {
+      snprintf(name, sizeof(name), "%s.%d.pat", base, i + 1);
+      PatternName(session, name, path, sizeof(path));
+      if (PF_Write(path, ant))
+        fprintf(f, "PATTERN %s\n", name);
+      else {
+        fprintf(stderr, "Could not write %s\n", path);
+        ok = false;
+      }  /**  Pattern not saved  **/
+    }  /**  Has a field  **/
+  }  /**  For each antenna  **/
+  fprintf(f, "CURRENT %d\n", TheAnts.curr_ant);
+
+  if (ferror(f))
+    ok = false;
+  if (fclose(f) != 0)
+    ok = false;
+  return ok;
+
+}  /**  End of SS_Save  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SS_Restore                                **/
+/**                                                                         **/
+/**  Replaces the scene with a saved session.  Fails, leaving the scene     **/
+/**  alone, if the file is not a session of this version.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SS_Restore(const char *session, SS_ReadView view, void *data) {
+
+  FILE        *f;                    /**  The session           **/
+  Ant         *ant;                  /**  Antenna being built   **/
+  Tube         tube;                 /**  Tube being read       **/
+  char         line[MAX_LINE];       /**  One record            **/
+  char         word[MAX_LINE];       /**  A word of it          **/
+  char         path[1024];           /**  Pattern file          **/
+  CONST84 char *words[MAX_WORDS+1];  /**  VIEW split in words   **/
+  char        *p;                    /**  Splitting             **/
+  double       value;                /**  SET value             **/
+  int          version;              /**  Session version       **/
+  int          ground;               /**  ANT ground flag       **/
+  int          current;              /**  CURRENT antenna       **/
+  int          n;                    /**  Word count            **/
+  int          i;                    /**  Loop counter          **/
+
+  if ((f = fopen(session, "rt")) == NULL) {
+    fprintf(stderr, "Could not open file %s\n", session);
+    return false;
+  }  /**  No file  **/
+  if (fgets(line, sizeof(line), f) == NULL ||
+      sscanf(line, "%s%d", word, &version) != 2 ||
+      strcmp(word, SS_MAGIC) != 0 || version != SS_VERSION) {
+    fprintf(stderr, "%s is not a version %d session\n", session, SS_VERSION);
+    fclose(f);
+    return false;
+  }  /**  Not a session  **/
+
+  ClearScene();
+  ant = NULL;
+  current = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (strncmp(line, "SET ", 4) == 0) {
+      if (sscanf(line + 4, "%s%lf", word, &value) != 2)
+        continue;
+      for (i = 0; Settings[i].name != NULL; i++)
+        if (strcmp(word, Settings[i].name) == 0) {
+          if (Settings[i].real != NULL)
+            *Settings[i].real = value;
+          else if (Settings[i].whole != NULL)
+            *Settings[i].whole = (int) value;
+          else
+            *Settings[i].flag = value != 0.0;
+        }  /**  Known setting  **/
+    }  /**  Display setting  **/
+
+    else if (strncmp(line, "CENTER ", 7) == 0)
+      sscanf(line + 7, "%lf%lf%lf", &Center.x, &Center.y, &Center.z);
+
+    else if (strncmp(line, "VIEW ", 5) == 0 && view != NULL) {
+      words[0] = "";
+      n = 1;
+      for (p = strtok(line + 5, " \t\n"); p != NULL && n < MAX_WORDS;
+           p = strtok(NULL, " \t\n"))
+        words[n++] = p;
+      words[n] = NULL;
+      view(n, words, data);
+    }  /**  Widget state  **/
+
+    else if (strncmp(line, "ANT ", 4) == 0) {
+      if (TheAnts.ant_count >= MAX_ANTENNAS) {
+        fprintf(stderr, "%s: more than %d antennas, rest dropped\n",
+                session, MAX_ANTENNAS);
+        ant = NULL;
+        continue;
+      }  /**  No room  **/
+      ant = &TheAnts.ants[TheAnts.ant_count++];
+      InitAnt(ant);
+      ant->card_count = 0;
+      ant->fieldComputed = false;
+      ant->current_tube = NULL;
+      sscanf(line + 4, "%d%lf%lf%lf%lf%lf%d%d", &ant->type, &ant->frequency,
+             &ant->dx, &ant->dy, &ant->dz, &ant->visual_scale, &ground,
+             &ant->total_segments);
+      ant->ground_specified = ground != 0;
+      AntennasInScene = true;
+    }  /**  New antenna  **/
+
+    else if (ant == NULL)
+      continue;
+
+    else if (strncmp(line, "CARD ", 5) == 0) {
+      if (ant->card_count < MAX_CARDS)
+        ant->cards[ant->card_count++] = strdup(line + 5);
+    }  /**  Card  **/
+
+    else if (strncmp(line, "TUBE ", 5) == 0) {
+      memset(&tube, 0, sizeof(tube));
+      if (sscanf(line + 5, "%d%d%lf%lf%lf%lf%lf%lf%lf", &tube.type,
+                 &tube.segments, &tube.width, &tube.e1.x, &tube.e1.y,
+                 &tube.e1.z, &tube.e2.x, &tube.e2.y, &tube.e2.z) == 9)
+        InsertTube(ant, &tube);
+    }  /**  Wire or wall  **/
+
+    else if (strncmp(line, "PATTERN ", 8) == 0) {
+      if (sscanf(line + 8, "%s", word) != 1)
+        continue;
+      PatternName(session, word, path, sizeof(path));
+      if (!PF_Load(path, ant))
+        fprintf(stderr, "Could not load pattern %s\n", path);
+    }  /**  Its field  **/
+
+    else if (strncmp(line, "CURRENT ", 8) == 0)
+      sscanf(line + 8, "%d", &current);
+  }  /**  For each record  **/
+  fclose(f);
+
+  for (i = 0; i < TheAnts.ant_count; i++)
+    TheAnts.ants[i].current_tube = TheAnts.ants[i].first_tube;
+  if (current >= 0 && current < TheAnts.ant_count)
+    TheAnts.curr_ant = current;
+  return true;
+
+}  /**  End of SS_Restore  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Session.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,89 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdio.h>
+#include "MyTypes.h"
+#include "togl.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  SS_MAGIC     "ANTENNAVIS-SESSION"  /**  First word of the file  **/
+#define  SS_VERSION   1
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Typedefs                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+/*
+ *  The camera, lights and materials belong to the widget, so it saves
+ *  and restores them itself: SS_WriteView writes its VIEW lines, and
+ *  SS_ReadView is handed each VIEW line split into words.
+ */
+
+typedef void (*SS_WriteView)(FILE *, void *);
+typedef void (*SS_ReadView)(int, CONST84 char **, void *);
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           Function Prototypes                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool  SS_Save(const char *, SS_WriteView, void *);
+bool  SS_Restore(const char *, SS_ReadView, void *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Session.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,750 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  A pool of solver worker processes.  nec2 itself reads one deck and
+ *  exits, so it cannot stay resident; what stays resident instead is a
+ *  small worker per slot, forked once by SP_Init while the caller is
+ *  still small and has no Tk or GL state.  Each worker reads jobs from a
+ *  pipe, forks and execs nec2 for the job and writes back how nec2
+ *  exited.  The caller never forks or waits on nec2 itself, so a failed
+ *  fork or a crashed solver is a result code rather than an exit(), and
+ *  a run that outlives the timeout is killed with its worker's process
+ *  group and the worker is replaced.
+ *
+ *  Idle workers are pinged before each job and replaced if they do not
+ *  answer.  The protocol is text, one line each way:
+ *
+ *    PING                  ->  PONG
+ *    JOB deck<TAB>output   ->  EXIT status  or  SIGNAL number
+ *
+ *  SP_Solve runs a job to completion; SP_Start and SP_Check let a caller
+ *  such as AntDaemon keep several running while it does other work, and
+ *  SP_SolveAll runs a batch of independent decks across every worker.
+ *
+ *  nec2 keeps its whole interaction matrix in memory, 16 bytes a
+ *  segment squared, and has no out-of-core mode to fall back on.  So
+ *  SP_SolveAll can be given what each deck will need and a budget for
+ *  them all; it only starts a deck while the running ones leave room
+ *  for it, and refuses one that could never fit rather than let it
+ *  push the machine into swap.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "MyTypes.h"
+#include "Timing.h"
+#include "SolverPool.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  PING_MS    2000   /**  An idle worker must answer within this  **/
+#define  MAX_LINE   2048   /**  Longest protocol line                   **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Worker {
+  pid_t   pid;           /**  Worker process, -1 if none       **/
+  int     to;            /**  Pipe to the worker               **/
+  int     from;          /**  Pipe from the worker             **/
+  bool    busy;          /**  A job is running                 **/
+  double  started;       /**  When it started, ms              **/
+  char    reply[64];     /**  Partial reply line               **/
+  size_t  len;           /**    ..its length                   **/
+} Worker;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local Worker  Pool[SP_MAX_WORKERS];   /**  The workers            **/
+local int     PoolSize = 0;           /**  0 until SP_Init        **/
+local double  TimeoutMs;              /**  Longest run allowed    **/
+local bool    AtExit = false;         /**  SP_Shutdown registered **/
+local double  Budget = 0.0;           /**  Bytes, 0 if unlimited  **/
+local SP_ProgressProc  Progress = NULL;   /**  SP_SolveAll reports  **/
+local void            *ProgressData;      /**    ..and passes this  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              WorkerMain                                 **/
+/**                                                                         **/
+/**  What a worker process runs, until its pipe is closed.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void WorkerMain(int in, int out) {
+
+  FILE   *jobs;            /**  Requests               **/
+  char    line[MAX_LINE];  /**  One request            **/
+  char    reply[64];       /**  Its answer             **/
+  char   *output;          /**  Output file name       **/
+  pid_t   child;           /**  nec2                   **/
+  int     status;          /**  How it exited          **/
+
+  if ((jobs = fdopen(in, "r")) == NULL)
+    _exit(1);
+  while (fgets(line, sizeof(line), jobs) != NULL) {
+    line[strcspn(line, "\n")] = '\0';
+    if (strcmp(line, "PING") == 0)
+      strcpy(reply, "PONG\n");
+    else if (strncmp(line, "JOB ", 4) == 0 &&
+             (output = strchr(line + 4, '\t')) != NULL) {
+      *output++ = '\0';
+      fflush(stdout);
+      if ((child = fork()) == 0) {
+        execlp("nec2", "nec2", line + 4, output, NULL);
+        _exit(127);
+      }  /**  We are nec2  **/
+      while (child > 0 && waitpid(child, &status, 0) < 0 && errno == EINTR)
+        ;
+      if (child < 0)
+        strcpy(reply, "EXIT 126\n");
+      else if (WIFSIGNALED(status))
+        sprintf(reply, "SIGNAL %d\n", WTERMSIG(status));
+      else
+        sprintf(reply, "EXIT %d\n", WEXITSTATUS(status));
+    }  /**  A job  **/
+    else
+      strcpy(reply, "EXIT 125\n");
+    if (write(out, reply, strlen(reply)) < 0)
+      break;
+  }  /**  Until the pipe closes  **/
+  _exit(0);
+
+}  /**  End of WorkerMain  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Spawn                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Spawn(Worker *w) {
+
+  int    to[2];    /**  Parent to worker  **/
+  int    from[2];  /**  Worker to parent  **/
+  pid_t  pid;      /**  The worker        **/
+  int    i;        /**  Loop counter      **/
+
+  w->pid = -1;
+  w->busy = false;
+  w->len = 0;
+  if (pipe(to) < 0)
+    return false;
+  if (pipe(from) < 0) {
+    close(to[0]);
+    close(to[1]);
+    return false;
+  }  /**  No pipes  **/
+  for (i = 0; i < 2; i++) {
+    fcntl(to[i], F_SETFD, FD_CLOEXEC);
+    fcntl(from[i], F_SETFD, FD_CLOEXEC);
+  }  /**  nec2 gets none of them  **/
+
+  fflush(stdout);
+  fflush(stderr);
+  if ((pid = fork()) < 0) {
+    close(to[0]);
+    close(to[1]);
+    close(from[0]);
+    close(from[1]);
+    return false;
+  }  /**  Error state  **/
+  if (pid == 0) {
+    setpgid(0, 0);
+    signal(SIGINT, SIG_IGN);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGPIPE, SIG_DFL);
+    for (i = 0; i < PoolSize; i++)
+      if (Pool[i].pid > 0) {
+        close(Pool[i].to);
+        close(Pool[i].from);
+      }  /**  Other workers' pipes  **/
+    close(to[1]);
+    close(from[0]);
+    WorkerMain(to[0], from[1]);
+  }  /**  We are the worker  **/
+
+  setpgid(pid, pid);
+  close(to[0]);
+  close(from[1]);
+  w->pid = pid;
+  w->to = to[1];
+  w->from = from[0];
+  return true;
+
+}  /**  End of Spawn  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Retire                                  **/
+/**                                                                         **/
+/**  Kills a worker, and nec2 with it, and reaps it.                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Retire(Worker *w) {
+
+  if (w->pid <= 0)
+    return;
+  kill(-w->pid, SIGKILL);
+  close(w->to);
+  close(w->from);
+  waitpid(w->pid, NULL, 0);
+  w->pid = -1;
+  w->busy = false;
+
+}  /**  End of Retire  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ReadReply                                 **/
+/**                                                                         **/
+/**  Waits up to wait_ms for a whole line from a worker.  Returns 1 with    **/
+/**  the line in w->reply, 0 if none came yet, -1 if the worker is gone.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int ReadReply(Worker *w, int wait_ms) {
+
+  struct pollfd  pfd;   /**  The pipe       **/
+  char          *eol;   /**  End of line    **/
+  ssize_t        n;     /**  Bytes read     **/
+
+  for (;;) {
+    if ((eol = memchr(w->reply, '\n', w->len)) != NULL) {
+      *eol = '\0';
+      w->len = 0;
+      return 1;
+    }  /**  A whole line  **/
+    if (w->len == sizeof(w->reply) - 1)
+      return -1;
+    pfd.fd = w->from;
+    pfd.events = POLLIN;
+    n = poll(&pfd, 1, wait_ms);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return n == 0 ? 0 : -1;
+    n = read(w->from, w->reply + w->len, sizeof(w->reply) - 1 - w->len);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    w->len += n;
+  }  /**  Until a line or a timeout  **/
+
+}  /**  End of ReadReply  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Healthy                                  **/
+/**                                                                         **/
+/**  Pings an idle worker, replacing it if it is gone or does not answer.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Healthy(Worker *w) {
+
+  if (w->pid > 0 && waitpid(w->pid, NULL, WNOHANG) == 0 &&
+      write(w->to, "PING\n", 5) == 5 && ReadReply(w, PING_MS) == 1 &&
+      strcmp(w->reply, "PONG") == 0)
+    return true;
+  if (w->pid > 0)
+    fprintf(stderr, "Solver worker %d not answering, replacing it\n",
+            (int) w->pid);
+  Retire(w);
+  return Spawn(w);
+
+}  /**  End of Healthy  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SP_Init                                  **/
+/**                                                                         **/
+/**  Forks the workers.  A timeout of 0 takes SP_ENV_TIMEOUT, if set, or    **/
+/**  SP_DEFAULT_TIMEOUT.  Safe to call again; later calls do nothing.       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SP_Init(int workers, int timeout) {
+
+  const char  *env;  /**  SP_ENV_TIMEOUT  **/
+  int          i;    /**  Loop counter    **/
+
+  if (PoolSize > 0)
+    return true;
+  if (timeout <= 0 && (env = getenv(SP_ENV_TIMEOUT)) != NULL)
+    timeout = atoi(env);
+  if (timeout <= 0)
+    timeout = SP_DEFAULT_TIMEOUT;
+  TimeoutMs = timeout * 1000.0;
+
+  if (workers < 1)
+    workers = 1;
+  if (workers > SP_MAX_WORKERS)
+    workers = SP_MAX_WORKERS;
+  signal(SIGPIPE, SIG_IGN);
+  for (i = 0; i < workers; i++) {
+    Pool[i].pid = -1;
+    PoolSize = i;
+    Spawn(&Pool[i]);
+  }  /**  For each worker  **/
+  PoolSize = workers;
+  if (!AtExit)
+    atexit(SP_Shutdown);
+  AtExit = true;
+  return Pool[0].pid > 0;
+
+}  /**  End of SP_Init  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SP_Workers                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SP_Workers(void) {
+
+  return PoolSize;
+
+}  /**  End of SP_Workers  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SP_Resize                                 **/
+/**                                                                         **/
+/**  Restarts the pool with a new number of workers, keeping the timeout.   **/
+/**  Refused, returning false, while any job is running.                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SP_Resize(int workers) {
+
+  int  timeout;  /**  Seconds, as now  **/
+  int  i;        /**  Loop counter     **/
+
+  for (i = 0; i < PoolSize; i++)
+    if (Pool[i].busy)
+      return false;
+  if (workers < 1)
+    workers = 1;
+  if (workers > SP_MAX_WORKERS)
+    workers = SP_MAX_WORKERS;
+  if (workers == PoolSize)
+    return true;
+
+  timeout = (PoolSize > 0) ? (int) (TimeoutMs / 1000.0) : 0;
+  SP_Shutdown();
+  return SP_Init(workers, timeout);
+
+}  /**  End of SP_Resize  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SP_Start                                 **/
+/**                                                                         **/
+/**  Hands a deck to an idle worker.  Returns the worker's slot for         **/
+/**  SP_Check, or -1 if every worker is busy or none could be started.      **/
+/**  Relative names are made absolute, as the worker keeps the directory    **/
+/**  it was forked in.                                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SP_Start(const char *deck, const char *output) {
+
+  char    line[MAX_LINE];    /**  The request          **/
+  char    cwd[MAX_LINE / 4]; /**  Current directory    **/
+  size_t  len;               /**  Request length       **/
+  int     i;                 /**  Loop counter         **/
+
+  if (PoolSize == 0)
+    SP_Init(1, 0);
+  for (i = 0; i < PoolSize; i++)
+    if (!Pool[i].busy)
+      break;
+  if (i == PoolSize || !Healthy(&Pool[i]))
+    return -1;
+
+  if (getcwd(cwd, sizeof(cwd)) == NULL)
+    strcpy(cwd, ".");
+  len = snprintf(line, sizeof(line), "JOB %s%s%s\t%s%s%s\n",
+                 deck[0] == '/' ? "" : cwd, deck[0] == '/' ? "" : "/", deck,
+                 output[0] == '/' ? "" : cwd, output[0] == '/' ? "" : "/",
+                 output);
+  if (len >= sizeof(line) || write(Pool[i].to, line, len) != (ssize_t) len)
+    return -1;
+  Pool[i].busy = true;
+  Pool[i].started = TM_Start();
+  return i;
+
+}  /**  End of SP_Start  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SP_Check                                 **/
+/**                                                                         **/
+/**  Waits up to wait_ms for the job in a slot.  Returns SP_BUSY if it is   **/
+/**  still running, else how it ended; the slot is then free again.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SP_Check(int slot, int wait_ms) {
+
+  Worker  *w;        /**  The worker          **/
+  double   left;     /**  Until the timeout   **/
+  int      got;      /**  ReadReply result    **/
+  int      status;   /**  nec2 exit status    **/
+
+  if (slot < 0 || slot >= PoolSize || !Pool[slot].busy)
+    return SP_NO_WORKER;
+  w = &Pool[slot];
+
+  left = TimeoutMs - (TM_Start() - w->started);
+  if (left < 0.0)
+    left = 0.0;
+  got = ReadReply(w, wait_ms < left ? wait_ms : (int) left);
+  if (got == 0 && TM_Start() - w->started < TimeoutMs)
+    return SP_BUSY;
+  if (got == 0) {
+    fprintf(stderr, "nec2 ran over %.0f s, stopping it\n",
+            TimeoutMs / 1000.0);
+    Retire(w);
+    Spawn(w);
+    return SP_TIMEOUT;
+  }  /**  Too long  **/
+  if (got < 0) {
+    Retire(w);
+    Spawn(w);
+    return SP_FAILED;
+  }  /**  Worker died  **/
+
+  w->busy = false;
+  if (sscanf(w->reply, "EXIT %d", &status) == 1)
+    return status == 0 ? SP_OK : status == 127 || status == 126 ?
+           SP_NO_SOLVER : SP_FAILED;
+  return SP_FAILED;
+
+}  /**  End of SP_Check  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SP_Solve                                 **/
+/**                                                                         **/
+/**  Runs nec2 on a deck and waits for it, or for the timeout.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SP_Solve(const char *deck, const char *output) {
+
+  int  slot;    /**  Worker given the job  **/
+  int  result;  /**  How it went           **/
+
+  if ((slot = SP_Start(deck, output)) < 0)
+    return SP_NO_WORKER;
+  while ((result = SP_Check(slot, 1000)) == SP_BUSY)
+    ;
+  return result;
+
+}  /**  End of SP_Solve  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SP_SolveAll                                **/
+/**                                                                         **/
+/**  Runs nec2 on count independent decks, as many at once as there are    **/
+/**  workers and the budget allows, and waits for them all.  bytes[i] is   **/
+/**  the memory decks[i] needs, or bytes is NULL if not known.  results[i]  **/
+/**  gets how decks[i] went.  Returns the number that finished cleanly.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SP_SolveAll(int count, const char *const *decks, 
+                const char *const *outputs, const double *bytes, 
+                int *results) {
+
+  int     slot[SP_MAX_WORKERS];  /**  Job in each running slot, -1 if none  **/
+  double  held[SP_MAX_WORKERS];  /**  Bytes each running slot needs         **/
+  double  in_use;                /**  Their sum                             **/
+  double  need;                  /**  Bytes the next job needs              **/
+  double  reported;              /**  When Progress was last called, ms     **/
+  int     next;                  /**  First job not started                 **/
+  int     running;               /**  Jobs started, not finished            **/
+  int     done;                  /**  Jobs finished or refused              **/
+  int     ok;                    /**  Jobs that went                        **/
+  bool    changed;               /**  Worth reporting                       **/
+  int     s;                     /**  Slot                                  **/
+  int     i;                     /**  Loop counter                          **/
+
+  if (PoolSize == 0)
+    SP_Init(1, 0);
+  for (i = 0; i < SP_MAX_WORKERS; i++)
+    slot[i] = -1;
+  next = running = done = ok = 0;
+  in_use = 0.0;
+  reported = TM_Start();
+  changed = true;
+
+  while (next < count || running > 0) {
+    while (next < count) {
+      need = (bytes != NULL) ? bytes[next] : 0.0;
+      if (Budget > 0.0 && need > Budget) {
+        fprintf(stderr, "%s needs %.0f MB, over the %.0f MB budget\n",
+                decks[next], need / 1048576.0, Budget / 1048576.0);
+        results[next++] = SP_OVER_BUDGET;
+        done++;
+        continue;
+      }  /**  Could never fit  **/
+      if (running > 0 && Budget > 0.0 && in_use + need > Budget)
+        break;
+      if ((s = SP_Start(decks[next], outputs[next])) < 0)
+        break;
+      slot[s] = next++;
+      held[s] = need;
+      in_use += need;
+      running++;
+      changed = true;
+    }  /**  Fill idle workers, within the budget  **/
+    if (running == 0) {
+      if (next < count) {
+        results[next++] = SP_NO_WORKER;
+        done++;
+      }  /**  No worker would take it  **/
+      continue;
+    }  /**  Nothing to wait for  **/
+
+    for (s = 0; s < PoolSize; s++) {
+      if (slot[s] < 0)
+        continue;
+      i = SP_Check(s, running == 1 ? 1000 : 10);
+      if (i == SP_BUSY)
+        continue;
+      results[slot[s]] = i;
+      if (i == SP_OK)
+        ok++;
+      slot[s] = -1;
+      in_use -= held[s];
+      running--;
+      done++;
+      changed = true;
+    }  /**  Collect finished jobs  **/
+
+    if (Progress != NULL && (changed || TM_Start() - reported >= 1000.0)) {
+      Progress(done, running, count, in_use, ProgressData);
+      reported = TM_Start();
+      changed = false;
+    }  /**  On news, or once a second  **/
+  }  /**  Until all are done  **/
+
+  if (Progress != NULL && changed)
+    Progress(count, 0, count, 0.0, ProgressData);
+  return ok;
+
+}  /**  End of SP_SolveAll  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SP_SetBudget                               **/
+/**                                                                         **/
+/**  Bytes SP_SolveAll may have running at once; 0 or less for no limit.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void SP_SetBudget(double bytes) {
+
+  Budget = (bytes > 0.0) ? bytes : 0.0;
+
+}  /**  End of SP_SetBudget  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             SP_SetProgress                              **/
+/**                                                                         **/
+/**  Has SP_SolveAll call proc as decks start and finish, and about once a  **/
+/**  second while they run; NULL for none.                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void SP_SetProgress(SP_ProgressProc proc, void *data) {
+
+  Progress = proc;
+  ProgressData = data;
+
+}  /**  End of SP_SetProgress  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SP_Message                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+const char *SP_Message(int result) {
+
+  switch (result) {
+    case SP_OK:          return "nec2 finished";
+    case SP_BUSY:        return "nec2 still running";
+    case SP_NO_SOLVER:   return "nec2 not found";
+    case SP_TIMEOUT:     return "nec2 timed out";
+    case SP_NO_WORKER:   return "no solver worker free";
+    case SP_OVER_BUDGET: return "deck needs more than the memory budget";
+    default:             return "nec2 failed";
+  }  /**  Result  **/
+
+}  /**  End of SP_Message  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SP_Shutdown                               **/
+/**                                                                         **/
+/**  Stops the workers; running jobs are killed.  Idle workers simply see   **/
+/**  their pipe close and exit.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void SP_Shutdown(void) {
+
+  int  i;  /**  Loop counter  **/
+
+  for (i = 0; i < PoolSize; i++) {
+    if (Pool[i].pid <= 0)
+      continue;
+    if (Pool[i].busy) {
+      Retire(&Pool[i]);
+      continue;
+    }  /**  Kill nec2 too  **/
+    close(Pool[i].to);
+    close(Pool[i].from);
+    waitpid(Pool[i].pid, NULL, 0);
+    Pool[i].pid = -1;
+  }  /**  For each worker  **/
+  PoolSize = 0;
+
+}  /**  End of SP_Shutdown  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           End of SolverPool.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
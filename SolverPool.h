@@ -0,0 +1,101 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SOLVER_POOL_H
+#define SOLVER_POOL_H
+
+#include "MyTypes.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  SP_ENV_TIMEOUT     "ANTENNAVIS_SOLVER_TIMEOUT"
+
+#define  SP_MAX_WORKERS     64    /**  Worker processes, at most        **/
+#define  SP_DEFAULT_TIMEOUT 300   /**  Seconds one nec2 run may take    **/
+
+#define  SP_OK              0     /**  nec2 ran and exited cleanly      **/
+#define  SP_BUSY            1     /**  SP_Check: still running          **/
+#define  SP_FAILED          2     /**  nec2 exited with an error        **/
+#define  SP_NO_SOLVER       3     /**  nec2 could not be started        **/
+#define  SP_TIMEOUT         4     /**  nec2 ran too long, was killed    **/
+#define  SP_NO_WORKER       5     /**  No worker could take the job     **/
+#define  SP_OVER_BUDGET     6     /**  Deck alone is over the budget    **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+/**  SP_SolveAll's progress: decks done, running, in all, bytes in use  **/
+typedef void (*SP_ProgressProc)(int, int, int, double, void *);
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool         SP_Init(int, int);
+int          SP_Workers(void);
+bool         SP_Resize(int);
+int          SP_Start(const char *, const char *);
+int          SP_Check(int, int);
+int          SP_Solve(const char *, const char *);
+int          SP_SolveAll(int, const char *const *, const char *const *, 
+                         const double *, int *);
+void         SP_SetBudget(double);
+void         SP_SetProgress(SP_ProgressProc, void *);
+const char  *SP_Message(int);
+void         SP_Shutdown(void);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           End of SolverPool.h                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
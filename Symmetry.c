@@ -0,0 +1,672 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Geometric symmetry of an antenna's wires, for NEC's GX and GR cards.
+ *  NEC only factors the interaction matrix of one part of a structure
+ *  it is told is symmetric, so a mirror plane halves the solve and an
+ *  n-fold rotation cuts it n times.  NEC builds the copies itself, in a
+ *  fixed order: GX reflects the wires so far in the XY plane, then the
+ *  XZ plane, then the YZ plane, each time appending the mirror images
+ *  with tags raised by an increment that doubles after each plane; GR
+ *  appends n - 1 copies turned about the z axis, the tags of copy j
+ *  raised by j increments.  No segment may lie in or cross a plane.
+ *
+ *  SY_Find looks for the largest such symmetry of a tube list, within
+ *  SY_TOLERANCE of its extent.  A wire that is its own mirror image, a
+ *  dipole across the plane, is split there into two halves when its
+ *  segment count is even; the segments stay where they were, so NEC's
+ *  solution does not change.  With an odd count the middle segment
+ *  straddles the plane and the plane cannot be used.  The plan lists
+ *  the pieces in the order NEC will number them, with the tube and the
+ *  segments each came from, so that cards can be rewritten for the deck
+ *  and NEC's output read back onto the tubes.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "Symmetry.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  AXES  "xyz"   /**  Plane n is where coordinate AXES[n] is 0  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Coord                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double Coord(Point p, int axis) {
+
+  return (axis == 0) ? p.x : (axis == 1) ? p.y : p.z;
+
+}  /**  End of Coord  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Mirror                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local Point Mirror(Point p, int axis) {
+
+  if (axis == 0)
+    p.x = -p.x;
+  else if (axis == 1)
+    p.y = -p.y;
+  else
+    p.z = -p.z;
+  return p;
+
+}  /**  End of Mirror  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                   Turn                                  **/
+/**                                                                         **/
+/**  Turns a point about the z axis, as GR does.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local Point Turn(Point p, double angle) {
+
+  Point  q;  /**  Turned  **/
+
+  q.x = p.x * cos(angle) - p.y * sin(angle);
+  q.y = p.x * sin(angle) + p.y * cos(angle);
+  q.z = p.z;
+  return q;
+
+}  /**  End of Turn  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                   Near                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Near(Point a, Point b, double tol) {
+
+  return fabs(a.x - b.x) <= tol && fabs(a.y - b.y) <= tol &&
+         fabs(a.z - b.z) <= tol;
+
+}  /**  End of Near  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Pieces                                 **/
+/**                                                                         **/
+/**  One piece per tube, with room for room pieces in all.  NULL if a tube  **/
+/**  is a wall, which PrintTube writes as several wires.                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Piece *Pieces(Tube *first, int room) {
+
+  SY_Piece  *p;     /**  The pieces     **/
+  Tube      *tube;  /**  Current tube   **/
+  int        n;     /**  Pieces so far  **/
+
+  if ((p = (SY_Piece *) malloc(room * sizeof(SY_Piece))) == NULL)
+    return NULL;
+  for (tube = first, n = 0; tube != NULL; tube = tube->next, n++) {
+    if (tube->type != IS_TUBE || tube->segments < 1) {
+      free(p);
+      return NULL;
+    }  /**  Not a plain wire  **/
+    p[n].tube = n + 1;
+    p[n].first = 0;
+    p[n].segments = tube->segments;
+    p[n].reversed = false;
+    p[n].e1 = tube->e1;
+    p[n].e2 = tube->e2;
+    p[n].width = tube->width;
+  }  /**  For each tube  **/
+  return p;
+
+}  /**  End of Pieces  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Match                                  **/
+/**                                                                         **/
+/**  The unused piece that is the same wire as g, either way round, or -1.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Match(const SY_Piece *g, const SY_Piece *p, int count,
+                const bool *used, double tol, bool *reversed) {
+
+  int  i;  /**  Loop counter  **/
+
+  for (i = 0; i < count; i++) {
+    if (used[i] || p[i].segments != g->segments ||
+        fabs(p[i].width - g->width) > SY_TOLERANCE * g->width)
+      continue;
+    if (Near(p[i].e1, g->e1, tol) && Near(p[i].e2, g->e2, tol)) {
+      *reversed = false;
+      return i;
+    }  /**  Same way  **/
+    if (Near(p[i].e1, g->e2, tol) && Near(p[i].e2, g->e1, tol)) {
+      *reversed = true;
+      return i;
+    }  /**  Other way  **/
+  }  /**  For each piece  **/
+  return -1;
+
+}  /**  End of Match  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Split                                  **/
+/**                                                                         **/
+/**  Splits every piece that is its own mirror image in the plane into      **/
+/**  halves meeting there.  False if a piece lies in the plane or crosses   **/
+/**  it any other way, so the plane cannot be used.                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Split(SY_Piece *p, int *count, int axis, double tol, char *note,
+                 int size) {
+
+  SY_Piece  *q;     /**  The new half          **/
+  Point      mid;   /**  Where the plane cuts  **/
+  double     a1;    /**  Ends' distances       **/
+  double     a2;    /**    ..from the plane    **/
+  int        half;  /**  Segments in each      **/
+  int        n;     /**  Pieces before         **/
+  int        i;     /**  Loop counter          **/
+
+  n = *count;
+  for (i = 0; i < n; i++) {
+    a1 = Coord(p[i].e1, axis);
+    a2 = Coord(p[i].e2, axis);
+    if (fabs(a1) <= tol && fabs(a2) <= tol)
+      return false;
+    if ((a1 >= -tol || a2 <= tol) && (a1 <= tol || a2 >= -tol))
+      continue;
+    if (!Near(Mirror(p[i].e1, axis), p[i].e2, tol))
+      return false;
+    if (p[i].segments % 2 != 0) {
+      if (note != NULL)
+        snprintf(note, size, "tag %d is mirrored in %c = 0 but has an odd "
+                 "number of segments", p[i].tube, AXES[axis]);
+      return false;
+    }  /**  A segment straddles the plane  **/
+
+    half = p[i].segments / 2;
+    mid.x = (axis == 0) ? 0.0 : (p[i].e1.x + p[i].e2.x) / 2.0;
+    mid.y = (axis == 1) ? 0.0 : (p[i].e1.y + p[i].e2.y) / 2.0;
+    mid.z = (axis == 2) ? 0.0 : (p[i].e1.z + p[i].e2.z) / 2.0;
+    q = &p[(*count)++];
+    *q = p[i];
+    q->e1 = mid;
+    q->first = p[i].first + half;
+    q->segments = half;
+    p[i].e2 = mid;
+    p[i].segments = half;
+  }  /**  For each piece  **/
+  return true;
+
+}  /**  End of Split  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 NewPlan                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Plan *NewPlan(int count) {
+
+  SY_Plan  *plan;  /**  The plan  **/
+
+  if ((plan = (SY_Plan *) calloc(1, sizeof(SY_Plan))) == NULL)
+    return NULL;
+  if ((plan->pieces = (SY_Piece *) malloc(count * sizeof(SY_Piece))) ==
+      NULL) {
+    free(plan);
+    return NULL;
+  }  /**  No room  **/
+  plan->count = count;
+  plan->copies = 1;
+  return plan;
+
+}  /**  End of NewPlan  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Reflect                                 **/
+/**                                                                         **/
+/**  The plan for mirror planes mask (1 x, 2 y, 4 z), or NULL if the        **/
+/**  tubes do not have them all.                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Plan *Reflect(Tube *first, int tubes, int mask, double tol,
+                       char *note, int size) {
+
+  static const int  order[3] = {2, 1, 0};  /**  NEC's: z, y, then x  **/
+
+  SY_Piece  *p;         /**  Pieces, after splitting       **/
+  SY_Piece   g;         /**  A mirror image                **/
+  SY_Plan   *plan;      /**  In NEC's order                **/
+  bool      *used;      /**  Pieces placed in it           **/
+  bool       reversed;  /**  Matched the other way round   **/
+  int        count;     /**  Pieces                        **/
+  int        len;       /**  Placed so far                 **/
+  int        axis;      /**  Current plane                 **/
+  int        i;         /**  Loop counter                  **/
+  int        j;         /**  Matching piece                **/
+  int        k;         /**  Loop counter                  **/
+
+  if ((p = Pieces(first, 8 * tubes)) == NULL)
+    return NULL;
+  count = tubes;
+  for (k = 0; k < 3; k++)
+    if ((mask & (1 << order[k])) &&
+        !Split(p, &count, order[k], tol, note, size)) {
+      free(p);
+      return NULL;
+    }  /**  Plane cannot be used  **/
+
+  plan = NewPlan(count);
+  used = (bool *) calloc(count, sizeof(bool));
+  if (plan == NULL || used == NULL) {
+    SY_Free(plan);
+    free(used);
+    free(p);
+    return NULL;
+  }  /**  No room  **/
+
+  /**  The pieces on the positive side of every plane are written  **/
+  len = 0;
+  for (i = 0; i < count; i++) {
+    for (axis = 0; axis < 3; axis++)
+      if ((mask & (1 << axis)) && (Coord(p[i].e1, axis) < -tol ||
+                                   Coord(p[i].e2, axis) < -tol))
+        break;
+    if (axis == 3) {
+      plan->pieces[len++] = p[i];
+      used[i] = true;
+    }  /**  Base piece  **/
+  }  /**  For each piece  **/
+  plan->base = len;
+
+  /**  NEC's images, matched to the pieces they stand for  **/
+  for (k = 0; k < 3 && len > 0; k++) {
+    if (!(mask & (1 << order[k])))
+      continue;
+    if (2 * len > count)
+      break;
+    for (i = 0; i < len; i++) {
+      g = plan->pieces[i];
+      g.e1 = Mirror(g.e1, order[k]);
+      g.e2 = Mirror(g.e2, order[k]);
+      if ((j = Match(&g, p, count, used, tol, &reversed)) < 0)
+        break;
+      used[j] = true;
+      plan->pieces[len + i] = p[j];
+      plan->pieces[len + i].reversed = (p[j].reversed != reversed);
+      plan->pieces[len + i].e1 = g.e1;
+      plan->pieces[len + i].e2 = g.e2;
+    }  /**  For each piece so far  **/
+    if (i < len)
+      break;
+    len *= 2;
+  }  /**  For each plane  **/
+
+  free(used);
+  free(p);
+  if (len != count || k < 3) {
+    SY_Free(plan);
+    return NULL;
+  }  /**  Not symmetric  **/
+  plan->planes = ((mask & 1) ? 100 : 0) + ((mask & 2) ? 10 : 0) +
+                 ((mask & 4) ? 1 : 0);
+  return plan;
+
+}  /**  End of Reflect  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Rotate                                 **/
+/**                                                                         **/
+/**  The plan for n copies turned about the z axis, or NULL.                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Plan *Rotate(Tube *first, int tubes, int n, double tol) {
+
+  SY_Piece  *p;         /**  One piece per tube             **/
+  SY_Piece   g;         /**  A turned copy                  **/
+  SY_Plan   *plan;      /**  In NEC's order                 **/
+  bool      *used;      /**  Pieces placed in it            **/
+  bool       reversed;  /**  Matched the other way round    **/
+  double     sector;    /**  Radians between copies         **/
+  double     angle;     /**  Of a piece's middle            **/
+  double     mx;        /**    ..which is here              **/
+  double     my;
+  int        len;       /**  Placed so far                  **/
+  int        i;         /**  Loop counter                   **/
+  int        j;         /**  Matching piece                 **/
+  int        c;         /**  Copy                           **/
+
+  if ((p = Pieces(first, tubes)) == NULL)
+    return NULL;
+  plan = NewPlan(tubes);
+  used = (bool *) calloc(tubes, sizeof(bool));
+  if (plan == NULL || used == NULL) {
+    SY_Free(plan);
+    free(used);
+    free(p);
+    return NULL;
+  }  /**  No room  **/
+
+  /**  The pieces whose middle is in the first sector are written  **/
+  sector = 2.0 * M_PI / n;
+  len = 0;
+  for (i = 0; i < tubes; i++) {
+    mx = (p[i].e1.x + p[i].e2.x) / 2.0;
+    my = (p[i].e1.y + p[i].e2.y) / 2.0;
+    if (hypot(mx, my) <= tol)
+      break;
+    angle = fmod(atan2(my, mx) + 1.0e-3 * sector + 2.0 * M_PI, 2.0 * M_PI);
+    if (angle < sector) {
+      plan->pieces[len++] = p[i];
+      used[i] = true;
+    }  /**  Base piece  **/
+  }  /**  For each piece  **/
+  plan->base = len;
+
+  /**  NEC's copies, one sector at a time  **/
+  if (i == tubes && len * n == tubes)
+    for (c = 1; c < n; c++) {
+      for (i = 0; i < plan->base; i++) {
+        g = plan->pieces[i];
+        g.e1 = Turn(g.e1, c * sector);
+        g.e2 = Turn(g.e2, c * sector);
+        if ((j = Match(&g, p, tubes, used, tol, &reversed)) < 0)
+          break;
+        used[j] = true;
+        plan->pieces[len] = p[j];
+        plan->pieces[len].reversed = reversed;
+        plan->pieces[len].e1 = g.e1;
+        plan->pieces[len++].e2 = g.e2;
+      }  /**  For each piece written  **/
+      if (i < plan->base)
+        break;
+    }  /**  For each copy  **/
+
+  free(used);
+  free(p);
+  if (len != tubes || plan->base * n != tubes) {
+    SY_Free(plan);
+    return NULL;
+  }  /**  Not symmetric  **/
+  plan->copies = n;
+  return plan;
+
+}  /**  End of Rotate  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 SY_Find                                 **/
+/**                                                                         **/
+/**  The largest symmetry NEC can use in the tubes: up to three mirror      **/
+/**  planes through the origin, but not z = 0 over ground, or a rotation    **/
+/**  about the z axis.  NULL if there is none; note then says why the       **/
+/**  likeliest plane could not be used, when that is known.                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+SY_Plan *SY_Find(Tube *first, bool ground, char *note, int size) {
+
+  static const int  masks[7] = {7, 3, 5, 6, 1, 2, 4};  /**  Most first  **/
+
+  SY_Plan  *best;     /**  Largest found     **/
+  SY_Plan  *plan;     /**  One tried         **/
+  Tube     *tube;     /**  Current tube      **/
+  double    extent;   /**  Of the structure  **/
+  double    tol;      /**  Allowed mismatch  **/
+  int       tubes;    /**  How many          **/
+  int       factor;   /**  Best's saving     **/
+  int       planes;   /**  In a mask         **/
+  int       n;        /**  Copies            **/
+  int       m;        /**  Loop counter      **/
+
+  if (note != NULL && size > 0)
+    note[0] = '\0';
+  extent = 0.0;
+  for (tube = first, tubes = 0; tube != NULL; tube = tube->next, tubes++) {
+    extent = fmax(extent, fmax(fabs(tube->e1.x), fabs(tube->e2.x)));
+    extent = fmax(extent, fmax(fabs(tube->e1.y), fabs(tube->e2.y)));
+    extent = fmax(extent, fmax(fabs(tube->e1.z), fabs(tube->e2.z)));
+  }  /**  For each tube  **/
+  if (tubes == 0 || extent <= 0.0)
+    return NULL;
+  tol = SY_TOLERANCE * extent;
+
+  best = NULL;
+  factor = 1;
+  for (m = 0; m < 7; m++) {
+    if (ground && (masks[m] & 4))
+      continue;
+    planes = (masks[m] & 1) + ((masks[m] >> 1) & 1) + ((masks[m] >> 2) & 1);
+    if ((1 << planes) <= factor)
+      continue;
+    if ((plan = Reflect(first, tubes, masks[m], tol, note, size)) != NULL) {
+      best = plan;
+      factor = 1 << planes;
+    }  /**  Found  **/
+  }  /**  For each set of planes  **/
+
+  for (n = SY_MAX_COPIES; n > factor; n--) {
+    if (tubes % n != 0)
+      continue;
+    if ((plan = Rotate(first, tubes, n, tol)) != NULL) {
+      SY_Free(best);
+      best = plan;
+      break;
+    }  /**  Found  **/
+  }  /**  For each rotation  **/
+
+  if (best != NULL && note != NULL && size > 0)
+    note[0] = '\0';
+  return best;
+
+}  /**  End of SY_Find  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SY_ToDeck                                **/
+/**                                                                         **/
+/**  Where segment seg of tube, both counted from 1, is in the deck: its    **/
+/**  tag and segment there, and whether the piece runs against the tube.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SY_ToDeck(const SY_Plan *plan, int tube, int seg, int *tag,
+               int *deck_seg, bool *reversed) {
+
+  const SY_Piece  *p;  /**  Current piece  **/
+  int              k;  /**  Loop counter   **/
+
+  for (k = 0; k < plan->count; k++) {
+    p = &plan->pieces[k];
+    if (p->tube != tube || seg <= p->first || seg > p->first + p->segments)
+      continue;
+    *tag = k + 1;
+    *deck_seg = p->reversed ? p->first + p->segments - seg + 1
+                            : seg - p->first;
+    *reversed = p->reversed;
+    return true;
+  }  /**  For each piece  **/
+  return false;
+
+}  /**  End of SY_ToDeck  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SY_FromDeck                               **/
+/**                                                                         **/
+/**  The tube and segment of segment deck_seg of tag in the deck.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SY_FromDeck(const SY_Plan *plan, int tag, int deck_seg, int *tube,
+                 int *seg, bool *reversed) {
+
+  const SY_Piece  *p;  /**  The piece  **/
+
+  if (tag < 1 || tag > plan->count)
+    return false;
+  p = &plan->pieces[tag - 1];
+  if (deck_seg < 1 || deck_seg > p->segments)
+    return false;
+  *tube = p->tube;
+  *seg = p->reversed ? p->first + p->segments - deck_seg + 1
+                     : p->first + deck_seg;
+  *reversed = p->reversed;
+  return true;
+
+}  /**  End of SY_FromDeck  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SY_FromSegment                             **/
+/**                                                                         **/
+/**  As SY_FromDeck, for NEC's number of a segment in the whole deck.       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SY_FromSegment(const SY_Plan *plan, int number, int *tube, int *seg,
+                    bool *reversed) {
+
+  int  k;  /**  Loop counter  **/
+
+  for (k = 0; k < plan->count && number > plan->pieces[k].segments; k++)
+    number -= plan->pieces[k].segments;
+  return k < plan->count &&
+         SY_FromDeck(plan, k + 1, number, tube, seg, reversed);
+
+}  /**  End of SY_FromSegment  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 SY_Free                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void SY_Free(SY_Plan *plan) {
+
+  if (plan == NULL)
+    return;
+  free(plan->pieces);
+  free(plan);
+
+}  /**  End of SY_Free  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of Symmetry.c                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
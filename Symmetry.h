@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  SY_TOLERANCE   1.0e-5   /**  Of the structure's extent          **/
+#define  SY_MAX_COPIES  16       /**  Largest GR rotation tried          **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct SY_Piece {
+  int     tube;      /**  Tube it is part of, counted from 1         **/
+  int     first;     /**  Tube's first segment in it, from 0         **/
+  int     segments;  /**  Segments in the piece                      **/
+  bool    reversed;  /**  Runs against the tube                      **/
+  Point   e1;        /**  End points as NEC has them                 **/
+  Point   e2;
+  double  width;     /**  The tube's                                 **/
+} SY_Piece;
+
+typedef struct SY_Plan {
+  int        planes;   /**  GX flags, 100 x + 10 y + z, 0 if none     **/
+  int        copies;   /**  GR copies about z, 1 if none              **/
+  int        base;     /**  Pieces written as GW, tags 1 to base      **/
+  int        count;    /**  All pieces, by the tag NEC gives them     **/
+  SY_Piece  *pieces;
+} SY_Plan;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+SY_Plan  *SY_Find(Tube *, bool, char *, int);
+bool      SY_ToDeck(const SY_Plan *, int, int, int *, int *, bool *);
+bool      SY_FromDeck(const SY_Plan *, int, int, int *, int *, bool *);
+bool      SY_FromSegment(const SY_Plan *, int, int *, int *, bool *);
+void      SY_Free(SY_Plan *);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of Symmetry.h                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,228 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  Wall clock timers for the expensive steps of the program: drawing a
+ *  frame, building the field and the wires, writing the NEC deck,
+ *  running nec2 and parsing its output.  Each timer keeps its last
+ *  TM_WINDOW samples in a ring, and the percentiles are worked out from
+ *  that window when asked for, so a slow start-up does not hide how the
+ *  program behaves now.  Timers are only used from the GUI thread.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "MyTypes.h"
+#include "Timing.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Typedefs                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Timer {
+  double  samples[TM_WINDOW];  /**  Rolling window, in ms       **/
+  long    count;               /**  Samples ever recorded       **/
+} Timer;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Global Variables                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local Timer  Timers[TM_COUNT];  /**  One per instrumented step  **/
+
+local const char *Names[TM_COUNT] = {
+  "display", "field_points", "field_surface", "field_sphere",
+  "tubes", "generate_nec", "nec2", "parse_field", "far_field", "check_deck"
+};  /**  As reported to Tcl  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              CompareDouble                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int CompareDouble(const void *a, const void *b) {
+
+  double  x = *(const double *) a;  /**  First   **/
+  double  y = *(const double *) b;  /**  Second  **/
+
+  return (x > y) - (x < y);
+
+}  /**  End of CompareDouble  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 TM_Start                                **/
+/**                                                                         **/
+/**  Milliseconds on the monotonic clock.  Only differences mean anything.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double TM_Start(void) {
+
+  struct timespec  now;  /**  Monotonic clock  **/
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000.0 + now.tv_nsec / 1.0e6;
+
+}  /**  End of TM_Start  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 TM_Stop                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TM_Stop(int timer, double start) {
+
+  TM_Record(timer, TM_Start() - start);
+
+}  /**  End of TM_Stop  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                TM_Record                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TM_Record(int timer, double ms) {
+
+  Timer  *t;  /**  The timer  **/
+
+  if (timer < 0 || timer >= TM_COUNT)
+    return;
+  t = &Timers[timer];
+  t->samples[t->count % TM_WINDOW] = ms;
+  t->count++;
+
+}  /**  End of TM_Record  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               TM_Summarize                              **/
+/**                                                                         **/
+/**  Fills in the percentiles of one timer over its rolling window.         **/
+/**  Percentiles are the nearest sample, which is plenty for 128 of them.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TM_Summarize(int timer, TM_Summary *summary) {
+
+  double  sorted[TM_WINDOW];  /**  Copy of the window  **/
+  int     kept;               /**  Samples in it       **/
+
+  memset(summary, 0, sizeof(TM_Summary));
+  if (timer < 0 || timer >= TM_COUNT || Timers[timer].count == 0)
+    return;
+
+  kept = Timers[timer].count < TM_WINDOW ? Timers[timer].count : TM_WINDOW;
+  memcpy(sorted, Timers[timer].samples, kept * sizeof(double));
+  qsort(sorted, kept, sizeof(double), CompareDouble);
+
+  summary->count = Timers[timer].count;
+  summary->kept = kept;
+  summary->p50 = sorted[(kept - 1) / 2];
+  summary->p95 = sorted[(kept * 95 - 1) / 100];
+  summary->max = sorted[kept - 1];
+
+}  /**  End of TM_Summarize  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 TM_Name                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+const char *TM_Name(int timer) {
+
+  if (timer < 0 || timer >= TM_COUNT)
+    return "unknown";
+  return Names[timer];
+
+}  /**  End of TM_Name  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 TM_Reset                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void TM_Reset(void) {
+
+  memset(Timers, 0, sizeof(Timers));
+
+}  /**  End of TM_Reset  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Timing.c                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
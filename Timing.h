@@ -0,0 +1,99 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Definitions                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  TM_DISPLAY         0   /**  TKA_Display, one frame               **/
+#define  TM_FIELD_POINTS    1   /**  DisplayField, point clouds           **/
+#define  TM_FIELD_SURFACE   2   /**  DisplayField, surfaces               **/
+#define  TM_FIELD_SPHERE    3   /**  DisplayField, unit spheres           **/
+#define  TM_TUBES           4   /**  Wires of one antenna                 **/
+#define  TM_GENERATE        5   /**  GenerateNECFile                      **/
+#define  TM_SOLVER          6   /**  The nec2 child process               **/
+#define  TM_PARSE           7   /**  ParseFieldData                       **/
+#define  TM_FAR_FIELD       8   /**  Pattern from the segment currents    **/
+#define  TM_CHECK           9   /**  DC_Check, the deck before nec2       **/
+#define  TM_COUNT          10
+
+#define  TM_WINDOW        128   /**  Samples kept per timer               **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Typedefs                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct TM_Summary {
+  long    count;  /**  Samples ever recorded          **/
+  int     kept;   /**  Samples in the rolling window  **/
+  double  p50;    /**  Median of the window, in ms    **/
+  double  p95;    /**  95th percentile, in ms         **/
+  double  max;    /**  Slowest in the window, in ms   **/
+} TM_Summary;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           Function Prototypes                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double       TM_Start(void);
+void         TM_Stop(int, double);
+void         TM_Record(int, double);
+void         TM_Summarize(int, TM_Summary *);
+const char  *TM_Name(int);
+void         TM_Reset(void);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             End of Timing.h                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
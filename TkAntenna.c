@@ -27,9 +27,11 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 #include "MyTypes.h"
 #include "TkAntenna.h"
 #include "togl.h"
+#include "SolverPool.h"
 
 
 /*****************************************************************************/
@@ -77,6 +79,9 @@ local int Init(Tcl_Interp *interp) {
 int  main(int argc, char **argv) {
 
   TKA_PrgName = argv[0];
+
+  /**  Fork the nec2 workers now, while the process is still small  **/
+  SP_Init(sysconf(_SC_NPROCESSORS_ONLN), 0);
   Tk_Main(argc, argv, Init );
   return 0;
 
@@ -29,6 +29,7 @@
 #include <stddef.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include "MyTypes.h"
@@ -38,6 +39,56 @@
 #include "pcard.h"
 #include "VisField.h"
 #include "VisWires.h"
+#include "PatKernel.h"
+#include "WorkPool.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  MESH_PLAIN        0   /**  Positions only             **/
+#define  MESH_SENSE        1   /**  Polarization sense colours  **/
+#define  MESH_TILT         2   /**  Polarization tilt colours   **/
+#define  MESH_AXIAL_RATIO  3   /**  Axial ratio colours         **/
+#define  MESH_NULLS        4   /**  Null highlight colours      **/
+
+#define  LOD_MAX           8   /**  Coarsest level, every 8th sample     **/
+#define  LOD_MIN_QUADS     8   /**  Never fewer quads around the mesh    **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct MeshJob {
+  Ant            *antData;     /**  Antenna whose mesh is built     **/
+  FieldData      *field;       /**  Its field data                  **/
+  const PK_Grid  *grid;        /**  Direction table of the RP grid  **/
+  int             increments;  /**  Mesh rows and columns           **/
+  int             columns;     /**  Samples per RP row              **/
+  double          offset;      /**  Added to every radius           **/
+  bool            use_gain;    /**  Gain surface or unit sphere     **/
+  int             colour;      /**  One of the MESH_ modes          **/
+  double          range;       /**  Span of the coloured quantity   **/
+  float          *px;          /**  Positions as increments^2 x     **/
+  float          *py;          /**    ..y                           **/
+  float          *pz;          /**    ..z                           **/
+  float          *nx;          /**  Normals, same layout            **/
+  float          *ny;          /**    ..y                           **/
+  float          *nz;          /**    ..z                           **/
+  float           rowmax[361]; /**  Largest radius in each row      **/
+} MeshJob;
 
 
 /*****************************************************************************/
@@ -55,6 +106,7 @@ extern double  ALPHA;             /**  Alpha transparency factor    **/
 extern double  curr_step_size;    /**  Updated when the NEC called  **/
 extern double  NULL_THRESHOLD;    /**  As a percentage of max dBi   **/
 extern double  NULL_DISTANCE;     /**  So null maps float above     **/
+extern double  LOD_PIXEL_ERROR;   /**  Allowed LOD error in pixels  **/
 
 
 /*****************************************************************************/
@@ -160,7 +212,7 @@ void DrawRFPowerDensityPoints(Ant *antData) {
   for(i = 0; i < antData->fieldData->count; i++) {
     PlotPoint(antData->fieldData->vals[i].theta, 
               antData->fieldData->vals[i].phi,
-              exp(antData->fieldData->vals[i].total_gain/10.0));
+              PK_DbToLinear(antData->fieldData->vals[i].total_gain));
   }  /**  For each point  **/
 
 }  /**  End of DrawRFPowerDensityPoints  **/
@@ -204,7 +256,7 @@ void DrawPolarizationSensePoints(Ant *antData) {
     glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color); 
     PlotPoint(antData->fieldData->vals[i].theta, 
               antData->fieldData->vals[i].phi,
-              exp(antData->fieldData->vals[i].total_gain/10.0));
+              PK_DbToLinear(antData->fieldData->vals[i].total_gain));
   }  /**  For each point  **/
 
 }  /**  End of DrawPolarizationSensePoints  **/
@@ -241,7 +293,7 @@ void DrawPolarizationTiltPoints(Ant *antData) {
     glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color); 
     PlotPoint(antData->fieldData->vals[i].theta, 
               antData->fieldData->vals[i].phi,
-              exp(antData->fieldData->vals[i].total_gain/10.0));
+              PK_DbToLinear(antData->fieldData->vals[i].total_gain));
   }  /**  For each point  **/
 
 }  /**  End of DrawPolarizationTiltPoints  **/
@@ -279,7 +331,7 @@ void DrawAxialRatioPoints(Ant *antData) {
     glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color); 
     PlotPoint(antData->fieldData->vals[i].theta, 
               antData->fieldData->vals[i].phi,
-              exp(antData->fieldData->vals[i].total_gain/10.0));
+              PK_DbToLinear(antData->fieldData->vals[i].total_gain));
   }  /**  For each point  **/
 
 }  /**  End of DrawAxialRatioPoints  **/
@@ -321,7 +373,7 @@ void DrawShowNullsPoints(Ant *antData) {
     if (point_color[3] > 0.0) {
       PlotPoint(antData->fieldData->vals[i].theta, 
                 antData->fieldData->vals[i].phi,
-                exp(antData->fieldData->vals[i].total_gain/10.0) +
+                PK_DbToLinear(antData->fieldData->vals[i].total_gain) +
                 (NULL_DISTANCE / 5));
     }  /**  Plot a point  **/
   }  /**  For each point  **/
@@ -329,6 +381,441 @@ void DrawShowNullsPoints(Ant *antData) {
 }  /**  End of DrawShowNullsPoints  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               MeshBand                                  **/
+/**                                                                         **/
+/**  Builds rows first to last-1 of the mesh: converts the samples with     **/
+/**  the PatKernel, stores the positions, maps the colour for the job's     **/
+/**  mode.  The positions also go to the job's x/y/z arrays for            **/
+/**  NormalBand.  Runs on the worker threads, so it only writes to its own  **/
+/**  rows and never calls GL.                                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void MeshBand(void *arg, int first, int last) {
+
+  MeshJob    *job;             /**  What to build               **/
+  MeshPoint  *mesh;            /**  Current mesh point          **/
+  FieldVal   *val;             /**  Current sample              **/
+  float       radius[361];     /**  Kernel output for one row   **/
+  float       x[361];          /**  Kernel output for one row   **/
+  float       y[361];          /**  Kernel output for one row   **/
+  float       z[361];          /**  Kernel output for one row   **/
+  GLfloat     point_color[4];  /**  ComputeColor output         **/
+  double      current_value;   /**  Current color value         **/
+  int         el;              /**  Loop counter                **/
+  int         az;              /**  Loop counter                **/
+
+  job = (MeshJob *) arg;
+  for (el = first; el < last; el++) {
+    job->rowmax[el] = 0.0;
+    PK_ConvertRows(job->grid, el, el + 1, &job->field->vals[0].total_gain, 
+                   sizeof(FieldVal), POINT_DIST_SCALE, job->offset, 
+                   job->use_gain, radius, x, y, z);
+    for (az = 0; az < job->increments; az++) {
+      mesh = &job->antData->surfaceMesh[el][az];
+      val = &job->field->vals[el * job->columns + az];
+      mesh->posx = x[az];
+      mesh->posy = y[az];
+      mesh->posz = z[az];
+      job->px[el * job->increments + az] = x[az];
+      job->py[el * job->increments + az] = y[az];
+      job->pz[el * job->increments + az] = z[az];
+      if (radius[az] > job->rowmax[el])
+        job->rowmax[el] = radius[az];
+
+      switch (job->colour) {
+        case MESH_SENSE:
+          if (val->sense == LINEAR) {
+            mesh->r = 0.0;
+            mesh->g = 1.0;
+            mesh->b = 0.0;
+          }  /**  Linear  **/
+          if (val->sense == RIGHT) {
+            mesh->r = 1.0;
+            mesh->g = 1.0;
+            mesh->b = 1.0;
+          }  /**  Right  **/
+          if (val->sense == LEFT) {
+            mesh->r = 0.0;
+            mesh->g = 0.0;
+            mesh->b = 1.0;
+          }  /**  Left  **/
+          break;
+        case MESH_TILT:
+          current_value = (val->tilt + (-1 * job->field->mintilt)) / 
+                          job->range;
+          mesh->r = current_value;
+          mesh->g = 1.0;
+          mesh->b = current_value;
+          break;
+        case MESH_AXIAL_RATIO:
+          current_value = (val->axial_ratio + 
+                          (-1 * job->field->minaxialratio)) / job->range;
+          ComputeColor(current_value, 
+                       job->field->minaxialratio,
+                       job->field->maxaxialratio,
+                       point_color);
+          mesh->r = point_color[0];
+          mesh->g = point_color[1];
+          mesh->b = point_color[2];
+          break;
+        case MESH_NULLS:
+          current_value = ((val->total_gain + (-1*job->field->mingain))
+                           / job->range);
+          mesh->r = (current_value < NULL_THRESHOLD) ? 1.0 : 0.0;
+          mesh->g = 0.0;
+          mesh->b = 0.0;
+          break;
+      }  /**  Switch on colour mode  **/
+    }  /**  By azimuth  **/
+
+  }  /**  By elevation  **/
+
+}  /**  End of MeshBand  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              NormalBand                                 **/
+/**                                                                         **/
+/**  Computes the normals for rows first to last-1 from the positions       **/
+/**  MeshBand left in the job, copies them into surfaceMesh and fills the   **/
+/**  wrap-around column.  Runs after every band of MeshBand has finished,   **/
+/**  since each normal needs the rows on either side.                       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void NormalBand(void *arg, int first, int last) {
+
+  MeshJob    *job;   /**  What to build       **/
+  MeshPoint  *mesh;  /**  Current mesh point  **/
+  int         el;    /**  Loop counter        **/
+  int         az;    /**  Loop counter        **/
+  int         i;     /**  Sample index        **/
+
+  job = (MeshJob *) arg;
+  PK_Normals(job->px, job->py, job->pz, job->increments, job->increments,
+             first, last, job->nx, job->ny, job->nz);
+  for (el = first; el < last; el++) {
+    for (az = 0; az < job->increments; az++) {
+      mesh = &job->antData->surfaceMesh[el][az];
+      i = el * job->increments + az;
+      mesh->nx = job->nx[i];
+      mesh->ny = job->ny[i];
+      mesh->nz = job->nz[i];
+    }  /**  By azimuth  **/
+
+    job->antData->surfaceMesh[el][job->increments] = 
+      job->antData->surfaceMesh[el][0];
+  }  /**  By elevation  **/
+
+}  /**  End of NormalBand  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             MeshIncrements                              **/
+/**                                                                         **/
+/**  The increments of the mesh for a field, from the field's own grid      **/
+/**  rather than curr_step_size, which may be that of another antenna or    **/
+/**  of no solve at all.  0 if the field is not the square RP grid          **/
+/**  WriteCardFile asks NEC for, so it cannot be meshed.                    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int MeshIncrements(const FieldData *field) {
+
+  double  step;        /**  Degrees between samples  **/
+  int     columns;     /**  Samples per row          **/
+  int     increments;  /**  Mesh size                **/
+
+  if (field == NULL || field->count < 4)
+    return 0;
+  columns = (int) (sqrt((double) field->count) + 0.5);
+  step = field->vals[1].theta - field->vals[0].theta;
+  if (columns * columns != field->count || step < 1.0)
+    return 0;
+  increments = (int) (360.0 / step + 1e-6);
+  if (increments < 1 || increments > columns || columns > 361)
+    return 0;
+  return increments;
+
+}  /**  End of MeshIncrements  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               BuildMesh                                 **/
+/**                                                                         **/
+/**  Fills surfaceMesh, including the wrap-around row and column and the    **/
+/**  normals, from the field data.  NEC prints the RP grid as rows of       **/
+/**  equal phi with columns*columns samples, so sample (el, az) is at el *  **/
+/**  columns + az; the grid has one more sample per row than the mesh has   **/
+/**  increments at a 1 degree step, and indexing by row keeps the rows      **/
+/**  from drifting.  The sample directions come from the shared direction   **/
+/**  table for the grid.  With use_gain false every point is put on a       **/
+/**  sphere of radius POINT_DIST_SCALE.  The colour mode selects how r, g   **/
+/**  and b are set (MESH_PLAIN leaves them alone).                          **/
+/**                                                                         **/
+/**  The mesh is only rebuilt when the field data or one of the parameters  **/
+/**  it depends on changed since the last call for this antenna, so         **/
+/**  redrawing the same pattern costs nothing here.  The rows are built in  **/
+/**  bands on the WorkPool threads; the GL calls that follow stay on this   **/
+/**  thread.                                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void BuildMesh(Ant *antData, int increments, double offset, 
+                     bool use_gain, int colour) {
+
+  static float  *buffer = NULL;   /**  Storage for the x/y/z arrays  **/
+  static int     allocated = 0;   /**  Samples the buffer holds      **/
+  MeshJob        job;             /**  Shared by all bands           **/
+  MeshKey        key;             /**  What this mesh is built for   **/
+  FieldData     *field;           /**  Shorthand for field data      **/
+  double         step;            /**  Degrees between samples       **/
+  int            size;            /**  Samples in the mesh           **/
+  int            az;              /**  Loop counter                  **/
+
+  field = antData->fieldData;
+  memset(&key, 0, sizeof(MeshKey));
+  key.serial = field->serial;
+  key.increments = increments;
+  key.colour = colour;
+  key.use_gain = use_gain;
+  key.offset = offset;
+  key.scale = POINT_DIST_SCALE;
+  key.threshold = (colour == MESH_NULLS) ? NULL_THRESHOLD : 0.0;
+  if (memcmp(&key, &antData->meshKey, sizeof(MeshKey)) == 0)
+    return;
+
+  job.antData = antData;
+  job.field = field;
+  job.increments = increments;
+  job.columns = (int) (sqrt((double) field->count) + 0.5);
+  job.offset = offset;
+  job.use_gain = use_gain;
+  job.colour = colour;
+  assert(job.columns >= increments && job.columns <= 361);
+
+  switch (colour) {
+    case MESH_TILT:
+      job.range = field->maxtilt - field->mintilt;
+      break;
+    case MESH_AXIAL_RATIO:
+      job.range = field->maxaxialratio - field->minaxialratio;
+      break;
+    case MESH_NULLS:
+      job.range = field->maxgain + (-1*field->mingain);
+      break;
+    default:
+      job.range = 1.0;
+      break;
+  }  /**  Switch on colour mode  **/
+
+  step = (job.columns > 1) ? field->vals[1].theta - field->vals[0].theta
+                           : curr_step_size;
+  job.grid = PK_DirectionTable(step, job.columns, job.columns);
+  PK_ActiveKernel();
+
+  size = increments * increments;
+  if (size > allocated) {
+    allocated = size;
+    buffer = (float *) realloc(buffer, 6 * allocated * sizeof(float));
+  }  /**  Grow the x/y/z arrays  **/
+  job.px = buffer;
+  job.py = buffer + size;
+  job.pz = buffer + 2 * size;
+  job.nx = buffer + 3 * size;
+  job.ny = buffer + 4 * size;
+  job.nz = buffer + 5 * size;
+
+  WP_Run(MeshBand, &job, increments);
+  WP_Run(NormalBand, &job, increments);
+
+  for (az = 0; az <= increments; az++)
+    antData->surfaceMesh[increments][az] = antData->surfaceMesh[0][az];
+  antData->meshRadius = 0.0;
+  for (az = 0; az < increments; az++)
+    if (job.rowmax[az] > antData->meshRadius)
+      antData->meshRadius = job.rowmax[az];
+  memcpy(&antData->meshKey, &key, sizeof(MeshKey));
+
+}  /**  End of BuildMesh  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             BuildPatternMesh                            **/
+/**                                                                         **/
+/**  Builds the mesh the radiation pattern surface (or, without use_gain,   **/
+/**  the sphere) would draw, without drawing it.  For callers that want     **/
+/**  the mesh ready, or timed, apart from the GL work.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void BuildPatternMesh(Ant *antData, bool use_gain) {
+
+  int  increments;  /**  Mesh size  **/
+
+  if ((increments = MeshIncrements(antData->fieldData)) > 0)
+    BuildMesh(antData, increments, 0.0, use_gain, MESH_PLAIN);
+
+}  /**  End of BuildPatternMesh  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SelectLOD                                 **/
+/**                                                                         **/
+/**  Picks the level of detail for drawing a mesh: the stride (1, 2, 4 or   **/
+/**  8) between the samples used.  The bounding sphere of the mesh is       **/
+/**  projected with the current GL matrices, which carry the eye distance   **/
+/**  and the antenna's visual scale, to get its radius in pixels.           **/
+/**  Skipping samples turns arcs of the surface into chords; the coarsest   **/
+/**  level whose chord error (radius * (1 - cos(angle/2))) stays within     **/
+/**  LOD_PIXEL_ERROR pixels wins.  An error budget of 0 always draws every  **/
+/**  sample.                                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int SelectLOD(Ant *antData, int increments) {
+
+  GLdouble  modelview[16];   /**  Current modelview matrix      **/
+  GLdouble  projection[16];  /**  Current projection matrix     **/
+  GLint     viewport[4];     /**  Current viewport              **/
+  double    scale;           /**  Model to eye scale            **/
+  double    depth;           /**  Distance to the mesh centre   **/
+  double    radius;          /**  Mesh radius in eye space      **/
+  double    pixels;          /**  Mesh radius on screen         **/
+  double    angle;           /**  Angle between used samples    **/
+  int       lod;             /**  Level being tried             **/
+
+  if (LOD_PIXEL_ERROR <= 0.0 || antData->meshRadius <= 0.0)
+    return 1;
+
+  glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+  glGetDoublev(GL_PROJECTION_MATRIX, projection);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  scale = sqrt(modelview[0] * modelview[0] + modelview[1] * modelview[1] +
+               modelview[2] * modelview[2]);
+  radius = antData->meshRadius * scale;
+  depth = -modelview[14];
+  if (depth <= radius)
+    return 1;
+  pixels = radius * projection[5] * viewport[3] / 2.0 / depth;
+
+  for (lod = LOD_MAX; lod > 1; lod /= 2) {
+    if (increments / lod < LOD_MIN_QUADS)
+      continue;
+    angle = radian(lod * 360.0 / increments);
+    if (pixels * (1.0 - cos(angle / 2.0)) <= LOD_PIXEL_ERROR)
+      return lod;
+  }  /**  Coarsest first  **/
+  return 1;
+
+}  /**  End of SelectLOD  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               MeshVertex                                **/
+/**                                                                         **/
+/**  Emits one vertex of the mesh with its normal, and its colour unless    **/
+/**  the surface is drawn in a single colour (MESH_PLAIN).                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void MeshVertex(MeshPoint *mesh, int colour) {
+
+  GLfloat  point_color[4];  /**  Color surface  **/
+
+  if (colour != MESH_PLAIN) {
+    point_color[0] = mesh->r;
+    point_color[1] = mesh->g;
+    point_color[2] = mesh->b;
+    point_color[3] = ALPHA;
+    if (colour == MESH_NULLS && point_color[0] != 1.0)
+      point_color[3] = 0.0;
+    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
+  }  /**  Per vertex colour  **/
+
+  glNormal3f(mesh->nx, mesh->ny, mesh->nz);
+  glVertex3f(mesh->posx, mesh->posy, mesh->posz);
+
+}  /**  End of MeshVertex  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             DrawMeshStrips                              **/
+/**                                                                         **/
+/**  Draws the triangle strips of a built mesh.  Each strip joins two       **/
+/**  latitudes lod rows apart, stepping lod samples along the longitude,    **/
+/**  so the coarser levels are just a sparser walk over the same cached     **/
+/**  mesh and need no rebuilding.  The last row and column are always       **/
+/**  included, so the surface stays closed at every level.                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void DrawMeshStrips(Ant *antData, int increments, int colour) {
+
+  int  lod;        /**  Level of detail, as a sample stride  **/
+  int  half;       /**  Last longitude drawn                 **/
+  int  latitude;   /**  Loop counter                         **/
+  int  next;       /**  Latitude on the other side of strip  **/
+  int  longitude;  /**  Loop counter                         **/
+
+  lod = SelectLOD(antData, increments);
+  half = increments / 2;
+  for (latitude = 0; latitude < increments; latitude += lod) {
+    next = latitude + lod;
+    if (next > increments)
+      next = increments;
+    glBegin(GL_TRIANGLE_STRIP);
+    longitude = 0;
+    while (true) {
+      MeshVertex(&antData->surfaceMesh[latitude][longitude], colour);
+      MeshVertex(&antData->surfaceMesh[next][longitude], colour);
+      if (longitude == half)
+        break;
+      longitude += lod;
+      if (longitude > half)
+        longitude = half;
+    }  /**  For all latitudes control points  **/
+    glEnd();
+  }  /**  Triangle strips  **/
+
+}  /**  End of DrawMeshStrips  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
@@ -344,17 +831,6 @@ void DrawShowNullsPoints(Ant *antData) {
 void DrawRFPowerDensitySurface(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
   GLfloat  green_color[4];   /**  Color surface    **/
   GLfloat  red_color[4];     /**  Color surface    **/
   GLfloat  blue_color[4];    /**  Color surface    **/
@@ -386,77 +862,20 @@ void DrawRFPowerDensitySurface(Ant *antData) {
   white_color[2] = 1.0;
   white_color[3] = ALPHA;
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = exp(antData->fieldData->vals[i].total_gain / 10.0) * 
-          POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;      
-	/*
-        if (el >= increments/4 && el < increments *3 /4) 
-          surfaceMesh[el][az].posy = surfaceMesh[el][az].posy * -1;
-	  */
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, true, MESH_PLAIN);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
     glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, green_color);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_PLAIN);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -480,23 +899,11 @@ void DrawRFPowerDensitySurface(Ant *antData) {
 void DrawPolarizationSenseSurface(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
   GLfloat  green_color[4];   /**  Color surface    **/
   GLfloat  red_color[4];     /**  Color surface    **/
   GLfloat  blue_color[4];    /**  Color surface    **/
   GLfloat  yellow_color[4];  /**  Color surface    **/
   GLfloat  white_color[4];   /**  Color surface    **/
-  GLfloat  point_color[4];   /**  Color surface    **/
 
   green_color[0] = 0.1;
   green_color[1] = 0.8;
@@ -523,113 +930,19 @@ void DrawPolarizationSenseSurface(Ant *antData) {
   white_color[2] = 1.0;
   white_color[3] = ALPHA;
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = exp(antData->fieldData->vals[i].total_gain / 10.0) * 
-          POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-	/*
-        if (el >= increments/4 && el < increments *3 /4) 
-          surfaceMesh[el][az].posy = surfaceMesh[el][az].posy * -1;
-	  */
-
-        if (antData->fieldData->vals[i].sense == LINEAR) {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 1.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        }  /**  Linear  **/
-
-        if (antData->fieldData->vals[i].sense == RIGHT) {
-          antData->surfaceMesh[el][az].r = 1.0;
-          antData->surfaceMesh[el][az].g = 1.0;
-          antData->surfaceMesh[el][az].b = 1.0;
-        }  /**  Right  **/
-
-        if (antData->fieldData->vals[i].sense == LEFT) {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 1.0;
-        }  /**  Left  **/
-          
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, true, MESH_SENSE);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_SENSE);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -653,115 +966,20 @@ void DrawPolarizationSenseSurface(Ant *antData) {
 void DrawPolarizationTiltSurface(Ant *antData) {
 
   int      increments;      /**  Number of incs       **/
-  int      az;              /**  Loop counter         **/
-  int      el;              /**  Loop counter         **/
-  int      latitude;        /**  Loop counter         **/
-  int      longitude;       /**  Loop counter         **/
-  int      i;               /**  Loop counter         **/
-  double   tx;              /**  Temporary x          **/
-  double   ty;              /**  Temporary y          **/
-  double   tz;              /**  Temporary z          **/
-  double   ttheta;          /**  Temporary angle      **/
-  double   tphi;            /**  Temporary angle      **/
-  double   tdist;           /**  Temp distance        **/
-  GLfloat  point_color[4];  /**  Color surface        **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
-
-  range = antData->fieldData->maxtilt - antData->fieldData->mintilt;
-
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = exp(antData->fieldData->vals[i].total_gain / 10.0) * 
-          POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        current_value = (antData->fieldData->vals[i].tilt + 
-                        (-1 * antData->fieldData->mintilt)) / range;
-        antData->surfaceMesh[el][az].r = current_value;
-        antData->surfaceMesh[el][az].g = 1.0;
-        antData->surfaceMesh[el][az].b = current_value;
-
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, true, MESH_TILT);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_TILT);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -785,118 +1003,20 @@ void DrawPolarizationTiltSurface(Ant *antData) {
 void DrawAxialRatioSurface(Ant *antData) {
 
   int      increments;      /**  Number of incs       **/
-  int      az;              /**  Loop counter         **/
-  int      el;              /**  Loop counter         **/
-  int      latitude;        /**  Loop counter         **/
-  int      longitude;       /**  Loop counter         **/
-  int      i;               /**  Loop counter         **/
-  double   tx;              /**  Temporary x          **/
-  double   ty;              /**  Temporary y          **/
-  double   tz;              /**  Temporary z          **/
-  double   ttheta;          /**  Temporary angle      **/
-  double   tphi;            /**  Temporary angle      **/
-  double   tdist;           /**  Temp distance        **/
-  GLfloat  point_color[4];  /**  Color surface        **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
-
-  range= antData->fieldData->maxaxialratio - antData->fieldData->minaxialratio;
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = exp(antData->fieldData->vals[i].total_gain / 10.0) * 
-          POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        current_value = (antData->fieldData->vals[i].axial_ratio + 
-                        (-1 * antData->fieldData->minaxialratio)) / range;
-        ComputeColor(current_value, 
-                     antData->fieldData->minaxialratio,
-                     antData->fieldData->maxaxialratio,
-                     point_color);
-        antData->surfaceMesh[el][az].r = point_color[0];
-        antData->surfaceMesh[el][az].g = point_color[1];
-        antData->surfaceMesh[el][az].b = point_color[2];
-
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, true, MESH_AXIAL_RATIO);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_AXIAL_RATIO);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -920,129 +1040,20 @@ void DrawAxialRatioSurface(Ant *antData) {
 void DrawShowNullsSurface(Ant *antData) {
 
   int      increments;      /**  Number of incs       **/
-  int      az;              /**  Loop counter         **/
-  int      el;              /**  Loop counter         **/
-  int      latitude;        /**  Loop counter         **/
-  int      longitude;       /**  Loop counter         **/
-  int      i;               /**  Loop counter         **/
-  double   tx;              /**  Temporary x          **/
-  double   ty;              /**  Temporary y          **/
-  double   tz;              /**  Temporary z          **/
-  double   ttheta;          /**  Temporary angle      **/
-  double   tphi;            /**  Temporary angle      **/
-  double   tdist;           /**  Temp distance        **/
-  GLfloat  point_color[4];  /**  Color surface        **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
 
-  range = antData->fieldData->maxtilt - antData->fieldData->mintilt;
-
-
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = (exp(antData->fieldData->vals[i].total_gain / 10.0) * 
-          POINT_DIST_SCALE) + NULL_DISTANCE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        range = antData->fieldData->maxgain + (-1*antData->fieldData->mingain);
-        current_value = ((antData->fieldData->vals[i].total_gain + 
-                         (-1*antData->fieldData->mingain))
-                         / range);
-        if (current_value < NULL_THRESHOLD) {
-          antData->surfaceMesh[el][az].r = 1.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        } else {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        }  /**  Not a null  **/
-
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, NULL_DISTANCE, true, MESH_NULLS);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        if (point_color[0] == 1.0)
-          point_color[3] = ALPHA;
-        else
-          point_color[3] = 0.0;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        if (point_color[0] == 1.0)
-          point_color[3] = ALPHA;
-        else
-          point_color[3] = 0.0;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_NULLS);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -1062,17 +1073,6 @@ void DrawShowNullsSurface(Ant *antData) {
 void DrawRFPowerDensitySphere(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
   GLfloat  green_color[4];   /**  Color surface    **/
 
   green_color[0] = 0.1;
@@ -1080,72 +1080,20 @@ void DrawRFPowerDensitySphere(Ant *antData) {
   green_color[2] = 0.1;
   green_color[3] = ALPHA;
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = 1.0 * POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, false, MESH_PLAIN);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, green_color);
-      while (longitude <= increments/2) {
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, green_color);
+    DrawMeshStrips(antData, increments, MESH_PLAIN);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -1165,23 +1113,11 @@ void DrawRFPowerDensitySphere(Ant *antData) {
 void DrawPolarizationSenseSphere(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
   GLfloat  green_color[4];   /**  Color surface    **/
   GLfloat  red_color[4];     /**  Color surface    **/
   GLfloat  blue_color[4];    /**  Color surface    **/
   GLfloat  yellow_color[4];  /**  Color surface    **/
   GLfloat  white_color[4];   /**  Color surface    **/
-  GLfloat  point_color[4];   /**  Color surface    **/
 
   green_color[0] = 0.1;
   green_color[1] = 0.8;
@@ -1208,108 +1144,19 @@ void DrawPolarizationSenseSphere(Ant *antData) {
   white_color[2] = 1.0;
   white_color[3] = ALPHA;
 
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = 1.0 * POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        if (antData->fieldData->vals[i].sense == LINEAR) {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 1.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        }  /**  Linear  **/
-
-        if (antData->fieldData->vals[i].sense == RIGHT) {
-          antData->surfaceMesh[el][az].r = 1.0;
-          antData->surfaceMesh[el][az].g = 1.0;
-          antData->surfaceMesh[el][az].b = 1.0;
-        }  /**  Right  **/
-
-        if (antData->fieldData->vals[i].sense == LEFT) {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 1.0;
-        }  /**  Left  **/
-          
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, false, MESH_SENSE);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_SENSE);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -1329,112 +1176,20 @@ void DrawPolarizationSenseSphere(Ant *antData) {
 void DrawPolarizationTiltSphere(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
-  GLfloat  point_color[4];   /**  Color surface    **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
 
-  range = antData->fieldData->maxtilt - antData->fieldData->mintilt;
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = 1.0 * POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        current_value = (antData->fieldData->vals[i].tilt + 
-                        (-1 * antData->fieldData->mintilt)) / range;
-        antData->surfaceMesh[el][az].r = current_value;
-        antData->surfaceMesh[el][az].g = 1.0;
-        antData->surfaceMesh[el][az].b = current_value;
-          
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, false, MESH_TILT);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_TILT);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -1454,116 +1209,20 @@ void DrawPolarizationTiltSphere(Ant *antData) {
 void DrawAxialRatioSphere(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
-  GLfloat  point_color[4];   /**  Color surface    **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
 
-  range= antData->fieldData->maxaxialratio - antData->fieldData->minaxialratio;
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = 1.0 * POINT_DIST_SCALE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        current_value = (antData->fieldData->vals[i].axial_ratio + 
-                        (-1 * antData->fieldData->minaxialratio)) / range;
-        ComputeColor(current_value, 
-                     antData->fieldData->minaxialratio,
-                     antData->fieldData->maxaxialratio,
-                     point_color);
-        antData->surfaceMesh[el][az].r = point_color[0];
-        antData->surfaceMesh[el][az].g = point_color[1];
-        antData->surfaceMesh[el][az].b = point_color[2];
-          
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, 0.0, false, MESH_AXIAL_RATIO);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        point_color[3] = ALPHA;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_AXIAL_RATIO);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -1583,126 +1242,20 @@ void DrawAxialRatioSphere(Ant *antData) {
 void DrawShowNullsSphere(Ant *antData) {
 
   int      increments;       /**  Number of incs   **/
-  int      az;               /**  Loop counter     **/
-  int      el;               /**  Loop counter     **/
-  int      latitude;         /**  Loop counter     **/
-  int      longitude;        /**  Loop counter     **/
-  int      i;                /**  Loop counter     **/
-  double   tx;               /**  Temporary x      **/
-  double   ty;               /**  Temporary y      **/
-  double   tz;               /**  Temporary z      **/
-  double   ttheta;           /**  Temporary angle  **/
-  double   tphi;             /**  Temporary angle  **/
-  double   tdist;            /**  Temp distance    **/
-  GLfloat  point_color[4];   /**  Color surface    **/
-  double   range;           /**  Range of tilt        **/
-  double   current_value;   /**  Current color value  **/
 
-  range = antData->fieldData->maxtilt - antData->fieldData->mintilt;
-  if (antData->fieldData->count != 0) {
+  if ((increments = MeshIncrements(antData->fieldData)) > 0) {
   
     /**  Build data structure  **/
-    increments = 360 / curr_step_size;
-    i = 0;
-    for (el = 0; el < increments; el++) {
-      for (az = 0; az < increments; az++) {
-        ttheta = antData->fieldData->vals[i].theta * 2.0 * PI / 360.0;
-        tphi = antData->fieldData->vals[i].phi * 2.0 * PI / 360.0;
-        tdist = 1.0 * POINT_DIST_SCALE + NULL_DISTANCE;
-        ty = cos(ttheta) * cos(tphi) * tdist;
-        tx = sin(ttheta) * cos(tphi) * tdist;
-        tz = sin(tphi)               * tdist;
-        antData->surfaceMesh[el][az].posx = tx;
-        antData->surfaceMesh[el][az].posy = ty;
-        antData->surfaceMesh[el][az].posz = tz;
-
-        range = antData->fieldData->maxgain + (-1*antData->fieldData->mingain);
-        current_value = ((antData->fieldData->vals[i].total_gain + 
-                         (-1*antData->fieldData->mingain))
-                         / range);
-        if (current_value < NULL_THRESHOLD) {
-          antData->surfaceMesh[el][az].r = 1.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        } else {
-          antData->surfaceMesh[el][az].r = 0.0;
-          antData->surfaceMesh[el][az].g = 0.0;
-          antData->surfaceMesh[el][az].b = 0.0;
-        }  /**  Not a null  **/
-          
-        i++;
-      }  /**  By elevation  **/
-    }  /**  By azimuth  **/
-
-    for (el = 0; el < increments; el++) {
-      antData->surfaceMesh[el][increments].posx = 
-        antData->surfaceMesh[el][0].posx;
-      antData->surfaceMesh[el][increments].posy = 
-        antData->surfaceMesh[el][0].posy;
-      antData->surfaceMesh[el][increments].posz = 
-        antData->surfaceMesh[el][0].posz;
-      antData->surfaceMesh[el][increments].r = antData->surfaceMesh[el][0].r;
-      antData->surfaceMesh[el][increments].g = antData->surfaceMesh[el][0].g;
-      antData->surfaceMesh[el][increments].b = antData->surfaceMesh[el][0].b;
-    }  /**  Wrap around buffer  **/
-    for (az = 0; az < increments; az++) {
-      antData->surfaceMesh[increments][az].posx = 
-        antData->surfaceMesh[0][az].posx;
-      antData->surfaceMesh[increments][az].posy = 
-        antData->surfaceMesh[0][az].posy;
-      antData->surfaceMesh[increments][az].posz = 
-        antData->surfaceMesh[0][az].posz;
-      antData->surfaceMesh[increments][az].r = antData->surfaceMesh[0][az].r;
-      antData->surfaceMesh[increments][az].g = antData->surfaceMesh[0][az].g;
-      antData->surfaceMesh[increments][az].b = antData->surfaceMesh[0][az].b;
-    }  /**  Wrap around buffer  **/
+    BuildMesh(antData, increments, NULL_DISTANCE, false, MESH_NULLS);
 
     glPushMatrix();
     glEnable(GL_BLEND);
+    glEnable(GL_NORMALIZE);
 
     glShadeModel(GL_SMOOTH);
     glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    for (latitude=0; latitude < increments; latitude++) {
-      longitude = 0;
-      glBegin(GL_TRIANGLE_STRIP);
-      while (longitude <= increments/2) {
-
-        point_color[0] = antData->surfaceMesh[latitude][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude][longitude].b;
-        if (point_color[0] == 1.0)
-          point_color[3] = ALPHA;
-        else
-          point_color[3] = 0.0;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude][longitude].posx,
-                   antData->surfaceMesh[latitude][longitude].posy,
-                   antData->surfaceMesh[latitude][longitude].posz);
-
-        point_color[0] = antData->surfaceMesh[latitude+1][longitude].r;
-        point_color[1] = antData->surfaceMesh[latitude+1][longitude].g;
-        point_color[2] = antData->surfaceMesh[latitude+1][longitude].b;
-        if (point_color[0] == 1.0)
-          point_color[3] = ALPHA;
-        else
-          point_color[3] = 0.0;
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, point_color);
-
-        glNormal3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-        glVertex3f(antData->surfaceMesh[latitude+1][longitude].posx,
-                   antData->surfaceMesh[latitude+1][longitude].posy,
-                   antData->surfaceMesh[latitude+1][longitude].posz);
-
-        longitude++;
-      }  /**  For all latitudes control points  **/
-      glEnd();
-    }  /**  Triangle strips  **/
+    DrawMeshStrips(antData, increments, MESH_NULLS);
+    glDisable(GL_NORMALIZE);
     glDisable(GL_BLEND);
     glPopMatrix();
   }  /**  Not empty  **/
@@ -78,6 +78,8 @@ void    DrawPolarizationTiltSphere(Ant *);
 void    DrawAxialRatioSphere(Ant *);
 void    DrawShowNullsSphere(Ant *);
 
+void    BuildPatternMesh(Ant *, bool);
+
 
 #endif
 
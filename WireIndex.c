@@ -0,0 +1,917 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  A bounding volume hierarchy over the tubes of every antenna in
+ *  TheAnts, for the questions that would otherwise walk each Tube list:
+ *  which wire a click lands on, which wire is nearest a point, and which
+ *  wires a wire runs into.
+ *
+ *  Each antenna has a tree of its own, split at the median of the wires'
+ *  centres along the longest side of their bounds, one wire to a leaf;
+ *  a query walks the trees of the antennas it asks about, so it visits
+ *  the boxes along one path or a few rather than every wire.  Positions
+ *  are the deck's, tube units plus the antenna's offset, as
+ *  WriteMultAntsFile writes them.
+ *
+ *  Adding or removing tubes calls WI_Invalidate and the trees are built
+ *  again by the next query.  Moving or resizing a tube calls WI_Refit,
+ *  which refits the boxes from its leaf up to the root, and moving an
+ *  antenna calls WI_RefitAnt, which refits that antenna's tree.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include "MyTypes.h"
+#include "ant.h"
+#include "WireIndex.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  TINY      1.0e-12   /**  Squared length of a point            **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct Node {
+  double  lo[3];    /**  Box, the radius around its wires  **/
+  double  hi[3];
+  int     left;     /**  Children, -1 at a leaf            **/
+  int     right;
+  int     parent;   /**  -1 at an antenna's root           **/
+  int     wire;     /**  A leaf's wire, -1 inside          **/
+  double  radius;   /**  Thickest wire under it            **/
+} Node;
+
+typedef struct Wire {
+  Tube   *tube;     /**  As in its antenna's list          **/
+  int     ant;      /**  Antenna in TheAnts                **/
+  int     index;    /**  Place in the list, from 1         **/
+  int     leaf;     /**  Its node                          **/
+  double  a[3];     /**  Ends, or a wall's corners         **/
+  double  b[3];
+  double  radius;   /**  0 for a wall                      **/
+} Wire;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           Global Variables                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+extern AntArray  TheAnts;   /**  The antennas' geometries  **/
+
+local Node  *Nodes = NULL;              /**  Every antenna's tree      **/
+local Wire  *Wires = NULL;              /**  Their leaves' wires       **/
+local int   *Order = NULL;              /**  Wires as they are split   **/
+local int    Room = 0;                  /**  Wires there is room for   **/
+local int    WireCount = 0;             /**  Wires indexed             **/
+local int    NodeCount = 0;             /**  Nodes built               **/
+local int    Antennas = 0;              /**  Antennas indexed          **/
+local int    Roots[MAX_ANTENNAS];       /**  Each tree, -1 if none     **/
+local int    FirstWire[MAX_ANTENNAS];   /**  Each antenna's wires      **/
+local int    FirstNode[MAX_ANTENNAS];   /**    ..and nodes             **/
+local int    EndNode[MAX_ANTENNAS];
+local bool   Valid = false;             /**  Trees match the tubes     **/
+local int    SortAxis;                  /**  For CompareCentre         **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SetWire                                  **/
+/**                                                                         **/
+/**  Takes a wire's ends from its tube and its antenna's offset.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SetWire(Wire *w) {
+
+  const Ant  *ant = &TheAnts.ants[w->ant];  /**  Its antenna  **/
+
+  w->a[0] = w->tube->e1.x + ant->dx;
+  w->a[1] = w->tube->e1.y + ant->dy;
+  w->a[2] = w->tube->e1.z + ant->dz;
+  w->b[0] = w->tube->e2.x + ant->dx;
+  w->b[1] = w->tube->e2.y + ant->dy;
+  w->b[2] = w->tube->e2.z + ant->dz;
+  w->radius = (w->tube->type == IS_TUBE) ? w->tube->width : 0.0;
+
+}  /**  End of SetWire  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Fit                                    **/
+/**                                                                         **/
+/**  A leaf's box around its wire, another's around its children's.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Fit(int n) {
+
+  Node        *node = &Nodes[n];  /**  The node      **/
+  const Wire  *w;                 /**  A leaf's      **/
+  int          i;                 /**  Loop counter  **/
+
+  if (node->wire >= 0) {
+    w = &Wires[node->wire];
+    node->radius = w->radius;
+    for (i = 0; i < 3; i++) {
+      node->lo[i] = fmin(w->a[i], w->b[i]) - w->radius;
+      node->hi[i] = fmax(w->a[i], w->b[i]) + w->radius;
+    }  /**  Each axis  **/
+  } else {
+    node->radius = fmax(Nodes[node->left].radius, Nodes[node->right].radius);
+    for (i = 0; i < 3; i++) {
+      node->lo[i] = fmin(Nodes[node->left].lo[i], Nodes[node->right].lo[i]);
+      node->hi[i] = fmax(Nodes[node->left].hi[i], Nodes[node->right].hi[i]);
+    }  /**  Each axis  **/
+  }  /**  Leaf or not  **/
+
+}  /**  End of Fit  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              CompareCentre                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int CompareCentre(const void *p, const void *q) {
+
+  const Wire  *a = &Wires[*(const int *) p];  /**  First   **/
+  const Wire  *b = &Wires[*(const int *) q];  /**  Second  **/
+  double       u;                             /**  Their   **/
+  double       v;                             /**   ..centres, twice  **/
+
+  u = a->a[SortAxis] + a->b[SortAxis];
+  v = b->a[SortAxis] + b->b[SortAxis];
+  return (u < v) ? -1 : (u > v) ? 1 : 0;
+
+}  /**  End of CompareCentre  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Split                                   **/
+/**                                                                         **/
+/**  Builds the tree over count wires of Order from first, returning its    **/
+/**  root.  Children always come after their parent in Nodes.               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Split(int first, int count, int parent) {
+
+  Node   *node;     /**  This one                **/
+  double  lo[3];    /**  Bounds of the centres   **/
+  double  hi[3];
+  double  c;        /**  A centre, twice         **/
+  int     n;        /**  This one's index        **/
+  int     i;        /**  Loop counter            **/
+  int     k;        /**  Loop counter            **/
+
+  n = NodeCount++;
+  node = &Nodes[n];
+  node->parent = parent;
+  if (count == 1) {
+    node->left = node->right = -1;
+    node->wire = Order[first];
+    Wires[node->wire].leaf = n;
+    Fit(n);
+    return n;
+  }  /**  Leaf  **/
+
+  for (i = 0; i < 3; i++) {
+    lo[i] = DBL_MAX;
+    hi[i] = -DBL_MAX;
+    for (k = first; k < first + count; k++) {
+      c = Wires[Order[k]].a[i] + Wires[Order[k]].b[i];
+      lo[i] = fmin(lo[i], c);
+      hi[i] = fmax(hi[i], c);
+    }  /**  Each wire  **/
+  }  /**  Each axis  **/
+  SortAxis = 0;
+  for (i = 1; i < 3; i++)
+    if (hi[i] - lo[i] > hi[SortAxis] - lo[SortAxis])
+      SortAxis = i;
+  qsort(Order + first, count, sizeof(int), CompareCentre);
+
+  node->wire = -1;
+  node->left = Split(first, count / 2, n);
+  node->right = Split(first + count / 2, count - count / 2, n);
+  Fit(n);
+  return n;
+
+}  /**  End of Split  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Build                                   **/
+/**                                                                         **/
+/**  Indexes every tube of every antenna.  False if there was no memory.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool Build(void) {
+
+  Tube  *tube;   /**  Current tube      **/
+  Wire  *w;      /**  Its wire          **/
+  Node  *nodes;  /**  Grown arrays      **/
+  Wire  *wires;
+  int   *order;
+  int    total;  /**  Tubes in all      **/
+  int    n;      /**  Place in the list **/
+  int    k;      /**  Loop counter      **/
+
+  Antennas = TheAnts.ant_count;
+  for (k = 0, total = 0; k < Antennas; k++)
+    for (tube = TheAnts.ants[k].first_tube; tube != NULL; tube = tube->next)
+      total++;
+  if (total > Room) {
+    nodes = (Node *) realloc(Nodes, 2 * total * sizeof(Node));
+    if (nodes != NULL)
+      Nodes = nodes;
+    wires = (Wire *) realloc(Wires, total * sizeof(Wire));
+    if (wires != NULL)
+      Wires = wires;
+    order = (int *) realloc(Order, total * sizeof(int));
+    if (order != NULL)
+      Order = order;
+    if (nodes == NULL || wires == NULL || order == NULL)
+      return false;
+    Room = total;
+  }  /**  More tubes than before  **/
+
+  WireCount = 0;
+  NodeCount = 0;
+  for (k = 0; k < Antennas; k++) {
+    FirstWire[k] = WireCount;
+    FirstNode[k] = NodeCount;
+    for (tube = TheAnts.ants[k].first_tube, n = 1; tube != NULL; 
+         tube = tube->next, n++) {
+      w = &Wires[WireCount];
+      w->tube = tube;
+      w->ant = k;
+      w->index = n;
+      SetWire(w);
+      tube->index = WireCount;
+      Order[WireCount] = WireCount;
+      WireCount++;
+    }  /**  For each tube  **/
+    Roots[k] = (WireCount > FirstWire[k]) ? 
+               Split(FirstWire[k], WireCount - FirstWire[k], -1) : -1;
+    EndNode[k] = NodeCount;
+  }  /**  For each antenna  **/
+
+  Valid = true;
+  return true;
+
+}  /**  End of Build  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 Find                                    **/
+/**                                                                         **/
+/**  A tube's wire, -1 if the trees do not hold it.                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int Find(const Tube *tube) {
+
+  if (tube == NULL || tube->index < 0 || tube->index >= WireCount ||
+      Wires[tube->index].tube != tube)
+    return -1;
+  return tube->index;
+
+}  /**  End of Find  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WI_Segments                               **/
+/**                                                                         **/
+/**  Distance between segments p0 p1 and q0 q1, with where along each       **/
+/**  (0 to 1) the closest points are.  Either may be a point.  Parallel     **/
+/**  segments set *parallel, if it is given, and take p0's closest point.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double WI_Segments(const double *p0, const double *p1, const double *q0,
+                   const double *q1, double *s, double *t, bool *parallel) {
+
+  double  d1[3];  /**  Along p         **/
+  double  d2[3];  /**  Along q         **/
+  double  r[3];   /**  q0 to p0        **/
+  double  a;      /**  d1.d1           **/
+  double  b;      /**  d1.d2           **/
+  double  c;      /**  d1.r            **/
+  double  e;      /**  d2.d2           **/
+  double  f;      /**  d2.r            **/
+  double  den;    /**  ae - bb         **/
+  double  g;      /**  Gap component   **/
+  double  sum;    /**  Squared gap     **/
+  int     i;      /**  Loop counter    **/
+
+  for (i = 0; i < 3; i++) {
+    d1[i] = p1[i] - p0[i];
+    d2[i] = q1[i] - q0[i];
+    r[i] = p0[i] - q0[i];
+  }  /**  Each axis  **/
+  a = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+  b = d1[0] * d2[0] + d1[1] * d2[1] + d1[2] * d2[2];
+  c = d1[0] * r[0] + d1[1] * r[1] + d1[2] * r[2];
+  e = d2[0] * d2[0] + d2[1] * d2[1] + d2[2] * d2[2];
+  f = d2[0] * r[0] + d2[1] * r[1] + d2[2] * r[2];
+  den = a * e - b * b;
+  if (parallel != NULL)
+    *parallel = (a > TINY && e > TINY && den <= TINY * a * e);
+
+  if (a <= TINY && e <= TINY) {
+    *s = *t = 0.0;
+  } else if (a <= TINY) {
+    *s = 0.0;
+    *t = fmin(1.0, fmax(0.0, f / e));
+  } else if (e <= TINY) {
+    *t = 0.0;
+    *s = fmin(1.0, fmax(0.0, -c / a));
+  } else {
+    *s = (den > TINY * a * e) ? 
+         fmin(1.0, fmax(0.0, (b * f - c * e) / den)) : 0.0;
+    *t = (b * *s + f) / e;
+    if (*t < 0.0) {
+      *t = 0.0;
+      *s = fmin(1.0, fmax(0.0, -c / a));
+    } else if (*t > 1.0) {
+      *t = 1.0;
+      *s = fmin(1.0, fmax(0.0, (b - c) / a));
+    }  /**  Clamped to q  **/
+  }  /**  Points or segments  **/
+
+  sum = 0.0;
+  for (i = 0; i < 3; i++) {
+    g = (p0[i] + *s * d1[i]) - (q0[i] + *t * d2[i]);
+    sum += g * g;
+  }  /**  Each axis  **/
+  return sqrt(sum);
+
+}  /**  End of WI_Segments  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 RayBox                                  **/
+/**                                                                         **/
+/**  Whether from + u dir, u from 0 to 1, enters the node's box grown by    **/
+/**  slack, and at what u it does.                                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool RayBox(const Node *node, const double *from, const double *dir,
+                  double slack, double *enter) {
+
+  double  u0 = 0.0;  /**  Inside from  **/
+  double  u1 = 1.0;  /**    ..to       **/
+  double  u;         /**  Slab planes  **/
+  double  v;
+  int     i;         /**  Loop counter **/
+
+  for (i = 0; i < 3; i++) {
+    if (dir[i] == 0.0) {
+      if (from[i] < node->lo[i] - slack || from[i] > node->hi[i] + slack)
+        return false;
+      continue;
+    }  /**  Parallel to the slab  **/
+    u = (node->lo[i] - slack - from[i]) / dir[i];
+    v = (node->hi[i] + slack - from[i]) / dir[i];
+    u0 = fmax(u0, fmin(u, v));
+    u1 = fmin(u1, fmax(u, v));
+    if (u0 > u1)
+      return false;
+  }  /**  Each axis  **/
+  *enter = u0;
+  return true;
+
+}  /**  End of RayBox  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               BoxDistance                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double BoxDistance(const Node *node, const double *p) {
+
+  double  g;    /**  Outside by     **/
+  double  sum;  /**  Squared        **/
+  int     i;    /**  Loop counter   **/
+
+  for (i = 0, sum = 0.0; i < 3; i++) {
+    g = fmax(0.0, fmax(node->lo[i] - p[i], p[i] - node->hi[i]));
+    sum += g * g;
+  }  /**  Each axis  **/
+  return sqrt(sum);
+
+}  /**  End of BoxDistance  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                SegmentLength                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local double SegmentLength(const double *a, const double *b, int segments) {
+
+  return sqrt((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]) +
+              (b[2] - a[2]) * (b[2] - a[2])) / ((segments > 0) ? segments : 1);
+
+}  /**  End of SegmentLength  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                AtSegmentEnd                             **/
+/**                                                                         **/
+/**  Whether u along a wire of segments (0 to 1) is within tol of one of    **/
+/**  its segment ends.                                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool AtSegmentEnd(const double *a, const double *b, int segments,
+                        double u, double tol) {
+
+  double  k;  /**  Segments from the start  **/
+
+  k = u * ((segments > 0) ? segments : 1);
+  return fabs(k - floor(k + 0.5)) * SegmentLength(a, b, segments) <= tol;
+
+}  /**  End of AtSegmentEnd  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            WI_JoinTolerance                             **/
+/**                                                                         **/
+/**  How near ends of wires p and q must come to meet: WI_JOIN of the       **/
+/**  shorter of their segments.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double WI_JoinTolerance(const double *p0, const double *p1, int np,
+                        const double *q0, const double *q1, int nq) {
+
+  return WI_JOIN * fmin(SegmentLength(p0, p1, np), SegmentLength(q0, q1, nq));
+
+}  /**  End of WI_JoinTolerance  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WI_Joined                                **/
+/**                                                                         **/
+/**  Whether wires p and q, of np and nq segments and gap apart at u along  **/
+/**  p and v along q, meet where both have a segment end, as NEC joins      **/
+/**  wires.  DC_Check and WI_Touching both take this as wires meeting.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool WI_Joined(const double *p0, const double *p1, int np, double u,
+               const double *q0, const double *q1, int nq, double v,
+               double gap) {
+
+  double  tol;  /**  Ends meet within  **/
+
+  tol = WI_JoinTolerance(p0, p1, np, q0, q1, nq);
+  return (gap <= tol && AtSegmentEnd(p0, p1, np, u, tol) &&
+          AtSegmentEnd(q0, q1, nq, v, tol));
+
+}  /**  End of WI_Joined  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                  Take                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void Take(WI_Hit *hit, const Wire *w, double t, double distance) {
+
+  hit->tube = w->tube;
+  hit->ant = w->ant;
+  hit->index = w->index;
+  hit->t = t;
+  hit->distance = distance;
+
+}  /**  End of Take  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              WI_Invalidate                              **/
+/**                                                                         **/
+/**  Tubes were added or removed: the next query builds the trees again.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WI_Invalidate(void) {
+
+  Valid = false;
+
+}  /**  End of WI_Invalidate  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WI_Refit                                 **/
+/**                                                                         **/
+/**  A tube moved or changed size: refits the boxes from its leaf up.       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WI_Refit(const Tube *tube) {
+
+  int  w;  /**  Its wire   **/
+  int  n;  /**  Its nodes  **/
+
+  if (Valid == false)
+    return;
+  if ((w = Find(tube)) < 0) {
+    Valid = false;
+    return;
+  }  /**  Not one we know  **/
+  SetWire(&Wires[w]);
+  for (n = Wires[w].leaf; n >= 0; n = Nodes[n].parent)
+    Fit(n);
+
+}  /**  End of WI_Refit  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WI_RefitAnt                               **/
+/**                                                                         **/
+/**  An antenna moved: refits its whole tree, children before parents.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WI_RefitAnt(int ant) {
+
+  int  w;  /**  Loop counter  **/
+  int  n;  /**  Loop counter  **/
+
+  if (Valid == false || ant < 0)
+    return;
+  if (ant >= Antennas) {
+    Valid = false;
+    return;
+  }  /**  Not one we know  **/
+  for (w = FirstWire[ant]; w < WireCount && Wires[w].ant == ant; w++)
+    SetWire(&Wires[w]);
+  for (n = EndNode[ant] - 1; n >= FirstNode[ant]; n--)
+    Fit(n);
+
+}  /**  End of WI_RefitAnt  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WI_Bounds                                **/
+/**                                                                         **/
+/**  The box around an antenna's wires.  False if it has none.              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool WI_Bounds(int ant, double *lo, double *hi) {
+
+  int  i;  /**  Loop counter  **/
+
+  if ((Valid == false && Build() == false) || ant < 0 || ant >= Antennas ||
+      Roots[ant] < 0)
+    return false;
+  for (i = 0; i < 3; i++) {
+    lo[i] = Nodes[Roots[ant]].lo[i];
+    hi[i] = Nodes[Roots[ant]].hi[i];
+  }  /**  Each axis  **/
+  return true;
+
+}  /**  End of WI_Bounds  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 WI_Pick                                 **/
+/**                                                                         **/
+/**  The wire of antenna ant (-1 for any) that the segment from to first    **/
+/**  comes within slack of, its radius taken widen times as it is drawn;    **/
+/**  walls are hit by their boxes.  hit->t is how far along, to compare     **/
+/**  picks in different frames.                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool WI_Pick(int ant, const double *from, const double *to, double widen,
+             double slack, WI_Hit *hit) {
+
+  const Wire  *w;                /**  A leaf's wire      **/
+  int          stack[WI_DEPTH];  /**  Nodes to visit     **/
+  int          top;              /**  How many           **/
+  double       dir[3];           /**  from to to         **/
+  double       enter;            /**  Along it           **/
+  double       gap;              /**  To a wire's axis   **/
+  double       t;                /**  Along the wire     **/
+  bool         found;            /**  Anything hit       **/
+  int          n;                /**  Current node       **/
+  int          k;                /**  Loop counter       **/
+  int          i;                /**  Loop counter       **/
+
+  if (Valid == false && Build() == false)
+    return false;
+  for (i = 0; i < 3; i++)
+    dir[i] = to[i] - from[i];
+  found = false;
+  hit->t = DBL_MAX;
+
+  for (k = (ant < 0) ? 0 : ant; k < ((ant < 0) ? Antennas : ant + 1) &&
+       k < Antennas; k++) {
+    if (Roots[k] < 0)
+      continue;
+    stack[0] = Roots[k];
+    top = 1;
+    while (top > 0) {
+      n = stack[--top];
+      if (!RayBox(&Nodes[n], from, dir, 
+                  slack + fmax(0.0, widen - 1.0) * Nodes[n].radius, &enter) ||
+          enter >= hit->t)
+        continue;
+      if (Nodes[n].wire < 0) {
+        stack[top++] = Nodes[n].left;
+        stack[top++] = Nodes[n].right;
+        continue;
+      }  /**  Inside  **/
+      w = &Wires[Nodes[n].wire];
+      gap = 0.0;
+      if (w->tube->type == IS_TUBE) {
+        gap = WI_Segments(from, to, w->a, w->b, &enter, &t, NULL);
+        if (gap > widen * w->radius + slack || enter >= hit->t)
+          continue;
+      }  /**  Walls are their boxes  **/
+      Take(hit, w, enter, gap);
+      found = true;
+    }  /**  Walk the tree  **/
+  }  /**  For each antenna  **/
+
+  return found;
+
+}  /**  End of WI_Pick  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WI_Nearest                                **/
+/**                                                                         **/
+/**  The wire of antenna ant (-1 for any) whose surface is nearest p;       **/
+/**  walls are left out.  False if there are no wires.                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool WI_Nearest(int ant, const double *p, WI_Hit *hit) {
+
+  const Wire  *w;                /**  A leaf's wire      **/
+  int          stack[WI_DEPTH];  /**  Nodes to visit     **/
+  int          top;              /**  How many           **/
+  double       best;             /**  Nearest so far     **/
+  double       d;                /**  A distance         **/
+  double       s;                /**  Unused, along p    **/
+  double       t;                /**  Along the wire     **/
+  int          n;                /**  Current node       **/
+  int          l;                /**  Its children       **/
+  int          r;
+  int          k;                /**  Loop counter       **/
+
+  if (Valid == false && Build() == false)
+    return false;
+  best = DBL_MAX;
+
+  for (k = (ant < 0) ? 0 : ant; k < ((ant < 0) ? Antennas : ant + 1) &&
+       k < Antennas; k++) {
+    if (Roots[k] < 0)
+      continue;
+    stack[0] = Roots[k];
+    top = 1;
+    while (top > 0) {
+      n = stack[--top];
+      if (BoxDistance(&Nodes[n], p) >= best)
+        continue;
+      if (Nodes[n].wire < 0) {
+        l = Nodes[n].left;
+        r = Nodes[n].right;
+        if (BoxDistance(&Nodes[l], p) < BoxDistance(&Nodes[r], p)) {
+          stack[top++] = r;
+          stack[top++] = l;
+        } else {
+          stack[top++] = l;
+          stack[top++] = r;
+        }  /**  Nearer child first  **/
+        continue;
+      }  /**  Inside  **/
+      w = &Wires[Nodes[n].wire];
+      if (w->tube->type != IS_TUBE)
+        continue;
+      d = fmax(0.0, WI_Segments(p, p, w->a, w->b, &s, &t, NULL) - w->radius);
+      if (d < best) {
+        best = d;
+        Take(hit, w, t, d);
+      }  /**  Nearer  **/
+    }  /**  Walk the tree  **/
+  }  /**  For each antenna  **/
+
+  return (best < DBL_MAX);
+
+}  /**  End of WI_Nearest  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WI_Touching                               **/
+/**                                                                         **/
+/**  Wires of any antenna that come within the radii of tube other than     **/
+/**  where segment ends meet.  Up to max go in hits, with t along tube;     **/
+/**  returns how many there are.                                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int WI_Touching(const Tube *tube, WI_Hit *hits, int max) {
+
+  const Wire  *p;                /**  The tube's wire    **/
+  const Wire  *w;                /**  A leaf's wire      **/
+  const Node  *box;              /**  Its leaf           **/
+  int          stack[WI_DEPTH];  /**  Nodes to visit     **/
+  int          top;              /**  How many           **/
+  int          found;            /**  Wires touching     **/
+  double       gap;              /**  Between axes       **/
+  double       s;                /**  Along p            **/
+  double       t;                /**  Along w            **/
+  int          self;             /**  p's index          **/
+  int          n;                /**  Current node       **/
+  int          k;                /**  Loop counter       **/
+  int          i;                /**  Loop counter       **/
+
+  if ((Valid == false && Build() == false) || (self = Find(tube)) < 0 ||
+      tube->type != IS_TUBE)
+    return 0;
+  p = &Wires[self];
+  box = &Nodes[p->leaf];
+  found = 0;
+
+  for (k = 0; k < Antennas; k++) {
+    if (Roots[k] < 0)
+      continue;
+    stack[0] = Roots[k];
+    top = 1;
+    while (top > 0) {
+      n = stack[--top];
+      for (i = 0; i < 3; i++)
+        if (Nodes[n].lo[i] > box->hi[i] || box->lo[i] > Nodes[n].hi[i])
+          break;
+      if (i < 3)
+        continue;
+      if (Nodes[n].wire < 0) {
+        stack[top++] = Nodes[n].left;
+        stack[top++] = Nodes[n].right;
+        continue;
+      }  /**  Inside  **/
+      w = &Wires[Nodes[n].wire];
+      if (w == p || w->tube->type != IS_TUBE)
+        continue;
+      gap = WI_Segments(p->a, p->b, w->a, w->b, &s, &t, NULL);
+      if (gap >= p->radius + w->radius ||
+          WI_Joined(p->a, p->b, p->tube->segments, s, w->a, w->b,
+                    w->tube->segments, t, gap))
+        continue;
+      if (found < max)
+        Take(&hits[found], w, s, gap);
+      found++;
+    }  /**  Walk the tree  **/
+  }  /**  For each antenna  **/
+
+  return found;
+
+}  /**  End of WI_Touching  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of WireIndex.c                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef WIREINDEX_H
+#define WIREINDEX_H
+
+#include "MyTypes.h"
+#include "ant.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  WI_PICK_PIXELS  4   /**  Clicks this near a wire pick it       **/
+#define  WI_DEPTH       64   /**  Deepest tree walked, 2^64 wires       **/
+#define  WI_JOIN    1.0e-3   /**  Of a segment, ends this near meet     **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               Typedefs                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+typedef struct WI_Hit {
+  Tube    *tube;      /**  The wire found                       **/
+  int      ant;       /**  Its antenna in TheAnts               **/
+  int      index;     /**  Its place in the antenna, from 1     **/
+  double   t;         /**  Along a pick, 0 near to 1 far        **/
+  double   distance;  /**  From a nearest query, deck units/100 **/
+} WI_Hit;
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                         Function Prototypes                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void  WI_Invalidate(void);
+void  WI_Refit(const Tube *);
+void  WI_RefitAnt(int);
+bool  WI_Bounds(int, double *, double *);
+bool  WI_Pick(int, const double *, const double *, double, double, 
+              WI_Hit *);
+bool  WI_Nearest(int, const double *, WI_Hit *);
+int   WI_Touching(const Tube *, WI_Hit *, int);
+double  WI_Segments(const double *, const double *, const double *,
+                    const double *, double *, double *, bool *);
+double  WI_JoinTolerance(const double *, const double *, int, const double *,
+                         const double *, int);
+bool  WI_Joined(const double *, const double *, int, double, const double *,
+                const double *, int, double, double);
+
+#endif
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            End of WireIndex.h                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,298 @@
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**  Antenna Visualization Toolkit                                          **/
+/**                                                                         **/
+/**  Copyright (C) 1998 Adrian Agogino, Ken Harker                          **/
+/**  Copyright (C) 2005 Joop Stakenborg                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ *  A small pool of worker threads for splitting per-sample work over the
+ *  rows of a pattern grid.  WP_Run hands out bands of consecutive rows to
+ *  the workers and to the calling thread until all rows are done, and
+ *  returns once every band has finished.  Callers write their results to
+ *  disjoint rows of a shared buffer, so no locking is needed on the data
+ *  itself.  Nothing here touches Tcl or OpenGL; those stay on the GUI
+ *  thread.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "MyTypes.h"
+#include "WorkPool.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  BANDS_PER_THREAD  4   /**  Keeps uneven rows from idling threads  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            Global Variables                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local pthread_t        Workers[WP_MAX_THREADS];  /**  Worker threads     **/
+local int              WorkerCount = -1;         /**  -1 until WP_Init   **/
+local pthread_mutex_t  Lock = PTHREAD_MUTEX_INITIALIZER;
+local pthread_cond_t   WorkReady = PTHREAD_COND_INITIALIZER;
+local pthread_cond_t   WorkDone = PTHREAD_COND_INITIALIZER;
+local unsigned long    Generation = 0;           /**  Bumped per WP_Run  **/
+local bool             Quit = false;             /**  Set by WP_Shutdown **/
+local WP_BandFunc      JobFunc;                  /**  Current job        **/
+local void            *JobArg;                   /**    ..its argument   **/
+local int              JobRows;                  /**    ..rows in total  **/
+local int              JobBand;                  /**    ..rows per band  **/
+local int              NextRow;                  /**  First row not run  **/
+local int              Busy;                     /**  Bands in progress  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               TakeBand                                  **/
+/**                                                                         **/
+/**  Claims the next band of the current job.  Called with Lock held.       **/
+/**  Returns false when no rows are left.                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool TakeBand(int *first, int *last) {
+
+  if (NextRow >= JobRows)
+    return false;
+  *first = NextRow;
+  *last = NextRow + JobBand;
+  if (*last > JobRows)
+    *last = JobRows;
+  NextRow = *last;
+  Busy++;
+  return true;
+
+}  /**  End of TakeBand  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               RunBands                                  **/
+/**                                                                         **/
+/**  Works through bands of the current job until none are left.  Called    **/
+/**  with Lock held and returns with it held.                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void RunBands(void) {
+
+  int  first;  /**  First row of the band      **/
+  int  last;   /**  One past the band's end    **/
+
+  while (TakeBand(&first, &last)) {
+    pthread_mutex_unlock(&Lock);
+    JobFunc(JobArg, first, last);
+    pthread_mutex_lock(&Lock);
+    if (--Busy == 0 && NextRow >= JobRows)
+      pthread_cond_broadcast(&WorkDone);
+  }  /**  For each band  **/
+
+}  /**  End of RunBands  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                Worker                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void *Worker(void *unused) {
+
+  unsigned long  seen;  /**  Last generation worked on  **/
+
+  pthread_mutex_lock(&Lock);
+  seen = Generation;
+  while (!Quit) {
+    while (!Quit && seen == Generation)
+      pthread_cond_wait(&WorkReady, &Lock);
+    if (Quit)
+      break;
+    seen = Generation;
+    RunBands();
+  }  /**  Until shut down  **/
+  pthread_mutex_unlock(&Lock);
+  return NULL;
+
+}  /**  End of Worker  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WP_Init                                  **/
+/**                                                                         **/
+/**  Starts the pool.  threads is the total number of threads working on   **/
+/**  a job, the caller included; 0 means one per online CPU.  A value of    **/
+/**  1 runs everything inline on the caller.  Called automatically by the   **/
+/**  first WP_Run if the program did not.                                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WP_Init(int threads) {
+
+  int  i;  /**  Loop counter  **/
+
+  if (WorkerCount >= 0)
+    return;
+  if (threads <= 0)
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1)
+    threads = 1;
+  if (threads > WP_MAX_THREADS)
+    threads = WP_MAX_THREADS;
+
+  Quit = false;
+  WorkerCount = 0;
+  for (i = 0; i < threads - 1; i++) {
+    if (pthread_create(&Workers[i], NULL, Worker, NULL) != 0) {
+      fprintf(stderr, "Could not start worker thread, using %d\n", i + 1);
+      break;
+    }  /**  Error  **/
+    WorkerCount++;
+  }  /**  For each worker  **/
+
+}  /**  End of WP_Init  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WP_Threads                                **/
+/**                                                                         **/
+/**  Number of threads a job is split over, the caller included.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int WP_Threads(void) {
+
+  WP_Init(0);
+  return WorkerCount + 1;
+
+}  /**  End of WP_Threads  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                 WP_Run                                  **/
+/**                                                                         **/
+/**  Calls func(arg, first, last) over bands of rows covering 0 to rows-1,  **/
+/**  spread over the pool, and waits for all of them.  Small jobs run       **/
+/**  inline since waking the workers would cost more than it saves.  Only   **/
+/**  one job runs at a time; WP_Run must not be called from a band.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WP_Run(WP_BandFunc func, void *arg, int rows) {
+
+  WP_Init(0);
+  if (WorkerCount == 0 || rows < WP_MIN_ROWS) {
+    func(arg, 0, rows);
+    return;
+  }  /**  Not worth splitting  **/
+
+  pthread_mutex_lock(&Lock);
+  JobFunc = func;
+  JobArg = arg;
+  JobRows = rows;
+  JobBand = rows / ((WorkerCount + 1) * BANDS_PER_THREAD);
+  if (JobBand < 1)
+    JobBand = 1;
+  NextRow = 0;
+  Busy = 0;
+  Generation++;
+  pthread_cond_broadcast(&WorkReady);
+
+  RunBands();
+  while (Busy > 0)
+    pthread_cond_wait(&WorkDone, &Lock);
+  pthread_mutex_unlock(&Lock);
+
+}  /**  End of WP_Run  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              WP_Shutdown                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void WP_Shutdown(void) {
+
+  int  i;  /**  Loop counter  **/
+
+  if (WorkerCount < 0)
+    return;
+  pthread_mutex_lock(&Lock);
+  Quit = true;
+  pthread_cond_broadcast(&WorkReady);
+  pthread_mutex_unlock(&Lock);
+  for (i = 0; i < WorkerCount; i++)
+    pthread_join(Workers[i], NULL);
+  WorkerCount = -1;
+
+}  /**  End of WP_Shutdown  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           End of WorkPool.c                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -29,6 +29,7 @@
 #include <stddef.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -41,6 +42,31 @@
 #include "pcard.h"
 #include "VisField.h"
 #include "VisWires.h"
+#include "Timing.h"
+#include "Fixture.h"
+#include "SolverPool.h"
+#include "PatFile.h"
+#include "FieldAnalysis.h"
+#include "FarField.h"
+#include "Ports.h"
+#include "WorkPool.h"
+#include "Clusters.h"
+#include "Symmetry.h"
+#include "DeckCheck.h"
+#include "WireIndex.h"
+#include "Convergence.h"
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             Definitions                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+#define  MAX_DECKS  64   /**  Decks solved together, at most  **/
 
 
 /*****************************************************************************/
@@ -59,8 +85,11 @@ double    STEP_SIZE;                  /**  Degrees between control points   **/
 double    NULL_THRESHOLD;             /**  As a percentage of max dBi       **/
 double    NULL_DISTANCE;              /**  So null maps float above         **/
 double    ALPHA;                      /**  Alpha transparency factor        **/
+double    LOD_PIXEL_ERROR;            /**  Mesh detail error, in pixels     **/
 double    TUBE_WIDTH_SCALE=2;         /**  Tube width scale                 **/
 double    curr_step_size;             /**  Updated when the NEC called      **/
+double    ClusterSpacing = 0.0;       /**  Wavelengths, 0 solves as one     **/
+double    SolverMemory = 0.0;         /**  GB for nec2 runs, 0 no limit     **/
 int       WireDrawMode;               /**  Mode to draw the wires in        **/
 int       MultipleAntMode;            /**  Current antenna or all in phase  **/
 int       ShowRadPat;                 /**  Show radiation pattern?          **/
@@ -69,6 +98,8 @@ int       ShowPolTilt;                /**  Show polarization tilt?          **/
 int       ShowAxialRatio;             /**  Show axial ratios?               **/
 int       ShowNulls;                  /**  Show nulls in pattern?           **/
 int       DrawMode = 0;               /**  Mode to draw output in           **/
+int       UseSymmetry = 1;            /**  Write GX and GR cards to nec2?   **/
+int       CheckDecks = 1;             /**  Refuse decks DC_Check faults?    **/
 int       FreqSteps;                  /**  Frequency steps                  **/
 AntArray  TheAnts;                    /**  The antennas' geometries         **/
 bool      FieldDataComputed = false;  /**  Do we need to compute field?     **/
@@ -76,6 +107,14 @@ bool      RFPowerDensityOn = false;   /**  Draw RF Power Density?           **/
 bool      AntennasInScene = false;    /**  Are there antennas yet?          **/
 Point     Center;                     /**  Center of scene                  **/
 
+local GLdouble  PickModel[16];             /**  View last drawn, for picks  **/
+local GLdouble  PickProjection[16];
+local GLint     PickViewport[4];
+local bool      PickReady = false;         /**  Drawn at all yet            **/
+local Point     PickShift[MAX_ANTENNAS];   /**  Elements moved by boom      **/
+local CV_Study *Study = NULL;              /**  Last segmentation study     **/
+local int       StudyAnt = -1;             /**    ..of this antenna         **/
+
 
 /*****************************************************************************/
 /*****************************************************************************/
@@ -88,6 +127,11 @@ Point     Center;                     /**  Center of scene                  **/
 
 void TKA_Cylinder(GLfloat radius, GLfloat height, GLint slices, GLint rings);
 void TKA_Cube(GLfloat size);
+local bool SolveDecks(int, char (*)[32], char (*)[32]);
+local bool SolveClusters(const int *, int);
+local bool CheckScene(double);
+local void FreeCurrents(Ant *);
+local void SwapCurrents(Ant *, SegmentData **);
 
 
 /*****************************************************************************/
@@ -164,6 +208,9 @@ void InsertTube(Ant *the_ant, Tube *the_tube) {
     InsertTubeR(the_ant->first_tube, the_tube);
 
   the_ant->tube_count++;
+  WI_Invalidate();
+  CV_Free(Study);
+  Study = NULL;
 
 }  /**  End of InsertTube  **/
 
@@ -288,6 +335,7 @@ void InitDisplay(void) {
     ShowNulls      = 0;
     NULL_THRESHOLD = 0.85;
     NULL_DISTANCE  = 5.0;
+    LOD_PIXEL_ERROR = 0.5;
     here_before    = 1;
     SetPoint(&Center, 0, 0, 0);
   }  /**  Thing we do once ever  **/
@@ -309,9 +357,12 @@ void InitDisplay(void) {
 
 void DisplayField(Ant *antData) {
 
+  double  start;  /**  Timer start  **/
+
   if(RFPowerDensityOn == true) {
 
     glPushMatrix();
+    start = TM_Start();
     if (DrawMode == 0) {
       if(ShowRadPat)
         DrawRFPowerDensityPoints(antData);
@@ -323,6 +374,7 @@ void DisplayField(Ant *antData) {
         DrawAxialRatioPoints(antData);
       if(ShowNulls)
         DrawShowNullsPoints(antData);
+      TM_Stop(TM_FIELD_POINTS, start);
     }  /**  Points  **/
 
     else if (DrawMode == 1) {
@@ -336,6 +388,7 @@ void DisplayField(Ant *antData) {
         DrawAxialRatioSurface(antData);
       if(ShowNulls)
         DrawShowNullsSurface(antData);
+      TM_Stop(TM_FIELD_SURFACE, start);
     }  /**  Surface  **/
 
     else if (DrawMode == 2) {
@@ -349,6 +402,7 @@ void DisplayField(Ant *antData) {
         DrawAxialRatioSphere(antData);
       if(ShowNulls)
         DrawShowNullsSphere(antData);
+      TM_Stop(TM_FIELD_SPHERE, start);
     }  /**  Sphere  **/
 
     glPopMatrix();
@@ -378,6 +432,8 @@ void DisplaySelectedAnt(Ant *ant, GLint slices, GLint rings, bool selected) {
   double   boomwidth;          /**  Width of boom                **/
   double   boomshift;          /**  How far we need to center    **/
   GLfloat  selected_color[4];  /**  The selected color           **/
+  double   start;              /**  Timer start                  **/
+  long     k;                  /**  Its place in TheAnts         **/
 
   if (selected == true)
     selected_color[0] = 1.0;
@@ -453,7 +509,12 @@ void DisplaySelectedAnt(Ant *ant, GLint slices, GLint rings, bool selected) {
   } else {
     glTranslatef((boomcenter * -1.0), boomheight*0, 0.0);
   }  /**  Move into position  **/
+  k = ant - TheAnts.ants;
+  if (k >= 0 && k < MAX_ANTENNAS)
+    SetPoint(&PickShift[k], -boomcenter, 
+             (ant->ground_specified == false) ? boomheight : 0.0, 0.0);
 
+  start = TM_Start();
   if (ant->fieldComputed == false) {
     DrawTubeList(ant->first_tube, ant->current_tube, slices, rings);
   } else {
@@ -478,6 +539,7 @@ void DisplaySelectedAnt(Ant *ant, GLint slices, GLint rings, bool selected) {
       */
     }  /**  How to draw wires  **/
   }  /**  Only if field computed  **/
+  TM_Stop(TM_TUBES, start);
 
   glPopMatrix();
 
@@ -500,21 +562,190 @@ void DisplaySelectedAnt(Ant *ant, GLint slices, GLint rings, bool selected) {
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
-/**                                DisplayAnt                               **/
+/**                              DisplayAntWires                            **/
 /**                                                                         **/
-/**  This should be DisplayAnts plural.                                     **/
+/**  Renders every antenna in the scene.  The antennas and the radiation    **/
+/**  field are drawn separately so the display can cache them as separate   **/
+/**  layers.                                                                **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-void DisplayAnt(GLint slices, GLint rings) {
+void DisplayAntWires(GLint slices, GLint rings) {
+
+  int  i;  /**  Loop counter  **/
+
+  InitDisplay();
+
+  for(i=0; i < TheAnts.ant_count; i++) {
+    if (i == TheAnts.curr_ant) {
+      DisplaySelectedAnt(&TheAnts.ants[i], slices, rings, true);
+    } else {
+      DisplaySelectedAnt(&TheAnts.ants[i], slices, rings, false);
+    }  /**  Normal antenna  **/
+  }  /**  For each antenna  **/
+
+}  /**  End of DisplayAntWires  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SavePickView                               **/
+/**                                                                         **/
+/**  Keeps the view the antennas are drawn under, the ground's frame, for   **/
+/**  PickTube.  The wires' display list leaves it out, so it is taken       **/
+/**  every frame.                                                           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void SavePickView(void) {
+
+  glGetDoublev(GL_MODELVIEW_MATRIX, PickModel);
+  glGetDoublev(GL_PROJECTION_MATRIX, PickProjection);
+  glGetIntegerv(GL_VIEWPORT, PickViewport);
+  PickReady = true;
+
+}  /**  End of SavePickView  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              DisplayToDeck                              **/
+/**                                                                         **/
+/**  From where DisplaySelectedAnt draws antenna k to the deck frame of     **/
+/**  WireIndex.c, and back.  Elements are drawn scaled by SCALE_FACTOR      **/
+/**  with NEC's z up, then moved by the boom and the antenna's offset.      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void DisplayToDeck(int k, const GLdouble *w, double *q) {
+
+  Ant     *ant = &TheAnts.ants[k];  /**  The antenna     **/
+  double   v[3];                    /**  Before offsets  **/
+
+  v[0] = w[0] / ant->visual_scale - ant->dx - PickShift[k].x;
+  v[1] = w[1] / ant->visual_scale - ant->dy - PickShift[k].y;
+  v[2] = w[2] / ant->visual_scale - ant->dz - PickShift[k].z;
+  q[0] = SCALE_FACTOR * v[0] + ant->dx;
+  q[1] = -SCALE_FACTOR * v[2] + ant->dy;
+  q[2] = SCALE_FACTOR * v[1] + ant->dz;
+
+}  /**  End of DisplayToDeck  **/
+
+
+local void DeckToDisplay(int k, const double *q, GLdouble *w) {
+
+  Ant     *ant = &TheAnts.ants[k];  /**  The antenna     **/
+
+  w[0] = ant->visual_scale * 
+         ((q[0] - ant->dx) / SCALE_FACTOR + ant->dx + PickShift[k].x);
+  w[1] = ant->visual_scale * 
+         ((q[2] - ant->dz) / SCALE_FACTOR + ant->dy + PickShift[k].y);
+  w[2] = ant->visual_scale * 
+         (-(q[1] - ant->dy) / SCALE_FACTOR + ant->dz + PickShift[k].z);
+
+}  /**  End of DeckToDisplay  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                PickTube                                 **/
+/**                                                                         **/
+/**  Makes the wire under window pixel x, y (Tk's, from the top left) and   **/
+/**  its antenna current.  Each antenna is drawn in a frame of its own, so  **/
+/**  the line of sight is taken into each and WireIndex.c asked there, for  **/
+/**  wires as thick as DrawTube draws them and WI_PICK_PIXELS of slack at   **/
+/**  the antenna's depth.  Returns the wire's place in its antenna from 1,  **/
+/**  0 if the click missed.                                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int PickTube(int x, int y) {
+
+  WI_Hit    hit;     /**  An antenna's pick     **/
+  WI_Hit    best;    /**  The nearest of them   **/
+  GLdouble  win[3];  /**  Window coordinates    **/
+  GLdouble  w[3];    /**  Ground frame          **/
+  GLdouble  c[3];    /**  Antenna's centre      **/
+  double    from[3]; /**  Line of sight, deck  **/
+  double    to[3];
+  double    lo[3];   /**  Antenna's bounds      **/
+  double    hi[3];
+  double    slack;   /**  Pixels, in the deck   **/
+  int       k;       /**  Loop counter          **/
+  int       i;       /**  Loop counter          **/
+
+  if (AntennasInScene == false || PickReady == false)
+    return 0;
+  y = PickViewport[1] + PickViewport[3] - 1 - y;
+  best.tube = NULL;
+
+  for (k = 0; k < TheAnts.ant_count; k++) {
+    if (WI_Bounds(k, lo, hi) == false)
+      continue;
+    for (i = 0; i < 3; i++)
+      from[i] = (lo[i] + hi[i]) / 2.0;
+    DeckToDisplay(k, from, c);
+    gluProject(c[0], c[1], c[2], PickModel, PickProjection, PickViewport,
+               &win[0], &win[1], &win[2]);
+    gluUnProject(x, y, win[2], PickModel, PickProjection, PickViewport,
+                 &w[0], &w[1], &w[2]);
+    DisplayToDeck(k, w, from);
+    gluUnProject(x + WI_PICK_PIXELS, y, win[2], PickModel, PickProjection, 
+                 PickViewport, &w[0], &w[1], &w[2]);
+    DisplayToDeck(k, w, to);
+    slack = sqrt((to[0] - from[0]) * (to[0] - from[0]) +
+                 (to[1] - from[1]) * (to[1] - from[1]) +
+                 (to[2] - from[2]) * (to[2] - from[2]));
+
+    gluUnProject(x, y, 0.0, PickModel, PickProjection, PickViewport,
+                 &w[0], &w[1], &w[2]);
+    DisplayToDeck(k, w, from);
+    gluUnProject(x, y, 1.0, PickModel, PickProjection, PickViewport,
+                 &w[0], &w[1], &w[2]);
+    DisplayToDeck(k, w, to);
+    if (WI_Pick(k, from, to, TUBE_WIDTH_SCALE * SCALE_FACTOR, slack, 
+                &hit) && (best.tube == NULL || hit.t < best.t))
+      best = hit;
+  }  /**  For each antenna  **/
+
+  if (best.tube == NULL)
+    return 0;
+  TheAnts.curr_ant = best.ant;
+  TheAnts.ants[best.ant].current_tube = best.tube;
+  return best.index;
+
+}  /**  End of PickTube  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              DisplayAntField                            **/
+/**                                                                         **/
+/**  Renders the radiation field of the current antenna, centred on all     **/
+/**  the antennas when they are shown in phase.                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void DisplayAntField(void) {
 
   double  median_x=0;  /**  Median X value               **/
   double  median_y=0;  /**  Median Y value               **/
   double  median_z=0;  /**  Median Z value               **/
   double  boomheight=0;/**  Height of boom above ground  **/
-  int     i;           /**  Loop counter                 **/
   int     j;           /**  Loop counter                 **/
 
   InitDisplay();
@@ -563,14 +794,6 @@ void DisplayAnt(GLint slices, GLint rings) {
     median_y = median_y + boomheight;
   }  /**  Display field in center of all antennas  **/
 
-  for(i=0; i < TheAnts.ant_count; i++) {
-    if (i == TheAnts.curr_ant) {
-      DisplaySelectedAnt(&TheAnts.ants[i], slices, rings, true);
-    } else {
-      DisplaySelectedAnt(&TheAnts.ants[i], slices, rings, false);
-    }  /**  Normal antenna  **/
-  }  /**  For each antenna  **/
-
   /**  Radiation field  **/
   glPushMatrix();
   if (MultipleAntMode == 1) {
@@ -582,8 +805,7 @@ void DisplayAnt(GLint slices, GLint rings) {
   }  /**  Only if field is computed  **/
   glPopMatrix(); 
 
-
-}  /**  End of DisplayAnt  **/
+}  /**  End of DisplayAntField  **/
 
 
 /*****************************************************************************/
@@ -603,6 +825,12 @@ void InitAnt(Ant *ant) {
   ant->first_tube = NULL;
   ant->tube_count = 0;
   ant->fieldData = NULL;
+  ant->feedTable = NULL;
+  ant->sweepTable = NULL;
+  ant->ports = NULL;
+  ant->solvedSerial = 0;
+  ant->resampleError = -1.0;
+  ant->meshKey.serial = 0;
   ant->dx = 0.0;
   ant->dy = 0.0;
   ant->dz = 0.0;
@@ -665,10 +893,64 @@ void DeleteCurrentAnt(void) {
 
   if(TheAnts.curr_ant >= TheAnts.ant_count)
     TheAnts.curr_ant--;
+  WI_Invalidate();
+  CV_Free(Study);
+  Study = NULL;
 
 }  /**  End of DeleteCurrentTube  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ClearScene                                **/
+/**                                                                         **/
+/**  Unloads every antenna and frees its wires, currents, cards and field.  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void ClearScene(void) {
+
+  Ant          *ant;   /**  Antenna being freed  **/
+  Tube         *tube;  /**  Tube being freed     **/
+  SegmentData  *seg;   /**  Current being freed  **/
+  int           i;     /**  Loop counter         **/
+
+  for (i = 0; AntennasInScene && i < TheAnts.ant_count; i++) {
+    ant = &TheAnts.ants[i];
+    while ((tube = ant->first_tube) != NULL) {
+      ant->first_tube = tube->next;
+      while ((seg = tube->currents) != NULL) {
+        tube->currents = seg->next;
+        free(seg);
+      }  /**  For each current  **/
+      free(tube);
+    }  /**  For each tube  **/
+    while (ant->card_count > 0)
+      free(ant->cards[--ant->card_count]);
+    if (ant->fieldData != NULL) {
+      free(ant->fieldData->vals);
+      free(ant->fieldData);
+    }  /**  Had a field  **/
+    FreeFeedTable(ant);
+    FreeFeedRows(ant->sweepTable);
+    ant->sweepTable = NULL;
+    PT_Free(ant->ports);
+    ant->ports = NULL;
+  }  /**  For each antenna  **/
+
+  TheAnts.ant_count = 0;
+  TheAnts.curr_ant = 0;
+  AntennasInScene = false;
+  WI_Invalidate();
+  CV_Free(Study);
+  Study = NULL;
+
+}  /**  End of ClearScene  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
@@ -686,6 +968,7 @@ void MoveCurrentAnt(double dx, double dy, double dz) {
     TheAnts.ants[TheAnts.curr_ant].dx += dx;
     TheAnts.ants[TheAnts.curr_ant].dy += dy;
     TheAnts.ants[TheAnts.curr_ant].dz += dz;
+    WI_RefitAnt(TheAnts.curr_ant);
   }  /**  While more elements  **/
 
 }  /**  End of MoveCurrentAnt  **/
@@ -715,6 +998,7 @@ void MoveCurrentTube(double dx, double dy, double dz) {
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.x += dx;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.y += dy;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.z += dz;
+      WI_Refit(current);
     }  /**  Only for elements  **/
   }  /**  While more elements  **/
 
@@ -745,6 +1029,7 @@ void MoveCurrentWall(double dx, double dy, double dz) {
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.x += dx;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.y += dy;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2.z += dz;
+      WI_Refit(current);
     }  /**  Only for walls  **/
   }  /**  While more elements  **/
 
@@ -867,6 +1152,7 @@ void RotateCurrentTube(double rx, double ry, double rz) {
       e2.z += center.z;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e1 = e1;
       TheAnts.ants[TheAnts.curr_ant].current_tube->e2 = e2;
+      WI_Refit(TheAnts.ants[TheAnts.curr_ant].current_tube);
     }  /**  Only for elements  **/
   }  /**  While more elements  **/
 
@@ -938,6 +1224,7 @@ void RotateCurrentAntenna(double rx, double ry, double rz) {
     e2.z += center.z;
     TheAnts.ants[TheAnts.curr_ant].current_tube->e1 = e1;
     TheAnts.ants[TheAnts.curr_ant].current_tube->e2 = e2;
+    WI_Refit(TheAnts.ants[TheAnts.curr_ant].current_tube);
 
   }  /**  While more elements  **/
 
@@ -964,6 +1251,7 @@ void ScaleCurrentWall(double sx, double sy, double sz) {
     TheAnts.ants[TheAnts.curr_ant].current_tube->e2.x += sx;
     TheAnts.ants[TheAnts.curr_ant].current_tube->e2.y += sy;
     TheAnts.ants[TheAnts.curr_ant].current_tube->e2.z += sz;
+    WI_Refit(current);
   }  /**  Only affect walls  **/
 
 }  /**  End of ScaleCurrentWall  **/
@@ -1016,6 +1304,7 @@ void ScaleCurrentTube(double scale, double width) {
       TheAnt.current_tube->width *= (width + 1);
       if(TheAnt.current_tube->width < 0.001)
         TheAnt.current_tube->width = 0.001;
+      WI_Refit(TheAnt.current_tube);
     }  /**  While there are still elements  **/
   }  /**  Only if it's not a wall  **/
 
@@ -1077,32 +1366,74 @@ void ChangeCurrentTube(int count) {
 }  /**  End of ChangeCurrentTube **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               CheckScene                                **/
+/**                                                                         **/
+/**  Runs DC_Check over what GenerateNECFile would write, at freq MHz,      **/
+/**  and prints what it finds.  False if the deck should not be solved,     **/
+/**  which with CheckDecks off it always should.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool CheckScene(double freq) {
+
+  Ant        *ants[MAX_ANTENNAS];  /**  Antennas written  **/
+  DC_Report   report;              /**  What was found    **/
+  int         count;               /**  How many          **/
+  int         k;                   /**  Loop counter      **/
+
+  count = 0;
+  if (MultipleAntMode == 1)
+    for (k = 0; k < TheAnts.ant_count; k++)
+      ants[count++] = &TheAnts.ants[k];
+  else
+    ants[count++] = &TheAnts.ants[TheAnts.curr_ant];
+  DC_Check(ants, count, freq, &report);
+  DC_Print(stderr, &report);
+  return (report.errors == 0 || CheckDecks == 0);
+
+}  /**  End of CheckScene  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
 /**                            GenerateNECFile                              **/
 /**                                                                         **/
 /**  This function traverses the details of the antenna we have stored in   **/
-/**  memory and output a .nec file that NEC2 will load by default.          **/
+/**  memory and output a .nec file that NEC2 will load by default.  Returns **/
+/**  the symmetry it was written with, NULL if none, for ParseFieldData.    **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-void GenerateNECFile(CONST84 char *file_name) {
+SY_Plan *GenerateNECFile(CONST84 char *file_name) {
 
+  SY_Plan  *plan;   /**  Symmetry written with  **/
+  double    start;  /**  Timer start            **/
+
+  start = TM_Start();
   curr_step_size = STEP_SIZE;
+  plan = NULL;
 
   if (MultipleAntMode == 0) {
-    WriteCardFile(file_name, 
-                 &TheAnts.ants[TheAnts.curr_ant], 
-                  STEP_SIZE, 
-                  TheAnts.ants[TheAnts.curr_ant].frequency);
+    plan = WriteCardFile(file_name, 
+                         &TheAnts.ants[TheAnts.curr_ant], 
+                         STEP_SIZE, 
+                         TheAnts.ants[TheAnts.curr_ant].frequency);
   } else if (MultipleAntMode == 1) {
     WriteMultAntsFile(file_name, 
                       STEP_SIZE, 
-                      TheAnts.ants[TheAnts.curr_ant].frequency);
+                      TheAnts.ants[TheAnts.curr_ant].frequency,
+                      NULL, 0);
   }  /**  Single or all antennas  **/
+  TM_Stop(TM_GENERATE, start);
+  return plan;
 
 }  /**  End of GenerateNECFile  **/
 
@@ -1125,6 +1456,8 @@ void AddWall(void) {
 
   a_tube.width = 1;
   a_tube.type = IS_WALL;
+  a_tube.segments = 5;      /**  As PrintTube writes walls  **/
+  a_tube.currents = NULL;
   SetPoint(&a_tube.e1, -2, 0, 0);
   SetPoint(&a_tube.e2, -1, 2, 4);
   InsertTube(&TheAnts.ants[TheAnts.curr_ant], &a_tube);
@@ -1143,13 +1476,16 @@ void AddWall(void) {
 /*****************************************************************************/
 
 
-void ComputeField(bool changed) {
+bool ComputeField(bool changed) {
 
   FILE *fin;        /**  Input file               **/
-  long  parentpid;  /**  Process ID of parent     **/
-  long  childpid;   /**  Process ID of child      **/
-  int   status;     /**  Status of child process  **/
   int   ferror;     /**  File access error        **/
+  char  deck[1][32];  /**  The deck                 **/
+  char  out[1][32];   /**    ..and its output       **/
+  double start;     /**  Timer start              **/
+  int   groups;       /**  Clusters of antennas     **/
+  int   cluster[MAX_ANTENNAS];  /**  Each antenna's     **/
+  SY_Plan *plan;      /**  Symmetry of the deck     **/
 
   /**  Check to see if antennas exist  **/
   if (AntennasInScene == true) {
@@ -1160,36 +1496,63 @@ void ComputeField(bool changed) {
       ferror = remove("output.nec");
       ferror = remove("input.nec");
 
+      /**  Port solves are of the old deck  **/
+      PT_Free(TheAnts.ants[TheAnts.curr_ant].ports);
+      TheAnts.ants[TheAnts.curr_ant].ports = NULL;
+
+      if (CheckScene(TheAnts.ants[TheAnts.curr_ant].frequency) == false) {
+        fprintf(stderr, "No field computed\n");
+        return false;
+      }  /**  Not worth a solve  **/
+
+      /**  Antennas far apart are solved apart, see Clusters.c  **/
+      groups = 0;
+      if (MultipleAntMode == 1 && ClusterSpacing > 0.0)
+        groups = CL_Group(&TheAnts, ClusterSpacing, 
+                          TheAnts.ants[TheAnts.curr_ant].frequency, cluster);
+      if (groups > 1) {
+        curr_step_size = STEP_SIZE;
+        if (SolveClusters(cluster, groups) == false)
+          return false;
+        RFPowerDensityOn = true;
+        FieldDataComputed = true;
+        return true;
+      }  /**  Clusters  **/
+
       /**  Output our current antenna to disk  **/
-      GenerateNECFile("input.nec"); 
+      plan = GenerateNECFile("input.nec"); 
   
-      /**  Run NEC code on that file  **/
-      parentpid = getpid();
-      if ((childpid = fork()) < 0) {
-        fprintf(stderr,"Can't fork\n");
-        exit(-2);
+      /**  Run NEC code on that file, unless a stand-in serves it  **/
+      start = TM_Start();
+      strcpy(deck[0], "input.nec");
+      strcpy(out[0], "output.nec");
+      if (SolveDecks(1, deck, out) == false) {
+        SY_Free(plan);
+        fprintf(stderr, "No field computed\n");
+        return false;
       }  /**  Error state  **/
-      if (childpid == 0) {  /**  We are child  **/
-        printf("Running NEC2 code...  please stand by...\n");
-        execlp("nec2", "nec2", "input.nec", "output.nec", NULL);  
-        exit(-1);  /**  We should never reach here  **/
-      }  /**  We are child  **/
-      else {  /**  We are parent  **/
-        if (wait(&status) != childpid) {
-          fprintf(stderr,"Problem with child\n");
-          exit(-3);
-        }  /**  Error state  **/
-      }  /**  We are parent  **/
+      TM_Stop(TM_SOLVER, start);
   
       /**  Read in results from disk  **/
       fin  = fopen("output.nec", "rt");
       if(fin != NULL) {
-        ParseFieldData(fin, &TheAnts.ants[TheAnts.curr_ant], true, true);
+        ParseFieldData(fin, &TheAnts.ants[TheAnts.curr_ant], plan, true, 
+                       true);
         fclose(fin);
+        SY_Free(plan);
+
+        /**  A scene's field is not this antenna's currents alone  **/
+        TheAnts.ants[TheAnts.curr_ant].solvedSerial = 0;
+        if (TheAnts.ants[TheAnts.curr_ant].fieldData != NULL &&
+            MultipleAntMode == 0)
+          TheAnts.ants[TheAnts.curr_ant].solvedSerial = 
+            TheAnts.ants[TheAnts.curr_ant].fieldData->serial;
+        TheAnts.ants[TheAnts.curr_ant].resampleError = -1.0;
       } 
       else {
+        SY_Free(plan);
         fprintf(stderr, "Could Not Open File output.nec!!!\n");
-        return;
+        return false;
       }
       /*
       ferror = remove("output.nec");
@@ -1201,12 +1564,1008 @@ void ComputeField(bool changed) {
       FieldDataComputed = true;
 
     }  /**  Need to compute field  **/
+    else if ((int) STEP_SIZE != (int) curr_step_size) {
+      if (MultipleAntMode != 0 || ResampleField((int) STEP_SIZE) == false)
+        return ComputeField(true);
+      printf("Field resampled from the segment currents.\n");
+    }  /**  Same currents, new step  **/
 
   }  /**  Antennas are in scene  **/
 
+  return true;
+
 }  /**  End of ComputeField  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             SampleFarField                              **/
+/**                                                                         **/
+/**  Fills fd with the current antenna's pattern on thetas x phis samples   **/
+/**  step degrees apart from (theta0, phi0), integrated from the segment    **/
+/**  currents of its last solve instead of by nec2 (see FarField.c).        **/
+/**  Gains are over the input power that solve reported, directivities if   **/
+/**  it reported none.  Not for patterns of all antennas at once.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SampleFarField(double theta0, double phi0, double step, int thetas,
+                    int phis, FieldData *fd) {
+
+  FF_Sources  src;     /**  Segment currents  **/
+  FeedTable  *table;   /**  Input parameters  **/
+  Ant        *ant;     /**  Current antenna   **/
+  double      freq;    /**  Of the solve, MHz **/
+  double      power;   /**  Input power, W    **/
+  double      start;   /**  Timer start       **/
+  bool        done;    /**  Pattern filled    **/
+  int         i;       /**  Loop counter      **/
+
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (AntennasInScene == false || MultipleAntMode != 0 ||
+      ant->fieldComputed == false || !FF_Gather(ant, &src))
+    return false;
+
+  freq = (ant->frequency > 0.0) ? ant->frequency : FF_NEC_FREQ;
+  power = 0.0;
+  if ((table = ant->feedTable) != NULL)
+    for (i = 0; i < table->count; i++)
+      if (fabs(table->frequency[i] - freq) <= 1e-6 * freq)
+        power += table->power[i];
+
+  start = TM_Start();
+  done = FF_Pattern(&src, freq, power, theta0, phi0, step, thetas, phis, 
+                    fd);
+  TM_Stop(TM_FAR_FIELD, start);
+  FF_Free(&src);
+  if (done)
+    fd->serial = NewPatternSerial();
+  return done;
+
+}  /**  End of SampleFarField  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              ResampleField                              **/
+/**                                                                         **/
+/**  Replaces the current antenna's field with the grid NEC would print     **/
+/**  for an RP card of the given step, from its segment currents.  The      **/
+/**  kernels work in single precision, so the first resample after a solve  **/
+/**  is checked against NEC's own pattern on its grid; if they differ by    **/
+/**  over FF_CHECK_DB this returns false and the caller solves instead.     **/
+/**  So does a field that was not solved from these currents alone, which   **/
+/**  leaves solvedSerial 0.                                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool ResampleField(int step) {
+
+  Ant        *ant;    /**  Current antenna   **/
+  FieldData   check;  /**  NEC's grid again  **/
+  int         n;      /**  Samples per row   **/
+
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (step < 1 || ant->fieldData == NULL || ant->solvedSerial == 0)
+    return false;
+
+  if (ant->resampleError < 0.0 &&
+      ant->fieldData->serial == ant->solvedSerial && curr_step_size >= 1) {
+    n = 361 / (int) curr_step_size;
+    memset(&check, 0, sizeof(check));
+    if (SampleFarField(0.0, 0.0, (int) curr_step_size, n, n, &check))
+      ant->resampleError = FF_Residual(ant->fieldData, &check, 
+                                       FF_CHECK_RANGE);
+    free(check.vals);
+    if (ant->resampleError < 0.0)
+      return false;
+    if (ant->resampleError > FF_CHECK_DB) {
+      fprintf(stderr, "Segment currents give the pattern to %.2f dB only, "
+              "solving again\n", ant->resampleError);
+      return false;
+    }  /**  Not to be trusted  **/
+    printf("Resample checked against NEC2, within %.3f dB\n", 
+           ant->resampleError);
+  }  /**  First resample of a solve  **/
+
+  n = 361 / step;
+  if (!SampleFarField(0.0, 0.0, step, n, n, ant->fieldData))
+    return false;
+  curr_step_size = step;
+  return true;
+
+}  /**  End of ResampleField  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             ComputeSweep                                **/
+/**                                                                         **/
+/**  Runs NEC2 on the current antenna over FreqSteps frequencies from       **/
+/**  start to stop MHz, without patterns, and keeps the input parameters    **/
+/**  at each in the antenna's sweep table.  The feed table stays that of    **/
+/**  the last solve, whose input power the far field is normalised by.  A   **/
+/**  stop not above start sweeps 5% either side of the antenna's            **/
+/**  frequency.  Each frequency is a fill and factor of its own, so the     **/
+/**  sweep is cut into one band per solver worker and the bands are solved  **/
+/**  at once.  A failed sweep leaves the last sweep table in place.         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool ComputeSweep(double start, double stop) {
+
+  FILE       *fin;                  /**  Solver output            **/
+  Ant        *ant;                  /**  Current antenna          **/
+  char        deck[MAX_DECKS][32];  /**  Input file per band      **/
+  char        out[MAX_DECKS][32];   /**  Output file per band     **/
+  SY_Plan    *plan[MAX_DECKS];      /**  Symmetry of each band    **/
+  FeedTable  *table;                /**  Feed table of the solve  **/
+  double      step;                 /**  MHz between frequencies  **/
+  int         freqs;                /**  Frequencies              **/
+  int         bands;                /**  Decks they are split in  **/
+  int         first;                /**  First of a band          **/
+  int         count;                /**    ..and how many         **/
+  bool        ok;                   /**  Every band solved        **/
+  double      begin;                /**  Timer start              **/
+  int         i;                    /**  Loop counter             **/
+
+  if (AntennasInScene == false)
+    return false;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  freqs = (FreqSteps > 1) ? FreqSteps : 2;
+  if (stop <= start) {
+    if (ant->frequency <= 0)
+      return false;
+    start = ant->frequency * 0.95;
+    stop = ant->frequency * 1.05;
+  }  /**  Default band  **/
+  step = (stop - start) / (freqs - 1);
+  if (CheckScene(start) == false || CheckScene(stop) == false)
+    return false;
+
+  /**  Each frequency is its own fill and factor: a band per worker.  **/
+  /**  Stand-ins and recordings key on the whole deck, so keep it.    **/
+  bands = (FX_Backend() == FX_NEC2) ? SP_Workers() : 1;
+  if (bands > freqs)
+    bands = freqs;
+  if (bands > MAX_DECKS)
+    bands = MAX_DECKS;
+  if (bands < 1)
+    bands = 1;
+  for (i = first = 0; i < bands; i++, first += count) {
+    count = freqs / bands + (i < freqs % bands ? 1 : 0);
+    sprintf(deck[i], "sweep%d_in.nec", i);
+    sprintf(out[i], "sweep%d_out.nec", i);
+    remove(out[i]);
+    plan[i] = WriteSweepFile(deck[i], ant, start + first * step, step, 
+                             count);
+  }  /**  For each band  **/
+
+  begin = TM_Start();
+  ok = SolveDecks(bands, deck, out);
+  TM_Stop(TM_SOLVER, begin);
+
+  /**  Read into a table of its own, keeping the solve's  **/
+  table = ant->feedTable;
+  ant->feedTable = NULL;
+  ClearFeedTable(ant);
+  for (i = 0; ok && i < bands; i++) {
+    if ((fin = fopen(out[i], "rt")) == NULL) {
+      fprintf(stderr, "Could Not Open File %s!!!\n", out[i]);
+      ok = false;
+      break;
+    }  /**  Error state  **/
+    AppendSweep(fin, ant, plan[i]);
+    fclose(fin);
+  }  /**  For each band  **/
+  for (i = 0; i < bands; i++) {
+    SY_Free(plan[i]);
+    remove(deck[i]);
+    remove(out[i]);
+  }  /**  Tidy up  **/
+
+  ok = ok && ant->feedTable != NULL && ant->feedTable->count > 0;
+  if (ok) {
+    FreeFeedRows(ant->sweepTable);
+    ant->sweepTable = ant->feedTable;
+    ant->feedTable = NULL;
+  } else
+    FreeFeedTable(ant);
+  ant->feedTable = table;
+  return ok;
+
+}  /**  End of ComputeSweep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SavePattern                                **/
+/**                                                                         **/
+/**  Writes the computed field of the current antenna as a binary pattern   **/
+/**  file, so it can be reopened later without running NEC2 again.          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SavePattern(CONST84 char *file_name) {
+
+  if (AntennasInScene == false || 
+      TheAnts.ants[TheAnts.curr_ant].fieldComputed == false) {
+    fprintf(stderr, "No field computed to save\n");
+    return false;
+  }  /**  Nothing to save  **/
+  if (!PF_Write(file_name, &TheAnts.ants[TheAnts.curr_ant])) {
+    fprintf(stderr, "Could not write %s\n", file_name);
+    return false;
+  }  /**  Write failed  **/
+  return true;
+
+}  /**  End of SavePattern  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              LoadPattern                                **/
+/**                                                                         **/
+/**  Makes a saved pattern file the field of the current antenna.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool LoadPattern(CONST84 char *file_name) {
+
+  FieldData  *fd;  /**  The loaded field  **/
+
+  if (AntennasInScene == false) {
+    fprintf(stderr, "Load an antenna before its pattern\n");
+    return false;
+  }  /**  Nothing to attach it to  **/
+  if (!PF_Load(file_name, &TheAnts.ants[TheAnts.curr_ant])) {
+    fprintf(stderr, "%s is not a pattern file\n", file_name);
+    return false;
+  }  /**  Load failed  **/
+
+  /**  PF_Load only takes NEC's grid, so the step is the file's  **/
+  fd = TheAnts.ants[TheAnts.curr_ant].fieldData;
+  curr_step_size = fd->vals[1].theta - fd->vals[0].theta;
+  RFPowerDensityOn = true;
+  FieldDataComputed = true;
+  return true;
+
+}  /**  End of LoadPattern  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             AnalyzePattern                              **/
+/**                                                                         **/
+/**  Figures of merit of the current antenna's computed field, see          **/
+/**  FieldAnalysis.c.                                                       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool AnalyzePattern(FA_Result *result) {
+
+  FA_Samples  samples;  /**  View of the field  **/
+  Ant        *ant;      /**  Current antenna    **/
+
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (AntennasInScene == false || ant->fieldComputed == false ||
+      ant->fieldData == NULL)
+    return false;
+  FA_FieldSamples(ant->fieldData, &samples);
+  return FA_Analyze(&samples, result);
+
+}  /**  End of AnalyzePattern  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SolveDecks                                **/
+/**                                                                         **/
+/**  Produces out[i] for each of count independent decks.  Those the        **/
+/**  stand-in does not serve go to the solver pool together, one per        **/
+/**  worker, so the batch takes about as long as its slowest deck.  Each    **/
+/**  is sized from its segments so the pool keeps their matrices within    **/
+/**  SolverMemory.  False if any deck got no output.                        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool SolveDecks(int count, char (*deck)[32], char (*out)[32]) {
+
+  const char  *run_deck[MAX_DECKS];  /**  Decks nec2 must solve  **/
+  const char  *run_out[MAX_DECKS];   /**    ..their outputs      **/
+  double       bytes[MAX_DECKS];     /**    ..their matrices     **/
+  int          result[MAX_DECKS];    /**    ..how each went      **/
+  int          runs;                 /**  How many               **/
+  int          solved;               /**  What FX_Solve did      **/
+  long         segments;             /**  In a deck              **/
+  int          copies;               /**    ..GX and GR make     **/
+  bool         ok;                   /**  Every deck has output  **/
+  int          i;                    /**  Loop counter           **/
+
+  ok = true;
+  runs = 0;
+  for (i = 0; i < count && i < MAX_DECKS; i++) {
+    solved = FX_Solve(deck[i], out[i]);
+    if (solved == FX_FAILED)
+      ok = false;
+    else if (solved == FX_RUN_NEC2) {
+      segments = DeckSegments(deck[i], &copies);
+      bytes[runs] = 16.0 * segments * segments / copies;
+      run_deck[runs] = deck[i];
+      run_out[runs++] = out[i];
+    }  /**  Needs nec2  **/
+  }  /**  For each deck  **/
+  if (!ok || runs == 0)
+    return ok;
+
+  if (runs == 1)
+    printf("Running NEC2 code...  please stand by...\n");
+  else
+    printf("Running NEC2 code on %d decks, %d at a time...\n", runs, 
+           SP_Workers());
+  SP_SetBudget(SolverMemory * 1073741824.0);
+  SP_SolveAll(runs, run_deck, run_out, bytes, result);
+  for (i = 0; i < runs; i++) {
+    if (result[i] != SP_OK) {
+      fprintf(stderr, "%s not solved: %s\n", run_deck[i], 
+              SP_Message(result[i]));
+      ok = false;
+    } else
+      FX_Solved(run_deck[i], run_out[i]);
+  }  /**  For each nec2 run  **/
+  return ok;
+
+}  /**  End of SolveDecks  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             SolveClusters                               **/
+/**                                                                         **/
+/**  Solves the scene in phase as groups decks, one per cluster of nearby   **/
+/**  antennas, together on the solver pool, and makes the sum of their      **/
+/**  fields the current antenna's.  An antenna alone in its cluster gets    **/
+/**  the currents of its solve.  Coupling between clusters is left out.     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool SolveClusters(const int *cluster, int groups) {
+
+  Ant        *ant;                     /**  Current antenna          **/
+  Ant        *holder;                  /**  Antenna parsed into      **/
+  FieldData   part[MAX_ANTENNAS];      /**  Field of each cluster    **/
+  FieldData  *parts[MAX_ANTENNAS];     /**    ..for CL_Sum           **/
+  double      power[MAX_ANTENNAS];     /**    ..and its input power  **/
+  char        deck[MAX_ANTENNAS][32];  /**  Input file per cluster   **/
+  char        out[MAX_ANTENNAS][32];   /**  Output file per cluster  **/
+  FieldData  *field;                   /**  Holder's own field       **/
+  FeedTable  *table;                   /**  Holder's own inputs      **/
+  double      range[4];                /**    ..current ranges       **/
+  bool        computed;                /**    ..and if solved        **/
+  FeedTable  *rows;                    /**  A cluster's inputs       **/
+  FeedTable  *inputs;                  /**  Every cluster's          **/
+  FILE       *fin;                     /**  Solver output            **/
+  double      start;                   /**  Timer start              **/
+  double      dense;                   /**  Segments of one deck     **/
+  double      split;                   /**  Sum of their squares     **/
+  bool        ok;                      /**  Every cluster solved     **/
+  int         members;                 /**  Antennas in a cluster    **/
+  int         c;                       /**  Cluster                  **/
+  int         i;                       /**  Loop counter             **/
+  int         k;                       /**  Antenna                  **/
+
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  dense = CL_Segments(&TheAnts, NULL, 0);
+  split = 0.0;
+  for (c = 0; c < groups; c++) {
+    split += (double) CL_Segments(&TheAnts, cluster, c) * 
+             CL_Segments(&TheAnts, cluster, c);
+    sprintf(deck[c], "cluster%d_in.nec", c);
+    sprintf(out[c], "cluster%d_out.nec", c);
+    remove(out[c]);
+    WriteMultAntsFile(deck[c], STEP_SIZE, ant->frequency, cluster, c);
+  }  /**  For each cluster  **/
+  printf("%d antennas solved as %d clusters, %.0f%% of the matrix of one "
+         "deck\n", TheAnts.ant_count, groups, 
+         dense > 0 ? 100.0 * split / (dense * dense) : 0.0);
+
+  start = TM_Start();
+  ok = SolveDecks(groups, deck, out);
+  TM_Stop(TM_SOLVER, start);
+
+  memset(part, 0, sizeof(part));
+  inputs = (FeedTable *) calloc(1, sizeof(FeedTable));
+  for (c = 0; ok && c < groups; c++) {
+    if ((fin = fopen(out[c], "rt")) == NULL) {
+      fprintf(stderr, "Could Not Open File %s!!!\n", out[c]);
+      ok = false;
+      break;
+    }  /**  Error state  **/
+    members = 0;
+    holder = ant;
+    for (k = 0; k < TheAnts.ant_count; k++)
+      if (cluster[k] == c) {
+        members++;
+        holder = &TheAnts.ants[k];
+      }  /**  Member  **/
+    if (members > 1)
+      holder = ant;
+
+    /**  Read into the holder, keeping its own field and inputs  **/
+    field = holder->fieldData;
+    table = holder->feedTable;
+    computed = holder->fieldComputed;
+    range[0] = holder->max_current_mag;
+    range[1] = holder->min_current_mag;
+    range[2] = holder->max_current_phase;
+    range[3] = holder->min_current_phase;
+    holder->fieldData = &part[c];
+    holder->feedTable = NULL;
+    ParseFieldData(fin, holder, NULL, true, members == 1);
+    fclose(fin);
+    holder->fieldComputed = computed;
+    holder->max_current_mag = range[0];
+    holder->min_current_mag = range[1];
+    holder->max_current_phase = range[2];
+    holder->min_current_phase = range[3];
+    parts[c] = &part[c];
+    power[c] = 0.0;
+    if ((rows = holder->feedTable) != NULL && inputs != NULL)
+      for (i = 0; i < rows->count; i++) {
+        power[c] += rows->power[i];
+        AddFeedRow(inputs, rows->frequency[i], rows->tag[i], 
+                   rows->segment[i], rows->resistance[i], 
+                   rows->reactance[i], rows->power[i]);
+      }  /**  Each input  **/
+    FreeFeedTable(holder);
+    holder->fieldData = field;
+    holder->feedTable = table;
+  }  /**  For each cluster  **/
+  for (c = 0; c < groups; c++) {
+    remove(deck[c]);
+    remove(out[c]);
+  }  /**  Tidy up  **/
+
+  if (ok && ant->fieldData == NULL)
+    ant->fieldData = (FieldData *) calloc(1, sizeof(FieldData));
+  ok = ok && ant->fieldData != NULL && 
+       CL_Sum(parts, power, groups, ant->fieldData);
+  for (c = 0; c < groups; c++)
+    free(part[c].vals);
+  FreeFeedTable(ant);
+  ant->feedTable = inputs;
+  if (!ok) {
+    fprintf(stderr, "Clusters could not be solved\n");
+    return false;
+  }  /**  Error state  **/
+
+  /**  A sum of clusters cannot be resampled from ant's currents  **/
+  ant->fieldData->serial = NewPatternSerial();
+  ant->solvedSerial = 0;
+  ant->resampleError = -1.0;
+  ant->fieldComputed = true;
+  return true;
+
+}  /**  End of SolveClusters  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SetThreads                                **/
+/**                                                                         **/
+/**  Splits solves and pattern work over n cores from now on: n solver      **/
+/**  workers and n threads for the pattern kernels, one per online CPU if   **/
+/**  n is 0.  False while a solve is running.                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SetThreads(int n) {
+
+  if (n <= 0)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (!SP_Resize(n))
+    return false;
+  WP_Shutdown();
+  WP_Init(n);
+  return true;
+
+}  /**  End of SetThreads  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              FreeCurrents                               **/
+/**                                                                         **/
+/**  Drops the segment currents of every tube of an antenna.                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void FreeCurrents(Ant *ant) {
+
+  Tube         *tube;  /**  Tube traversal       **/
+  SegmentData  *seg;   /**  Current being freed  **/
+
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+    while ((seg = tube->currents) != NULL) {
+      tube->currents = seg->next;
+      free(seg);
+    }  /**  For each current  **/
+
+}  /**  End of FreeCurrents  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              SwapCurrents                               **/
+/**                                                                         **/
+/**  Exchanges the segment currents of each tube of an antenna with those   **/
+/**  kept in saved, one entry per tube.                                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void SwapCurrents(Ant *ant, SegmentData **saved) {
+
+  Tube         *tube;  /**  Tube traversal  **/
+  SegmentData  *seg;   /**  Being swapped   **/
+  int           i;     /**  Tube index      **/
+
+  for (tube = ant->first_tube, i = 0; tube != NULL; tube = tube->next, i++) {
+    seg = tube->currents;
+    tube->currents = saved[i];
+    saved[i] = seg;
+  }  /**  For each tube  **/
+
+}  /**  End of SwapCurrents  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SolvePorts                                **/
+/**                                                                         **/
+/**  Solves the current antenna once per voltage source, 1 volt at that     **/
+/**  source and the others shorted, and keeps the solutions so SteerPorts   **/
+/**  can drive the sources with any amplitudes and phases without nec2      **/
+/**  (see Ports.c).  The solves go to the solver pool together and are      **/
+/**  read into a scratch field, inputs and currents.  Only once every port  **/
+/**  is captured is the field made that of the deck's own excitation.       **/
+/**  Returns the number of ports, 0 if the deck has none it can split or a  **/
+/**  solve failed, with the antenna's field, currents and ports as they     **/
+/**  were.                                                                  **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int SolvePorts(void) {
+
+  Ant          *ant;                     /**  Current antenna        **/
+  PT_Set       *set;                     /**  Its ports              **/
+  FILE         *fin;                     /**  Solver output          **/
+  char          deck[PT_MAX_PORTS][32];  /**  Input file per port    **/
+  char          out[PT_MAX_PORTS][32];   /**  Output file per port   **/
+  SY_Plan      *plan[PT_MAX_PORTS];      /**  Symmetry of each deck  **/
+  FieldData     part;                    /**  Field of one port      **/
+  FieldData    *field;                   /**  Antenna's own field    **/
+  FeedTable    *table;                   /**    ..and inputs         **/
+  SegmentData **saved;                   /**    ..and currents       **/
+  double        range[4];                /**    ..current ranges     **/
+  bool          computed;                /**    ..and if solved      **/
+  bool          ok;                      /**  All solves went        **/
+  double        start;                   /**  Timer start            **/
+  int           p;                       /**  Port                   **/
+
+  if (AntennasInScene == false)
+    return 0;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if ((set = PT_Find(ant)) == NULL) {
+    fprintf(stderr, "No voltage sources to solve one at a time\n");
+    return 0;
+  }  /**  No ports  **/
+  if (CheckScene(ant->frequency) == false) {
+    PT_Free(set);
+    return 0;
+  }  /**  Not worth the solves  **/
+  if ((saved = (SegmentData **) calloc(ant->tube_count + 1, 
+                                       sizeof(SegmentData *))) == NULL) {
+    PT_Free(set);
+    return 0;
+  }  /**  Out of memory  **/
+
+  start = TM_Start();
+  for (p = 0; p < set->ports; p++) {
+    sprintf(deck[p], "port%d_in.nec", p);
+    sprintf(out[p], "port%d_out.nec", p);
+    remove(out[p]);
+    plan[p] = WritePortFile(deck[p], ant, STEP_SIZE, ant->frequency, p);
+  }  /**  For each port  **/
+  ok = SolveDecks(set->ports, deck, out);
+  TM_Stop(TM_SOLVER, start);
+
+  /**  Read each port into scratch, keeping the antenna's own  **/
+  field = ant->fieldData;
+  table = ant->feedTable;
+  computed = ant->fieldComputed;
+  range[0] = ant->max_current_mag;
+  range[1] = ant->min_current_mag;
+  range[2] = ant->max_current_phase;
+  range[3] = ant->min_current_phase;
+  SwapCurrents(ant, saved);
+  for (p = 0; ok && p < set->ports; p++) {
+    if ((fin = fopen(out[p], "rt")) == NULL) {
+      ok = false;
+      break;
+    }  /**  Error state  **/
+    memset(&part, 0, sizeof(part));
+    ant->fieldData = &part;
+    ant->feedTable = NULL;
+    FreeCurrents(ant);
+    ParseFieldData(fin, ant, plan[p], true, true);
+    fclose(fin);
+    ok = PT_Capture(set, p, ant);
+    free(part.vals);
+    FreeFeedTable(ant);
+    ant->fieldData = field;
+    ant->feedTable = table;
+  }  /**  For each port  **/
+  ant->fieldComputed = computed;
+  for (p = 0; p < set->ports; p++) {
+    SY_Free(plan[p]);
+    remove(deck[p]);
+    remove(out[p]);
+  }  /**  Tidy up  **/
+
+  /**  The last port's currents, in NEC's layout, take the combined ones  **/
+  ok = ok && PT_Combine(set, ant);
+  if (ok) {
+    SwapCurrents(ant, saved);
+    FreeCurrents(ant);
+    SwapCurrents(ant, saved);
+  } else {
+    FreeCurrents(ant);
+    SwapCurrents(ant, saved);
+    ant->max_current_mag = range[0];
+    ant->min_current_mag = range[1];
+    ant->max_current_phase = range[2];
+    ant->min_current_phase = range[3];
+  }  /**  Keep one set of currents  **/
+  free(saved);
+  if (!ok) {
+    fprintf(stderr, "Ports could not be solved one at a time\n");
+    PT_Free(set);
+    return 0;
+  }  /**  Error state  **/
+
+  PT_Free(ant->ports);
+  ant->ports = set;
+  curr_step_size = STEP_SIZE;
+  RFPowerDensityOn = true;
+  FieldDataComputed = true;
+  return set->ports;
+
+}  /**  End of SolvePorts  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               SteerPorts                                **/
+/**                                                                         **/
+/**  Drives the first n ports SolvePorts solved with amplitude (volts) and  **/
+/**  phase (degrees) and makes the superposed field, currents and feed      **/
+/**  table those of the current antenna.  Ports past n keep their drive.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+bool SteerPorts(int n, const double *amplitude, const double *phase) {
+
+  PT_Set     *set;    /**  Current antenna's ports  **/
+  FieldData  *fd;     /**  Its new field            **/
+  double      start;  /**  Timer start              **/
+  int         p;      /**  Loop counter             **/
+
+  if ((set = CurrentPorts()) == NULL)
+    return false;
+  for (p = 0; p < n && p < set->ports; p++) {
+    set->amplitude[p] = amplitude[p];
+    set->phase[p] = phase[p];
+  }  /**  New drive  **/
+
+  start = TM_Start();
+  if (!PT_Combine(set, &TheAnts.ants[TheAnts.curr_ant]))
+    return false;
+  TM_Stop(TM_FAR_FIELD, start);
+
+  /**  The mesh is indexed by the step the ports were solved at  **/
+  fd = TheAnts.ants[TheAnts.curr_ant].fieldData;
+  if (fd->count > 1 && fd->vals[1].theta > fd->vals[0].theta)
+    curr_step_size = fd->vals[1].theta - fd->vals[0].theta;
+  return true;
+
+}  /**  End of SteerPorts  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              CurrentPorts                               **/
+/**                                                                         **/
+/**  The per port solves of the current antenna, NULL if there are none.    **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+PT_Set *CurrentPorts(void) {
+
+  if (AntennasInScene == false)
+    return NULL;
+  return TheAnts.ants[TheAnts.curr_ant].ports;
+
+}  /**  End of CurrentPorts  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           StudySegmentation                             **/
+/**                                                                         **/
+/**  Solves the current antenna at each density of a CV_Plan together,     **/
+/**  compares them and keeps the study for ApplySegmentation.  Densities    **/
+/**  DC_Check refuses are skipped, all but the deck's own.  Each density    **/
+/**  is read into a scratch field; only once the study succeeds is the      **/
+/**  antenna given the field, inputs and currents of its own segmentation   **/
+/**  and its ports dropped.  NULL if nothing was studied, with the reason   **/
+/**  on the terminal, and the antenna as it was.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+CV_Study *StudySegmentation(void) {
+
+  Ant        *ant;                  /**  Current antenna         **/
+  CV_Study   *study;                /**  Its densities           **/
+  SY_Plan    *plan[CV_LEVELS];      /**  Symmetry of each deck   **/
+  DC_Report   report;               /**  Of each density         **/
+  FieldData   part;                 /**  Field of one density    **/
+  FieldData  *field;                /**  Antenna's own field     **/
+  FeedTable  *table;                /**    ..and inputs          **/
+  bool        computed;             /**    ..and if it had any   **/
+  FILE       *fin;                  /**  Solver output           **/
+  char        deck[CV_LEVELS][32];  /**  Input file per density  **/
+  char        out[CV_LEVELS][32];   /**  Output file per density **/
+  char        note[128];            /**  Why there is no study   **/
+  int         level[CV_LEVELS];     /**  Density of each deck    **/
+  int         decks;                /**  Decks written           **/
+  bool        ok;                   /**  All solves went         **/
+  double      start;                /**  Timer start             **/
+  int         i;                    /**  Loop counter            **/
+  int         k;                    /**  Loop counter            **/
+
+  CV_Free(Study);
+  Study = NULL;
+  if (AntennasInScene == false)
+    return NULL;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (CheckScene(ant->frequency) == false)
+    return NULL;
+  if ((study = CV_Plan(ant, note, sizeof(note))) == NULL) {
+    fprintf(stderr, "No segmentation study: %s\n", note);
+    return NULL;
+  }  /**  Cannot be studied  **/
+
+  start = TM_Start();
+  curr_step_size = STEP_SIZE;
+  decks = 0;
+  for (k = 0; k < study->levels; k++) {
+    plan[k] = NULL;
+    if (!CV_Use(study, ant, k)) {
+      snprintf(study->level[k].note, sizeof(study->level[k].note),
+               "out of memory");
+      continue;
+    }  /**  Cards not moved  **/
+    if (k != study->original && DC_Check(&ant, 1, ant->frequency, 
+                                         &report) > 0) {
+      snprintf(study->level[k].note, sizeof(study->level[k].note), "%s",
+               DC_FirstError(&report));
+      continue;
+    }  /**  Not worth a solve  **/
+    sprintf(deck[decks], "study%d_in.nec", k);
+    sprintf(out[decks], "study%d_out.nec", k);
+    remove(out[decks]);
+    plan[k] = WriteCardFile(deck[decks], ant, STEP_SIZE, ant->frequency);
+    level[decks++] = k;
+  }  /**  For each density  **/
+  CV_Restore(study, ant);
+  ok = decks > 0 && SolveDecks(decks, deck, out);
+  TM_Stop(TM_SOLVER, start);
+
+  /**  Read each density into a scratch field, keeping the antenna's  **/
+  field = ant->fieldData;
+  table = ant->feedTable;
+  computed = ant->fieldComputed;
+  for (i = 0; ok && i < decks; i++) {
+    if ((fin = fopen(out[i], "rt")) == NULL) {
+      ok = false;
+      break;
+    }  /**  Error state  **/
+    memset(&part, 0, sizeof(part));
+    ant->fieldData = &part;
+    ant->feedTable = NULL;
+    CV_Use(study, ant, level[i]);
+    ParseFieldData(fin, ant, plan[level[i]], true, false);
+    fclose(fin);
+    CV_Capture(study, level[i], ant);
+    CV_Restore(study, ant);
+    free(part.vals);
+    FreeFeedTable(ant);
+    ant->fieldData = field;
+    ant->feedTable = table;
+  }  /**  For each density  **/
+  ant->fieldComputed = computed;
+
+  /**  Back to the field and currents of the deck's own segments  **/
+  for (i = 0; i < decks && level[i] != study->original; i++)
+    ;
+  ok = ok && i < decks && study->level[study->original].solved;
+  if (ok && (fin = fopen(out[i], "rt")) != NULL) {
+    PT_Free(ant->ports);
+    ant->ports = NULL;
+    ParseFieldData(fin, ant, plan[study->original], true, true);
+    fclose(fin);
+    ant->solvedSerial = ant->fieldData->serial;
+    ant->resampleError = -1.0;
+    RFPowerDensityOn = true;
+    FieldDataComputed = true;
+  } else
+    ok = false;
+  for (k = 0; k < study->levels; k++)
+    SY_Free(plan[k]);
+  for (i = 0; i < decks; i++) {
+    remove(deck[i]);
+    remove(out[i]);
+  }  /**  Tidy up  **/
+
+  if (!ok) {
+    fprintf(stderr, "Segmentation study could not be solved\n");
+    CV_Free(study);
+    return NULL;
+  }  /**  Error state  **/
+  CV_Choose(study);
+  CV_Print(stdout, study);
+  Study = study;
+  StudyAnt = TheAnts.curr_ant;
+  return study;
+
+}  /**  End of StudySegmentation  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           ApplySegmentation                             **/
+/**                                                                         **/
+/**  Gives the current antenna the cheapest segmentation its last study     **/
+/**  found within tolerance, so every later solve of it costs no more       **/
+/**  than it must.  Returns its segments in all, 0 if there was no study    **/
+/**  of this antenna or it found none.                                      **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+int ApplySegmentation(void) {
+
+  Ant  *ant;       /**  Current antenna  **/
+  int   segments;  /**  It now has       **/
+
+  if (AntennasInScene == false || Study == NULL || Study->best < 0 ||
+      StudyAnt != TheAnts.curr_ant)
+    return 0;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (!CV_Keep(Study, ant, Study->best))
+    return 0;
+  segments = Study->level[Study->best].segments;
+  CV_Free(Study);
+  Study = NULL;
+
+  PT_Free(ant->ports);
+  ant->ports = NULL;
+  ant->fieldComputed = false;
+  printf("Segmentation applied: %d segments\n", segments);
+  return segments;
+
+}  /**  End of ApplySegmentation  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            CurrentFeedTable                             **/
+/**                                                                         **/
+/**  The input parameters of the current antenna from its last solve,       **/
+/**  NULL if there are none.                                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+FeedTable *CurrentFeedTable(void) {
+
+  Ant  *ant;  /**  Current antenna  **/
+
+  if (AntennasInScene == false)
+    return NULL;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (ant->feedTable == NULL || ant->feedTable->count == 0)
+    return NULL;
+  return ant->feedTable;
+
+}  /**  End of CurrentFeedTable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            CurrentSweepTable                            **/
+/**                                                                         **/
+/**  The input parameters of the current antenna from its last sweep,       **/
+/**  NULL if it has not been swept.                                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+FeedTable *CurrentSweepTable(void) {
+
+  Ant  *ant;  /**  Current antenna  **/
+
+  if (AntennasInScene == false)
+    return NULL;
+  ant = &TheAnts.ants[TheAnts.curr_ant];
+  if (ant->sweepTable == NULL || ant->sweepTable->count == 0)
+    return NULL;
+  return ant->sweepTable;
+
+}  /**  End of CurrentSweepTable  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
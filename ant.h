@@ -75,8 +75,21 @@ typedef struct {
   GLfloat  g;      /**  Green color value   **/
   GLfloat  b;      /**  Blue color value    **/
   GLfloat  a;      /**  Transparency value  **/
+  GLfloat  nx;     /**  Unit normal in x    **/
+  GLfloat  ny;     /**  Unit normal in y    **/
+  GLfloat  nz;     /**  Unit normal in z    **/
 } MeshPoint;
 
+typedef struct MeshKey {
+  long    serial;      /**  FieldData serial, 0 if no mesh  **/
+  int     increments;  /**  Mesh rows and columns           **/
+  int     colour;      /**  Colour mode                     **/
+  bool    use_gain;    /**  Gain surface or unit sphere     **/
+  double  offset;      /**  Added to every radius           **/
+  double  scale;       /**  POINT_DIST_SCALE at build time  **/
+  double  threshold;   /**  NULL_THRESHOLD at build time    **/
+} MeshKey;
+
 typedef struct SegmentData {
   float               currentMagnitude;  /**  Magnitude of current in amps  **/
   float               currentPhase;      /**  Phase of the current wave     **/
@@ -89,6 +102,7 @@ typedef struct Tube {
   int          type;      /**  Is it a tube or a wall        **/
   int          segments;  /**  Number of segment NEC uses    **/
   double       width;     /**  Thickness of the tube         **/
+  int          index;     /**  Its wire in WireIndex.c       **/
   SegmentData *currents;  /**  Currents                      **/
   struct Tube *next;      /**  Pointer to next tube in list  **/
 } Tube;
@@ -117,8 +131,23 @@ typedef struct FieldData {
   double    mintilt;        /**  Minimum value of polarization tilt  **/
   double    maxaxialratio;  /**  Maximum axial ratio                 **/
   double    minaxialratio;  /**  Minimum axial ratio                 **/
+  long      serial;         /**  New value each time vals is filled  **/
 } FieldData;
 
+typedef struct FeedTable {
+  int      count;        /**  Rows, one per source per frequency  **/
+  int      allocated;    /**  Rows the columns have room for      **/
+  double  *frequency;    /**  MHz                                 **/
+  int     *tag;          /**  Wire tag of the source              **/
+  int     *segment;      /**  Segment of the source               **/
+  double  *resistance;   /**  Input impedance, real part, ohms    **/
+  double  *reactance;    /**  Input impedance, imaginary part     **/
+  double  *power;        /**  Input power, watts                  **/
+} FeedTable;
+
+struct PT_Set;                      /**  Ports.h  **/
+struct SY_Plan;                     /**  Symmetry.h  **/
+
 typedef struct Ant {
   int        tube_count;             /**  Number of elements in antenna  **/ 
   int        card_count;             /**  Number of cards in .nec file   **/
@@ -137,11 +166,21 @@ typedef struct Ant {
   double     max_current_phase;      /**  Maximum current phase          **/
   double     min_current_phase;      /**  Minimum current phase          **/
   MeshPoint  surfaceMesh[361][361];  /**  Triangular mesh                **/
+  MeshKey    meshKey;                /**  What surfaceMesh was built for **/
+  double     meshRadius;             /**  Largest radius in surfaceMesh  **/
   FieldData *fieldData;              /**  Field data for this antenna    **/
+  FeedTable *feedTable;              /**  Input parameters, per freq     **/
+  FeedTable *sweepTable;             /**    ..of the last sweep          **/
+  struct PT_Set *ports;              /**  Per port solves, Ports.h       **/
   bool       fieldComputed;          /**  Field data computed yet        **/
+  long       solvedSerial;           /**  Serial of NEC's own field     **/
+  double     resampleError;          /**  Its FF_Residual, -1 unchecked **/
   double     visual_scale;           /**  Visual scale factor            **/
 } Ant;
 
+struct FA_Result;                   /**  FieldAnalysis.h  **/
+struct CV_Study;                    /**  Convergence.h  **/
+
 typedef   struct AntArray {
   int  ant_count;           /**  Number of antennas in scene  **/
   int  curr_ant;            /**  The current antenna          **/
@@ -159,13 +198,18 @@ typedef   struct AntArray {
 
 
 void    InsertTube(Ant *, Tube *);
+void    InitAnt(Ant *);
 void    SetPoint(Point *, double, double, double);
 double  sqr(double);
 double  PointDist(Point, Point);
 void    ToggleDrawMode(int);
+void    InitDisplay(void);
 void    ChangeFrequency(double);
 void    DisplaySelectedAnt(Ant *, GLint, GLint, bool);
-void    DisplayAnt(GLint, GLint);
+void    DisplayAntWires(GLint, GLint);
+void    SavePickView(void);
+int     PickTube(int, int);
+void    DisplayAntField(void);
 void    ReadFile(CONST84 char *);
 void    MoveCurrentTube(double, double, double);
 void    MoveCurrentWall(double, double, double);
@@ -176,10 +220,25 @@ void    ScaleCurrentWall(double, double, double);
 void    ScaleCurrentTube(double, double);
 void    ChangeCurrentTube(int);
 void    ChangeCurrentAnt(int);
-void    GenerateNECFile(CONST84 char *);
+struct SY_Plan *GenerateNECFile(CONST84 char *);
 void    AddWall(void);
-void    ComputeField(bool);
+bool    ComputeField(bool);
+bool    ComputeSweep(double, double);
+bool    SetThreads(int);
+bool    SampleFarField(double, double, double, int, int, FieldData *);
+bool    ResampleField(int);
+bool    SavePattern(CONST84 char *);
+bool    LoadPattern(CONST84 char *);
+bool    AnalyzePattern(struct FA_Result *);
+int     SolvePorts(void);
+bool    SteerPorts(int, const double *, const double *);
+struct PT_Set *CurrentPorts(void);
+struct CV_Study *StudySegmentation(void);
+int     ApplySegmentation(void);
+FeedTable *CurrentFeedTable(void);
+FeedTable *CurrentSweepTable(void);
 void    DeleteCurrentAnt(void);
+void    ClearScene(void);
 
 #endif
 
@@ -201,6 +201,54 @@ proc CreateUserInterface {} {
          -font $font 
   pack $WsaveFileButton -side top -pady $pad
 
+  set WsavePatternButton $WFileControlFrame.savePatternButton
+  button $WsavePatternButton -relief $relief -text "Save Pattern" \
+         -command "SavePattern $WAntenna" \
+         -font $font 
+  pack $WsavePatternButton -side top -pady $pad
+
+  set WloadPatternButton $WFileControlFrame.loadPatternButton
+  button $WloadPatternButton -relief $relief -text "Load Pattern" \
+         -command "LoadPattern $WAntenna" \
+         -font $font 
+  pack $WloadPatternButton -side top -pady $pad
+
+  set WanalyzeButton $WFileControlFrame.analyzeButton
+  button $WanalyzeButton -relief $relief -text "Pattern Figures" \
+         -command "PatternFigures $WAntenna" \
+         -font $font 
+  pack $WanalyzeButton -side top -pady $pad
+
+  set WsweepButton $WFileControlFrame.sweepButton
+  button $WsweepButton -relief $relief -text "SWR Sweep" \
+         -command "SWRSweep $WAntenna" \
+         -font $font 
+  pack $WsweepButton -side top -pady $pad
+
+  set WportsButton $WFileControlFrame.portsButton
+  button $WportsButton -relief $relief -text "Port Phases" \
+         -command "PortPhases $WAntenna" \
+         -font $font 
+  pack $WportsButton -side top -pady $pad
+
+  set WconvergeButton $WFileControlFrame.convergeButton
+  button $WconvergeButton -relief $relief -text "Segmentation" \
+         -command "SegmentationStudy $WAntenna" \
+         -font $font 
+  pack $WconvergeButton -side top -pady $pad
+
+  set WsaveSessionButton $WFileControlFrame.saveSessionButton
+  button $WsaveSessionButton -relief $relief -text "Save Session" \
+         -command "SaveSession $WAntenna" \
+         -font $font 
+  pack $WsaveSessionButton -side top -pady $pad
+
+  set WrestoreSessionButton $WFileControlFrame.restoreSessionButton
+  button $WrestoreSessionButton -relief $relief -text "Restore Session" \
+         -command "RestoreSession $WAntenna" \
+         -font $font 
+  pack $WrestoreSessionButton -side top -pady $pad
+
   set WsaveImageButton $WFileControlFrame.saveImageButton
   button $WsaveImageButton -relief $relief -text "Save As EPS Image" \
          -command "SaveRGBImage $WAntenna" \
@@ -249,6 +297,10 @@ proc CreateUserInterface {} {
          -font $font 
   pack $Wdraw_RFPowerDensityButton -side top -pady $pad
 
+  set SolveProgress ""
+  label $WVisControlFrame.progress -textvariable SolveProgress -font $font
+  pack $WVisControlFrame.progress -side top
+
   set MultAntsVariable 0
   set SingleAntButton $WVisControlFrame.single_ant_button
   radiobutton $SingleAntButton -text "Current Antenna" -font $font \
@@ -265,6 +317,20 @@ proc CreateUserInterface {} {
                         $MultAntsVariable}
   pack $MultipleAntButton -side top
 
+  set UseSymmetry 1
+  set SymmetryButton $WVisControlFrame.symmetry_button
+  checkbutton $SymmetryButton -text "Use Symmetry" -font $font \
+              -variable UseSymmetry \
+              -command {$WAntenna change_mode "Symmetry" $UseSymmetry}
+  pack $SymmetryButton -side top
+
+  set CheckDecks 1
+  set CheckDecksButton $WVisControlFrame.check_decks_button
+  checkbutton $CheckDecksButton -text "Check Decks" -font $font \
+              -variable CheckDecks \
+              -command {$WAntenna change_mode "CheckDecks" $CheckDecks}
+  pack $CheckDecksButton -side top
+
 
   ###########################################################################
   ###########################################################################
@@ -583,6 +649,18 @@ proc CreateUserInterface {} {
   $WGFreqSteps.slider set 5
   pack $WGFreqSteps -side bottom -fill x
 
+  set WGClusterSpacing $WGScalesFrame.cluster_spacing
+  lscale2 $WGClusterSpacing "Cluster Spacing" "ClusterSpacing" \
+  horizontal 0 20 
+  $WGClusterSpacing.slider set 0
+  pack $WGClusterSpacing -side bottom -fill x
+
+  set WGSolverMemory $WGScalesFrame.solver_memory
+  lscale2 $WGSolverMemory "Solver Memory" "SolverMemory" \
+  horizontal 0 64 
+  $WGSolverMemory.slider set 0
+  pack $WGSolverMemory -side bottom -fill x
+
   pack $WGScalesFrame -side top -fill x \
       -padx $pad -pady $pad -ipadx $pad -ipady $pad
 
@@ -698,11 +776,17 @@ proc ValueUpdate {newpos oldpos valpp minval maxval cyclic command} {
 
 proc MouseButtonAntenna {x y button window} {
 
-  global MouseX MouseY
+  global MouseControl MouseX MouseY
 
   set MouseX $x
   set MouseY $y
 
+  # a press on an element or wall makes it the one the drag works on
+  if {[string match "Element*" $MouseControl] || \
+      [string match "Wall*" $MouseControl]} {
+    $window pick_tube $x $y
+  }
+
 }
 
 
@@ -1545,6 +1629,290 @@ proc SaveFile {WAntenna} {
 }
 
 
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                 SavePattern                               ##
+##                                                                           ##
+##  Saves the computed field of the current antenna as a binary pattern      ##
+##  file.                                                                    ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc SavePattern {WAntenna} {
+
+  set file_name [GetValue "Please Enter File Name"]
+
+  if {[string length $file_name] > 0} {
+    catch {$WAntenna save_pattern $file_name}
+  }
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                 LoadPattern                               ##
+##                                                                           ##
+##  Reopens a saved pattern file as the field of the current antenna.        ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc LoadPattern {WAntenna} {
+
+  set file_name [fileselect "File Selection" "*.pat"]
+
+  if {[string length $file_name] > 0} {
+    catch {$WAntenna load_pattern $file_name}
+  }
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                               PatternFigures                              ##
+##                                                                           ##
+##  Shows the figures of merit of the computed field.                        ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc PatternFigures {WAntenna} {
+
+  if {[catch {$WAntenna analyze} figures]} {
+    tk_messageBox -icon info -title "Pattern Figures" \
+                  -message "Compute the RF field first."
+    return
+  }
+  array set f $figures
+
+  set text [format "Peak gain %.2f dBi at theta %.0f, phi %.0f\n" \
+                   $f(gain) $f(theta) $f(phi)]
+  append text [format "Directivity %.2f dBi, efficiency %.1f %%\n" \
+                      $f(directivity) [expr {100.0 * $f(efficiency)}]]
+  append text [format "Radiated power %.4g W\n" $f(radiated)]
+  append text [format "Front to back %.2f dB, front to rear %.2f dB\n" \
+                      $f(front_to_back) $f(front_to_rear)]
+  append text [format "Beamwidth %.1f deg in phi, %.1f deg in theta\n" \
+                      $f(beamwidth_az) $f(beamwidth_el)]
+  append text [format "First sidelobe %.2f dB in phi, %.2f dB in theta\n" \
+                      $f(sidelobe_az) $f(sidelobe_el)]
+  append text "\n-999.99 means the pattern has no such figure."
+  tk_messageBox -icon info -title "Pattern Figures" -message $text
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                  SWRSweep                                 ##
+##                                                                           ##
+##  Sweeps the current antenna over Frequency Steps frequencies, 5% either   ##
+##  side of its own, and shows the feedpoint impedance and 50 ohm SWR.       ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc SWRSweep {WAntenna} {
+
+  if {[catch {$WAntenna sweep} err]} {
+    tk_messageBox -icon error -title "SWR Sweep" -message $err
+    return
+  }
+
+  set text [format "%9s %4s %4s %10s %10s %7s\n" \
+                   MHz Tag Seg "R ohms" "X ohms" SWR]
+  foreach row [$WAntenna sweep_table 50] {
+    foreach {freq tag seg r x swr power} $row break
+    append text [format "%9.4f %4d %4d %10.3f %10.3f %7.2f\n" \
+                        $freq $tag $seg $r $x $swr]
+  }
+  tk_messageBox -icon info -title "SWR Sweep" -message $text
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                 PortPhases                                ##
+##                                                                           ##
+##  Solves the current antenna once per voltage source, then opens sliders   ##
+##  for the amplitude and phase of each that redraw the pattern as they      ##
+##  move, from the stored solutions rather than by running NEC2 again.       ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc PortPhases {WAntenna} {
+
+  global font portDrive
+
+  if {[catch {$WAntenna solve_ports} err]} {
+    tk_messageBox -icon error -title "Port Phases" -message $err
+    return
+  }
+
+  catch {destroy .ports}
+  set t [toplevel .ports -borderwidth 10]
+  wm title $t "Port Phases"
+  set p 0
+  foreach row [$WAntenna ports] {
+    foreach {tag seg amp phase} $row break
+    set portDrive(amp,$p) $amp
+    set portDrive(phase,$p) $phase
+    set f [frame $t.port$p]
+    label $f.label -text "Tag $tag Seg $seg" -font $font
+    scale $f.amp -orient horizontal -from 0.0 -to 2.0 -resolution 0.05 \
+      -label Volts -variable portDrive(amp,$p) -length 200 -font $font \
+      -command "SteerPorts $WAntenna"
+    scale $f.phase -orient horizontal -from -180 -to 180 -resolution 1 \
+      -label Degrees -variable portDrive(phase,$p) -length 200 \
+      -font $font -command "SteerPorts $WAntenna"
+    pack $f.label -side top -anchor w
+    pack $f.amp $f.phase -side left
+    pack $f -side top -fill x -pady 4
+    incr p
+  }
+  set portDrive(count) $p
+  button $t.close -text Close -command "destroy $t" -font $font
+  pack $t.close -side top
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                             SegmentationStudy                             ##
+##                                                                           ##
+##  Solves the current antenna at several segment densities together and     ##
+##  shows how far each is from the finest.  If a coarser one agrees within   ##
+##  tolerance, offers to give the antenna the cheapest that does.            ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc SegmentationStudy {WAntenna} {
+
+  if {[catch {$WAntenna converge} rows]} {
+    tk_messageBox -icon error -title "Segmentation" -message $rows
+    return
+  }
+
+  set text [format "%7s %9s %8s %8s %8s\n" \
+                   Factor Segments "Gain dB" "|Z| %" "Pat. dB"]
+  set best ""
+  foreach row $rows {
+    foreach {factor segs dgain dz dpat within isbest deck} $row break
+    set mark ""
+    if {$deck} {append mark " deck"}
+    if {$isbest} {
+      append mark " best"
+      set best $segs
+    }
+    append text [format "%7.2f %9d %8.3f %8.2f %8.3f%s\n" \
+                        $factor $segs $dgain [expr {100.0 * $dz}] $dpat $mark]
+  }
+  if {$best == ""} {
+    append text "\nNo coarser density agrees with the finest."
+    tk_messageBox -icon info -title "Segmentation" -message $text
+    return
+  }
+
+  append text "\nUse $best segments for this antenna?"
+  if {[tk_messageBox -icon question -type yesno -title "Segmentation" \
+                     -message $text] == "yes"} {
+    if {[catch {$WAntenna converge apply} err]} {
+      tk_messageBox -icon error -title "Segmentation" -message $err
+    }
+  }
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                 SteerPorts                                ##
+##                                                                           ##
+##  Drives the solved ports as the Port Phases sliders are set.              ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc SteerPorts {WAntenna args} {
+
+  global portDrive
+
+  set drive {}
+  for {set p 0} {$p < $portDrive(count)} {incr p} {
+    lappend drive $portDrive(amp,$p) $portDrive(phase,$p)
+  }
+  if {[llength $drive] > 0} {
+    catch {eval $WAntenna steer $drive}
+  }
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                 SaveSession                               ##
+##                                                                           ##
+##  Saves every antenna, its field and the view as a session file.           ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc SaveSession {WAntenna} {
+
+  set file_name [GetValue "Please Enter File Name"]
+
+  if {[string length $file_name] > 0} {
+    catch {$WAntenna save_session $file_name}
+  }
+
+}
+
+
+###############################################################################
+###############################################################################
+##                                                                           ##
+##                                RestoreSession                             ##
+##                                                                           ##
+##  Puts back a saved session without running NEC2.                          ##
+##                                                                           ##
+###############################################################################
+###############################################################################
+
+
+proc RestoreSession {WAntenna} {
+
+  set file_name [fileselect "File Selection" "*.session"]
+
+  if {[string length $file_name] > 0} {
+    catch {$WAntenna restore_session $file_name}
+  }
+
+}
+
+
 ###############################################################################
 ###############################################################################
 ##                                                                           ##
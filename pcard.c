@@ -32,6 +32,8 @@
 #include <string.h>
 #include "ant.h"
 #include "pcard.h"
+#include "Timing.h"
+#include "Symmetry.h"
 
 
 /*****************************************************************************/
@@ -46,6 +48,9 @@
 extern double    curr_step_size;  /**  Current step size         **/
 extern int       FreqSteps;       /**  Frequency steps           **/
 extern AntArray  TheAnts;         /**  The antennas' geometries  **/
+extern int       UseSymmetry;     /**  Write GX and GR cards     **/
+
+local long       PatternSerial = 0;  /**  Last FieldData serial used  **/
 
 
 /*****************************************************************************/
@@ -280,13 +285,462 @@ void PrintTubeOffset(FILE *f,
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
-/**                            WriteCardFile                                **/
+/**                               TubeOffset                                **/
+/**                                                                         **/
+/**  Segments before tube n (counted from 1) in the antenna's own deck,     **/
+/**  where NEC numbers them over the whole structure.  -1 if there is no    **/
+/**  such tube.                                                             **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local int TubeOffset(const Ant *ant, int n) {
+
+  Tube  *tube;    /**  Current tube    **/
+  int    offset;  /**  Segments so far **/
+
+  offset = 0;
+  for (tube = ant->first_tube; tube != NULL && n > 1; tube = tube->next) {
+    offset += tube->segments;
+    n--;
+  }  /**  Tubes before  **/
+  return (tube != NULL && n == 1) ? offset : -1;
+
+}  /**  End of TubeOffset  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               MapSegment                                **/
+/**                                                                         **/
+/**  Where segment seg of tag is in the plan's deck, tag 0 counting over    **/
+/**  the whole structure as NEC does.                                       **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local bool MapSegment(const Ant *ant, const SY_Plan *plan, int tag, int seg,
+                      int *deck_tag, int *deck_seg, bool *reversed) {
+
+  Tube  *tube;  /**  Current tube  **/
+
+  if (tag == 0) {
+    for (tube = ant->first_tube; tube != NULL && seg > tube->segments;
+         tube = tube->next) {
+      seg -= tube->segments;
+      tag++;
+    }  /**  Tubes before  **/
+    tag++;
+  }  /**  Absolute segment number  **/
+  return SY_ToDeck(plan, tag, seg, deck_tag, deck_seg, reversed);
+
+}  /**  End of MapSegment  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               LoadRange                                 **/
+/**                                                                         **/
+/**  The segments of its tag an LD card loads, from NEC's rules: both 0     **/
+/**  for the whole wire, a last of 0 for the first alone.                   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void LoadRange(const Ant *ant, const int *ld, int *first, int *last) {
+
+  Tube  *tube;  /**  The loaded tube  **/
+  int    n;     /**  Loop counter     **/
+
+  for (tube = ant->first_tube, n = 1; tube != NULL && n < ld[1]; n++)
+    tube = tube->next;
+  *first = ld[2];
+  *last = ld[3];
+  if (*first == 0 && *last == 0) {
+    *first = 1;
+    *last = (tube != NULL) ? tube->segments : 0;
+  } else if (*last == 0)
+    *last = *first;
+
+}  /**  End of LoadRange  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              DeckSymmetry                               **/
+/**                                                                         **/
+/**  The symmetry nec2 can be given for the antenna's deck, or NULL.        **/
+/**  Cards that name segments other than by EX and LD, patches, GM cards    **/
+/**  that do more than move the whole structure, and loads that differ      **/
+/**  between a piece and its copies all rule it out, as NEC assumes every   **/
+/**  copy is loaded as the piece it was made from.                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Plan *DeckSymmetry(Ant *ant) {
+
+  SY_Plan        *plan;       /**  The symmetry         **/
+  const SY_Piece *p;          /**  Current piece        **/
+  unsigned long  *sig;        /**  Loads, per segment   **/
+  unsigned long   h;          /**  One load's hash      **/
+  int            *start;      /**  Pieces' first segs   **/
+  char           *card;       /**  Current card         **/
+  char            note[128];  /**  Why there is none    **/
+  char            text[64];   /**  A load, for hashing  **/
+  char           *c;          /**  Into text            **/
+  int             ld[4];      /**  LD integers          **/
+  double          z[3];       /**  LD values            **/
+  int             ex[4];      /**  EX integers          **/
+  double          gm[7];      /**  GM values            **/
+  int             tag;        /**  In the deck          **/
+  int             seg;        /**    ..and segment      **/
+  bool            reversed;   /**  Runs the other way   **/
+  int             first;      /**  Loaded segments      **/
+  int             last;
+  int             total;      /**  Deck segments        **/
+  bool            same;       /**  Loads match so far   **/
+  int             i;          /**  Loop counter         **/
+  int             j;          /**  Loop counter         **/
+  int             k;          /**  Loop counter         **/
+
+  for (i = 0; i < ant->card_count; i++) {
+    card = ant->cards[i];
+    if (card[0] == 'G' && card[1] == 'M' &&
+        (sscanf(card + 2, "%d%d%lf%lf%lf%lf%lf%lf%lf", &ex[0], &ex[1],
+                &gm[0], &gm[1], &gm[2], &gm[3], &gm[4], &gm[5], 
+                &gm[6]) != 9 || ex[0] != 0 || ex[1] != 0 || gm[0] != 0.0 ||
+         gm[1] != 0.0 || gm[2] != 0.0 || gm[6] != 0.0))
+      return NULL;
+    if ((card[0] == 'G' && card[1] != 'W' && card[1] != 'E' && 
+         card[1] != 'N' && card[1] != 'S' && card[1] != 'M') ||
+        (card[0] == 'S' && (card[1] == 'P' || card[1] == 'M' || 
+                            card[1] == 'C')) ||
+        (card[0] == 'N' && card[1] == 'T') ||
+        (card[0] == 'T' && card[1] == 'L') ||
+        (card[0] == 'C' && card[1] == 'P'))
+      return NULL;
+    if (card[0] == 'P' && (card[1] == 'T' || card[1] == 'Q') &&
+        sscanf(card + 2, "%d%d", &ex[0], &ex[1]) == 2 && ex[1] != 0)
+      return NULL;
+    if (card[0] == 'L' && card[1] == 'D' &&
+        (sscanf(card + 2, "%d%d%d%d", &ld[0], &ld[1], &ld[2], &ld[3]) != 4 ||
+         ld[0] < 0 || (ld[1] == 0 && (ld[2] != 0 || ld[3] != 0))))
+      return NULL;
+  }  /**  Cards nec2 would see differently  **/
+
+  if ((plan = SY_Find(ant->first_tube, ant->ground_specified, note,
+                      sizeof(note))) == NULL) {
+    if (note[0] != '\0')
+      printf("No symmetry for nec2: %s\n", note);
+    return NULL;
+  }  /**  None  **/
+
+  for (i = 0; i < ant->card_count; i++) {
+    card = ant->cards[i];
+    if (card[0] == 'E' && card[1] == 'X' &&
+        sscanf(card + 2, "%d%d%d", &ex[0], &ex[1], &ex[2]) == 3 &&
+        (ex[0] == 0 || ex[0] == 5) &&
+        !MapSegment(ant, plan, ex[1], ex[2], &tag, &seg, &reversed)) {
+      SY_Free(plan);
+      return NULL;
+    }  /**  Source on no segment  **/
+  }  /**  For each card  **/
+
+  /**  Loads hashed onto the deck's segments, then copies against pieces  **/
+  start = (int *) malloc((plan->count + 1) * sizeof(int));
+  if (start == NULL) {
+    SY_Free(plan);
+    return NULL;
+  }  /**  No room  **/
+  start[0] = 0;
+  for (k = 0; k < plan->count; k++)
+    start[k + 1] = start[k] + plan->pieces[k].segments;
+  total = start[plan->count];
+  if ((sig = (unsigned long *) calloc(total, sizeof(unsigned long))) == 
+      NULL) {
+    free(start);
+    SY_Free(plan);
+    return NULL;
+  }  /**  No room  **/
+  for (i = 0; i < ant->card_count; i++) {
+    card = ant->cards[i];
+    if (card[0] != 'L' || card[1] != 'D')
+      continue;
+    z[0] = z[1] = z[2] = 0.0;
+    sscanf(card + 2, "%d%d%d%d%lf%lf%lf", &ld[0], &ld[1], &ld[2], &ld[3],
+           &z[0], &z[1], &z[2]);
+    if (ld[1] == 0)
+      continue;
+    snprintf(text, sizeof(text), "%d %.6g %.6g %.6g", ld[0], z[0], z[1], 
+             z[2]);
+    for (h = 2166136261UL, c = text; *c != '\0'; c++)
+      h = (h ^ (unsigned char) *c) * 16777619UL;
+    LoadRange(ant, ld, &first, &last);
+    for (k = 0; k < plan->count; k++) {
+      p = &plan->pieces[k];
+      if (p->tube != ld[1])
+        continue;
+      for (j = first; j <= last; j++)
+        if (j > p->first && j <= p->first + p->segments)
+          sig[start[k] + (p->reversed ? p->first + p->segments - j 
+                                      : j - p->first - 1)] += h;
+    }  /**  For each piece of the tube  **/
+  }  /**  For each load  **/
+  same = true;
+  for (k = plan->base; k < plan->count && same; k++)
+    for (j = 0; j < plan->pieces[k].segments && same; j++)
+      same = (sig[start[k] + j] == sig[start[k % plan->base] + j]);
+  free(sig);
+  free(start);
+  if (!same) {
+    printf("No symmetry for nec2: the loads are not symmetric\n");
+    SY_Free(plan);
+    return NULL;
+  }  /**  Copies loaded differently  **/
+
+  if (plan->planes != 0)
+    printf("Deck mirrored in%s%s%s, nec2's matrix %d times smaller\n",
+           (plan->planes >= 100) ? " x = 0" : "",
+           (plan->planes / 10 % 10) ? " y = 0" : "",
+           (plan->planes % 10) ? " z = 0" : "", plan->count / plan->base);
+  else
+    printf("Deck turned %d times about z, nec2's matrix %d times smaller\n",
+           plan->copies, plan->copies);
+  return plan;
+
+}  /**  End of DeckSymmetry  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               WritePieces                               **/
+/**                                                                         **/
+/**  The plan's base pieces as GW cards, then the GX or GR card that has    **/
+/**  nec2 make the rest of the structure from them.                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void WritePieces(FILE *f, const SY_Plan *plan) {
+
+  const SY_Piece  *p;  /**  Current piece  **/
+  int              k;  /**  Loop counter   **/
+
+  for (k = 0; k < plan->base; k++) {
+    p = &plan->pieces[k];
+    fprintf(f, "GW %d %d %lf %lf %lf %lf %lf %lf %lf\n", k + 1, p->segments,
+            p->e1.x * 100.0, p->e1.y * 100.0, p->e1.z * 100.0,
+            p->e2.x * 100.0, p->e2.y * 100.0, p->e2.z * 100.0,
+            p->width * 100.0);
+  }  /**  For each piece written  **/
+  if (plan->planes != 0)
+    fprintf(f, "GX %d %03d\n", plan->base, plan->planes);
+  else
+    fprintf(f, "GR %d %d\n", plan->base, plan->copies);
+
+}  /**  End of WritePieces  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                WriteLoad                                **/
+/**                                                                         **/
+/**  An LD card on a tube as one card per piece of it, in the deck's tags   **/
+/**  and segments.                                                          **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void WriteLoad(FILE *f, const Ant *ant, const SY_Plan *plan, 
+                     const char *card) {
+
+  const SY_Piece  *p;      /**  Current piece      **/
+  int              ld[4];  /**  LD integers        **/
+  double           z[3];   /**  LD values          **/
+  int              first;  /**  Loaded segments    **/
+  int              last;
+  int              lo;     /**  ..within the piece **/
+  int              hi;
+  int              k;      /**  Loop counter       **/
+
+  z[0] = z[1] = z[2] = 0.0;
+  sscanf(card + 2, "%d%d%d%d%lf%lf%lf", &ld[0], &ld[1], &ld[2], &ld[3],
+         &z[0], &z[1], &z[2]);
+  LoadRange(ant, ld, &first, &last);
+  for (k = 0; k < plan->count; k++) {
+    p = &plan->pieces[k];
+    lo = (first > p->first) ? first - p->first : 1;
+    hi = (last < p->first + p->segments) ? last - p->first : p->segments;
+    if (p->tube != ld[1] || lo > hi)
+      continue;
+    if (p->reversed)
+      fprintf(f, "LD %d %d %d %d %g %g %g\n", ld[0], k + 1, 
+              p->segments - hi + 1, p->segments - lo + 1, z[0], z[1], z[2]);
+    else
+      fprintf(f, "LD %d %d %d %d %g %g %g\n", ld[0], k + 1, lo, hi, 
+              z[0], z[1], z[2]);
+  }  /**  For each piece of the tube  **/
+
+}  /**  End of WriteLoad  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              UnmapFeedRows                              **/
+/**                                                                         **/
+/**  Puts the feed rows from row first on, read from a deck written with    **/
+/**  the symmetry plan, back on the antenna's own tags and segments.        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void UnmapFeedRows(const Ant *ant, const SY_Plan *plan, 
+                         FeedTable *table, int first) {
+
+  int   tube;      /**  Row's tube        **/
+  int   seg;       /**    ..and segment   **/
+  bool  reversed;  /**  Unused            **/
+  int   i;         /**  Loop counter      **/
+
+  for (i = first; i < table->count; i++)
+    if (SY_FromSegment(plan, table->segment[i], &tube, &seg,
+                       &reversed)) {
+      table->tag[i] = tube;
+      table->segment[i] = TubeOffset(ant, tube) + seg;
+    }  /**  As the antenna's own deck has it  **/
+
+}  /**  End of UnmapFeedRows  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              MappedCurrents                             **/
+/**                                                                         **/
+/**  Reads the segment currents, from line on, of a deck written with the   **/
+/**  symmetry plan onto the antenna's tubes, the phase turned half round    **/
+/**  on pieces that run against their tube.  Returns false if the output    **/
+/**  ends first.                                                            **/
 /**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-void WriteCardFile(CONST84 char *file_name, Ant *the_ant, int step_size, double freq) {
+local bool MappedCurrents(FILE *fin, Ant *ant, const SY_Plan *plan, 
+                          char *line) {
+
+  Tube         *tube;      /**  Current tube         **/
+  SegmentData  *segptr;    /**  Current data         **/
+  SegmentData **next;      /**  Where it goes        **/
+  float        *mags;      /**  Per segment          **/
+  float        *phases;
+  double        dummyf;    /**  Columns not used     **/
+  double        mag;       /**  Current magnitude    **/
+  double        phase;     /**    ..and phase        **/
+  int           number;    /**  NEC's segment        **/
+  int           tag;       /**  NEC's tag, unused    **/
+  int           n;         /**  Tube number          **/
+  int           seg;       /**  Segment on it        **/
+  int           offset;    /**  Tube's first         **/
+  int           total;     /**  Segments             **/
+  int           count;     /**  Lines read           **/
+  bool          reversed;  /**  Against the tube     **/
+  int           i;         /**  Loop counter         **/
+
+  total = 0;
+  for (tube = ant->first_tube; tube != NULL; tube = tube->next)
+    total += tube->segments;
+  mags = (float *) calloc(total, sizeof(float));
+  phases = (float *) calloc(total, sizeof(float));
+  if (mags == NULL || phases == NULL) {
+    free(mags);
+    free(phases);
+    return false;
+  }  /**  No room  **/
+
+  for (count = 0; count < total; count++) {
+    if (sscanf(line, "%d%d%lf%lf%lf%lf%lf%lf%lf%lf", &number, &tag, 
+               &dummyf, &dummyf, &dummyf, &dummyf, &dummyf, &dummyf,
+               &mag, &phase) != 10)
+      break;
+    if (SY_FromSegment(plan, number, &n, &seg, &reversed) &&
+        (offset = TubeOffset(ant, n)) >= 0) {
+      if (reversed)
+        phase = (phase > 0.0) ? phase - 180.0 : phase + 180.0;
+      mags[offset + seg - 1] = mag;
+      phases[offset + seg - 1] = phase;
+      if (count == 0) {
+        ant->max_current_mag = ant->min_current_mag = mag;
+        ant->max_current_phase = ant->min_current_phase = phase;
+      }  /**  First  **/
+      ant->max_current_mag = fmax(ant->max_current_mag, mag);
+      ant->min_current_mag = fmin(ant->min_current_mag, mag);
+      ant->max_current_phase = fmax(ant->max_current_phase, phase);
+      ant->min_current_phase = fmin(ant->min_current_phase, phase);
+    }  /**  On a tube  **/
+    if (fgets(line, 255, fin) == NULL) {
+      count++;
+      break;
+    }  /**  End of file  **/
+  }  /**  For each segment  **/
+
+  for (tube = ant->first_tube, i = 0; tube != NULL; tube = tube->next) {
+    while ((segptr = tube->currents) != NULL) {
+      tube->currents = segptr->next;
+      free(segptr);
+    }  /**  Old currents  **/
+    for (next = &tube->currents, seg = 0; seg < tube->segments; seg++, i++) {
+      segptr = (SegmentData *) calloc(1, sizeof(SegmentData));
+      segptr->currentMagnitude = mags[i];
+      segptr->currentPhase = phases[i];
+      *next = segptr;
+      next = &segptr->next;
+    }  /**  For each segment  **/
+  }  /**  For each tube  **/
+  free(mags);
+  free(phases);
+  return count == total;
+
+}  /**  End of MappedCurrents  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              WriteCards                                 **/
+/**                                                                         **/
+/**  Writes the antenna's deck with its FR card set to freqs frequencies    **/
+/**  from freq, freq_step apart.  A step_size of 0 asks for no pattern:     **/
+/**  RP cards are dropped and an XQ card goes before EN, so nec2 only       **/
+/**  solves for currents and input parameters at each frequency.  With a    **/
+/**  port of 0 or more only that voltage source (EX type 0 or 5, counted    **/
+/**  in deck order) is kept, driven with 1 volt.  If the tubes have a       **/
+/**  symmetry nec2 can use, and UseSymmetry is set, only their base         **/
+/**  pieces are written, with a GX or GR card, and sources and loads are    **/
+/**  moved onto the deck's tags.  Returns that plan, or NULL, for the      **/
+/**  caller to give ParseFieldData with the output and then SY_Free.        **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local SY_Plan *WriteCards(CONST84 char *file_name, Ant *the_ant, 
+                          int step_size, double freq, double freq_step, 
+                          int freqs, int port) {
 
   FILE *fout;            /**  Output file                 **/
   char *card;            /**  Ouput buffer                **/
@@ -295,12 +749,23 @@ void WriteCardFile(CONST84 char *file_name, Ant *the_ant, int step_size, double
   int   curr_tube;       /**  Current tube                **/
   int   increment;       /**  Increment in theta and phi  **/
   bool  seen_rp;         /**  Seen the RP card            **/
+  bool  seen_fr;         /**  Seen the FR card            **/
   bool  finished_tubes;  /**  Done drawing tubes          **/
-
+  int   sources;         /**  Voltage sources so far      **/
+  int   ex[4];           /**  EX type, tag, segment, flag **/
+  double v[2];           /**  EX voltage                  **/
+  int   tag;             /**  Source's tag in the deck    **/
+  int   seg;             /**    ..and segment             **/
+  bool  reversed;        /**  Its piece runs backwards    **/
+  SY_Plan *plan;         /**  Symmetry, NULL if none      **/
+
+  plan = UseSymmetry ? DeckSymmetry(the_ant) : NULL;
   finished_tubes = false;
+  sources = 0;
   curr_tube = 1;
   fout = fopen(file_name, "wt");
   seen_rp = false;
+  seen_fr = false;
 
   if(fout == NULL)
     fprintf(stderr, "Could not open file %s for writing\n", file_name);
@@ -309,13 +774,15 @@ void WriteCardFile(CONST84 char *file_name, Ant *the_ant, int step_size, double
     for(i=0; i < the_ant->card_count; i++) {
       card = the_ant->cards[i];
       if((card[0] == 'G') && (card[1] == 'W')) {
-        while((the_tube != NULL) && (!finished_tubes)) {
+        if (plan != NULL && !finished_tubes)
+          WritePieces(fout, plan);
+        while((the_tube != NULL) && (!finished_tubes) && (plan == NULL)) {
           PrintTube(fout, the_tube, curr_tube++);
           the_tube = the_tube->next;
         }
         finished_tubes = true;
       } else if ((card[0] == 'R') && (card[1] == 'P')) {
-        if (seen_rp == false) {
+        if (seen_rp == false && step_size > 0) {
           increment = 361 / step_size;
           fprintf(fout,"RP  0   %d   %d    1001   0   0   %d   %d     0   0\n",
             increment, increment, step_size, step_size);
@@ -323,29 +790,134 @@ void WriteCardFile(CONST84 char *file_name, Ant *the_ant, int step_size, double
         } else {
         }  /**  Have we already output RP?  **/
       } else if ((card[0] == 'F') && (card[1] == 'R')) {
-        fprintf(fout,"FR  0    1    0   0   %f     .0000     .0000     .0000    .0000    .0000\n",freq);
+        seen_fr = true;
+        if (freqs > 1)
+          fprintf(fout,"FR  0    %d    0   0   %f     %f     .0000     .0000"
+                  "    .0000    .0000\n", freqs, freq, freq_step);
+        else
+          fprintf(fout,"FR  0    1    0   0   %f     .0000     .0000     .0000    .0000    .0000\n",freq);
       } else if ((card[0] == 'G') && (card[1] == 'N')) {
         /**  Do nothing  **/
+      } else if ((card[0] == 'X') && (card[1] == 'Q') && (step_size == 0)) {
+        /**  Written before EN  **/
+      } else if ((card[0] == 'E') && (card[1] == 'X') && (port >= 0) &&
+                 (sscanf(card + 2, "%d%d%d%d", &ex[0], &ex[1], &ex[2], 
+                         &ex[3]) == 4) && (ex[0] == 0 || ex[0] == 5)) {
+        if (sources++ != port) {
+          /**  Other ports are left out  **/
+        } else if (plan == NULL)
+          fprintf(fout, "EX  %d  %d  %d  %d  1.0  0.0\n", ex[0], ex[1], 
+                  ex[2], ex[3]);
+        else if (MapSegment(the_ant, plan, ex[1], ex[2], &tag, &seg, 
+                            &reversed))
+          fprintf(fout, "EX  %d  %d  %d  %d  %s  0.0\n", ex[0], tag, seg, 
+                  ex[3], reversed ? "-1.0" : "1.0");
+      } else if ((card[0] == 'E') && (card[1] == 'X') && (plan != NULL) &&
+                 (sscanf(card + 2, "%d%d%d%d", &ex[0], &ex[1], &ex[2], 
+                         &ex[3]) == 4) && (ex[0] == 0 || ex[0] == 5) &&
+                 MapSegment(the_ant, plan, ex[1], ex[2], &tag, &seg, 
+                            &reversed)) {
+        v[0] = v[1] = 0.0;
+        sscanf(card + 2, "%*d%*d%*d%*d%lf%lf", &v[0], &v[1]);
+        if (reversed) {
+          v[0] = 0.0 - v[0];
+          v[1] = 0.0 - v[1];
+        }  /**  Source drives the other way along the piece  **/
+        fprintf(fout, "EX  %d  %d  %d  %d  %lf  %lf\n", ex[0], tag, seg, 
+                ex[3], v[0], v[1]);
+      } else if ((card[0] == 'L') && (card[1] == 'D') && (plan != NULL) &&
+                 (sscanf(card + 2, "%d%d", &ex[0], &ex[1]) == 2) && 
+                 (ex[1] != 0)) {
+        WriteLoad(fout, the_ant, plan, card);
       } else {
+        if ((card[0] == 'E') && (card[1] == 'N') && (step_size == 0)) {
+          if (seen_fr == false)
+            fprintf(fout,"FR  0    %d    0   0   %f     %f     .0000     .0000"
+                    "    .0000    .0000\n", freqs, freq, freq_step);
+          fprintf(fout, "XQ\n");
+        }  /**  Sweep without patterns  **/
         fprintf(fout, "%s", card);
       }  /**  Just output all other lines  **/
     }  /**  For each card  **/ 
     fclose(fout);
   }  /**  Antenna exists in memory  **/
+  return plan;
+
+}  /**  End of WriteCards  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            WriteCardFile                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+SY_Plan *WriteCardFile(CONST84 char *file_name, Ant *the_ant, int step_size,
+                       double freq) {
+
+  return WriteCards(file_name, the_ant, step_size, freq, 0.0, 1, -1);
 
 }  /**  End of WriteCardFile  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                            WriteSweepFile                               **/
+/**                                                                         **/
+/**  Writes the antenna's deck for a frequency sweep without patterns:      **/
+/**  freqs frequencies from start, freq_step MHz apart.                     **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+SY_Plan *WriteSweepFile(CONST84 char *file_name, Ant *the_ant, 
+                        double start, double freq_step, int freqs) {
+
+  return WriteCards(file_name, the_ant, 0, start, freq_step, freqs, -1);
+
+}  /**  End of WriteSweepFile  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             WritePortFile                               **/
+/**                                                                         **/
+/**  Writes the antenna's deck as WriteCardFile does, but driven at one     **/
+/**  port only, with 1 volt, for solving the ports one at a time.           **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+SY_Plan *WritePortFile(CONST84 char *file_name, Ant *the_ant, 
+                       int step_size, double freq, int port) {
+
+  return WriteCards(file_name, the_ant, step_size, freq, 0.0, 1, port);
+
+}  /**  End of WritePortFile  **/
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
 /**                          WriteMultAntsFile                              **/
 /**                                                                         **/
+/**  Writes every antenna of the scene, at its offset, as one deck with     **/
+/**  the last antenna's control cards.  With a cluster array only the       **/
+/**  antennas whose cluster[k] is id are written.                           **/
+/**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
-void WriteMultAntsFile(CONST84 char *file_name, int step_size, double freq) {
+void WriteMultAntsFile(CONST84 char *file_name, int step_size, double freq,
+                       const int *cluster, int id) {
 
   FILE *fout;            /**  Output file                 **/
   char *card;            /**  Ouput buffer                **/
@@ -358,6 +930,19 @@ void WriteMultAntsFile(CONST84 char *file_name, int step_size, double freq) {
   bool  seen_rp;         /**  Seen the RP card            **/
   bool  finished_tubes;  /**  Are we done yet             **/
   Ant  *the_ant;         /**  Current antenna             **/
+  int   first;           /**  First antenna written       **/
+  int   last;            /**  Last antenna written        **/
+
+  first = -1;
+  last = -1;
+  for (k = 0; k < TheAnts.ant_count; k++)
+    if (cluster == NULL || cluster[k] == id) {
+      if (first < 0)
+        first = k;
+      last = k;
+    }  /**  Member  **/
+  if (last < 0)
+    return;
 
   finished_tubes = false;
   fout = fopen(file_name, "wt");
@@ -368,17 +953,19 @@ void WriteMultAntsFile(CONST84 char *file_name, int step_size, double freq) {
     fprintf(stderr, "Could not open file %s for writing\n", file_name);
   else {
 
-    for(k=0; k < TheAnts.ant_count-1; k++) {
+    for(k=first; k < last; k++) {
 
+      if (cluster != NULL && cluster[k] != id)
+        continue;
       curr_tube = 1;
       the_ant = &TheAnts.ants[k];
  
       the_tube = the_ant->first_tube;
       for(i=0; i < the_ant->card_count; i++) {
         card = the_ant->cards[i];
-        if ((card[0] == 'C') && (card[1] == 'M') && (k==0)) {
+        if ((card[0] == 'C') && (card[1] == 'M') && (k==first)) {
           fprintf(fout, "%s", card);
-        } else if ((card[0] == 'C') && (card[1] == 'E') && (k==0)) {
+        } else if ((card[0] == 'C') && (card[1] == 'E') && (k==first)) {
           fprintf(fout, "%s", card);
         } else if ((card[0] == 'G') && (card[1] == 'W')) {
           while((the_tube != NULL) && (!finished_tubes)) {
@@ -397,17 +984,17 @@ void WriteMultAntsFile(CONST84 char *file_name, int step_size, double freq) {
     }  /**  For all but last antenna  **/
 
     curr_tube = 1;
-    the_ant = &TheAnts.ants[TheAnts.ant_count-1];
+    the_ant = &TheAnts.ants[last];
     finished_tubes = false;
 
     the_tube = the_ant->first_tube;
     for(i=0; i < the_ant->card_count; i++) {
       card = the_ant->cards[i];
       if ((card[0] == 'C') && (card[1] == 'M')) {
-        if (TheAnts.ant_count == 1)
+        if (first == last)
           fprintf(fout, "%s", card);
       } else if ((card[0] == 'C') && (card[1] == 'E')) {
-        if (TheAnts.ant_count == 1)
+        if (first == last)
           fprintf(fout, "%s", card);
       } else if((card[0] == 'G') && (card[1] == 'W')) {
         while((the_tube != NULL) && (!finished_tubes)) {
@@ -632,17 +1219,323 @@ void ReadCardFile(CONST84 char *file_name, Ant *antData) {
 }  /**  End of ReadCardFile  **/
 
 
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              DeckSegments                               **/
+/**                                                                         **/
+/**  Segments in a written deck, for sizing nec2's matrix before it runs:   **/
+/**  GW, GA and GH wires, times the copies GR and GX make of them.  0 if    **/
+/**  the deck cannot be read.  The copies go in *copies, as nec2 keeps      **/
+/**  only that fraction of the matrix for a symmetric structure.            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+long DeckSegments(CONST84 char *file_name, int *copies) {
+
+  FILE  *fin;        /**  The deck              **/
+  char   line[256];  /**  One card              **/
+  long   segments;   /**  So far                **/
+  int    tag;        /**  Wire tag, unused      **/
+  int    count;      /**  Segments, or copies   **/
+
+  *copies = 1;
+  if ((fin = fopen(file_name, "rt")) == NULL)
+    return 0;
+  segments = 0;
+  while (fgets(line, sizeof(line), fin) != NULL) {
+    if (line[0] != 'G')
+      continue;
+    if (line[1] == 'E')
+      break;
+    if (sscanf(line + 2, "%d%d", &tag, &count) != 2)
+      continue;
+    if (line[1] == 'W' || line[1] == 'A' || line[1] == 'H')
+      segments += count;
+    else if (line[1] == 'R' && count > 1) {
+      segments *= count;
+      *copies *= count;
+    } else if (line[1] == 'X') {
+      for (; count > 0; count /= 10)
+        if (count % 10 != 0) {
+          segments *= 2;
+          *copies *= 2;
+        }  /**  Plane  **/
+    }  /**  One reflection per non-zero digit  **/
+  }  /**  Geometry cards  **/
+  fclose(fin);
+  return segments;
+
+}  /**  End of DeckSegments  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                           NewPatternSerial                              **/
+/**                                                                         **/
+/**  A serial for freshly filled FieldData, so cached meshes are rebuilt.   **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+long NewPatternSerial(void) {
+
+  return ++PatternSerial;
+
+}  /**  End of NewPatternSerial  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             FreeFeedRows                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FreeFeedRows(FeedTable *table) {
+
+  if (table == NULL)
+    return;
+  free(table->frequency);
+  free(table->tag);
+  free(table->segment);
+  free(table->resistance);
+  free(table->reactance);
+  free(table->power);
+  free(table);
+
+}  /**  End of FreeFeedRows  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             FreeFeedTable                               **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void FreeFeedTable(Ant *ant) {
+
+  FreeFeedRows(ant->feedTable);
+  ant->feedTable = NULL;
+
+}  /**  End of FreeFeedTable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                             ClearFeedTable                              **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+FeedTable *ClearFeedTable(Ant *ant) {
+
+  if (ant->feedTable == NULL)
+    ant->feedTable = (FeedTable *) calloc(1, sizeof(FeedTable));
+  else
+    ant->feedTable->count = 0;
+  return ant->feedTable;
+
+}  /**  End of ClearFeedTable  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               AddFeedRow                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void AddFeedRow(FeedTable *table, double freq, int tag, int seg, 
+                double resistance, double reactance, double power) {
+
+  int  i;  /**  New row  **/
+
+  if (table->count == table->allocated) {
+    table->allocated = (table->allocated > 0) ? 2 * table->allocated : 16;
+    table->frequency = (double *) realloc(table->frequency, 
+                                          table->allocated * sizeof(double));
+    table->tag = (int *) realloc(table->tag, table->allocated * sizeof(int));
+    table->segment = (int *) realloc(table->segment, 
+                                     table->allocated * sizeof(int));
+    table->resistance = (double *) realloc(table->resistance, 
+                                           table->allocated * sizeof(double));
+    table->reactance = (double *) realloc(table->reactance, 
+                                          table->allocated * sizeof(double));
+    table->power = (double *) realloc(table->power, 
+                                      table->allocated * sizeof(double));
+  }  /**  Grow the columns  **/
+
+  i = table->count++;
+  table->frequency[i] = freq;
+  table->tag[i] = tag;
+  table->segment[i] = seg;
+  table->resistance[i] = resistance;
+  table->reactance[i] = reactance;
+  table->power[i] = power;
+
+}  /**  End of AddFeedRow  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                          ScanInputParameters                            **/
+/**                                                                         **/
+/**  Looks at one line of NEC output for the frequency, which is kept in    **/
+/**  freq, and for the ANTENNA INPUT PARAMETERS heading, whose rows are     **/
+/**  then read into the table, one per source.  The line after the rows is  **/
+/**  left in line for the caller to look at.                                **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+local void ScanInputParameters(char *line, FILE *fin, FeedTable *table, 
+                               double *freq) {
+
+  char    *p;          /**  Into the line          **/
+  double   v[9];       /**  Voltage through power  **/
+  int      tag;        /**  Source wire            **/
+  int      seg;        /**    ..and segment        **/
+  int      rows;       /**  Rows read              **/
+  int      skipped;    /**  Heading lines          **/
+
+  if ((p = strstr(line, "FREQUENCY")) != NULL && 
+      strstr(line, "MHZ") != NULL) {
+    for (p += 9; *p == ' ' || *p == '=' || *p == ':'; p++)
+      ;
+    *freq = atof(p);
+    return;
+  }  /**  NEC2 "FREQUENCY= ", nec2c "FREQUENCY : "  **/
+
+  if (strstr(line, "ANTENNA INPUT PARAMETERS") == NULL)
+    return;
+  rows = 0;
+  skipped = 0;
+  while (fgets(line, 256, fin) != NULL) {
+    if (sscanf(line, "%d%d%lf%lf%lf%lf%lf%lf%lf%lf%lf", &tag, &seg, 
+               &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], 
+               &v[8]) == 11) {
+      AddFeedRow(table, *freq, tag, seg, v[4], v[5], v[8]);
+      rows++;
+    }  /**  One source  **/
+    else if (rows > 0 || ++skipped > 4)
+      break;
+  }  /**  Heading, then the rows  **/
+
+}  /**  End of ScanInputParameters  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                               ParseSweep                                **/
+/**                                                                         **/
+/**  Reads the input parameters at every frequency of a sweep, as written   **/
+/**  for a deck from WriteSweepFile with plan, into the antenna's feed      **/
+/**  table.                                                                 **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void ParseSweep(FILE *fin, Ant *currAnt, const SY_Plan *plan) {
+
+  ClearFeedTable(currAnt);
+  AppendSweep(fin, currAnt, plan);
+
+}  /**  End of ParseSweep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                              AppendSweep                                **/
+/**                                                                         **/
+/**  As ParseSweep, but adds the rows after those already in the feed       **/
+/**  table, for a sweep solved in several parts.                            **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+void AppendSweep(FILE *fin, Ant *currAnt, const SY_Plan *plan) {
+
+  FeedTable  *table;      /**  Where the rows go     **/
+  char        line[256];  /**  A line of the output  **/
+  double      freq;       /**  Current frequency     **/
+  int         first;      /**  First new row        **/
+
+  if ((table = currAnt->feedTable) == NULL)
+    table = ClearFeedTable(currAnt);
+  freq = currAnt->frequency;
+  first = table->count;
+  while (fgets(line, 256, fin) != NULL)
+    ScanInputParameters(line, fin, table, &freq);
+  if (plan != NULL)
+    UnmapFeedRows(currAnt, plan, table, first);
+
+}  /**  End of AppendSweep  **/
+
+
+/*****************************************************************************/
+/*****************************************************************************/
+/**                                                                         **/
+/**                                FeedSWR                                  **/
+/**                                                                         **/
+/**  SWR of an input impedance on a line of impedance z0, capped at 999.99  **/
+/**  where the reflection is total.                                         **/
+/**                                                                         **/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+double FeedSWR(double resistance, double reactance, double z0) {
+
+  double  rho;  /**  |reflection coefficient|  **/
+
+  rho = sqrt(((resistance - z0) * (resistance - z0) + 
+              reactance * reactance) /
+             ((resistance + z0) * (resistance + z0) + 
+              reactance * reactance));
+  if (!(rho < 0.99980002))
+    return 999.99;
+  return (1.0 + rho) / (1.0 - rho);
+
+}  /**  End of FeedSWR  **/
+
+
+
 /*****************************************************************************/
 /*****************************************************************************/
 /**                                                                         **/
 /**                          ParseFieldData                                 **/
 /**                                                                         **/
+/**  Reads nec2's output into the antenna: the field, the currents and the  **/
+/**  input parameters.  plan is the symmetry the deck was written with,     **/
+/**  NULL if it was written whole.                                          **/
+/**                                                                         **/
 /*****************************************************************************/
 /*****************************************************************************/
 
 
 void ParseFieldData(FILE *fin, 
                      Ant *currAnt, 
+           const SY_Plan *plan,
                     bool  compField, 
                     bool  compCurrents) {
 
@@ -662,7 +1555,11 @@ void ParseFieldData(FILE *fin,
   double       dummyf;           /**  Data we don't care about           **/
   double       mag;              /**  Magnitude of the current           **/
   double       phase;            /**  Phase of the current               **/
+  double       start;            /**  Timer start                        **/
+  double       freq;             /**  Frequency of the output, MHz       **/
+  FeedTable   *feed;             /**  Input parameters                   **/
 
+  start = TM_Start();
   end_of_file = false;
   fprintf(stdout,"Parsing NEC2 output...\n");
   if (currAnt->fieldData == NULL)
@@ -676,11 +1573,15 @@ void ParseFieldData(FILE *fin,
   currAnt->fieldData->vals    = (FieldVal*)malloc(max_data*sizeof(FieldVal));
   count = 0;
   done_first_line = false;
+  feed = ClearFeedTable(currAnt);
+  freq = currAnt->frequency;
 
 
   if (compCurrents == true) {
-    do {  /**  Ignore everything up to currents  **/
+    do {  /**  Input parameters on the way, then up to currents  **/
       ptr = fgets(line, 256, fin);
+      if (ptr != NULL)
+        ScanInputParameters(line, fin, feed, &freq);
       if(strstr(line, "CURRENTS AND LOCATION") != NULL)
         count++;
       if(ptr == NULL) {
@@ -699,17 +1600,28 @@ void ParseFieldData(FILE *fin,
     count = 0;
     card_num = 1;
     segptr = NULL;
+    if (plan != NULL && end_of_file == false) {
+      if (!MappedCurrents(fin, currAnt, plan, line))
+        end_of_file = true;
+      done_first_line = true;
+      count = currAnt->total_segments;
+    }  /**  Deck written with GX or GR  **/
     while((end_of_file == false) && (count < currAnt->total_segments)) {
       sscanf(line, "%d%d%lf%lf%lf%lf%lf%lf%lf%lf", 
                     &seg_num, &tag_num, &dummyf, &dummyf, 
                     &dummyf, &dummyf, &dummyf, &dummyf,
                     &mag, &phase);
 
-      if (tag_num > card_num) {
+      if (tag_num > card_num && currAnt->current_tube != NULL) {
         currAnt->current_tube = currAnt->current_tube->next;
         card_num = tag_num;
         segptr = NULL;
       }  /**  Advance to next card  **/
+      if (currAnt->current_tube == NULL) {
+        fprintf(stderr, "NEC output has more wires than the antenna\n");
+        end_of_file = true;
+        break;
+      }  /**  Not this antenna's output  **/
 
       if (done_first_line == false) {
         currAnt->max_current_mag = mag;
@@ -758,6 +1670,8 @@ void ParseFieldData(FILE *fin,
     end_of_file = false;
     do {  /**  Ignore everything but RP  **/
       ptr = fgets(line, 256, fin);
+      if (ptr != NULL && compCurrents == false)
+        ScanInputParameters(line, fin, feed, &freq);
       if(strstr(line, "RADIATION PATTERNS") != NULL)
         count++;
       if(ptr == NULL) {
@@ -830,11 +1744,15 @@ void ParseFieldData(FILE *fin,
 
     }  /**  Processing loop  **/
     currAnt->fieldData->count = count;
+    currAnt->fieldData->serial = NewPatternSerial();
     currAnt->fieldComputed = true;
   }  /**  Compute field  **/
 
+  if (plan != NULL)
+    UnmapFeedRows(currAnt, plan, feed, 0);
   if (end_of_file == true)
     printf("NEC RP failed!\n");
+  TM_Stop(TM_PARSE, start);
 
 }  /**  End of ParseFieldData  **/
 
@@ -43,11 +43,22 @@
 
 void  PrintTube(FILE *, Tube *, int);
 void  PrintTubeOffset(FILE *, Tube *, int, double, double, double);
-void  WriteCardFile(CONST84 char *, Ant *, int, double);
-void  WriteMultAntsFile(CONST84 char *, int, double);
+struct SY_Plan *WriteCardFile(CONST84 char *, Ant *, int, double);
+struct SY_Plan *WriteSweepFile(CONST84 char *, Ant *, double, double, int);
+struct SY_Plan *WritePortFile(CONST84 char *, Ant *, int, double, int);
+void  WriteMultAntsFile(CONST84 char *, int, double, const int *, int);
 bool  CardToTube(char *, Tube *);
 void  ReadCardFile(CONST84 char *, Ant *);
-void  ParseFieldData(FILE *, Ant *, bool, bool);
+long  DeckSegments(CONST84 char *, int *);
+void  ParseFieldData(FILE *, Ant *, const struct SY_Plan *, bool, bool);
+void  ParseSweep(FILE *, Ant *, const struct SY_Plan *);
+void  AppendSweep(FILE *, Ant *, const struct SY_Plan *);
+void  FreeFeedRows(FeedTable *);
+void  FreeFeedTable(Ant *);
+FeedTable *ClearFeedTable(Ant *);
+void  AddFeedRow(FeedTable *, double, int, int, double, double, double);
+double FeedSWR(double, double, double);
+long  NewPatternSerial(void);
 
 #endif
 